@@ -858,8 +858,11 @@ cdef extern from "<datoviz/datoviz.h>":
         DVZ_VISUAL_AXES_2D = 28
         DVZ_VISUAL_AXES_3D = 29
         DVZ_VISUAL_COLORMAP = 30
-        DVZ_VISUAL_COUNT = 31
-        DVZ_VISUAL_CUSTOM = 32
+        DVZ_VISUAL_STREAM = 31
+        DVZ_VISUAL_POINT_CLOUD = 32
+        DVZ_VISUAL_DENSITY = 33
+        DVZ_VISUAL_COUNT = 34
+        DVZ_VISUAL_CUSTOM = 35
 
     ctypedef enum DvzAxisLevel:
         DVZ_AXES_LEVEL_MINOR = 0
@@ -85,6 +85,123 @@ static int demo(int argc, char** argv)
 
 
 
+/*************************************************************************************************/
+/*  Benchmarks                                                                                   */
+/*************************************************************************************************/
+
+// Maximum number of positions transformed at once in the benchmarks, larger point counts are
+// processed in successive blocks to bound the memory usage.
+#define BENCH_BLOCK_SIZE 16777216
+
+static void bench_transform(
+    const char* name, DvzTransformType transform, DvzDataType dtype_in, DvzDataType dtype_out,
+    uint64_t n)
+{
+    uint32_t block = (uint32_t)MIN(n, BENCH_BLOCK_SIZE);
+    DvzArray pos_in = dvz_array(block, dtype_in);
+    DvzArray pos_out = dvz_array(block, dtype_out);
+
+    // Random longitudes and latitudes, so that the positions are also valid for web Mercator.
+    dvec3 pos = {0};
+    for (uint32_t i = 0; i < block; i++)
+    {
+        pos[0] = -180 + 360 * dvz_rand_float();
+        pos[1] = -80 + 160 * dvz_rand_float();
+        pos[2] = dvz_rand_float();
+        _pos_set(dtype_in, pos, dvz_array_item(&pos_in, i));
+    }
+
+    DvzDataCoords coords = {0};
+    coords.box = (DvzBox){{-180, -80, 0}, {180, 80, 1}};
+    coords.transform = transform;
+
+    DvzClock clock = {0};
+    _clock_init(&clock);
+    for (uint64_t done = 0; done < n; done += block)
+    {
+        pos_in.item_count = pos_out.item_count = (uint32_t)MIN(block, n - done);
+        dvz_transform_pos(coords, &pos_in, &pos_out, false);
+    }
+    double elapsed = _clock_get(&clock);
+    printf(
+        "%-32s %12" PRIu64 " points %8.3f s %10.1f Mpoints/s\n", name, n, elapsed,
+        n / elapsed / 1e6);
+
+    pos_in.item_count = pos_out.item_count = block;
+    dvz_array_destroy(&pos_in);
+    dvz_array_destroy(&pos_out);
+}
+
+static void bench_normals(uint32_t n)
+{
+    // Sphere with about n triangles, 2 triangles per grid cell.
+    uint32_t side = (uint32_t)ceil(sqrt(n / 2.0)) + 1;
+    DvzMesh mesh = dvz_mesh_sphere(side, side);
+    uint32_t face_count = mesh.indices.item_count / 3;
+    printf(
+        "mesh normals benchmark on %u processor(s), %u vertices\n", dvz_num_procs(),
+        mesh.vertices.item_count);
+
+    const char* names[] = {"uniform", "area", "angle"};
+    DvzClock clock = {0};
+    for (DvzMeshNormalsWeight weight = DVZ_MESH_NORMALS_UNIFORM; weight <= DVZ_MESH_NORMALS_ANGLE;
+         weight++)
+    {
+        _clock_init(&clock);
+        dvz_mesh_normals_weighted(&mesh, weight);
+        double elapsed = _clock_get(&clock);
+        printf(
+            "normals %-24s %12u faces  %8.3f s %10.1f Mfaces/s\n", names[weight], face_count,
+            elapsed, face_count / elapsed / 1e6);
+    }
+
+    dvz_mesh_destroy(&mesh);
+}
+
+static int bench(int argc, char** argv)
+{
+    // argv: bench, normals, [number of triangles]
+    if (argc >= 2 && strcmp(argv[1], "normals") == 0)
+    {
+        uint64_t n = argc >= 3 ? strtoull(argv[2], NULL, 10) : 10000000;
+        if (n == 0 || n > UINT32_MAX / 3)
+        {
+            log_error("invalid number of triangles");
+            return 1;
+        }
+        bench_normals((uint32_t)n);
+        return 0;
+    }
+
+    // argv: bench, [number of points]
+    uint64_t n = argc >= 2 ? strtoull(argv[1], NULL, 10) : 10000000;
+    if (n == 0)
+    {
+        log_error("invalid number of points");
+        return 1;
+    }
+    printf("transform benchmark on %u processor(s)\n", dvz_num_procs());
+
+    bench_transform(
+        "cartesian dvec3 -> dvec3", DVZ_TRANSFORM_CARTESIAN, DVZ_DTYPE_DVEC3, DVZ_DTYPE_DVEC3, n);
+    bench_transform(
+        "cartesian dvec3 -> vec3", DVZ_TRANSFORM_CARTESIAN, DVZ_DTYPE_DVEC3, DVZ_DTYPE_VEC3, n);
+    bench_transform(
+        "cartesian vec3 -> vec3", DVZ_TRANSFORM_CARTESIAN, DVZ_DTYPE_VEC3, DVZ_DTYPE_VEC3, n);
+    bench_transform(
+        "cartesian vec2 -> vec2", DVZ_TRANSFORM_CARTESIAN, DVZ_DTYPE_VEC2, DVZ_DTYPE_VEC2, n);
+    bench_transform(
+        "mercator dvec3 -> dvec3", DVZ_TRANSFORM_EARTH_MERCATOR_WEB, DVZ_DTYPE_DVEC3,
+        DVZ_DTYPE_DVEC3, n);
+    bench_transform(
+        "mercator dvec2 -> vec2", DVZ_TRANSFORM_EARTH_MERCATOR_WEB, DVZ_DTYPE_DVEC2,
+        DVZ_DTYPE_VEC2, n);
+
+    return 0;
+}
+
+
+
 /*************************************************************************************************/
 /*  Main functions                                                                               */
 /*************************************************************************************************/
@@ -149,7 +266,7 @@ int main(int argc, char** argv)
     log_set_level_env();
     if (argc <= 1)
     {
-        log_error("specify a command: info, demo, test");
+        log_error("specify a command: info, demo, test, bench");
         return 1;
     }
     ASSERT(argc >= 2);
@@ -157,5 +274,6 @@ int main(int argc, char** argv)
     SWITCH_CLI_ARG(info)
     SWITCH_CLI_ARG(test)
     SWITCH_CLI_ARG(demo)
+    SWITCH_CLI_ARG(bench)
     return res;
 }
@@ -23,8 +23,9 @@ function(create_resources files prefix output)
         # Get short filename
         string(REGEX MATCH "([^/]+)$" filename ${bin})
 
-        # HACK: do not include non graphics shaders in the embeded resources files.
-        if(${filename} MATCHES ".spv" AND NOT ${filename} MATCHES "graphics_")
+        # HACK: do not include non graphics shaders in the embeded resources files, except the
+        # builtin compute shaders used by the visuals.
+        if(${filename} MATCHES ".spv" AND NOT ${filename} MATCHES "^(graphics|compute)_")
             continue()
         endif()
 
@@ -50,8 +51,9 @@ function(create_resources files prefix output)
     foreach(bin ${files_l})
         string(REGEX MATCH "([^/]+)$" filename ${bin})
 
-        # HACK: do not include non graphics shaders in the embeded resources files.
-        if(${filename} MATCHES ".spv" AND NOT ${filename} MATCHES "graphics_")
+        # HACK: do not include non graphics shaders in the embeded resources files, except the
+        # builtin compute shaders used by the visuals.
+        if(${filename} MATCHES ".spv" AND NOT ${filename} MATCHES "^(graphics|compute)_")
             continue()
         endif()
 
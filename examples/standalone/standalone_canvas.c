@@ -40,7 +40,7 @@ static void _triangle_refill(DvzCanvas* canvas, DvzEvent ev)
     dvz_cmd_viewport(cmds, idx, canvas->viewport.viewport);
 
     // We bind the vertex buffer for the upcoming drawing command.
-    dvz_cmd_bind_vertex_buffer(cmds, idx, vertex_buffer, 0);
+    dvz_cmd_bind_vertex_buffer(cmds, idx, 0, vertex_buffer, 0);
 
     // We bind the graphics pipeline.
     dvz_cmd_bind_graphics(cmds, idx, &graphics, &bindings, 0);
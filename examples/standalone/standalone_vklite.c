@@ -258,7 +258,7 @@ int main(int argc, char** argv)
         dvz_cmd_viewport(&cmds, 0, viewport.viewport);
 
         // We bind the vertex buffer for the upcoming drawing command.
-        dvz_cmd_bind_vertex_buffer(&cmds, 0, vertex_buffer, 0);
+        dvz_cmd_bind_vertex_buffer(&cmds, 0, 0, vertex_buffer, 0);
 
         // We bind the graphics pipeline.
         dvz_cmd_bind_graphics(&cmds, 0, &graphics, &bindings, 0);
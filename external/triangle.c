@@ -692,16 +692,25 @@ struct memorypool
 
 /* Global constants.                                                         */
 
-REAL splitter; /* Used to split REAL factors for exact multiplication. */
-REAL epsilon;  /* Floating-point machine epsilon. */
-REAL resulterrbound;
-REAL ccwerrboundA, ccwerrboundB, ccwerrboundC;
-REAL iccerrboundA, iccerrboundB, iccerrboundC;
-REAL o3derrboundA, o3derrboundB, o3derrboundC;
+/* Datoviz: exactinit() recomputes the constants at every call of            */
+/*   triangulate(), and the random seed is reset too. They are thread-local  */
+/*   so that several meshes can be triangulated concurrently.                */
+#ifdef _MSC_VER
+#define THREADLOCAL __declspec(thread)
+#else
+#define THREADLOCAL __thread
+#endif
+
+THREADLOCAL REAL splitter; /* Used to split REAL factors for exact multiplication. */
+THREADLOCAL REAL epsilon;  /* Floating-point machine epsilon. */
+THREADLOCAL REAL resulterrbound;
+THREADLOCAL REAL ccwerrboundA, ccwerrboundB, ccwerrboundC;
+THREADLOCAL REAL iccerrboundA, iccerrboundB, iccerrboundC;
+THREADLOCAL REAL o3derrboundA, o3derrboundB, o3derrboundC;
 
 /* Random number seed is not constant, but I've made it global anyway.       */
 
-unsigned long randomseed; /* Current random number seed. */
+THREADLOCAL unsigned long randomseed; /* Current random number seed. */
 
 
 /* Mesh data structure.  Triangle operates on only one mesh, but the mesh    */
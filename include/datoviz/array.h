@@ -67,6 +67,11 @@ typedef enum
     DVZ_DTYPE_MAT2, // matrices of floats
     DVZ_DTYPE_MAT3,
     DVZ_DTYPE_MAT4,
+
+    // Compressed vertex formats, only used as cast targets when copying props to a source.
+    DVZ_DTYPE_SNORM16_VEC4, // 4x16 bits, signed normalized (positions in [-1, +1])
+    DVZ_DTYPE_OCT16_VEC2,   // 2x16 bits, signed normalized, octahedral-encoded unit vector
+    DVZ_DTYPE_HALF_VEC2,    // 2x16 bits, half-precision floats
 } DvzDataType;
 
 
@@ -175,6 +180,13 @@ static VkDeviceSize _get_dtype_size(DvzDataType dtype)
     case DVZ_DTYPE_MAT4:
         return 4 * 4 * 4;
 
+    // Compressed vertex formats.
+    case DVZ_DTYPE_SNORM16_VEC4:
+        return 2 * 4;
+    case DVZ_DTYPE_OCT16_VEC2:
+    case DVZ_DTYPE_HALF_VEC2:
+        return 2 * 2;
+
     default:
         break;
     }
@@ -207,6 +219,8 @@ static uint32_t _get_components(DvzDataType dtype)
     case DVZ_DTYPE_IVEC2:
     case DVZ_DTYPE_VEC2:
     case DVZ_DTYPE_DVEC2:
+    case DVZ_DTYPE_OCT16_VEC2:
+    case DVZ_DTYPE_HALF_VEC2:
         return 2;
 
     case DVZ_DTYPE_CVEC3:
@@ -225,6 +239,7 @@ static uint32_t _get_components(DvzDataType dtype)
     case DVZ_DTYPE_IVEC4:
     case DVZ_DTYPE_VEC4:
     case DVZ_DTYPE_DVEC4:
+    case DVZ_DTYPE_SNORM16_VEC4:
         return 4;
 
     default:
@@ -695,6 +710,164 @@ static inline void* dvz_array_item(DvzArray* array, uint32_t idx)
 
 
 
+// Whether a dtype can be used to store positions (1D, 2D or 3D, single or double precision).
+static inline bool _is_pos_dtype(DvzDataType dtype)
+{
+    return dtype == DVZ_DTYPE_FLOAT || dtype == DVZ_DTYPE_DOUBLE || //
+           dtype == DVZ_DTYPE_VEC2 || dtype == DVZ_DTYPE_DVEC2 ||   //
+           dtype == DVZ_DTYPE_VEC3 || dtype == DVZ_DTYPE_DVEC3;
+}
+
+
+
+// Read a position of any position dtype as a dvec3 (missing components are set to 0).
+static inline void _pos_get(DvzDataType dtype, const void* src, dvec3 out)
+{
+    switch (dtype)
+    {
+    case DVZ_DTYPE_DVEC3:
+        out[0] = ((const double*)src)[0];
+        out[1] = ((const double*)src)[1];
+        out[2] = ((const double*)src)[2];
+        break;
+    case DVZ_DTYPE_VEC3:
+        out[0] = ((const float*)src)[0];
+        out[1] = ((const float*)src)[1];
+        out[2] = ((const float*)src)[2];
+        break;
+    case DVZ_DTYPE_DVEC2:
+        out[0] = ((const double*)src)[0];
+        out[1] = ((const double*)src)[1];
+        out[2] = 0;
+        break;
+    case DVZ_DTYPE_VEC2:
+        out[0] = ((const float*)src)[0];
+        out[1] = ((const float*)src)[1];
+        out[2] = 0;
+        break;
+    case DVZ_DTYPE_DOUBLE:
+        out[0] = ((const double*)src)[0];
+        out[1] = 0;
+        out[2] = 0;
+        break;
+    case DVZ_DTYPE_FLOAT:
+        out[0] = ((const float*)src)[0];
+        out[1] = 0;
+        out[2] = 0;
+        break;
+    default:
+        log_error("unsupported position dtype %d", dtype);
+        break;
+    }
+}
+
+
+
+// Write a dvec3 position into a position of any position dtype (extra components are dropped).
+static inline void _pos_set(DvzDataType dtype, const dvec3 in, void* dst)
+{
+    switch (dtype)
+    {
+    case DVZ_DTYPE_DVEC3:
+        ((double*)dst)[2] = in[2];
+        // fall through
+    case DVZ_DTYPE_DVEC2:
+        ((double*)dst)[1] = in[1];
+        // fall through
+    case DVZ_DTYPE_DOUBLE:
+        ((double*)dst)[0] = in[0];
+        break;
+    case DVZ_DTYPE_VEC3:
+        ((float*)dst)[2] = (float)in[2];
+        // fall through
+    case DVZ_DTYPE_VEC2:
+        ((float*)dst)[1] = (float)in[1];
+        // fall through
+    case DVZ_DTYPE_FLOAT:
+        ((float*)dst)[0] = (float)in[0];
+        break;
+    default:
+        log_error("unsupported position dtype %d", dtype);
+        break;
+    }
+}
+
+
+
+// Read a position of any position dtype as a vec3 (missing components are set to 0).
+static inline void _pos_vec3(DvzDataType dtype, const void* src, vec3 out)
+{
+    if (dtype == DVZ_DTYPE_VEC3)
+    {
+        memcpy(out, src, sizeof(vec3));
+        return;
+    }
+    dvec3 pos = {0};
+    _pos_get(dtype, src, pos);
+    out[0] = (float)pos[0];
+    out[1] = (float)pos[1];
+    out[2] = (float)pos[2];
+}
+
+
+
+// Quantize a float in [-1, +1] to a 16-bit signed normalized integer.
+static inline int16_t _snorm16(float x)
+{
+    x = x < -1 ? -1 : (x > +1 ? +1 : x);
+    return (int16_t)lroundf(x * 32767.0f);
+}
+
+
+
+// Convert a float to a half-precision float (round to nearest, no denormals).
+static inline uint16_t _half(float x)
+{
+    uint32_t u = 0;
+    memcpy(&u, &x, sizeof(float));
+    uint16_t sign = (uint16_t)((u >> 16) & 0x8000);
+    int32_t exponent = (int32_t)((u >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = u & 0x007fffff;
+
+    if (((u >> 23) & 0xff) == 0xff) // inf or nan
+        return (uint16_t)(sign | 0x7c00 | (mantissa != 0 ? 0x0200 : 0));
+    if (exponent <= 0) // too small: flush to zero
+        return sign;
+    if (exponent >= 31) // too large: inf
+        return (uint16_t)(sign | 0x7c00);
+
+    // Round to nearest, a carry in the mantissa correctly increments the exponent.
+    uint32_t h = ((uint32_t)exponent << 10) | (mantissa >> 13);
+    if ((mantissa & 0x1fff) > 0x1000 || ((mantissa & 0x1fff) == 0x1000 && (h & 1)))
+        h++;
+    return (uint16_t)(sign | (h >= 0x7c00 ? 0x7c00 : h));
+}
+
+
+
+// Encode a unit vector with the octahedral mapping, as two 16-bit signed normalized integers.
+static inline void _oct16(const float* n, int16_t* out)
+{
+    float s = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+    if (s == 0)
+    {
+        out[0] = out[1] = 0;
+        return;
+    }
+    float x = n[0] / s, y = n[1] / s;
+    if (n[2] < 0)
+    {
+        // Fold the lower hemisphere over the diagonals.
+        float x0 = x;
+        x = (1 - fabsf(y)) * (x0 >= 0 ? +1 : -1);
+        y = (1 - fabsf(x0)) * (y >= 0 ? +1 : -1);
+    }
+    out[0] = _snorm16(x);
+    out[1] = _snorm16(y);
+}
+
+
+
 // Cast a vector.
 static inline void _cast(DvzDataType target_dtype, void* dst, DvzDataType source_dtype, void* src)
 {
@@ -713,6 +886,29 @@ static inline void _cast(DvzDataType target_dtype, void* dst, DvzDataType source
         ((vec3*)dst)[0][1] = ((dvec3*)src)[0][1];
         ((vec3*)dst)[0][2] = ((dvec3*)src)[0][2];
     }
+    else if (_is_pos_dtype(source_dtype) && target_dtype == DVZ_DTYPE_VEC3)
+    {
+        // 2D positions are padded with z=0.
+        _pos_vec3(source_dtype, src, (float*)dst);
+    }
+    else if (_is_pos_dtype(source_dtype) && target_dtype == DVZ_DTYPE_SNORM16_VEC4)
+    {
+        vec3 pos = {0};
+        _pos_vec3(source_dtype, src, pos);
+        ((int16_t*)dst)[0] = _snorm16(pos[0]);
+        ((int16_t*)dst)[1] = _snorm16(pos[1]);
+        ((int16_t*)dst)[2] = _snorm16(pos[2]);
+        ((int16_t*)dst)[3] = INT16_MAX;
+    }
+    else if (source_dtype == DVZ_DTYPE_VEC3 && target_dtype == DVZ_DTYPE_OCT16_VEC2)
+    {
+        _oct16((const float*)src, (int16_t*)dst);
+    }
+    else if (source_dtype == DVZ_DTYPE_VEC2 && target_dtype == DVZ_DTYPE_HALF_VEC2)
+    {
+        ((uint16_t*)dst)[0] = _half(((const float*)src)[0]);
+        ((uint16_t*)dst)[1] = _half(((const float*)src)[1]);
+    }
     else
         log_error("unknown casting dtypes %d %d", source_dtype, target_dtype);
 }
@@ -816,14 +1012,13 @@ static void dvz_array_column(
 static void dvz_array_print(DvzArray* array)
 {
     ASSERT(array != NULL);
-    dvec3* item = NULL;
+    dvec3 item = {0};
+    if (!_is_pos_dtype(array->dtype))
+        return;
     for (uint32_t i = 0; i < array->item_count; i++)
     {
-        item = (dvec3*)dvz_array_item(array, i);
-        if (array->dtype == DVZ_DTYPE_DVEC3)
-        {
-            log_info("%f %f %f", item[0][0], item[0][1], item[0][2]);
-        }
+        _pos_get(array->dtype, dvz_array_item(array, i), item);
+        log_info("%f %f %f", item[0], item[1], item[2]);
     }
 }
 
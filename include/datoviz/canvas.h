@@ -354,6 +354,11 @@ struct DvzViewport
     // Used to discard transform on one axis
     int32_t interact_axis;
 
+    // GPU data normalization, applied to the positions before the MVP transform: pos * scale +
+    // shift. Disabled when data_scale[3] is 0, which is the default.
+    vec4 data_scale;
+    vec4 data_shift;
+
     // TODO: aspect ratio
 };
 
@@ -102,6 +102,9 @@ END_INCL_NO_WARN
 
 #define DVZ_MAX_FRAMES_IN_FLIGHT    2
 #define DVZ_CONTAINER_DEFAULT_COUNT 64
+#define DVZ_MAX_THREADS             64
+#define DVZ_CACHE_DIR_ENVVAR        "DVZ_CACHE_DIR"
+#define DVZ_HASH_SEED               0xcbf29ce484222325ull
 
 
 /*************************************************************************************************/
@@ -242,8 +245,10 @@ typedef struct DvzObject DvzObject;
 typedef struct DvzContainer DvzContainer;
 typedef struct DvzContainerIterator DvzContainerIterator;
 typedef struct DvzThread DvzThread;
+typedef struct DvzMappedFile DvzMappedFile;
 
 typedef void* (*DvzThreadCallback)(void*);
+typedef void (*DvzParallelCallback)(uint32_t item_first, uint32_t item_count, void* user_data);
 
 
 
@@ -293,6 +298,15 @@ struct DvzThread
 
 
 
+// Read-only memory mapping of a whole file.
+struct DvzMappedFile
+{
+    void* data; // NULL if the file could not be mapped, the pages must not be written
+    uint64_t size;
+};
+
+
+
 struct DvzMVP
 {
     mat4 model;
@@ -660,6 +674,50 @@ DVZ_EXPORT char* dvz_read_npy(const char* filename, size_t* size);
  */
 DVZ_EXPORT uint8_t* dvz_read_ppm(const char* filename, int* width, int* height);
 
+/**
+ * Map a whole file in memory, read-only.
+ *
+ * The file contents are loaded lazily by the operating system, so that mapping a large file is
+ * immediate.
+ *
+ * @param filename path of the file to map
+ * @returns the mapped file, with a NULL data pointer if the file could not be mapped
+ */
+DVZ_EXPORT DvzMappedFile dvz_map_file(const char* filename);
+
+/**
+ * Unmap a file mapped with `dvz_map_file()`.
+ *
+ * @param file the mapped file
+ */
+DVZ_EXPORT void dvz_unmap_file(DvzMappedFile* file);
+
+/**
+ * Hash a buffer (64-bit FNV-1a variant), used for the keys of the disk caches.
+ *
+ * @param h the hash of the previous data, or `DVZ_HASH_SEED`
+ * @param data the buffer
+ * @param size the size of the buffer, in bytes
+ * @returns the hash
+ */
+DVZ_EXPORT uint64_t dvz_hash(uint64_t h, const void* data, size_t size);
+
+/**
+ * Return the path of a file in the disk cache.
+ *
+ * The default cache directory is given by the `DVZ_CACHE_DIR` environment variable, or is the
+ * temporary directory of the system. The disk cache is disabled if the variable is empty.
+ *
+ * @param cache_dir the cache directory, NULL for the default one
+ * @param name the kind of cached data, used in the file name
+ * @param key the cache key
+ * @param[out] path the path of the cache file
+ * @param size the size of the path buffer
+ * @returns false if the disk cache is disabled
+ */
+DVZ_EXPORT bool
+dvz_cache_path(const char* cache_dir, const char* name, uint64_t key, char* path, size_t size);
+
 // Defined in cmake-generated file build/_shaders.c
 DVZ_EXPORT unsigned char* dvz_resource_shader(const char* name, unsigned long* size);
 
@@ -682,7 +740,7 @@ DVZ_EXPORT unsigned char* dvz_resource_font(const char* name, unsigned long* siz
  *
  * @param callback the function that will run in a background thread
  * @param user_data a pointer to arbitrary user data
- * @returns thread object
+ * @returns thread object, not marked as created if the thread could not be started
  */
 DVZ_EXPORT DvzThread dvz_thread(DvzThreadCallback callback, void* user_data);
 
@@ -703,10 +761,37 @@ DVZ_EXPORT void dvz_thread_unlock(DvzThread* thread);
 /**
  * Destroy a thread after the thread function has finished running.
  *
+ * Threads that could not be started are ignored.
+ *
  * @param thread the thread
  */
 DVZ_EXPORT void dvz_thread_join(DvzThread* thread);
 
+/**
+ * Return the number of logical processors available.
+ *
+ * @returns the number of processors
+ */
+DVZ_EXPORT uint32_t dvz_num_procs(void);
+
+/**
+ * Process contiguous chunks of items in parallel, with at most one thread per processor.
+ *
+ * Callback function signature: `void(uint32_t item_first, uint32_t item_count, void*)`
+ *
+ * The function returns once all chunks have been processed. Small item counts are processed in
+ * the calling thread. There is no persistent thread pool: every call starts new threads, and
+ * joins them before returning. The chunks of the threads that cannot be started are processed
+ * in the calling thread.
+ *
+ * @param item_count the total number of items
+ * @param min_chunk the minimum number of items processed by each thread
+ * @param callback the function processing a chunk of items
+ * @param user_data a pointer to arbitrary user data passed to the callback
+ */
+DVZ_EXPORT void dvz_parallel(
+    uint32_t item_count, uint32_t min_chunk, DvzParallelCallback callback, void* user_data);
+
 
 
 /*************************************************************************************************/
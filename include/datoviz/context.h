@@ -66,6 +66,7 @@ typedef enum
 /*************************************************************************************************/
 
 typedef struct DvzFontAtlas DvzFontAtlas;
+typedef struct DvzGlyphAtlas DvzGlyphAtlas;
 typedef struct DvzColorTexture DvzColorTexture;
 
 
@@ -112,7 +113,8 @@ struct DvzContext
     DvzFifo transfers;
 
     // Font atlas.
-    DvzFontAtlas font_atlas;
+    DvzFontAtlas font_atlas;    // fixed monospace atlas, used for glyph indices
+    DvzGlyphAtlas* glyph_atlas; // dynamic atlas, used for text strings
     DvzColorTexture color_texture;
     DvzTexture* transfer_texture; // Default linear 1D texture
 };
@@ -179,6 +181,22 @@ DVZ_EXPORT void dvz_context_colormap(DvzContext* context);
 DVZ_EXPORT DvzBufferRegions dvz_ctx_buffers(
     DvzContext* context, DvzBufferType buffer_type, uint32_t buffer_count, VkDeviceSize size);
 
+/**
+ * Allocate one of several buffer regions on the GPU, with offsets that are multiples of a stride.
+ *
+ * The vertices of several visuals in the same vertex buffer can then be addressed by vertex index
+ * (draw batches, see DVZ_GRAPHICS_FLAGS_DRAW_BATCH).
+ *
+ * @param context the context
+ * @param buffer_type the type of buffer to allocate the regions on
+ * @param buffer_count the number of buffer regions to allocate
+ * @param size the size of each region to allocate, in bytes
+ * @param stride the stride of the items in the regions, in bytes
+ */
+DVZ_EXPORT DvzBufferRegions dvz_ctx_buffers_strided(
+    DvzContext* context, DvzBufferType buffer_type, uint32_t buffer_count, VkDeviceSize size,
+    VkDeviceSize stride);
+
 /**
  * Resize a set of buffer regions.
  *
@@ -199,7 +217,7 @@ dvz_ctx_buffers_resize(DvzContext* context, DvzBufferRegions* br, VkDeviceSize n
  * Create a new compute pipeline.
  *
  * @param context the context
- * @param shader_path path to the `.spirv` file containing the compute shader
+ * @param shader_path (optional) path to the `.spirv` file containing the compute shader
  */
 DVZ_EXPORT DvzCompute* dvz_ctx_compute(DvzContext* context, const char* shader_path);
 
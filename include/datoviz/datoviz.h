@@ -20,7 +20,9 @@ extern "C" {
 #include "gui.h"
 #include "interact.h"
 #include "mesh.h"
+#include "octree.h"
 #include "panel.h"
+#include "pslg.h"
 #include "scene.h"
 #include "transfers.h"
 #include "visuals.h"
@@ -72,7 +72,7 @@ struct VkViewport {
     float x, y, w, h, dmin, dmax;
 };
 
-layout (std140, binding = 1) uniform Viewport {
+struct Viewport {
     VkViewport viewport;    // Vulkan viewport
     vec4 margins;           // margins
 
@@ -85,7 +85,22 @@ layout (std140, binding = 1) uniform Viewport {
     // Options
     int clip;               // viewport clipping
     int interact_axis;
-} viewport;
+
+    // GPU data normalization, enabled if data_scale.w > 0
+    vec4 data_scale;
+    vec4 data_shift;
+};
+
+#ifdef DRAW_BATCH
+// The viewport of the current draw is read from the per-draw data of the draw batch.
+#include "draw_batch.glsl"
+#else
+layout (std140, binding = 1) uniform ViewportUniform {
+    Viewport viewport;
+};
+
+#define PASS_DRAW_INDEX
+#endif
 
 
 
@@ -103,8 +118,18 @@ vec4 to_vulkan(vec4 tr) {
 
 
 
+vec3 normalize_data(vec3 pos) {
+    // Positions relative to the visual origin, rescaled to NDC on the GPU.
+    if (viewport.data_scale.w > 0)
+        pos = pos * viewport.data_scale.xyz + viewport.data_shift.xyz;
+    return pos;
+}
+
+
+
 vec4 transform(vec3 pos, vec2 shift, uint transform_mode) {
     mat4 mvp = mvp.proj * mvp.view * mvp.model;
+    pos = normalize_data(pos);
     vec4 tr = vec4(pos, 1.0);
 
     // By default, take the viewport transform.
@@ -265,6 +290,16 @@ vec4 unpack_color(vec2 uv) {
 
 
 
+vec3 oct_decode(vec2 e) {
+    // Decode a unit vector encoded with the octahedral mapping (see _oct16() on the CPU).
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0 ? 1.0 : -1.0, n.y >= 0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
+
+
 ivec2 colormap_idx(int cmap, int value)
 {
     int row = 0, col = 0;
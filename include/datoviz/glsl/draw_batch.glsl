@@ -0,0 +1,38 @@
+/*************************************************************************************************/
+/*  Draw batches                                                                                 */
+/*************************************************************************************************/
+
+// The shaders of the graphics supporting draw batches (DVZ_GRAPHICS_FLAGS_DRAW_BATCH) are
+// compiled a second time with DRAW_BATCH defined, and DRAW_BATCH_VERTEX in the vertex shaders.
+// Successive visuals sharing the same graphics pipeline are then drawn with a single multi-draw
+// indirect command, and the viewport and params of each visual are read from a storage buffer
+// indexed by the draw index. The vertex shader must enable GL_ARB_shader_draw_parameters before
+// any declaration, and call PASS_DRAW_INDEX to pass the draw index to the fragment shader.
+
+#ifndef GLSL_DRAW_BATCH
+#define GLSL_DRAW_BATCH
+
+#define DRAW_INDEX_LOCATION 8
+
+// NOTE: must match DvzGraphicsBatchDraw.
+struct Draw {
+    Viewport viewport;
+    vec4 params[2];         // params of the visual, for example the marker edge color and width
+};
+
+layout (std430, binding = 1) readonly buffer Draws {
+    Draw draws[];
+};
+
+#ifdef DRAW_BATCH_VERTEX
+layout (location = DRAW_INDEX_LOCATION) flat out uint draw_index;
+#define DRAW_INDEX (uint(gl_DrawIDARB))
+#define PASS_DRAW_INDEX draw_index = DRAW_INDEX;
+#else
+layout (location = DRAW_INDEX_LOCATION) flat in uint draw_index;
+#define DRAW_INDEX draw_index
+#endif
+
+#define viewport (draws[DRAW_INDEX].viewport)
+
+#endif
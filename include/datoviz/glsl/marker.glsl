@@ -0,0 +1,25 @@
+// Marker fragment shader function, shared by the marker graphics with point sprites and with
+// instanced quads. The including shader must declare the MarkersParams uniform.
+
+#ifndef GLSL_MARKER
+#define GLSL_MARKER
+
+#include "antialias.glsl"
+#include "markers.glsl"
+
+
+// Compute the marker color at a given point coordinate, between (0, 0) and (1, 1).
+vec4 marker_fragment(vec2 point_coord, vec4 color, float size, float marker, float angle) {
+    vec4 frag_color;
+    vec2 P = point_coord - vec2(0.5, 0.5);
+    mat2 rot = mat2(cos(angle), sin(angle), -sin(angle), cos(angle));
+    P = rot * P;
+    float distance = select_marker(P * (size + 2 * params.edge_width + antialias), size, marker);
+    if (params.edge_width > 0)
+        frag_color = outline(distance, params.edge_width, params.edge_color, color);
+    else
+        frag_color = filled(distance, params.edge_width, color);
+    return frag_color;
+}
+
+#endif
@@ -0,0 +1,41 @@
+/*************************************************************************************************/
+/*  Scalar colors                                                                                */
+/*************************************************************************************************/
+
+// The vertex shaders including this file are compiled a second time with SCALAR_COLOR defined,
+// see DVZ_GRAPHICS_FLAGS_SCALAR_COLOR. The color attribute then holds one float per vertex (in
+// the red channel) which is mapped to the colormap texture. CMAP_BINDING must be defined before
+// including this file, it is the binding of the colormap params, followed by the colormap
+// texture.
+
+#ifndef GLSL_SCALAR_COLOR
+#define GLSL_SCALAR_COLOR
+
+#ifdef SCALAR_COLOR
+
+layout(std140, binding = CMAP_BINDING) uniform ColormapParams
+{
+    vec2 vrange;
+    int cmap;
+} cmap_params;
+
+layout(binding = (CMAP_BINDING + 1)) uniform sampler2D tex_cmap;
+
+vec4 scalar_color(vec4 color)
+{
+    float v0 = cmap_params.vrange.x;
+    float v1 = cmap_params.vrange.y;
+    float value = v0 != v1 ? (color.r - v0) / (v1 - v0) : 0;
+    // NOTE: the last column of the colormap texture is at 255/256.
+    return colormap_fetch(tex_cmap, cmap_params.cmap, clamp(value, 0, .999));
+}
+
+#define COLOR(c) scalar_color(c)
+
+#else
+
+#define COLOR(c) (c)
+
+#endif
+
+#endif
@@ -0,0 +1,68 @@
+// Segment vertex shader functions, shared by the segment graphics with vertex attributes and with
+// vertex pulling. The including shader must declare the out_* variables.
+
+#ifndef GLSL_SEGMENT
+#define GLSL_SEGMENT
+
+#include "constants.glsl"
+
+
+// Compute the position of one of the 4 vertices (index) of the segment quad.
+void segment_vertex(
+    int index, vec3 P0, vec3 P1, vec4 shift, vec4 color, float linewidth,
+    int cap0, int cap1, uint transform_mode)
+{
+    out_color = color;
+    out_linewidth = linewidth;
+
+    vec4 P0_ = transform(P0, shift.xy, transform_mode);
+    vec4 P1_ = transform(P1, shift.zw, transform_mode);
+
+    // Viewport coordinates.
+    mat4 ortho = get_ortho_matrix(viewport.size);
+    mat4 ortho_inv = inverse(ortho);
+
+    vec4 p0 = ortho_inv * P0_;
+    vec4 p1 = ortho_inv * P1_;
+
+    // NOTE: we need to normalize by the homogeneous coordinates after converting into pixels.
+    p0.xyz /= p0.w;
+    p1.xyz /= p1.w;
+
+    float z = p0.z;
+
+    vec2 position = p0.xy;
+    vec2 T = (p1 - p0).xy;
+    out_length = length(T);
+    float w = linewidth / 2.0 + 1.5 * antialias;
+    T = w * normalize(T);
+
+    if (index < 0.5) {
+       position = vec2(p0.x - T.y - T.x, p0.y + T.x - T.y);
+       out_texcoord = vec2(-w, +w);
+       z = p0.z;
+       out_cap = cap0;
+    }
+    else if (index < 1.5) {
+       position = vec2(p0.x + T.y - T.x, p0.y - T.x - T.y);
+       out_texcoord = vec2(-w, -w);
+       z = p0.z;
+       out_cap = cap0;
+    }
+    else if (index < 2.5) {
+       position = vec2(p1.x + T.y + T.x, p1.y - T.x + T.y);
+       out_texcoord = vec2(out_length + w, -w);
+       z = p1.z;
+       out_cap = cap1;
+    }
+    else {
+       position = vec2(p1.x - T.y + T.x, p1.y + T.x + T.y);
+       out_texcoord = vec2(out_length + w, +w);
+       z = p1.z;
+       out_cap = cap1;
+    }
+
+    gl_Position = ortho * vec4(position, z, 1.0);
+}
+
+#endif
@@ -0,0 +1,195 @@
+/*************************************************************************************************/
+/*  Dynamic glyph atlas with signed distance fields rasterized on demand                         */
+/*************************************************************************************************/
+
+#ifndef DVZ_GLYPHS_HEADER
+#define DVZ_GLYPHS_HEADER
+
+#include "array.h"
+#include "common.h"
+#include "context.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_GLYPH_MAX_FONTS        8
+#define DVZ_GLYPH_RASTER_SIZE      48   // line height of the rasterized glyphs, in texels
+#define DVZ_GLYPH_PADDING          4    // distance field margin around the glyphs, in texels
+#define DVZ_GLYPH_DIST_SCALE       64   // distance field value per texel (onedge value is 128)
+#define DVZ_GLYPH_ATLAS_WIDTH      1024 // width of the atlas texture
+#define DVZ_GLYPH_ATLAS_HEIGHT     256  // initial height of the atlas texture, doubled when full
+#define DVZ_GLYPH_ATLAS_MAX_HEIGHT 8192
+#define DVZ_GLYPH_TABLE_SIZE       1024 // initial size of the codepoint hash table
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzGlyph DvzGlyph;
+typedef struct DvzGlyphFont DvzGlyphFont;
+typedef struct DvzGlyphShelf DvzGlyphShelf;
+// NOTE: DvzGlyphAtlas is declared in context.h
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+// A rasterized glyph. The metrics are expressed in units of the line height of the font, so that
+// they only need to be multiplied by the font size in pixels.
+struct DvzGlyph
+{
+    uint32_t font;
+    uint32_t codepoint;
+    usvec4 rect;   // x, y, width, height in the atlas texture, in texels, empty for blank glyphs
+    vec2 offset;   // top left corner of the rectangle relative to the pen on the baseline, y down
+    vec2 size;     // size of the rectangle
+    float advance; // horizontal advance of the pen
+};
+
+
+
+struct DvzGlyphFont
+{
+    unsigned char* data; // copy of the TTF file
+    void* info;          // stb_truetype font info
+    float scale;         // scale from font units to texels
+    float ascent;        // distance from the top of the line to the baseline, in line heights
+};
+
+
+
+// Horizontal band of the atlas texture where glyphs of similar heights are packed left to right.
+struct DvzGlyphShelf
+{
+    uint32_t y, height;
+    uint32_t x;
+};
+
+
+
+struct DvzGlyphAtlas
+{
+    DvzObject obj;
+    DvzContext* ctx;
+
+    uint32_t font_count;
+    DvzGlyphFont fonts[DVZ_GLYPH_MAX_FONTS];
+
+    // Rasterized glyphs, and open addressing hash table from (font, codepoint) to glyph index.
+    DvzArray glyphs;
+    uint32_t table_size;  // power of two
+    uint64_t* table_keys; // 0 for empty slots
+    uint32_t* table_glyphs;
+
+    // Shelf packing in the atlas texture, a copy of which is kept in memory.
+    uint32_t width, height;
+    DvzArray shelves;
+    uint32_t shelf_y; // top of the free space below the last shelf
+    uint8_t* pixels;  // RGBA, the distance is repeated in the three color channels
+
+    // Rows of the texture modified since the last upload.
+    uint32_t dirty_first, dirty_count;
+
+    // Incremented every time the texture is resized, the visuals must then rebind it.
+    uint32_t generation;
+    DvzTexture* texture;
+};
+
+
+
+/*************************************************************************************************/
+/*  UTF-8                                                                                        */
+/*************************************************************************************************/
+
+/**
+ * Decode the next codepoint of a UTF-8 string.
+ *
+ * Invalid bytes are decoded as the replacement character U+FFFD.
+ *
+ * @param str a pointer to the string, moved to the next codepoint
+ * @returns the codepoint, 0 at the end of the string
+ */
+DVZ_EXPORT uint32_t dvz_utf8_next(const char** str);
+
+/**
+ * Count the codepoints of a UTF-8 string.
+ *
+ * @param str the string
+ * @returns the number of codepoints
+ */
+DVZ_EXPORT uint32_t dvz_utf8_count(const char* str);
+
+
+
+/*************************************************************************************************/
+/*  Glyph atlas                                                                                  */
+/*************************************************************************************************/
+
+/**
+ * Create a dynamic glyph atlas, with the default font.
+ *
+ * The glyphs are rasterized as signed distance fields the first time they are requested, and
+ * packed in a texture that grows when full.
+ *
+ * @param ctx the context
+ * @returns the glyph atlas
+ */
+DVZ_EXPORT DvzGlyphAtlas* dvz_glyph_atlas(DvzContext* ctx);
+
+/**
+ * Add a TrueType font to a glyph atlas.
+ *
+ * @param atlas the glyph atlas
+ * @param size the size of the TTF file buffer, in bytes
+ * @param ttf the TTF file buffer, which is copied
+ * @returns the font index, or -1 if the font could not be loaded
+ */
+DVZ_EXPORT int32_t
+dvz_glyph_atlas_font(DvzGlyphAtlas* atlas, unsigned long size, const unsigned char* ttf);
+
+/**
+ * Get a glyph, rasterizing it and packing it in the atlas if needed.
+ *
+ * The returned pointer is only valid until the next call, as new glyphs may be added.
+ *
+ * @param atlas the glyph atlas
+ * @param font the font index
+ * @param codepoint the Unicode codepoint
+ * @returns the glyph
+ */
+DVZ_EXPORT DvzGlyph* dvz_glyph_atlas_get(DvzGlyphAtlas* atlas, uint32_t font, uint32_t codepoint);
+
+/**
+ * Upload the glyphs added since the last upload to the atlas texture.
+ *
+ * Only the modified rows are uploaded, unless the texture has been resized.
+ *
+ * @param atlas the glyph atlas
+ */
+DVZ_EXPORT void dvz_glyph_atlas_upload(DvzGlyphAtlas* atlas);
+
+/**
+ * Destroy a glyph atlas.
+ *
+ * @param atlas the glyph atlas
+ */
+DVZ_EXPORT void dvz_glyph_atlas_destroy(DvzGlyphAtlas* atlas);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
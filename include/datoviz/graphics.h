@@ -92,18 +92,35 @@ typedef enum
 /*************************************************************************************************/
 
 typedef struct DvzVertex DvzVertex;
+typedef struct DvzGraphicsColormapParams DvzGraphicsColormapParams;
+typedef struct DvzGraphicsBatchDraw DvzGraphicsBatchDraw;
 
 typedef struct DvzGraphicsPointParams DvzGraphicsPointParams;
+typedef struct DvzGraphicsPointQuantizedVertex DvzGraphicsPointQuantizedVertex;
 
 typedef struct DvzGraphicsMarkerVertex DvzGraphicsMarkerVertex;
 typedef struct DvzGraphicsMarkerParams DvzGraphicsMarkerParams;
 
 typedef struct DvzGraphicsSegmentVertex DvzGraphicsSegmentVertex;
+typedef struct DvzGraphicsSegmentPullVertex DvzGraphicsSegmentPullVertex;
 
 typedef struct DvzGraphicsPathVertex DvzGraphicsPathVertex;
+typedef struct DvzGraphicsPathPullVertex DvzGraphicsPathPullVertex;
 typedef struct DvzGraphicsPathParams DvzGraphicsPathParams;
 // typedef struct DvzGraphicsPathItem DvzGraphicsPathItem;
 
+typedef struct DvzGraphicsStreamParams DvzGraphicsStreamParams;
+
+typedef struct DvzGraphicsDensityHeader DvzGraphicsDensityHeader;
+typedef struct DvzGraphicsDensityParams DvzGraphicsDensityParams;
+typedef struct DvzGraphicsHistogramHeader DvzGraphicsHistogramHeader;
+typedef struct DvzGraphicsHistogramParams DvzGraphicsHistogramParams;
+
+typedef struct DvzGraphicsAxesTick DvzGraphicsAxesTick;
+typedef struct DvzGraphicsAxesLabel DvzGraphicsAxesLabel;
+typedef struct DvzGraphicsAxesGlyph DvzGraphicsAxesGlyph;
+typedef struct DvzGraphicsAxesParams DvzGraphicsAxesParams;
+
 typedef struct DvzGraphicsImageItem DvzGraphicsImageItem;
 typedef struct DvzGraphicsImageVertex DvzGraphicsImageVertex;
 typedef struct DvzGraphicsImageParams DvzGraphicsImageParams;
@@ -118,6 +135,7 @@ typedef struct DvzGraphicsVolumeVertex DvzGraphicsVolumeVertex;
 typedef struct DvzGraphicsVolumeParams DvzGraphicsVolumeParams;
 
 typedef struct DvzGraphicsMeshVertex DvzGraphicsMeshVertex;
+typedef struct DvzGraphicsMeshQuantizedVertex DvzGraphicsMeshQuantizedVertex;
 typedef struct DvzGraphicsMeshParams DvzGraphicsMeshParams;
 
 typedef struct DvzGraphicsTextParams DvzGraphicsTextParams;
@@ -139,6 +157,24 @@ struct DvzVertex
 };
 
 
+// Scalar colors (DVZ_GRAPHICS_FLAGS_SCALAR_COLOR): the vertex shader maps the scalar value of
+// every vertex to a color of the colormap texture.
+struct DvzGraphicsColormapParams
+{
+    vec2 vrange; /* value range mapped to the colormap */
+    int cmap;    /* colormap number */
+};
+
+
+// Draw batches (DVZ_GRAPHICS_FLAGS_DRAW_BATCH): per-draw data, read by the shaders from a storage
+// buffer indexed by the draw index. Must match the Draw struct in draw_batch.glsl.
+struct DvzGraphicsBatchDraw
+{
+    DvzViewport viewport; /* viewport of the visual */
+    vec4 params[2];       /* params of the visual, for example the marker edge color and width */
+};
+
+
 
 struct DvzGraphicsData
 {
@@ -162,6 +198,13 @@ struct DvzGraphicsPointParams
     float point_size; /* point size, in pixels */
 };
 
+// Compressed vertex, positions are normalized to [-1, +1] and quantized to 16 bits.
+struct DvzGraphicsPointQuantizedVertex
+{
+    int16_t pos[4]; /* position, snorm16 (w is unused) */
+    cvec4 color;    /* color */
+};
+
 
 
 /*************************************************************************************************/
@@ -203,6 +246,20 @@ struct DvzGraphicsSegmentVertex
     uint8_t transform; /* transform enum */
 };
 
+// Vertex pulling: raw segment, stored once in the vertex buffer and read by the vertex shader.
+// NOTE: only 32-bit words, the layout is tightly packed (no vec4 alignment).
+struct DvzGraphicsSegmentPullVertex
+{
+    vec3 P0;           /* start position */
+    vec3 P1;           /* end position */
+    float shift[4];    /* shift of start (xy) and end (zw) positions, in pixels */
+    cvec4 color;       /* color */
+    float linewidth;   /* line width, in pixels */
+    uint8_t cap0;      /* start cap enum */
+    uint8_t cap1;      /* end cap enum */
+    uint8_t transform; /* transform enum */
+};
+
 
 
 /*************************************************************************************************/
@@ -218,6 +275,15 @@ struct DvzGraphicsPathVertex
     cvec4 color; /* point color */
 };
 
+// Vertex pulling: raw path point, the neighbors are fetched by the vertex shader.
+struct DvzGraphicsPathPullVertex
+{
+    vec3 pos;            /* position */
+    cvec4 color;         /* point color */
+    uint32_t path_first; /* index of the first point of the path */
+    int32_t path_size;   /* number of points in the path, negative if the path is closed */
+};
+
 struct DvzGraphicsPathParams
 {
     float linewidth;    /* line width in pixels */
@@ -228,6 +294,123 @@ struct DvzGraphicsPathParams
 
 
 
+/*************************************************************************************************/
+/*  Graphics stream                                                                              */
+/*************************************************************************************************/
+
+// The vertex buffer is a ring buffer of float samples, interleaved across channels: item #i is
+// the sample #(i / channel_count) of the channel #(i % channel_count).
+struct DvzGraphicsStreamParams
+{
+    uint32_t capacity;      /* capacity of the ring buffer, in items */
+    uint32_t head;          /* ring buffer item where the next item will be written */
+    uint32_t count;         /* number of valid items in the ring buffer */
+    uint32_t channel_count; /* number of interleaved channels */
+    cvec4 color;            /* line color */
+    float y_scale;          /* vertical scaling of the samples */
+};
+
+
+
+/*************************************************************************************************/
+/*  Graphics density                                                                             */
+/*************************************************************************************************/
+
+#define DVZ_DENSITY_WORKGROUP_SIZE 256   // local size of the binning compute shaders
+#define DVZ_DENSITY_MAX_GROUPS     65535 // larger tasks loop over the items in the shaders
+
+// The bins storage buffer starts with this header, followed by one uint32 count per bin. The
+// bins cover the panel viewport, with one bin per framebuffer pixel, row by row.
+struct DvzGraphicsDensityHeader
+{
+    uint32_t max_count;   /* maximum count over all bins, computed by the GPU */
+    uint32_t point_count; /* number of points */
+    uvec2 size;           /* number of bins along x and y */
+};
+
+struct DvzGraphicsDensityParams
+{
+    int32_t cmap; /* colormap of the logarithm of the counts */
+};
+
+
+
+/*************************************************************************************************/
+/*  Graphics histogram                                                                           */
+/*************************************************************************************************/
+
+#define DVZ_HISTOGRAM_MAX_BINS       65536 // capacity of the bins buffer
+#define DVZ_HISTOGRAM_LOCAL_BINS     4096  // smaller histograms are first binned in shared memory
+#define DVZ_HISTOGRAM_WORKGROUP_SIZE 256   // local size of the binning compute shaders
+#define DVZ_HISTOGRAM_MAX_GROUPS     1024  // each workgroup adds its local bins to the global ones
+
+// The bins storage buffer starts with this header, followed by one uint32 count per bin. The
+// draw command is written by the GPU, with 6 vertices per bin, so that the bars are drawn
+// indirectly from the bins buffer.
+struct DvzGraphicsHistogramHeader
+{
+    VkDrawIndirectCommand draw;
+    uint32_t max_count;    /* maximum count over all bins, computed by the GPU */
+    uint32_t sample_count; /* number of samples */
+    uint32_t _pad[2];
+};
+
+struct DvzGraphicsHistogramParams
+{
+    vec2 range;         /* range of the samples covered by the bins */
+    uint32_t bin_count; /* number of bins, at most DVZ_HISTOGRAM_MAX_BINS */
+    cvec4 color;        /* color of the bars */
+};
+
+
+
+/*************************************************************************************************/
+/*  Graphics axes                                                                                */
+/*************************************************************************************************/
+
+#define DVZ_AXES_TICK_SEGMENTS    7  // 4 minor ticks, the major tick, the grid line, the limit
+#define DVZ_AXES_LABEL_MAX_GLYPHS 24 // glyph quads expanded per tick label
+
+// The axes graphics only receive the major ticks, the tick marks, grid lines and label quads are
+// expanded in the vertex shaders, with 6 vertices per segment and per glyph.
+struct DvzGraphicsAxesTick
+{
+    float value;    /* tick position, in normalized coordinates */
+    uint32_t label; /* index of the glyph run of the tick label */
+};
+
+// Glyph run of a tick label in the glyphs buffer.
+struct DvzGraphicsAxesLabel
+{
+    uint32_t first; /* index of the first glyph */
+    uint32_t count; /* number of glyphs, at most DVZ_AXES_LABEL_MAX_GLYPHS */
+    vec2 size;      /* size of the string box, in line heights */
+};
+
+// Glyph of a tick label, laid out with the dynamic glyph atlas, see DvzGlyph.
+struct DvzGraphicsAxesGlyph
+{
+    usvec4 rect; /* glyph rectangle in the atlas texture, in texels */
+    vec2 offset; /* top left corner of the glyph within the string box, in line heights */
+    vec2 size;   /* glyph size, in line heights */
+};
+
+struct DvzGraphicsAxesParams
+{
+    cvec4 colors[4];     /* colors of the minor ticks, major ticks, grid and limit lines */
+    vec4 line_widths;    /* line widths of the four levels, in pixels */
+    vec2 tick_lengths;   /* lengths of the minor and major ticks, in pixels */
+    vec2 label_anchor;   /* anchor of the labels, relative to their string box */
+    vec2 label_shift;    /* shift of the labels, in pixels */
+    float font_size;     /* font size of the labels, in pixels */
+    int32_t coord;       /* 0 for the x axis, 1 for the y axis */
+    cvec4 label_color;   /* color of the labels */
+    uint32_t tick_count; /* number of major ticks */
+    uint32_t _pad[2];
+};
+
+
+
 /*************************************************************************************************/
 /*  Graphics text                                                                                */
 /*************************************************************************************************/
@@ -241,6 +424,9 @@ struct DvzGraphicsTextVertex
     vec2 anchor;       /* character anchor, in normalized coordinates */
     float angle;       /* string angle */
     usvec4 glyph;      /* glyph: char code, char index, string length, string index */
+    usvec4 glyph_rect; /* glyph rectangle in the atlas texture, in texels */
+    vec2 glyph_offset; /* top left corner of the glyph within the string box, in pixels */
+    vec2 string_size;  /* size of the string box, in pixels */
     uint8_t transform; /* transform enum */
 };
 
@@ -249,14 +435,15 @@ struct DvzGraphicsTextItem
     DvzGraphicsTextVertex vertex; /* text vertex */
     cvec4* glyph_colors;          /* glyph colors */
     float font_size;              /* font size */
-    const char* string;           /* text string */
+    const char* string;           /* UTF-8 text string, rendered with the glyph atlas */
     uint32_t strlen;              /* string size (only used if glyphs is set instead of string) */
-    const uint16_t* glyphs;       /* glyph indices within the font atlas */
+    const uint16_t* glyphs;       /* glyph indices within the fixed font atlas */
+    uint32_t font;                /* font index within the glyph atlas */
 };
 
 struct DvzGraphicsTextParams
 {
-    ivec2 grid_size; /* font atlas grid size (rows, columns) */
+    ivec2 grid_size; /* fixed font atlas grid size (rows, columns) */
     ivec2 tex_size;  /* font atlas texture size, in pixels */
 };
 
@@ -377,6 +564,15 @@ struct DvzGraphicsMeshVertex
     uint8_t alpha; /* transparency value */
 };
 
+// Compressed mesh vertex: quantized position, octahedral-encoded normal, half-float tex coords.
+struct DvzGraphicsMeshQuantizedVertex
+{
+    int16_t pos[4];    /* position, snorm16 (w is unused) */
+    int16_t normal[2]; /* octahedral-encoded normal vector, snorm16 */
+    uint16_t uv[2];    /* tex coords, half floats, negative v to use the color instead */
+    cvec4 color;       /* RGB color (when not using textures) and transparency value */
+};
+
 struct DvzGraphicsMeshParams
 {
     mat4 lights_pos_0;    /* positions of each of the maximum four lights */
@@ -14,6 +14,17 @@ extern "C" {
 
 
 
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_MESH_FILE_MAGIC     0x4d5a5644 // "DVZM"
+#define DVZ_MESH_FILE_VERSION   1
+#define DVZ_MESH_FILE_ALIGNMENT 64    // alignment of the blocks of the mesh files, in bytes
+#define DVZ_MESH_FILE_CHUNK     65536 // number of faces of the chunks with their own bounds
+
+
+
 /*************************************************************************************************/
 /*  Enums                                                                                     */
 /*************************************************************************************************/
@@ -34,11 +45,33 @@ typedef enum
 
 
 
+// Weights of the face normals in the vertex normals.
+typedef enum
+{
+    DVZ_MESH_NORMALS_UNIFORM, // same weight for all incident faces
+    DVZ_MESH_NORMALS_AREA,    // faces weighted by their area
+    DVZ_MESH_NORMALS_ANGLE,   // faces weighted by their angle at the vertex
+} DvzMeshNormalsWeight;
+
+
+
+// Mesh file flags.
+typedef enum
+{
+    DVZ_MESH_FILE_FLAGS_NONE = 0x0000,
+    DVZ_MESH_FILE_FLAGS_QUANTIZED = 0x0001, // DvzGraphicsMeshQuantizedVertex vertices
+} DvzMeshFileFlags;
+
+
+
 /*************************************************************************************************/
 /*  Typedefs                                                                                     */
 /*************************************************************************************************/
 
 typedef struct DvzMesh DvzMesh;
+typedef struct DvzMeshFileHeader DvzMeshFileHeader;
+typedef struct DvzMeshChunk DvzMeshChunk;
+typedef struct DvzMeshFile DvzMeshFile;
 
 
 
@@ -55,6 +88,49 @@ struct DvzMesh
 
 
 
+// Mesh file header. The header is followed by the vertices, the indices, and the bounds of the
+// chunks of faces, each block starting at a multiple of DVZ_MESH_FILE_ALIGNMENT bytes, so that
+// the blocks can be used in place once the file is mapped in memory.
+struct DvzMeshFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t vertex_size; // size of the vertex struct, depends on the quantization
+    uint64_t key;         // key of the source file, 0 if none
+    uint32_t vertex_count;
+    uint32_t index_count;
+    uint32_t chunk_count;
+    uint32_t chunk_size;    // number of faces of every chunk
+    uint64_t vertex_offset; // offsets of the blocks in the file, in bytes
+    uint64_t index_offset;
+    uint64_t chunk_offset;
+    uint64_t file_size;
+};
+
+
+
+// Bounding box of a chunk of consecutive faces.
+struct DvzMeshChunk
+{
+    vec3 box_min;
+    vec3 box_max;
+};
+
+
+
+// Mesh file mapped in memory, the pointers point to the mapped file.
+struct DvzMeshFile
+{
+    DvzMappedFile file;
+    const DvzMeshFileHeader* header; // NULL if the file could not be opened
+    const void* vertices;            // DvzGraphicsMeshVertex or DvzGraphicsMeshQuantizedVertex
+    const DvzIndex* indices;
+    const DvzMeshChunk* chunks;
+};
+
+
+
 /*************************************************************************************************/
 /*  Mesh transformation                                                                          */
 /*************************************************************************************************/
@@ -109,12 +185,42 @@ DVZ_EXPORT void dvz_mesh_transform(DvzMesh* mesh);
 /**
  * Compute the normals of a mesh from the vertices and faces, with cross-products.
  *
- * Useful when a mesh has no normal data, just vertex positions and face indices.
+ * Useful when a mesh has no normal data, just vertex positions and face indices. All incident
+ * faces have the same weight in the vertex normals.
  *
  * @param mesh the mesh
  */
 DVZ_EXPORT void dvz_mesh_normals(DvzMesh* mesh);
 
+/**
+ * Compute the normals of a mesh from the vertices and faces, with weighted face normals.
+ *
+ * @param mesh the mesh
+ * @param weight the weights of the face normals
+ */
+DVZ_EXPORT void dvz_mesh_normals_weighted(DvzMesh* mesh, DvzMeshNormalsWeight weight);
+
+/**
+ * Compute vertex normals from positions and triangular faces.
+ *
+ * The face normals are computed in parallel, then every vertex sums the normals of its incident
+ * faces (found with a face-to-vertex adjacency table), in parallel as well. The vertices that do
+ * not belong to any face keep their normal.
+ *
+ * @param vertex_count the number of vertices
+ * @param pos the vertex positions (3 floats per vertex)
+ * @param pos_stride the number of bytes between two positions, 0 for packed positions
+ * @param face_count the number of faces
+ * @param indices the vertex indices, 3 per face
+ * @param weight the weights of the face normals
+ * @param normals the output normals (3 floats per vertex)
+ * @param normal_stride the number of bytes between two normals, 0 for packed normals
+ */
+DVZ_EXPORT void dvz_normals(
+    uint32_t vertex_count, const float* pos, VkDeviceSize pos_stride, //
+    uint32_t face_count, const DvzIndex* indices, DvzMeshNormalsWeight weight, float* normals,
+    VkDeviceSize normal_stride);
+
 
 
 /*************************************************************************************************/
@@ -221,11 +327,78 @@ DVZ_EXPORT void dvz_mesh_destroy(DvzMesh* mesh);
 /**
  * Load an OBJ mesh.
  *
+ * The mesh is saved in a mesh file in the disk cache the first time, and later loads of the same
+ * OBJ file (same path, size and modification time) read the mesh file instead of parsing the OBJ
+ * file again. See `dvz_cache_path()` for the location of the disk cache.
+ *
  * @param file_path the path to the .obj file
  * @returns the mesh
  */
 DVZ_EXPORT DvzMesh dvz_mesh_obj(const char* file_path);
 
+/**
+ * Parse an OBJ file, without the disk cache.
+ *
+ * The file is parsed in parallel. Faces with more than 3 vertices are triangulated as fans. The
+ * normals are computed if the file does not specify them, and the mesh is normalized.
+ *
+ * @param file_path the path to the .obj file
+ * @returns the mesh, empty if the file could not be parsed
+ */
+DVZ_EXPORT DvzMesh dvz_mesh_obj_parse(const char* file_path);
+
+/**
+ * Open the mesh file of an OBJ file in the disk cache, creating it on the first import.
+ *
+ * The vertices and indices can be uploaded directly from the mapped file, for example with
+ * `dvz_visual_data_source()`. Quantized mesh files are meant for the mesh visual with the
+ * `DVZ_MESH_FLAGS_QUANTIZED` flag.
+ *
+ * @param file_path the path to the .obj file
+ * @param cache_dir the cache directory, NULL for the default one
+ * @param flags the mesh file flags
+ * @returns the mapped mesh file, with a NULL header if the disk cache is disabled or on error
+ */
+DVZ_EXPORT DvzMeshFile dvz_mesh_obj_file(const char* file_path, const char* cache_dir, int flags);
+
+/**
+ * Save a mesh to a mesh file.
+ *
+ * With `DVZ_MESH_FILE_FLAGS_QUANTIZED`, the positions must be normalized in [-1, +1], and the
+ * colors packed in the tex coords are moved to the color field of the quantized vertices.
+ *
+ * @param mesh the mesh
+ * @param file_path the path to the mesh file
+ * @param flags the mesh file flags
+ * @returns 0 on success
+ */
+DVZ_EXPORT int dvz_mesh_save(DvzMesh* mesh, const char* file_path, int flags);
+
+/**
+ * Map a mesh file in memory.
+ *
+ * The file is checked but not parsed: the blocks are used in place.
+ *
+ * @param file_path the path to the mesh file
+ * @returns the mapped mesh file, with a NULL header if the file is invalid
+ */
+DVZ_EXPORT DvzMeshFile dvz_mesh_file(const char* file_path);
+
+/**
+ * Copy a non-quantized mesh file into a new mesh.
+ *
+ * @param file the mapped mesh file
+ * @returns the mesh
+ */
+DVZ_EXPORT DvzMesh dvz_mesh_file_mesh(DvzMeshFile* file);
+
+/**
+ * Unmap a mesh file.
+ *
+ * @param file the mapped mesh file
+ */
+DVZ_EXPORT void dvz_mesh_file_close(DvzMeshFile* file);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,212 @@
+/*************************************************************************************************/
+/*  Out-of-core octree of 3D points, for level-of-detail rendering of massive point clouds       */
+/*************************************************************************************************/
+
+#ifndef DVZ_OCTREE_HEADER
+#define DVZ_OCTREE_HEADER
+
+#include "array.h"
+#include "common.h"
+#include "graphics.h"
+#include "transforms.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_OCTREE_MAGIC            0x4f5a5644 // "DVZO"
+#define DVZ_OCTREE_VERSION          1
+#define DVZ_OCTREE_DEFAULT_CAPACITY 16384
+#define DVZ_OCTREE_MAX_DEPTH        21
+#define DVZ_OCTREE_MAX_LOADS        8   // maximum number of nodes loaded from disk per frame
+#define DVZ_OCTREE_MIN_NODE_SIZE    128 // nodes smaller than this (in pixels) are not refined
+#define DVZ_OCTREE_NONE             UINT32_MAX
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzOctreeHeader DvzOctreeHeader;
+typedef struct DvzOctreeNode DvzOctreeNode;
+typedef struct DvzOctreeLoad DvzOctreeLoad;
+typedef struct DvzOctree DvzOctree;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+// File header. The file contains the header, the table of nodes, and the points of every node
+// stored contiguously as DvzVertex structures, in the order of the nodes.
+struct DvzOctreeHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t node_count;
+    uint32_t node_capacity; // maximum number of points per node
+    uint64_t point_count;
+    DvzBox box; // bounding cube of the points in data coordinates, mapped to [-1, +1]^3
+};
+
+
+
+// Every node contains a subsample of the points of its cube. The points of a node are not
+// repeated in its children, so that a node and its descendants make up the full resolution.
+struct DvzOctreeNode
+{
+    vec3 center;     // normalized coordinates
+    float half_size; // half size of the node cube, 1 for the root
+    uint32_t depth;
+    uint32_t point_count;
+    uint64_t offset;      // byte offset of the points in the file
+    uint32_t children[8]; // DVZ_OCTREE_NONE when the octant has no point
+};
+
+
+
+// A node read from disk that must be uploaded to the GPU in a given slot.
+struct DvzOctreeLoad
+{
+    uint32_t node;
+    uint32_t slot;
+    uint32_t point_count;
+    DvzVertex* vertices; // valid until the next frame
+};
+
+
+
+struct DvzOctree
+{
+    DvzObject obj;
+    FILE* file;
+    DvzOctreeHeader header;
+    DvzOctreeNode* nodes;
+
+    // Selection of the nodes to display, by decreasing projected size.
+    uint32_t selected_count;
+    uint32_t* selected;
+    float* heap_sizes; // max-heap used by the traversal
+    uint32_t* heap_nodes;
+
+    // Residency: the GPU vertex buffer is divided into slots of node_capacity points, each slot
+    // holding the points of one node. Slots are reassigned in least-recently-used order.
+    uint32_t slot_count;
+    uint32_t* node_slots;  // slot of each node, DVZ_OCTREE_NONE if not resident
+    uint32_t* slot_nodes;  // node of each slot, DVZ_OCTREE_NONE if free
+    uint64_t* slot_frames; // last frame where each slot was selected
+    uint64_t frame;
+
+    // Nodes loaded at the last update, the staging vertices are double-buffered as the uploads
+    // are processed at the next frame.
+    uint32_t load_count;
+    DvzOctreeLoad loads[DVZ_OCTREE_MAX_LOADS];
+    DvzArray staging;
+
+    // Indirect draw commands, one per slot, also double-buffered.
+    DvzArray draws;
+    bool draws_changed;
+};
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Build an octree from a set of 3D points and save it to disk.
+ *
+ * The nodes of each level are computed in parallel. All points must fit in memory.
+ *
+ * @param path the path to the octree file
+ * @param point_count the number of points
+ * @param pos the point positions
+ * @param color the point colors, or NULL for white points
+ * @param node_capacity the maximum number of points per node, 0 for the default
+ * @returns 0 on success, a non-zero value if the file could not be written
+ */
+DVZ_EXPORT int dvz_octree_build(
+    const char* path, uint32_t point_count, dvec3* pos, cvec4* color,
+    uint32_t node_capacity);
+
+/**
+ * Open an octree file.
+ *
+ * Only the header and the table of nodes are loaded in memory, the points are read on demand.
+ *
+ * @param path the path to the octree file
+ * @returns an octree, which is not created if the file could not be read
+ */
+DVZ_EXPORT DvzOctree dvz_octree_open(const char* path);
+
+/**
+ * Set the maximum number of points kept on the GPU.
+ *
+ * @param octree the octree
+ * @param point_budget the maximum number of points, rounded down to a multiple of the capacity
+ * @returns the number of slots, each slot holding the points of one node
+ */
+DVZ_EXPORT uint32_t dvz_octree_budget(DvzOctree* octree, uint64_t point_budget);
+
+/**
+ * Read the points of a node from disk.
+ *
+ * @param octree the octree
+ * @param node_idx the node index
+ * @param vertices the output buffer, with at least node_capacity vertices
+ * @returns the number of points read
+ */
+DVZ_EXPORT uint32_t dvz_octree_load(DvzOctree* octree, uint32_t node_idx, DvzVertex* vertices);
+
+/**
+ * Select the visible nodes, by decreasing projected size, within the point budget.
+ *
+ * @param octree the octree
+ * @param mvp the current model-view-projection matrices
+ * @param viewport_size the size of the viewport, in pixels
+ * @returns the number of selected nodes
+ */
+DVZ_EXPORT uint32_t dvz_octree_select(DvzOctree* octree, DvzMVP* mvp, vec2 viewport_size);
+
+/**
+ * Assign slots to the selected nodes, and read the nodes that are not resident yet.
+ *
+ * At most DVZ_OCTREE_MAX_LOADS nodes are read per call, the parent nodes are displayed until
+ * their children have been loaded. The indirect draw commands are updated.
+ *
+ * @param octree the octree
+ * @returns the number of nodes to upload, listed in `octree->loads`
+ */
+DVZ_EXPORT uint32_t dvz_octree_update(DvzOctree* octree);
+
+/**
+ * Return the current indirect draw commands, one per slot.
+ *
+ * @param octree the octree
+ * @returns a pointer to `slot_count` VkDrawIndirectCommand structures
+ */
+DVZ_EXPORT VkDrawIndirectCommand* dvz_octree_draws(DvzOctree* octree);
+
+/**
+ * Close an octree file.
+ *
+ * @param octree the octree
+ */
+DVZ_EXPORT void dvz_octree_destroy(DvzOctree* octree);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
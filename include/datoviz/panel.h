@@ -19,6 +19,7 @@
 #define DVZ_MAX_PANELS            1024
 #define DVZ_MAX_LINKS             16
 #define DVZ_MAX_VISUALS_PER_PANEL 64
+#define DVZ_MAX_DRAW_BATCHES      8
 
 // Group index of the set of panel DvzCommands objects.
 #define DVZ_COMMANDS_GROUP_PANELS 1
@@ -73,6 +74,24 @@ typedef struct DvzController DvzController;
 /*  Structs                                                                                      */
 /*************************************************************************************************/
 
+// Successive visuals of a panel sharing the same graphics pipeline, drawn with a single multi-draw
+// indirect command. The vertices of all visuals are in the same vertex buffer, and the per-draw
+// data (DvzGraphicsBatchDraw) is in a storage buffer indexed by the draw index.
+struct DvzDrawBatch
+{
+    DvzGraphics* graphics; // variant of the graphics pipeline with DVZ_GRAPHICS_FLAGS_DRAW_BATCH
+    bool indexed;
+    uint32_t draw_count;
+
+    // NOTE: the GPU objects are created once and reused by the batches occupying the same slot
+    // in the panel. The descriptor set layouts of all batch graphics are identical.
+    DvzBindings bindings;      // MVP and per-draw data
+    DvzBufferRegions draws;    // one DvzGraphicsBatchDraw struct per draw
+    DvzBufferRegions indirect; // one indirect draw command per draw
+};
+
+
+
 struct DvzPanel
 {
     DvzObject obj;
@@ -102,6 +121,10 @@ struct DvzPanel
     // GPU objects
     DvzBufferRegions br_mvp; // for the uniform buffer containing the MVP
 
+    // Draw batches, recomputed when the command buffers are filled.
+    uint32_t batch_count;
+    DvzDrawBatch batches[DVZ_MAX_DRAW_BATCHES];
+
     DvzController* controller;
     DvzCommands* cmds;
     int prority_max;
@@ -0,0 +1,128 @@
+/*************************************************************************************************/
+/*  Constrained Delaunay triangulation of planar straight-line graphs, with a disk cache         */
+/*************************************************************************************************/
+
+#ifndef DVZ_PSLG_HEADER
+#define DVZ_PSLG_HEADER
+
+#include "common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_PSLG_MAGIC            0x505a5644 // "DVZP"
+#define DVZ_PSLG_VERSION          1
+#define DVZ_PSLG_DEFAULT_ANGLE    20 // minimum angle of the triangles, in degrees
+#define DVZ_PSLG_MAX_ANGLE        33 // Triangle may not terminate with larger minimum angles
+#define DVZ_PSLG_CACHE_DIR_ENVVAR DVZ_CACHE_DIR_ENVVAR
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzPslgInput DvzPslgInput;
+typedef struct DvzPslgMesh DvzPslgMesh;
+typedef struct DvzPslgHeader DvzPslgHeader;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+// Independent planar straight-line graphs (PSLG), triangulated in parallel. The points and
+// segments of all PSLGs are concatenated.
+struct DvzPslgInput
+{
+    uint32_t pslg_count;
+    const uint32_t* point_counts;   // number of points of each PSLG
+    const uint32_t* segment_counts; // number of segments of each PSLG
+    const dvec2* points;
+    const uvec2* segments; // point indices, relative to the first point of the PSLG
+    uint32_t hole_count;
+    const dvec2* holes; // one point inside each hole, shared by all PSLGs
+    float min_angle;    // minimum angle of the triangles in degrees, 0 to disable the refinement
+};
+
+
+
+// The vertices of each PSLG are its points, in the same order, followed by the Steiner points
+// added by the refinement.
+struct DvzPslgMesh
+{
+    uint64_t key; // hash of the input, 0 if the mesh is empty
+    uint32_t pslg_count;
+    uint32_t* vertex_counts; // number of vertices of each PSLG
+    uint32_t vertex_count;
+    dvec2* vertices;
+    uint32_t index_count;
+    DvzIndex* indices; // 3 vertex indices per triangle, relative to the first vertex of the mesh
+};
+
+
+
+// Cache file header, followed by the vertex counts, the vertices, and the indices.
+struct DvzPslgHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t pslg_count;
+    uint32_t vertex_count;
+    uint32_t index_count;
+    uint32_t _pad;
+};
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Hash of the input of a triangulation, used as a cache key.
+ *
+ * @param input the PSLGs
+ * @returns a non-zero 64-bit hash
+ */
+DVZ_EXPORT uint64_t dvz_pslg_key(const DvzPslgInput* input);
+
+/**
+ * Triangulate planar straight-line graphs with the Triangle library.
+ *
+ * The PSLGs are triangulated in parallel, one PSLG per task. The result is cached on disk, in a
+ * file named after the hash of the input, so that the same input is not triangulated again in a
+ * later session.
+ *
+ * The default cache directory is given by the `DVZ_CACHE_DIR` environment variable, or is the
+ * temporary directory of the system. The disk cache is disabled if the variable is empty.
+ *
+ * @param input the PSLGs
+ * @param cache_dir the cache directory, NULL for the default one
+ * @returns the mesh, to be destroyed with `dvz_pslg_destroy()`
+ */
+DVZ_EXPORT DvzPslgMesh dvz_pslg_triangulate(const DvzPslgInput* input, const char* cache_dir);
+
+/**
+ * Destroy a PSLG mesh.
+ *
+ * @param mesh the mesh
+ */
+DVZ_EXPORT void dvz_pslg_destroy(DvzPslgMesh* mesh);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -52,6 +52,11 @@ typedef enum
     DVZ_VISUAL_FLAGS_TRANSFORM_NONE = 0x0010,
     DVZ_VISUAL_FLAGS_TRANSFORM_BOX_INIT = 0x0020, // do not recompute the panel box whenever
                                                   // the POS prop changes
+    DVZ_VISUAL_FLAGS_TRANSFORM_GPU = 0x0040, // upload raw positions once and apply the data
+                                             // normalization in the vertex shader
+    DVZ_VISUAL_FLAGS_LOD = 0x0080, // min/max decimation of line strips and paths depending on
+                                   // the panel width and zoom level
+    DVZ_VISUAL_FLAGS_CULL = 0x1000, // skip the chunks of items that are out of view
 } DvzVisualFlags;
 
 
@@ -113,6 +118,7 @@ struct DvzAxes2D
     DvzAxesTicks ticks[2];
     DvzBox box; // box, in data coordinates, corresponding to the box showed with initial panzoom
     float font_size;
+    DvzTicksWorker* worker; // computes the ticks in the background during panzoom
 };
 
 
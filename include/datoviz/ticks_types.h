@@ -6,6 +6,15 @@
 #define DVZ_TICKS_STRUCTS_HEADER
 
 #include "common.h"
+#include "fifo.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_TICKS_MEMO_SIZE 32
 
 
 
@@ -29,6 +38,9 @@ typedef enum
 
 typedef struct DvzAxesContext DvzAxesContext;
 typedef struct DvzAxesTicks DvzAxesTicks;
+typedef struct DvzTicksMemo DvzTicksMemo;
+typedef struct DvzTicksRequest DvzTicksRequest;
+typedef struct DvzTicksWorker DvzTicksWorker;
 typedef struct Q Q;
 
 
@@ -40,10 +52,11 @@ typedef struct Q Q;
 struct DvzAxesContext
 {
     DvzAxisCoord coord;
-    float size_viewport; // along the current dimension
-    float size_glyph;    // either width or height
-    float scale_orig;    // scale
-    uint32_t extensions; // number of extensions on each side (typically 1)
+    float size_viewport;   // along the current dimension
+    float size_glyph;      // either width or height
+    float scale_orig;      // scale
+    uint32_t extensions;   // number of extensions on each side (typically 1)
+    atomic(bool, *cancel); // if not NULL, the search is aborted as soon as it is true
 };
 
 
@@ -63,4 +76,41 @@ struct DvzAxesTicks
 
 
 
+// Ticks computed on a range quantized to a tenth of its order of magnitude.
+struct DvzTicksMemo
+{
+    DvzAxisCoord coord;
+    dvec2 range; // quantized range
+    float size_viewport;
+    float size_glyph;
+    uint64_t last_used; // used for the eviction of the least recently used entry, 0 if empty
+    DvzAxesTicks ticks; // owned by the memo entry
+};
+
+
+
+// Tick computation processed by the tick worker thread.
+struct DvzTicksRequest
+{
+    DvzAxesContext ctx;
+    DvzTicksMemo memo;       // key of the request, and the computed ticks when done
+    atomic(bool, cancelled); // set by the main thread when the result is no longer needed
+};
+
+
+
+// Background thread computing the ticks, so that the search does not stall the frames.
+struct DvzTicksWorker
+{
+    DvzThread thread;
+    DvzFifo requests;            // submitted requests, a NULL item stops the thread
+    DvzFifo results;             // processed requests, polled by the main thread
+    DvzTicksRequest* pending[2]; // request in flight on each axis, NULL if none
+
+    uint64_t clock; // incremented at every memo access
+    DvzTicksMemo memo[DVZ_TICKS_MEMO_SIZE];
+};
+
+
+
 #endif
@@ -196,9 +196,12 @@ MAKE_TRANSPOSE(vec3)
 /**
  * Apply a CPU builtin transformation on position data.
  *
+ * The input and output arrays may hold 1D, 2D or 3D positions in single or double precision, and
+ * their dtypes may differ. The computations are always done in double precision.
+ *
  * @param coords the data coordinate system and bounds
- * @param pos_in input array of dvec3 values
- * @param[out] pos_out output array of dvec3 values
+ * @param pos_in input array of positions
+ * @param[out] pos_out output array of positions, with the same number of items
  * @param inverse whether to use the inverse or forward transformation
  */
 DVZ_EXPORT void
@@ -75,6 +75,11 @@ typedef enum
     DVZ_VISUAL_AXES_3D,
     DVZ_VISUAL_COLORMAP,
 
+    // NOTE: new visual types are appended here to keep the values of the existing ones.
+    DVZ_VISUAL_STREAM,
+    DVZ_VISUAL_POINT_CLOUD,
+    DVZ_VISUAL_DENSITY,
+
     DVZ_VISUAL_COUNT,
 
     DVZ_VISUAL_CUSTOM,
@@ -98,12 +103,67 @@ typedef enum
 typedef enum
 {
     DVZ_AXES_FLAGS_DEFAULT = 0x0000,
+    DVZ_AXES_FLAGS_GPU = 0x0200, // ticks and labels expanded from the major ticks on the GPU
     DVZ_AXES_FLAGS_HIDE_MINOR = 0x0400,
     DVZ_AXES_FLAGS_HIDE_GRID = 0x0800,
 } DvzAxesFlags;
 
 
 
+// Point flags.
+typedef enum
+{
+    DVZ_POINT_FLAGS_DEFAULT = 0x0000,
+    DVZ_POINT_FLAGS_QUANTIZED = 0x0400, // 16-bit positions, must be normalized in [-1, +1]
+} DvzPointFlags;
+
+
+
+// Path flags.
+typedef enum
+{
+    DVZ_PATH_FLAGS_DEFAULT = 0x0000,
+    DVZ_PATH_FLAGS_VERTEX_PULLING = 0x0400, // raw points fetched in the vertex shader
+} DvzPathFlags;
+
+
+
+// Segment flags.
+typedef enum
+{
+    DVZ_SEGMENT_FLAGS_DEFAULT = 0x0000,
+    DVZ_SEGMENT_FLAGS_VERTEX_PULLING = 0x0400, // raw segments fetched in the vertex shader
+} DvzSegmentFlags;
+
+
+
+// Marker flags.
+typedef enum
+{
+    DVZ_MARKER_FLAGS_DEFAULT = 0x0000,
+    DVZ_MARKER_FLAGS_INSTANCED = 0x0400, // one instanced quad per marker instead of point sprites
+} DvzMarkerFlags;
+
+
+
+// Text flags.
+typedef enum
+{
+    DVZ_TEXT_FLAGS_DEFAULT = 0x0000,
+    DVZ_TEXT_FLAGS_INSTANCED = 0x0400, // one instanced quad per glyph
+} DvzTextFlags;
+
+
+
+// Mesh flags.
+typedef enum
+{
+    DVZ_MESH_FLAGS_DEFAULT = 0x0000,
+    DVZ_MESH_FLAGS_QUANTIZED = 0x0400, // 16-bit positions and normals, half-float tex coords
+} DvzMeshFlags;
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -165,6 +225,80 @@ static void _common_props(DvzVisual* visual)
     dvz_visual_prop_copy(prop, 0, 0, DVZ_ARRAY_COPY_SINGLE, 1);
 }
 
+// Declare the COLOR prop of a visual, with an optional default color.
+//
+// With DVZ_GRAPHICS_FLAGS_SCALAR_COLOR, the prop holds one float per item instead, which goes to
+// the VERTEX source #1 bound at the vertex binding 1 and which is mapped to the colormap by the
+// vertex shader (see _colormap_props()). With DVZ_GRAPHICS_FLAGS_SPLIT_COLOR, the colors go to
+// the VERTEX source #1, so that changing the colors only uploads 4 bytes per vertex. Otherwise,
+// they go to the VERTEX source #0 at the given offset.
+static DvzProp* _color_prop(
+    DvzVisual* visual, uint32_t field_idx, VkDeviceSize offset, //
+    DvzArrayCopyType copy_type, uint32_t reps, cvec4* color)
+{
+    ASSERT(visual != NULL);
+    DvzProp* prop = NULL;
+
+    if ((visual->flags & DVZ_GRAPHICS_FLAGS_SCALAR_COLOR) != 0)
+    {
+        dvz_visual_source(
+            visual, DVZ_SOURCE_TYPE_VERTEX, 1, DVZ_PIPELINE_GRAPHICS, 0, 1, sizeof(float), 0);
+        prop =
+            dvz_visual_prop(visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_FLOAT, DVZ_SOURCE_TYPE_VERTEX, 1);
+        dvz_visual_prop_copy(prop, 0, 0, copy_type, reps);
+        dvz_visual_prop_default(prop, (float[]){0});
+        return prop;
+    }
+
+    if ((visual->flags & DVZ_GRAPHICS_FLAGS_SPLIT_COLOR) != 0)
+    {
+        dvz_visual_source(
+            visual, DVZ_SOURCE_TYPE_VERTEX, 1, DVZ_PIPELINE_GRAPHICS, 0, 1, sizeof(cvec4), 0);
+        prop =
+            dvz_visual_prop(visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_CVEC4, DVZ_SOURCE_TYPE_VERTEX, 1);
+        dvz_visual_prop_copy(prop, 0, 0, copy_type, reps);
+    }
+    else
+    {
+        prop =
+            dvz_visual_prop(visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_CVEC4, DVZ_SOURCE_TYPE_VERTEX, 0);
+        dvz_visual_prop_copy(prop, field_idx, offset, copy_type, reps);
+    }
+    if (color != NULL)
+        dvz_visual_prop_default(prop, color);
+    return prop;
+}
+
+// Sources and props of the scalar colors (DVZ_GRAPHICS_FLAGS_SCALAR_COLOR): the colormap params
+// at the given binding, with the RANGE and COLORMAP props, and the colormap texture at the next
+// binding. Changing the colormap or its range only updates this small uniform buffer.
+static void _colormap_props(DvzVisual* visual, uint32_t binding)
+{
+    ASSERT(visual != NULL);
+    if ((visual->flags & DVZ_GRAPHICS_FLAGS_SCALAR_COLOR) == 0)
+        return;
+    DvzProp* prop = NULL;
+
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_PARAM, 1, DVZ_PIPELINE_GRAPHICS, 0, binding,
+        sizeof(DvzGraphicsColormapParams), 0);
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_COLOR_TEXTURE, 0, DVZ_PIPELINE_GRAPHICS, 0, binding + 1,
+        sizeof(uint8_t), 0);
+
+    // Range of the values mapped to the colormap.
+    prop = dvz_visual_prop(visual, DVZ_PROP_RANGE, 0, DVZ_DTYPE_VEC2, DVZ_SOURCE_TYPE_PARAM, 1);
+    dvz_visual_prop_copy(
+        prop, 0, offsetof(DvzGraphicsColormapParams, vrange), DVZ_ARRAY_COPY_SINGLE, 1);
+    dvz_visual_prop_default(prop, (vec2){0, 1});
+
+    // Colormap.
+    prop = dvz_visual_prop(visual, DVZ_PROP_COLORMAP, 0, DVZ_DTYPE_INT, DVZ_SOURCE_TYPE_PARAM, 1);
+    dvz_visual_prop_copy(
+        prop, 1, offsetof(DvzGraphicsColormapParams, cmap), DVZ_ARRAY_COPY_SINGLE, 1);
+    DvzColormap cmap = DVZ_CMAP_VIRIDIS;
+    dvz_visual_prop_default(prop, &cmap);
+}
 
 
 #endif
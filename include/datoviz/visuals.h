@@ -8,6 +8,7 @@
 #include "array.h"
 #include "context.h"
 #include "graphics.h"
+#include "pslg.h"
 #include "transforms.h"
 #include "vklite.h"
 
@@ -21,6 +22,10 @@
 #define DVZ_MAX_VISUAL_GROUPS       1024
 #define DVZ_MAX_VISUAL_PRIORITY     4
 #define DVZ_MAX_UNIFORM_SIZE        65536
+#define DVZ_MAX_LOD_LEVELS          32
+#define DVZ_CHUNK_SIZE              12288 // multiple of 2 and 3: chunks hold whole primitives
+#define DVZ_CULL_MARGIN             0.1   // relative margin around the view when culling chunks
+#define DVZ_AXES_MAX_LABELS         4096  // glyph runs kept by a GPU axes visual before a reset
 
 
 /*************************************************************************************************/
@@ -146,6 +151,7 @@ typedef enum
 typedef enum
 {
     DVZ_SOURCE_FLAG_MAPPABLE = 0x0001,
+    DVZ_SOURCE_FLAG_RING = 0x0002, // fixed-capacity ring buffer, see dvz_visual_ring()
 } DvzSourceFlags;
 
 
@@ -170,6 +176,15 @@ typedef enum
 
 typedef struct DvzVisual DvzVisual;
 typedef struct DvzProp DvzProp;
+typedef struct DvzLod DvzLod;
+typedef struct DvzChunks DvzChunks;
+typedef struct DvzDensity DvzDensity;
+typedef struct DvzHistogram DvzHistogram;
+typedef struct DvzTextRun DvzTextRun;
+typedef struct DvzTextCache DvzTextCache;
+typedef struct DvzAxesLabels DvzAxesLabels;
+typedef struct DvzOctree DvzOctree;
+typedef struct DvzDrawBatch DvzDrawBatch;
 
 typedef union DvzSourceUnion DvzSourceUnion;
 typedef struct DvzSource DvzSource;
@@ -233,10 +248,20 @@ struct DvzSource
     uint32_t source_idx;
     DvzSourceType source_type; // Type of the source (MVP, viewport, vertex buffer, etc.)
     DvzSourceKind source_kind; // Vertex, index, uniform, storage, or texture
-    uint32_t slot_idx;         // Binding slot, or 0 for vertex/index
+    uint32_t slot_idx;         // Binding slot, vertex binding for vertex, or 0 for index
     int flags;
     DvzArray arr; // array to be uploaded to that source
 
+    // Range of items of arr modified by the last bake, only this range is uploaded to the GPU.
+    // A count of 0 means that the whole array must be uploaded. With ring buffers, the range
+    // may wrap around the end of the array.
+    uint32_t dirty_first;
+    uint32_t dirty_count;
+
+    // Ring buffer state (DVZ_SOURCE_FLAG_RING), the capacity is the number of items in arr.
+    uint32_t ring_head;  // index of the item where the next item will be written
+    uint32_t ring_count; // number of valid items, the oldest one is at ring_head - ring_count
+
     DvzSourceOrigin origin; // whether the underlying GPU object is handled by the user or datoviz
     DvzSourceUnion u;
 };
@@ -267,6 +292,159 @@ struct DvzProp
     DvzDataType target_dtype; // used for casting during the copy to the vertex array
     DvzArrayCopyType copy_type;
     uint32_t reps; // number of repeats when copying
+
+    // Cached bounding box of a POS prop, covering the first box_count items of arr_orig. Appended
+    // items are merged incrementally, box_count is reset to 0 when existing items are overwritten.
+    DvzBox box;
+    uint32_t box_count;
+
+    // Range of items modified since the last bake, used to only copy and upload the modified
+    // vertices when the number of items does not change.
+    uint32_t dirty_first;
+    uint32_t dirty_count;
+};
+
+
+
+/*************************************************************************************************/
+/*  Level of detail                                                                              */
+/*************************************************************************************************/
+
+// Pyramid of min/max envelopes of the POS prop of a line strip or path. At level L >= 2, the
+// samples are grouped in bins of 2^L samples, and each bin is replaced by the two samples with
+// the minimum and maximum y values, in their original order.
+struct DvzLod
+{
+    bool valid;           // false when the POS prop has changed since the pyramid was built
+    bool staged;          // whether the props currently have decimated staging arrays
+    uint32_t item_count;  // number of samples in the POS prop
+    uint32_t level_count; // levels 2 to level_count - 1 are available
+    uint32_t level;       // current level, 0 means no decimation
+
+    // Indices of the selected samples at each level, 2 per bin.
+    DvzArray levels[DVZ_MAX_LOD_LEVELS];
+};
+
+
+
+/*************************************************************************************************/
+/*  Culling                                                                                      */
+/*************************************************************************************************/
+
+// Spatial chunks of the items of a visual, see DVZ_VISUAL_FLAGS_CULL. Every chunk covers
+// DVZ_CHUNK_SIZE consecutive items of the POS props and has its own indirect draw command, which
+// is emptied when the box of the chunk is out of view.
+struct DvzChunks
+{
+    bool active;                // whether the visual is currently drawn chunk by chunk
+    uint32_t item_count;        // number of POS items when the boxes were computed
+    uint32_t chunk_count;       // number of chunks
+    uint32_t vertices_per_item; // number of vertices of every POS item
+    uint32_t dirty_first;       // range of POS items modified since the boxes were computed
+    uint32_t dirty_count;
+    DvzArray boxes; // bounding box of every chunk, in data coordinates
+
+    // View at the last culling, the visibility of the chunks is only recomputed when it changes.
+    mat4 mvp;
+    DvzBox data_box;
+
+    uint32_t capacity; // number of indirect draw commands, may exceed the number of chunks
+    DvzArray draws;
+    DvzBufferRegions indirect;
+};
+
+
+
+/*************************************************************************************************/
+/*  Density                                                                                      */
+/*************************************************************************************************/
+
+// GPU binning of the points of a density visual. A first compute pipeline clears the bins, a
+// second one counts the points in each bin. Both are dispatched indirectly, and only run during
+// a few frames after the view or the data have changed.
+struct DvzDensity
+{
+    bool enabled;              // whether the visual is a density visual
+    bool ready;                // whether all buffers have been bound to the compute pipelines
+    bool changed;              // whether the points have changed since the last binning
+    uint32_t frames;           // number of remaining frames during which the bins are computed
+    uint64_t frame_idx;        // last frame where the number of remaining frames was updated
+    DvzBufferRegions bound[4]; // buffers bound to the compute pipelines
+
+    // View at the last binning.
+    mat4 mvp;
+    DvzViewport viewport;
+
+    DvzGraphicsDensityHeader header;
+    DvzBufferRegions bins;
+    VkDispatchIndirectCommand dispatch_cmds[2];
+    DvzBufferRegions dispatch;
+};
+
+
+
+/*************************************************************************************************/
+/*  Histogram                                                                                    */
+/*************************************************************************************************/
+
+// GPU binning of the samples of a histogram visual. The samples are uploaded once, the bins are
+// recomputed by two compute pipelines dispatched indirectly after a change of the samples, the
+// number of bins, or the range.
+struct DvzHistogram
+{
+    bool enabled;              // whether the visual is a histogram visual
+    bool ready;                // whether all buffers have been bound to the compute pipelines
+    bool changed;              // whether the samples have changed since the last binning
+    uint32_t frames;           // number of remaining frames during which the bins are computed
+    uint64_t frame_idx;        // last frame where the number of remaining frames was updated
+    DvzBufferRegions bound[3]; // buffers bound to the compute pipelines
+
+    uint32_t sample_count;
+    DvzGraphicsHistogramParams params; // params at the last binning
+    DvzBufferRegions bins;
+    VkDispatchIndirectCommand dispatch_cmds[2];
+    DvzBufferRegions dispatch;
+};
+
+
+
+/*************************************************************************************************/
+/*  Text layout cache                                                                            */
+/*************************************************************************************************/
+
+// Glyphs of a string of a text visual, laid out by the last bake.
+struct DvzTextRun
+{
+    uint64_t key;         // hash of the string or glyphs, font size, anchor and angle
+    vec3 pos;             // string position, patched without a new layout
+    cvec4 color;          // string color, patched without a new layout
+    uint32_t first;       // index of the first glyph in the vertex source
+    uint32_t glyph_count; // number of glyphs of the string
+};
+
+// Layout of the strings of a text visual at the last bake, with a hash map from the layout keys
+// to the glyph runs. The glyph vertices of the strings laid out at the last bake are reused from
+// the vertex source array, wherever they were, only the new or modified strings are laid out.
+struct DvzTextCache
+{
+    DvzArray runs;        // DvzTextRun, one per string
+    DvzArray slots;       // uint, open addressing hash map, 1-based run index or 0 if empty
+    uint32_t glyph_count; // total number of glyphs
+};
+
+
+
+/*************************************************************************************************/
+/*  Axes labels                                                                                  */
+/*************************************************************************************************/
+
+// Glyph runs of the tick labels of a GPU axes visual, see DVZ_AXES_FLAGS_GPU. The runs are only
+// appended to the labels and glyphs sources, so that the labels of ticks coming back into view
+// are neither laid out nor uploaded again.
+struct DvzAxesLabels
+{
+    DvzArray keys;        // uint64_t hash of the label string and font size, one per glyph run
+    uint32_t glyph_count; // total number of glyphs in the glyphs source
 };
 
 
@@ -299,6 +477,7 @@ struct DvzVisual
 
     // Fill callbacks.
     DvzVisualFillCallback callback_fill;
+    DvzVisualFillCallback callback_compute; // recorded before the render pass
 
     // Data callbacks.
     // DvzVisualDataCallback callback_transform;
@@ -319,9 +498,60 @@ struct DvzVisual
     DvzViewportClip clip[DVZ_MAX_GRAPHICS_PER_VISUAL];
     DvzViewport viewport; // usually the visual's panel viewport, but may be customized
 
+    // With GPU data normalization, the POS props are uploaded relative to this origin (the
+    // center of the visual box) to preserve precision in single-precision vertex attributes.
+    dvec3 data_origin;
+
+    // Cached bounding box of all POS props, invalidated whenever a POS prop changes.
+    DvzBox box;
+    bool box_valid;
+
+    // Level of detail of line strips and paths, see DVZ_VISUAL_FLAGS_LOD.
+    DvzLod lod;
+
+    // Spatial chunks skipped when out of view, see DVZ_VISUAL_FLAGS_CULL.
+    DvzChunks chunks;
+
+    // GPU binning of the points of a density visual.
+    DvzDensity density;
+
+    // GPU binning of the samples of a histogram visual.
+    DvzHistogram histogram;
+
+    // Generation of the glyph atlas texture bound to the text pipelines, see dvz_glyph_atlas().
+    uint32_t glyph_generation;
+
+    // Layout of the strings of a text visual at the last bake.
+    DvzTextCache text_cache;
+
+    // Glyph runs of the tick labels of a GPU axes visual.
+    DvzAxesLabels axes_labels;
+
+    // Hash of the POS and LENGTH props of a polygon visual at the last triangulation.
+    uint64_t polygon_key;
+
+    // Triangulation of a PSLG visual at the last bake.
+    DvzPslgMesh pslg;
+
+    // Out-of-core octree streamed by a point cloud visual, see dvz_visual_octree().
+    DvzOctree* octree;
+
     // GPU data
     DvzContainer bindings;
     DvzContainer bindings_comp;
+
+    // Indirect draw commands, one per graphics pipeline, or one per octree slot with point cloud
+    // visuals. Changes in the number of vertices or indices are uploaded to the GPU and do not
+    // require a command buffer refill.
+    DvzBufferRegions indirect;
+    VkDrawIndexedIndirectCommand indirect_cmds[DVZ_MAX_GRAPHICS_PER_VISUAL];
+
+    // Draw batch of the panel the visual is drawn in, if any, see DvzDrawBatch. The per-draw data
+    // and the draw command uploaded for the visual are kept to only upload them when they change.
+    DvzDrawBatch* batch;
+    uint32_t batch_idx; // draw index of the visual in the batch
+    DvzGraphicsBatchDraw batch_draw;
+    VkDrawIndexedIndirectCommand batch_cmd;
 };
 
 
@@ -337,6 +567,7 @@ struct DvzVisualFillEvent
     uint32_t cmd_idx;
     VkClearColorValue clear_color;
     DvzViewport viewport;
+    DvzGraphics* bound_graphics; // graphics pipeline already bound in the command buffer, if any
     void* user_data;
 };
 
@@ -504,6 +735,21 @@ DVZ_EXPORT void dvz_visual_compute(DvzVisual* visual, DvzCompute* compute);
  */
 DVZ_EXPORT void dvz_visual_group(DvzVisual* visual, uint32_t group_idx, uint32_t size);
 
+/**
+ * Change the data type of a position prop.
+ *
+ * Builtin visuals declare their positions as dvec3, but positions can also be passed as vec3,
+ * vec2 or dvec2 values, in which case they are transformed and copied to the GPU without any
+ * intermediate double-precision array. The existing prop data, if any, is converted.
+ *
+ * @param visual the visual
+ * @param prop_type the prop type
+ * @param prop_idx the prop index
+ * @param dtype the new data type: float, double, vec2, vec3, dvec2, or dvec3
+ */
+DVZ_EXPORT void dvz_visual_dtype(
+    DvzVisual* visual, DvzPropType prop_type, uint32_t prop_idx, DvzDataType dtype);
+
 /**
  * Set the data for a given visual prop.
  *
@@ -561,6 +807,49 @@ DVZ_EXPORT void dvz_visual_data_source(
     DvzVisual* visual, DvzSourceType source_type, uint32_t source_idx, //
     uint32_t first_item, uint32_t item_count, uint32_t data_item_count, const void* data);
 
+/**
+ * Turn a source into a fixed-capacity ring buffer.
+ *
+ * The source array and GPU buffer have a fixed size. New items are written at a moving head and
+ * overwrite the oldest ones once the ring buffer is full, so that streaming data uses constant
+ * memory and appending items only uploads the new items. The vertex shader is responsible for
+ * unwrapping the item indices using the head and count of the ring buffer.
+ *
+ * @param visual the visual
+ * @param source_type the source type
+ * @param source_idx the source index
+ * @param capacity the maximum number of items in the ring buffer
+ */
+DVZ_EXPORT void dvz_visual_ring(
+    DvzVisual* visual, DvzSourceType source_type, uint32_t source_idx, uint32_t capacity);
+
+/**
+ * Append items to a ring buffer source.
+ *
+ * @param visual the visual
+ * @param source_type the source type
+ * @param source_idx the source index
+ * @param item_count the number of items to append, only the last ones are kept if it exceeds
+ *      the capacity of the ring buffer
+ * @param data the data, that should be in the dtype of the source
+ */
+DVZ_EXPORT void dvz_visual_data_ring(
+    DvzVisual* visual, DvzSourceType source_type, uint32_t source_idx, //
+    uint32_t item_count, const void* data);
+
+/**
+ * Stream the points of an out-of-core octree to a point cloud visual.
+ *
+ * The vertex buffer is divided into slots holding the points of one octree node each. At every
+ * frame, the scene selects the nodes from the panel MVP, loads the missing nodes from disk, and
+ * updates the indirect draw commands. The octree must outlive the visual.
+ *
+ * @param visual the point cloud visual
+ * @param octree the octree, opened with dvz_octree_open()
+ * @param point_budget the maximum number of points kept on the GPU
+ */
+DVZ_EXPORT void dvz_visual_octree(DvzVisual* visual, DvzOctree* octree, uint64_t point_budget);
+
 /**
  * Set an existing GPU buffer for a visual source.
  *
@@ -616,6 +905,19 @@ DVZ_EXPORT uint32_t dvz_visual_item_count(DvzVisual* visual);
  */
 DVZ_EXPORT void dvz_visual_fill_callback(DvzVisual* visual, DvzVisualFillCallback callback);
 
+/**
+ * Set the visual compute callback function.
+ *
+ * This callback records compute commands in the command buffers, before the render pass begins,
+ * for example to prepare data used by the graphics pipelines of the visual.
+ *
+ * Callback function signature: `void(DvzVisual*, DvzVisualFillEvent)`
+ *
+ * @param visual the visual
+ * @param callback the compute callback
+ */
+DVZ_EXPORT void dvz_visual_compute_callback(DvzVisual* visual, DvzVisualFillCallback callback);
+
 /**
  * Call the visual fill callback.
  *
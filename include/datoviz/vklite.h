@@ -156,6 +156,9 @@ typedef enum
 {
     DVZ_GRAPHICS_FLAGS_DEPTH_TEST = 0x0100,
     DVZ_GRAPHICS_FLAGS_PICK = 0x0200,
+    DVZ_GRAPHICS_FLAGS_SPLIT_COLOR = 0x2000,  // vertex colors fetched from the vertex binding 1
+    DVZ_GRAPHICS_FLAGS_SCALAR_COLOR = 0x4000, // one float per vertex, colormapped on the GPU
+    DVZ_GRAPHICS_FLAGS_DRAW_BATCH = 0x8000,   // per-draw viewport and params in a storage buffer
 } DvzGraphicsFlags;
 
 
@@ -188,6 +191,31 @@ typedef enum
     DVZ_GRAPHICS_FAKE_SPHERE,
     DVZ_GRAPHICS_VOLUME,
 
+    // Vertex pulling variants.
+    DVZ_GRAPHICS_SEGMENT_PULL,
+    DVZ_GRAPHICS_PATH_PULL,
+
+    // Instanced variants.
+    DVZ_GRAPHICS_MARKER_INSTANCED,
+    DVZ_GRAPHICS_TEXT_INSTANCED,
+
+    // Compressed vertex format variants.
+    DVZ_GRAPHICS_POINT_QUANTIZED,
+    DVZ_GRAPHICS_MESH_QUANTIZED,
+
+    // Streaming time series stored in a ring buffer.
+    DVZ_GRAPHICS_STREAM,
+
+    // Density of points binned by a compute shader, colormapped in a fullscreen pass.
+    DVZ_GRAPHICS_DENSITY,
+
+    // Histogram bars pulled from a bins buffer computed by a compute shader.
+    DVZ_GRAPHICS_HISTOGRAM,
+
+    // Axes tick marks, grid lines and labels expanded from the major ticks in the vertex shaders.
+    DVZ_GRAPHICS_AXES_TICK,
+    DVZ_GRAPHICS_AXES_LABEL,
+
     DVZ_GRAPHICS_COUNT,
     DVZ_GRAPHICS_CUSTOM,
 } DvzGraphicsType;
@@ -349,6 +377,7 @@ struct DvzGpu
     VkDescriptorPool dset_pool;
 
     VkPhysicalDeviceFeatures requested_features;
+    bool draw_parameters; // whether VK_KHR_shader_draw_parameters is enabled (gl_DrawIDARB)
     VkDevice device;
 
     DvzContext* context;
@@ -543,6 +572,7 @@ struct DvzVertexBinding
 {
     uint32_t binding;
     VkDeviceSize stride;
+    VkVertexInputRate input_rate;
 };
 
 
@@ -586,6 +616,15 @@ struct DvzGraphics
     uint32_t vertex_attr_count;
     DvzVertexAttr vertex_attrs[DVZ_MAX_VERTEX_ATTRS];
 
+    // Vertex pulling: the vertex buffer is bound as a storage buffer at the pull slot, each item
+    // is expanded into several vertices in the vertex shader.
+    uint32_t pull_slot;
+    uint32_t vertices_per_item;
+
+    // Instancing: each item in the vertex buffer is an instance, drawn with a fixed number of
+    // vertices computed in the vertex shader from `gl_VertexIndex`.
+    uint32_t vertices_per_instance;
+
     uint32_t shader_count;
     VkShaderStageFlagBits shader_stages[DVZ_MAX_SHADERS_PER_GRAPHICS];
     VkShaderModule shader_modules[DVZ_MAX_SHADERS_PER_GRAPHICS];
@@ -1648,6 +1687,15 @@ DVZ_EXPORT void dvz_compute_create(DvzCompute* compute);
  */
 DVZ_EXPORT void dvz_compute_code(DvzCompute* compute, const char* code);
 
+/**
+ * Set the SPIR-V code of the compute shader directly, for shaders embedded in the library.
+ *
+ * @param compute the compute pipeline
+ * @param size the size of the SPIR-V code, in bytes
+ * @param buffer the SPIR-V code
+ */
+DVZ_EXPORT void dvz_compute_spirv(DvzCompute* compute, VkDeviceSize size, const uint32_t* buffer);
+
 /**
  * Declare a slot for the compute pipeline.
  *
@@ -1756,6 +1804,19 @@ dvz_graphics_shader(DvzGraphics* graphics, VkShaderStageFlagBits stage, const ch
 DVZ_EXPORT void
 dvz_graphics_vertex_binding(DvzGraphics* graphics, uint32_t binding, VkDeviceSize stride);
 
+/**
+ * Set the input rate of a vertex binding.
+ *
+ * With `VK_VERTEX_INPUT_RATE_INSTANCE`, the vertex attributes of that binding are fetched once per
+ * instance instead of once per vertex.
+ *
+ * @param graphics the graphics pipeline
+ * @param binding the binding index
+ * @param input_rate the input rate
+ */
+DVZ_EXPORT void dvz_graphics_vertex_input_rate(
+    DvzGraphics* graphics, uint32_t binding, VkVertexInputRate input_rate);
+
 /**
  * Add a vertex attribute.
  *
@@ -1838,6 +1899,31 @@ DVZ_EXPORT void dvz_graphics_create(DvzGraphics* graphics);
  */
 DVZ_EXPORT void dvz_graphics_slot(DvzGraphics* graphics, uint32_t idx, VkDescriptorType type);
 
+/**
+ * Enable vertex pulling in a graphics pipeline.
+ *
+ * The vertex buffer is bound as a storage buffer at the given slot, and the vertex shader fetches
+ * the items directly from it. Each item is expanded into a fixed number of vertices, computed in
+ * the vertex shader from `gl_VertexIndex`.
+ *
+ * @param graphics the graphics pipeline
+ * @param idx the slot index of the storage buffer
+ * @param vertices_per_item the number of vertices generated from each item
+ */
+DVZ_EXPORT void
+dvz_graphics_vertex_pulling(DvzGraphics* graphics, uint32_t idx, uint32_t vertices_per_item);
+
+/**
+ * Enable instanced rendering in a graphics pipeline.
+ *
+ * Each item in the vertex buffer is drawn as an instance with a fixed number of vertices. The
+ * vertex bindings should have the `VK_VERTEX_INPUT_RATE_INSTANCE` input rate.
+ *
+ * @param graphics the graphics pipeline
+ * @param vertices_per_instance the number of vertices of each instance
+ */
+DVZ_EXPORT void dvz_graphics_instancing(DvzGraphics* graphics, uint32_t vertices_per_instance);
+
 /**
  * Set a graphics pipeline push constant.
  *
@@ -2287,6 +2373,20 @@ DVZ_EXPORT void dvz_cmd_end_renderpass(DvzCommands* cmds, uint32_t idx);
  */
 DVZ_EXPORT void dvz_cmd_compute(DvzCommands* cmds, uint32_t idx, DvzCompute* compute, uvec3 size);
 
+/**
+ * Launch a compute task whose shape is read from a GPU buffer.
+ *
+ * The buffer contains a `VkDispatchIndirectCommand` struct, which may be modified without
+ * refilling the command buffers. A task with a zero shape does nothing.
+ *
+ * @param cmds the set of command buffers to record
+ * @param idx the index of the command buffer to record
+ * @param compute the computer pipeline
+ * @param indirect the buffer regions with the task shape
+ */
+DVZ_EXPORT void dvz_cmd_compute_indirect(
+    DvzCommands* cmds, uint32_t idx, DvzCompute* compute, DvzBufferRegions indirect);
+
 /**
  * Register a barrier.
  *
@@ -2368,16 +2468,34 @@ DVZ_EXPORT void dvz_cmd_bind_graphics(
     DvzCommands* cmds, uint32_t idx, DvzGraphics* graphics, //
     DvzBindings* bindings, uint32_t dynamic_idx);
 
+/**
+ * Bind the descriptor sets of a graphics pipeline that is already bound.
+ *
+ * This is used when successive draws share the same graphics pipeline but not the same bindings,
+ * to avoid redundant pipeline binds.
+ *
+ * @param cmds the set of command buffers to record
+ * @param idx the index of the command buffer to record
+ * @param graphics the graphics pipeline, already bound in the command buffer
+ * @param bindings the bindings associated to the pipeline
+ * @param dynamic_idx the dynamic uniform buffer index
+ */
+DVZ_EXPORT void dvz_cmd_bind_descriptors(
+    DvzCommands* cmds, uint32_t idx, DvzGraphics* graphics, //
+    DvzBindings* bindings, uint32_t dynamic_idx);
+
 /**
  * Bind a vertex buffer.
  *
  * @param cmds the set of command buffers to record
  * @param idx the index of the command buffer to record
+ * @param binding_idx the vertex binding index
  * @param br the buffer regions
  * @param offset the offset within the buffer regions, in bytes
  */
 DVZ_EXPORT void dvz_cmd_bind_vertex_buffer(
-    DvzCommands* cmds, uint32_t idx, DvzBufferRegions br, VkDeviceSize offset);
+    DvzCommands* cmds, uint32_t idx, uint32_t binding_idx, DvzBufferRegions br,
+    VkDeviceSize offset);
 
 /**
  * Bind an index buffer.
@@ -2401,6 +2519,20 @@ DVZ_EXPORT void dvz_cmd_bind_index_buffer(
 DVZ_EXPORT void
 dvz_cmd_draw(DvzCommands* cmds, uint32_t idx, uint32_t first_vertex, uint32_t vertex_count);
 
+/**
+ * Direct instanced draw.
+ *
+ * @param cmds the set of command buffers to record
+ * @param idx the index of the command buffer to record
+ * @param first_vertex index of the first vertex
+ * @param vertex_count number of vertices to draw in each instance
+ * @param first_instance index of the first instance
+ * @param instance_count number of instances to draw
+ */
+DVZ_EXPORT void dvz_cmd_draw_instanced(
+    DvzCommands* cmds, uint32_t idx, uint32_t first_vertex, uint32_t vertex_count,
+    uint32_t first_instance, uint32_t instance_count);
+
 /**
  * Direct indexed draw.
  *
@@ -2417,21 +2549,31 @@ DVZ_EXPORT void dvz_cmd_draw_indexed(
 /**
  * Indirect draw.
  *
+ * The buffer regions must contain `draw_count` contiguous `VkDrawIndirectCommand` structures.
+ * A single multi-draw command is recorded if the GPU supports it, otherwise one command per draw.
+ *
  * @param cmds the set of command buffers to record
  * @param idx the index of the command buffer to record
  * @param indirect buffer regions with the indirect draw info
+ * @param draw_count the number of draws
  */
-DVZ_EXPORT void dvz_cmd_draw_indirect(DvzCommands* cmds, uint32_t idx, DvzBufferRegions indirect);
+DVZ_EXPORT void dvz_cmd_draw_indirect(
+    DvzCommands* cmds, uint32_t idx, DvzBufferRegions indirect, uint32_t draw_count);
 
 /**
  * Indirect indexed draw.
  *
+ * The buffer regions must contain `draw_count` contiguous `VkDrawIndexedIndirectCommand`
+ * structures. A single multi-draw command is recorded if the GPU supports it, otherwise one
+ * command per draw.
+ *
  * @param cmds the set of command buffers to record
  * @param idx the index of the command buffer to record
  * @param indirect buffer regions with the indirect draw info
+ * @param draw_count the number of draws
  */
-DVZ_EXPORT void
-dvz_cmd_draw_indexed_indirect(DvzCommands* cmds, uint32_t idx, DvzBufferRegions indirect);
+DVZ_EXPORT void dvz_cmd_draw_indexed_indirect(
+    DvzCommands* cmds, uint32_t idx, DvzBufferRegions indirect, uint32_t draw_count);
 
 /**
  * Copy a GPU buffer to another.
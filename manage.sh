@@ -202,6 +202,11 @@ then
     ./build/datoviz demo $2
 fi
 
+if [ $1 == "bench" ]
+then
+    ./build/datoviz bench $2 $3
+fi
+
 
 
 # -------------------------------------------------------------------------------------------------
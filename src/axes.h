@@ -93,6 +93,7 @@ static void _axes_ticks(DvzController* controller, DvzAxisCoord coord, dvec2 ran
 
     DvzAxes2D* axes = &controller->u.axes_2D;
     ASSERT(axes != NULL);
+    ASSERT(axes->worker != NULL);
 
     DvzPanel* panel = controller->panel;
     ASSERT(panel != NULL);
@@ -105,12 +106,25 @@ static void _axes_ticks(DvzController* controller, DvzAxisCoord coord, dvec2 ran
     double vlen = vmax - vmin;
     ASSERT(vlen > 0);
 
+    // The ticks computed here supersede the ones being computed in the background.
+    dvz_ticks_cancel(axes->worker, coord);
+
     // Free the existing ticks.
     if (axes->ticks[coord].values != NULL)
         dvz_ticks_destroy(&axes->ticks[coord]);
 
-    // Determine the tick number and positions.
-    axes->ticks[coord] = dvz_ticks(vmin, vmax, ctx);
+    // Determine the tick number and positions, unless they have already been computed.
+    DvzTicksMemo key = _ticks_key(range, &ctx);
+    DvzAxesTicks* memo = dvz_ticks_memo_get(axes->worker, &key);
+    if (memo != NULL)
+    {
+        axes->ticks[coord] = _ticks_copy(memo);
+    }
+    else
+    {
+        axes->ticks[coord] = dvz_ticks(key.range[0], key.range[1], ctx);
+        dvz_ticks_memo_set(axes->worker, &key, &axes->ticks[coord]);
+    }
 
     // We keep track of the context.
     axes->ctx[coord] = ctx;
@@ -155,14 +169,6 @@ static void _axes_upload(DvzController* controller, DvzAxisCoord coord)
         // log_info("%d %f vmin=%f vmax=%f", i, ticks[i], vmin, vmax);
     }
 
-    // Minor ticks.
-    double* minor_ticks = (double*)calloc((N - 1) * 4, sizeof(double));
-    uint32_t k = 0;
-    for (uint32_t i = 0; i < N - 1; i++)
-        for (uint32_t j = 1; j <= 4; j++)
-            minor_ticks[k++] = ticks[i] + j * (ticks[i + 1] - ticks[i]) / 5.;
-    ASSERT(k == (N - 1) * 4);
-
     // Prepare text values.
     char** text = (char**)calloc(N, sizeof(char*));
     for (uint32_t i = 0; i < N; i++)
@@ -171,6 +177,25 @@ static void _axes_upload(DvzController* controller, DvzAxisCoord coord)
         // log_info("%f %s", ticks[i], text[i]);
     }
 
+    // GPU axes: the minor ticks, grid and limit lines are computed from the major ticks in the
+    // vertex shader.
+    if ((controller->flags & DVZ_AXES_FLAGS_GPU) != 0)
+    {
+        dvz_visual_data(visual, DVZ_PROP_POS, DVZ_AXES_LEVEL_MAJOR, N, ticks);
+        dvz_visual_data(visual, DVZ_PROP_TEXT, 0, N, text);
+        FREE(ticks);
+        FREE(text);
+        return;
+    }
+
+    // Minor ticks.
+    double* minor_ticks = (double*)calloc((N - 1) * 4, sizeof(double));
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < N - 1; i++)
+        for (uint32_t j = 1; j <= 4; j++)
+            minor_ticks[k++] = ticks[i] + j * (ticks[i + 1] - ticks[i]) / 5.;
+    ASSERT(k == (N - 1) * 4);
+
     // Set visual data.
     double lim[] = {-1};
     dvz_visual_data(visual, DVZ_PROP_POS, DVZ_AXES_LEVEL_MINOR, 4 * (N - 1), minor_ticks);
@@ -316,6 +341,78 @@ static bool _axes_collision(DvzController* controller, DvzAxisCoord coord, dvec2
 
 
 
+// Request new ticks during panzoom. Memoized ticks are displayed right away, otherwise they are
+// computed in the background and the current ticks remain displayed in the meantime.
+static void
+_axes_ticks_async(DvzController* controller, DvzAxisCoord coord, dvec2 range, bool force)
+{
+    ASSERT(controller != NULL);
+    ASSERT(controller->type == DVZ_CONTROLLER_AXES_2D);
+    DvzAxes2D* axes = &controller->u.axes_2D;
+    ASSERT(axes != NULL);
+    DvzTicksWorker* worker = axes->worker;
+    ASSERT(worker != NULL);
+
+    DvzAxesContext ctx = _axes_context(controller, coord);
+    if (ctx.size_viewport <= 0 || range[0] >= range[1])
+        return;
+
+    DvzTicksMemo key = _ticks_key(range, &ctx);
+    DvzAxesTicks* memo = dvz_ticks_memo_get(worker, &key);
+    if (memo != NULL)
+    {
+        dvz_ticks_cancel(worker, coord);
+        if (_ticks_equal(memo, &axes->ticks[coord]))
+            return;
+        dvz_ticks_destroy(&axes->ticks[coord]);
+        axes->ticks[coord] = _ticks_copy(memo);
+        axes->ctx[coord] = ctx;
+        _axes_upload(controller, coord);
+        return;
+    }
+
+    // Throttling: wait for the computation in flight, unless the viewport has changed.
+    if (dvz_ticks_pending(worker, coord) && !force)
+        return;
+    dvz_ticks_submit(worker, &key, ctx);
+}
+
+
+
+// Display the ticks computed in the background since the last frame.
+static bool _axes_poll(DvzController* controller)
+{
+    ASSERT(controller != NULL);
+    ASSERT(controller->type == DVZ_CONTROLLER_AXES_2D);
+    DvzAxes2D* axes = &controller->u.axes_2D;
+    ASSERT(axes != NULL);
+    ASSERT(axes->worker != NULL);
+
+    bool polled = false;
+    DvzTicksRequest* req = NULL;
+    DvzAxisCoord coord = DVZ_AXES_COORD_X;
+    while ((req = dvz_ticks_poll(axes->worker)) != NULL)
+    {
+        coord = req->ctx.coord;
+        if (req->memo.ticks.value_count > 0)
+        {
+            dvz_ticks_destroy(&axes->ticks[coord]);
+            axes->ticks[coord] = req->memo.ticks;
+            axes->ctx[coord] = req->ctx;
+            _axes_upload(controller, coord);
+            polled = true;
+        }
+        else
+        {
+            dvz_ticks_destroy(&req->memo.ticks);
+        }
+        FREE(req);
+    }
+    return polled;
+}
+
+
+
 // Callback called at every frame.
 static void _axes_refresh(DvzController* controller, bool force)
 {
@@ -331,7 +428,11 @@ static void _axes_refresh(DvzController* controller, bool force)
     DvzPanel* panel = controller->panel;
     ASSERT(panel != NULL);
 
-    if (!force && !controller->interacts[0].is_active && !canvas->resized)
+    // NOTE: the view may have changed while the new ticks were being computed, in which case they
+    // need to be checked again.
+    bool polled = _axes_poll(controller);
+
+    if (!force && !polled && !controller->interacts[0].is_active && !canvas->resized)
         return;
 
     // Check label collision
@@ -369,8 +470,8 @@ static void _axes_refresh(DvzController* controller, bool force)
     {
         if (!update[coord])
             continue;
-        _axes_ticks(controller, (DvzAxisCoord)coord, range[coord]);
-        _axes_upload(controller, (DvzAxisCoord)coord);
+        _axes_ticks_async(
+            controller, (DvzAxisCoord)coord, range[coord], canvas->resized || force);
 
         // TODO: what else to do here? update a request??
         // canvas->obj.status = DVZ_OBJECT_STATUS_NEED_UPDATE;
@@ -407,7 +508,6 @@ static void _axes_visual(DvzController* controller, DvzAxisCoord coord)
     ASSERT(panel->scene != NULL);
     DvzCanvas* canvas = panel->scene->canvas;
     ASSERT(canvas != NULL);
-    DvzContext* ctx = panel->grid->canvas->gpu->context;
 
     // Axes visual flags
     // 0x000X: coordinate (X=0/1)
@@ -435,16 +535,7 @@ static void _axes_visual(DvzController* controller, DvzAxisCoord coord)
         (coord == 0 ? DVZ_INTERACT_FIXED_AXIS_Y : DVZ_INTERACT_FIXED_AXIS_X) >> 12;
 
     // Text params.
-    DvzFontAtlas* atlas = &ctx->font_atlas;
-    ASSERT(strlen(atlas->font_str) > 0);
-    dvz_visual_texture(visual, DVZ_SOURCE_TYPE_FONT_ATLAS, 0, atlas->texture);
-
-    DvzGraphicsTextParams params = {0};
-    params.grid_size[0] = (int32_t)atlas->rows;
-    params.grid_size[1] = (int32_t)atlas->cols;
-    params.tex_size[0] = (int32_t)atlas->width;
-    params.tex_size[1] = (int32_t)atlas->height;
-    dvz_visual_data_source(visual, DVZ_SOURCE_TYPE_PARAM, 0, 0, 1, 1, &params);
+    _text_font_atlas(visual, false);
 
     if (!_is_white_background(canvas))
     {
@@ -474,6 +565,9 @@ static void _add_axes(DvzController* controller)
 
     dvz_panel_margins(panel, DVZ_DEFAULT_AXES_MARGINS);
 
+    // Thread computing the ticks during panzoom.
+    controller->u.axes_2D.worker = dvz_ticks_worker();
+
     for (uint32_t coord = 0; coord < 2; coord++)
         _axes_visual(controller, (DvzAxisCoord)coord);
 
@@ -491,6 +585,10 @@ static void _axes_destroy(DvzController* controller)
     DvzAxes2D* axes = &controller->u.axes_2D;
     ASSERT(axes != NULL);
 
+    if (axes->worker != NULL)
+        dvz_ticks_worker_destroy(axes->worker);
+    axes->worker = NULL;
+
     for (uint32_t i = 0; i < 2; i++)
     {
         dvz_ticks_destroy(&axes->ticks[i]);
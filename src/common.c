@@ -10,6 +10,12 @@
 
 #include "../include/datoviz/common.h"
 
+#if !OS_WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 BEGIN_INCL_NO_WARN
 #include <cglm/struct.h>
 END_INCL_NO_WARN
@@ -262,6 +268,114 @@ error:
 
 
 
+DvzMappedFile dvz_map_file(const char* filename)
+{
+    ASSERT(filename != NULL);
+    DvzMappedFile file = {0};
+
+#if OS_WIN32
+    HANDLE handle = CreateFileA(
+        filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE)
+        return file;
+    LARGE_INTEGER size = {0};
+    GetFileSizeEx(handle, &size);
+    HANDLE mapping =
+        size.QuadPart > 0 ? CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+    CloseHandle(handle);
+    if (mapping == NULL)
+        return file;
+    // The view keeps the mapping alive.
+    file.data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    file.size = file.data != NULL ? (uint64_t)size.QuadPart : 0;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return file;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            file.data = data;
+            file.size = (uint64_t)st.st_size;
+        }
+    }
+    // The mapping remains valid after closing the file descriptor.
+    close(fd);
+#endif
+
+    if (file.data == NULL)
+        log_error("could not map the file %s", filename);
+    return file;
+}
+
+
+
+void dvz_unmap_file(DvzMappedFile* file)
+{
+    ASSERT(file != NULL);
+    if (file->data == NULL)
+        return;
+#if OS_WIN32
+    UnmapViewOfFile(file->data);
+#else
+    munmap(file->data, (size_t)file->size);
+#endif
+    file->data = NULL;
+    file->size = 0;
+}
+
+
+
+// FNV-1a on 64-bit words, with an extra shift so that the high bits are mixed too.
+uint64_t dvz_hash(uint64_t h, const void* data, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint64_t w = 0;
+    size_t i = 0;
+    if (bytes != NULL)
+    {
+        for (i = 0; i + 8 <= size; i += 8)
+        {
+            memcpy(&w, bytes + i, 8);
+            h = (h ^ w) * 0x100000001b3ull;
+            h ^= h >> 32;
+        }
+        for (; i < size; i++)
+            h = (h ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return (h ^ size) * 0x100000001b3ull;
+}
+
+
+
+bool dvz_cache_path(const char* cache_dir, const char* name, uint64_t key, char* path, size_t size)
+{
+    ASSERT(name != NULL);
+    ASSERT(path != NULL);
+    if (cache_dir == NULL)
+        cache_dir = getenv(DVZ_CACHE_DIR_ENVVAR);
+    if (cache_dir == NULL)
+    {
+#if OS_WIN32
+        cache_dir = getenv("TEMP");
+#else
+        cache_dir = getenv("TMPDIR");
+        if (cache_dir == NULL)
+            cache_dir = "/tmp";
+#endif
+    }
+    if (cache_dir == NULL || cache_dir[0] == 0)
+        return false;
+    snprintf(path, size, "%s/dvz_%s_%016" PRIx64 ".bin", cache_dir, name, key);
+    return true;
+}
+
+
+
 /*************************************************************************************************/
 /*  Thread                                                                                       */
 /*************************************************************************************************/
@@ -270,7 +384,10 @@ DvzThread dvz_thread(DvzThreadCallback callback, void* user_data)
 {
     DvzThread thread = {0};
     if (pthread_create(&thread.thread, NULL, callback, user_data) != 0)
+    {
         log_error("thread creation failed");
+        return thread;
+    }
     if (pthread_mutex_init(&thread.lock, NULL) != 0)
         log_error("mutex creation failed");
     atomic_init(&thread.lock_idx, 0);
@@ -283,6 +400,8 @@ DvzThread dvz_thread(DvzThreadCallback callback, void* user_data)
 void dvz_thread_join(DvzThread* thread)
 {
     ASSERT(thread != NULL);
+    if (!dvz_obj_is_created(&thread->obj))
+        return;
     pthread_join(thread->thread, NULL);
     pthread_mutex_destroy(&thread->lock);
     dvz_obj_destroyed(&thread->obj);
@@ -329,6 +448,84 @@ void dvz_thread_unlock(DvzThread* thread)
 
 
 
+uint32_t dvz_num_procs(void)
+{
+#if OS_WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    long n = (long)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return n >= 1 ? (uint32_t)n : 1;
+}
+
+
+
+typedef struct
+{
+    DvzParallelCallback callback;
+    void* user_data;
+    uint32_t item_first;
+    uint32_t item_count;
+} DvzParallelChunk;
+
+static void* _parallel_chunk(void* user_data)
+{
+    DvzParallelChunk* chunk = (DvzParallelChunk*)user_data;
+    ASSERT(chunk != NULL);
+    chunk->callback(chunk->item_first, chunk->item_count, chunk->user_data);
+    return NULL;
+}
+
+void dvz_parallel(
+    uint32_t item_count, uint32_t min_chunk, DvzParallelCallback callback, void* user_data)
+{
+    ASSERT(callback != NULL);
+    if (item_count == 0)
+        return;
+    min_chunk = MAX(min_chunk, 1);
+
+    // Number of threads, depending on the number of processors and items.
+    uint32_t n_threads = MIN(dvz_num_procs(), DVZ_MAX_THREADS);
+    n_threads = MIN(n_threads, item_count / min_chunk);
+    if (n_threads <= 1)
+    {
+        callback(0, item_count, user_data);
+        return;
+    }
+    log_trace("processing %d items in %d threads", item_count, n_threads);
+
+    DvzParallelChunk chunks[DVZ_MAX_THREADS] = {0};
+    DvzThread threads[DVZ_MAX_THREADS] = {0};
+    uint32_t chunk_size = item_count / n_threads;
+    for (uint32_t i = 0; i < n_threads; i++)
+    {
+        chunks[i].callback = callback;
+        chunks[i].user_data = user_data;
+        chunks[i].item_first = i * chunk_size;
+        // The last chunk takes the remaining items.
+        chunks[i].item_count = i < n_threads - 1 ? chunk_size : item_count - i * chunk_size;
+    }
+
+    // The calling thread processes the first chunk, and the chunks of the threads that could not
+    // be started.
+    for (uint32_t i = 1; i < n_threads; i++)
+    {
+        threads[i] = dvz_thread(_parallel_chunk, &chunks[i]);
+        if (!dvz_obj_is_created(&threads[i].obj))
+            _parallel_chunk(&chunks[i]);
+    }
+    _parallel_chunk(&chunks[0]);
+    for (uint32_t i = 1; i < n_threads; i++)
+    {
+        if (dvz_obj_is_created(&threads[i].obj))
+            dvz_thread_join(&threads[i]);
+    }
+}
+
+
+
 /*************************************************************************************************/
 /*  Random                                                                                       */
 /*************************************************************************************************/
@@ -1,5 +1,6 @@
 #include "../include/datoviz/context.h"
 #include "../include/datoviz/atlas.h"
+#include "../include/datoviz/glyphs.h"
 #include "context_utils.h"
 #include "vklite_utils.h"
 #include <stdlib.h>
@@ -90,7 +91,9 @@ static void _context_default_buffers(DvzContext* context)
         ASSERT(buffer != NULL);
         dvz_buffer_type(buffer, DVZ_BUFFER_TYPE_STORAGE);
         dvz_buffer_size(buffer, DVZ_BUFFER_TYPE_STORAGE_SIZE);
-        dvz_buffer_usage(buffer, transferable | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        dvz_buffer_usage(
+            buffer,
+            transferable | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
         dvz_buffer_memory(buffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
         dvz_buffer_create(buffer);
         ASSERT(dvz_obj_is_created(&buffer->obj));
@@ -136,6 +139,7 @@ static void _context_default_resources(DvzContext* context)
 
     // Create the font atlas and assign it to the context.
     context->font_atlas = dvz_font_atlas(context);
+    context->glyph_atlas = dvz_glyph_atlas(context);
 
     // Color texture.
     context->color_texture.arr = _load_colormaps();
@@ -178,7 +182,12 @@ static void _destroy_resources(DvzContext* context)
 static void _gpu_default_features(DvzGpu* gpu)
 {
     ASSERT(gpu != NULL);
-    dvz_gpu_request_features(gpu, (VkPhysicalDeviceFeatures){.independentBlend = true});
+    // NOTE: multi-draw indirect is optional, indirect draws fall back to one command per draw.
+    dvz_gpu_request_features(
+        gpu, (VkPhysicalDeviceFeatures){
+                 .independentBlend = true,
+                 .multiDrawIndirect = gpu->device_features.multiDrawIndirect,
+             });
 }
 
 
@@ -287,6 +296,8 @@ void dvz_context_destroy(DvzContext* context)
 
     // Destroy the font atlas.
     dvz_font_atlas_destroy(&context->font_atlas);
+    dvz_glyph_atlas_destroy(context->glyph_atlas);
+    FREE(context->glyph_atlas);
 
     // Destroy the buffers, images, samplers, textures, computes.
     _destroy_resources(context);
@@ -327,8 +338,34 @@ void dvz_app_reset(DvzApp* app)
 /*  Buffer allocation                                                                            */
 /*************************************************************************************************/
 
+// Least common multiple of two alignments.
+static VkDeviceSize _lcm(VkDeviceSize a, VkDeviceSize b)
+{
+    ASSERT(a > 0);
+    ASSERT(b > 0);
+    VkDeviceSize x = a, y = b, t = 0;
+    while (y != 0)
+    {
+        t = x % y;
+        x = y;
+        y = t;
+    }
+    return a / x * b;
+}
+
+
+
 DvzBufferRegions dvz_ctx_buffers(
     DvzContext* context, DvzBufferType buffer_type, uint32_t buffer_count, VkDeviceSize size)
+{
+    return dvz_ctx_buffers_strided(context, buffer_type, buffer_count, size, 0);
+}
+
+
+
+DvzBufferRegions dvz_ctx_buffers_strided(
+    DvzContext* context, DvzBufferType buffer_type, uint32_t buffer_count, VkDeviceSize size,
+    VkDeviceSize stride)
 {
     ASSERT(context != NULL);
     ASSERT(context->gpu != NULL);
@@ -364,6 +401,19 @@ DvzBufferRegions dvz_ctx_buffers(
         alignment = context->gpu->device_properties.limits.minUniformBufferOffsetAlignment;
         ASSERT(offset % alignment == 0); // offset should be already aligned
     }
+    // Vertex and storage buffer regions may be bound as storage buffers in the shaders (vertex
+    // pulling), their offset needs to be aligned. The offset is aligned upwards if needed.
+    else if (buffer_type == DVZ_BUFFER_TYPE_VERTEX || buffer_type == DVZ_BUFFER_TYPE_STORAGE)
+    {
+        needs_align = true;
+        alignment = context->gpu->device_properties.limits.minStorageBufferOffsetAlignment;
+    }
+    // The offsets must also be multiples of the stride.
+    if (stride > 0)
+    {
+        alignment = alignment > 0 ? _lcm(alignment, stride) : stride;
+        needs_align = true;
+    }
 
     DvzBufferRegions regions = dvz_buffer_regions(buffer, buffer_count, offset, size, alignment);
     VkDeviceSize alsize = regions.aligned_size;
@@ -377,7 +427,7 @@ DvzBufferRegions dvz_ctx_buffers(
         return regions;
     }
 
-    // Check alignment for uniform buffers.
+    // Check alignment for uniform and storage buffers.
     if (needs_align)
     {
         ASSERT(alignment > 0);
@@ -386,6 +436,9 @@ DvzBufferRegions dvz_ctx_buffers(
             ASSERT(regions.offsets[i] % alignment == 0);
     }
 
+    // The offset may have been aligned upwards.
+    offset = regions.offsets[0];
+
     // Need to reallocate?
     if (offset + alsize * buffer_count > regions.buffer->size)
     {
@@ -398,7 +451,7 @@ DvzBufferRegions dvz_ctx_buffers(
         "allocating %d buffers (type %d) with size %s (aligned size %s)", //
         buffer_count, buffer_type, pretty_size(size), pretty_size(alsize));
     ASSERT(offset + alsize * buffer_count <= regions.buffer->size);
-    buffer->allocated_size += alsize * buffer_count;
+    buffer->allocated_size = offset + alsize * buffer_count;
 
     ASSERT(regions.offsets[buffer_count - 1] + alsize == buffer->allocated_size);
     return regions;
@@ -457,7 +510,6 @@ void dvz_ctx_buffers_resize(DvzContext* context, DvzBufferRegions* br, VkDeviceS
 DvzCompute* dvz_ctx_compute(DvzContext* context, const char* shader_path)
 {
     ASSERT(context != NULL);
-    ASSERT(shader_path != NULL);
 
     DvzCompute* compute = dvz_container_alloc(&context->computes);
     *compute = dvz_compute(context->gpu, shader_path);
@@ -0,0 +1,121 @@
+#version 450
+#include "common.glsl"
+
+// Glyph quads expanded per major tick, see DVZ_AXES_LABEL_MAX_GLYPHS.
+#define LABEL_MAX_GLYPHS 24u
+
+layout (std140, binding = USER_BINDING) uniform TextParams {
+    ivec2 grid_size;  // only used with the fixed font atlas
+    ivec2 tex_size;
+} text_params;
+
+// See DvzGraphicsAxesParams.
+layout (std140, binding = USER_BINDING + 2) uniform Params {
+    uvec4 colors;
+    vec4 line_widths;
+    vec2 tick_lengths;
+    vec2 label_anchor;
+    vec2 label_shift;
+    float font_size;
+    int coord;
+    uint label_color;
+    uint tick_count;
+} params;
+
+// See DvzGraphicsAxesLabel.
+struct Label {
+    uint first;
+    uint count;
+    vec2 size;
+};
+
+layout (std430, binding = USER_BINDING + 3) readonly buffer Labels {
+    Label data[];
+} labels;
+
+// See DvzGraphicsAxesGlyph, the 16-bit rectangle is read as two 32-bit words.
+struct Glyph {
+    uvec2 rect;
+    vec2 offset;
+    vec2 size;
+};
+
+layout (std430, binding = USER_BINDING + 4) readonly buffer Glyphs {
+    Glyph data[];
+} glyphs;
+
+// Major ticks, fetched from a storage buffer (vertex pulling), see DvzGraphicsAxesTick.
+struct Tick {
+    float value;
+    uint label;
+};
+
+layout (std430, binding = USER_BINDING + 5) readonly buffer Ticks {
+    Tick data[];
+} ticks;
+
+layout (location = 0) out vec4 out_color;
+layout (location = 1) out vec2 out_tex_coords;
+layout (location = 2) out vec2 out_glyph_size;
+layout (location = 3) out float out_str_index;
+
+// Two triangles per glyph, in the same vertex order as the triangle strip of the text graphics.
+const int corners[6] = int[6](0, 1, 2, 2, 1, 3);
+
+
+void main() {
+    uint tick = uint(gl_VertexIndex) / (6u * LABEL_MAX_GLYPHS);
+    uint j = (uint(gl_VertexIndex) / 6u) % LABEL_MAX_GLYPHS;
+
+    Label label = labels.data[ticks.data[tick].label];
+    if (tick >= params.tick_count || j >= label.count) {
+        // Degenerate triangles, clipped before rasterization.
+        gl_Position = vec4(2, 2, 2, 1);
+        out_color = vec4(0);
+        out_str_index = 0.5;
+        return;
+    }
+    Glyph glyph = glyphs.data[label.first + j];
+
+    // The label is anchored at the major tick on the axis.
+    float x = ticks.data[tick].value;
+    vec3 pos = params.coord == 0 ? vec3(x, -1, 0) : vec3(-1, x, 0);
+    vec4 pos_tr = transform(pos, params.label_shift, 0);
+
+    mat4 ortho = get_ortho_matrix(viewport.size);
+    mat4 ortho_inv = inverse(ortho);
+
+    // Glyph layout in pixels, see graphics_text.vert.
+    vec2 glyph_size = glyph.size * params.font_size;
+    vec2 glyph_offset = glyph.offset * params.font_size;
+    vec2 string_size = label.size * params.font_size;
+    float w = 2 * glyph_size.x;
+    float h = 2 * glyph_size.y;
+
+    int i = corners[gl_VertexIndex % 6];
+    float dx = int(i / 2.0);
+    float dy = mod(i, 2.0);
+
+    vec2 origin = string_size * (params.label_anchor - 1);
+    vec2 p = origin + 2 * glyph_offset;
+
+    gl_Position = ortho_inv * pos_tr;
+    gl_Position.xy += gl_Position.w * (p + vec2(dx * w, dy * h));
+    gl_Position = ortho * gl_Position;
+
+    // Little margin to avoid edge effects between glyphs.
+    float eps = .005;
+    dx = eps + (1.0 - 2 * eps) * dx;
+    dy = eps + (1.0 - 2 * eps) * dy;
+
+    vec4 rect = vec4(
+        glyph.rect.x & 0xFFFFu, glyph.rect.x >> 16, glyph.rect.y & 0xFFFFu, glyph.rect.y >> 16);
+    vec2 uv = rect.xy + vec2(dx, dy) * rect.zw;
+    out_tex_coords = uv / text_params.tex_size;
+
+    // String index, used to discard between different strings.
+    out_str_index = float(tick);
+
+    out_glyph_size = glyph_size;
+    out_color = unpackUnorm4x8(params.label_color);
+}
@@ -0,0 +1,91 @@
+#version 450
+#include "common.glsl"
+
+// Segments expanded per major tick, see DVZ_AXES_TICK_SEGMENTS.
+#define MINOR_COUNT 4u
+#define TICK_SEGMENTS 7u
+
+// See DvzGraphicsAxesParams.
+layout (std140, binding = USER_BINDING) uniform Params {
+    uvec4 colors;  // minor, major, grid, lim
+    vec4 line_widths;
+    vec2 tick_lengths;
+    vec2 label_anchor;
+    vec2 label_shift;
+    float font_size;
+    int coord;
+    uint label_color;
+    uint tick_count;
+} params;
+
+// Major ticks, fetched from a storage buffer (vertex pulling), see DvzGraphicsAxesTick.
+struct Tick {
+    float value;
+    uint label;
+};
+
+layout (std430, binding = USER_BINDING + 1) readonly buffer Ticks {
+    Tick data[];
+} ticks;
+
+layout (location = 0) out vec4  out_color;
+layout (location = 1) out vec2  out_texcoord;
+layout (location = 2) out float out_length;
+layout (location = 3) out float out_linewidth;
+layout (location = 4) out float out_cap;
+
+#include "segment.glsl"
+
+// Two triangles per segment, no index buffer.
+const int corners[6] = int[6](0, 1, 2, 0, 2, 3);
+
+
+void main (void)
+{
+    uint tick = uint(gl_VertexIndex) / (6u * TICK_SEGMENTS);
+    uint segment = (uint(gl_VertexIndex) / 6u) % TICK_SEGMENTS;
+
+    // The minor ticks between a major tick and the next one come first, then the major tick, the
+    // grid line, and the limit line which is only drawn once.
+    uint level = segment < MINOR_COUNT ? 0u : segment - MINOR_COUNT + 1u;
+    float x = ticks.data[tick].value;
+    bool visible = tick < params.tick_count;
+    if (level == 0u) {
+        visible = visible && tick + 1u < params.tick_count;
+        if (visible)
+            x += float(segment + 1u) * (ticks.data[tick + 1u].value - x) / float(MINOR_COUNT + 1u);
+    }
+    else if (level == 3u) {
+        visible = visible && tick == 0u;
+        x = -1;
+    }
+
+    vec4 color = unpackUnorm4x8(params.colors[level]);
+    if (!visible || color.a == 0) {
+        // Degenerate triangles, clipped before rasterization.
+        gl_Position = vec4(2, 2, 2, 1);
+        out_color = vec4(0);
+        return;
+    }
+
+    // The ticks go from the axis towards the labels, the grid and limit lines cross the viewport.
+    float lim = level <= 1u ? -1.0 : +1.0;
+    vec3 P0 = params.coord == 0 ? vec3(x, -1, 0) : vec3(-1, x, 0);
+    vec3 P1 = params.coord == 0 ? vec3(x, lim, 0) : vec3(lim, x, 0);
+
+    float linewidth = params.line_widths[level];
+    vec4 shift = vec4(0);
+    uint transform_mode = 0u;
+    if (level <= 1u)
+        shift[3 - params.coord] = params.tick_lengths[level];
+    else if (level == 3u) {
+        // Prevent half of the limit line to be cut off by viewport clipping.
+        shift[params.coord] += .5 * linewidth;
+        shift[params.coord + 2] += .5 * linewidth;
+        transform_mode = DVZ_INTERACT_FIXED_AXIS_ALL;
+    }
+
+    segment_vertex(
+        corners[gl_VertexIndex % 6], P0, P1, shift, color, linewidth,
+        CAP_NONE, CAP_NONE, transform_mode);
+}
@@ -1,12 +1,19 @@
 #version 450
+#ifdef DRAW_BATCH_VERTEX
+#extension GL_ARB_shader_draw_parameters : require
+#endif
 #include "common.glsl"
 
+#define CMAP_BINDING USER_BINDING
+#include "scalar_color.glsl"
+
 layout (location = 0) in vec3 pos;
 layout (location = 1) in vec4 color;
 
 layout (location = 0) out vec4 out_color;
 
 void main() {
+    PASS_DRAW_INDEX
     gl_Position = transform(pos);
-    out_color = color;
+    out_color = COLOR(color);
 }
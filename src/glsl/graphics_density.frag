@@ -0,0 +1,38 @@
+#version 450
+#include "common.glsl"
+
+layout(std140, binding = USER_BINDING) uniform Params
+{
+    int cmap;
+} params;
+
+layout(binding = (USER_BINDING + 1)) uniform sampler2D tex_cmap; // colormap texture
+
+// See DvzGraphicsDensityHeader.
+layout(std430, binding = (USER_BINDING + 2)) readonly buffer Bins
+{
+    uint max_count;
+    uint point_count;
+    uvec2 size;
+    uint counts[];
+} bins;
+
+layout(location = 0) out vec4 out_color;
+
+void main()
+{
+    CLIP
+
+    // One bin per framebuffer pixel of the viewport.
+    uvec2 ij = uvec2(gl_FragCoord.xy - viewport.offset);
+    if (ij.x >= bins.size.x || ij.y >= bins.size.y)
+        discard;
+    uint count = bins.counts[ij.y * bins.size.x + ij.x];
+    if (count == 0)
+        discard;
+
+    // Logarithmic scaling of the counts.
+    float value = log(1.0 + count) / log(1.0 + max(bins.max_count, 1));
+    out_color = texture(tex_cmap, vec2(value, (params.cmap + .5) / 256.0));
+    out_color.a = 1;
+}
@@ -0,0 +1,7 @@
+#version 450
+
+// A single triangle covering the whole viewport.
+void main() {
+    vec2 uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(2 * uv - 1, 0, 1);
+}
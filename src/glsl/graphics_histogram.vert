@@ -0,0 +1,37 @@
+#version 450
+#include "common.glsl"
+
+// See DvzGraphicsHistogramParams.
+layout (std140, binding = USER_BINDING) uniform Params {
+    vec2 range;
+    uint bin_count;
+    uint color;
+} params;
+
+// See DvzGraphicsHistogramHeader.
+layout (std430, binding = USER_BINDING + 1) readonly buffer Bins {
+    uvec4 draw;
+    uint max_count;
+    uint sample_count;
+    uvec2 _pad;
+    uint counts[];
+} bins;
+
+layout (location = 0) out vec4 out_color;
+
+// Two triangles per bar, no vertex buffer.
+const vec2 corners[6] = vec2[6](
+    vec2(0, 0), vec2(1, 0), vec2(1, 1), vec2(0, 0), vec2(1, 1), vec2(0, 1));
+
+void main() {
+    // The number of bins used by the last binning, the params may have changed since then.
+    uint bin_count = max(bins.draw.x / 6, 1);
+    uint bin = uint(gl_VertexIndex / 6);
+    vec2 corner = corners[gl_VertexIndex % 6];
+
+    // The bars cover [-1, +1]^2, the highest bar reaching the top.
+    float height = float(bins.counts[bin]) / float(max(bins.max_count, 1));
+    vec2 pos = vec2((bin + corner.x) / float(bin_count), corner.y * height);
+    gl_Position = transform(vec3(2 * pos - 1, 0));
+    out_color = unpackUnorm4x8(params.color);
+}
@@ -1,12 +1,21 @@
 #version 450
-#include "antialias.glsl"
-#include "markers.glsl"
 #include "common.glsl"
 
+#ifdef DRAW_BATCH
+// In a draw batch, the marker params are part of the per-draw data.
+struct MarkersParams {
+    vec4 edge_color;
+    float edge_width;
+};
+#define params (MarkersParams(draws[DRAW_INDEX].params[0], draws[DRAW_INDEX].params[1].x))
+#else
 layout (binding = USER_BINDING) uniform MarkersParams {
     vec4 edge_color;
     float edge_width;
 } params;
+#endif
+
+#include "marker.glsl"
 
 layout(location = 0) in vec4 color;
 layout(location = 1) in float size;
@@ -19,14 +28,7 @@ layout(location = 0) out vec4 out_color;
 void main() {
     CLIP
 
-    vec2 P = gl_PointCoord.xy - vec2(0.5, 0.5);
-    mat2 rot = mat2(cos(angle), sin(angle), -sin(angle), cos(angle));
-    P = rot * P;
-    float distance = select_marker(P * (size + 2 * params.edge_width + antialias), size, marker);
-    if (params.edge_width > 0)
-        out_color = outline(distance, params.edge_width, params.edge_color, color);
-    else
-        out_color = filled(distance, params.edge_width, color);
+    out_color = marker_fragment(gl_PointCoord.xy, color, size, marker, angle);
     if (out_color.a < .05)
         discard;
 }
@@ -1,7 +1,13 @@
 #version 450
+#ifdef DRAW_BATCH_VERTEX
+#extension GL_ARB_shader_draw_parameters : require
+#endif
 #include "constants.glsl"
 #include "common.glsl"
 
+#define CMAP_BINDING (USER_BINDING + 1)
+#include "scalar_color.glsl"
+
 layout (location = 0) in vec3 pos;
 layout (location = 1) in vec4 color;
 layout (location = 2) in float size;
@@ -15,10 +21,11 @@ layout (location = 2) out float out_marker;
 layout (location = 3) out float out_angle;
 
 void main() {
+    PASS_DRAW_INDEX
     gl_Position = transform(pos, transform_mode);
     gl_PointSize = size;
 
-    out_color = color;
+    out_color = COLOR(color);
     out_size = size;
     out_marker = marker;
     out_angle = angle * M_2PI;
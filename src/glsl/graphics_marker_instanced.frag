@@ -0,0 +1,26 @@
+#version 450
+#include "common.glsl"
+
+layout (binding = USER_BINDING) uniform MarkersParams {
+    vec4 edge_color;
+    float edge_width;
+} params;
+
+#include "marker.glsl"
+
+layout(location = 0) in vec4 color;
+layout(location = 1) in float size;
+layout(location = 2) in float marker;
+layout(location = 3) in float angle;
+layout(location = 4) in vec2 point_coord;
+
+layout(location = 0) out vec4 out_color;
+
+
+void main() {
+    CLIP
+
+    out_color = marker_fragment(point_coord, color, size, marker, angle);
+    if (out_color.a < .05)
+        discard;
+}
@@ -0,0 +1,38 @@
+#version 450
+#include "constants.glsl"
+#include "common.glsl"
+
+#define CMAP_BINDING (USER_BINDING + 1)
+#include "scalar_color.glsl"
+
+// Per-instance attributes, one instance per marker.
+layout (location = 0) in vec3 pos;
+layout (location = 1) in vec4 color;
+layout (location = 2) in float size;
+layout (location = 3) in uint marker;
+layout (location = 4) in float angle;
+layout (location = 5) in uint transform_mode;
+
+layout (location = 0) out vec4 out_color;
+layout (location = 1) out float out_size;
+layout (location = 2) out float out_marker;
+layout (location = 3) out float out_angle;
+layout (location = 4) out vec2 out_point_coord;
+
+void main() {
+    // Which vertex within the triangle strip forming the quad.
+    int i = gl_VertexIndex % 4;
+    vec2 corner = vec2(i / 2, i % 2);
+
+    // Quad of size x size pixels around the marker position, like a point sprite.
+    gl_Position = transform(pos, transform_mode);
+    gl_Position.xy += gl_Position.w * (2 * corner - 1) * size / viewport.size;
+
+    // Same convention as gl_PointCoord, the Vulkan y axis goes down.
+    out_point_coord = corner;
+
+    out_color = COLOR(color);
+    out_size = size;
+    out_marker = marker;
+    out_angle = angle * M_2PI;
+}
@@ -1,6 +1,9 @@
 #version 450
 #include "common.glsl"
 
+#define CMAP_BINDING (USER_BINDING + 5)
+#include "scalar_color.glsl"
+
 layout (std140, binding = USER_BINDING) uniform Params {
     mat4 lights_pos_0; // lights 0-3
     mat4 lights_params_0; // for each light, coefs for ambient, diffuse, specular, specular expon
@@ -12,6 +15,9 @@ layout (location = 0) in vec3 pos;
 layout (location = 1) in vec3 normal;
 layout (location = 2) in vec2 uv;
 layout (location = 3) in float alpha;
+#ifdef SCALAR_COLOR
+layout (location = 4) in vec4 color;
+#endif
 
 layout (location = 0) out vec3 out_pos;
 layout (location = 1) out vec3 out_normal;
@@ -23,7 +29,7 @@ layout (location = 5) out float out_alpha;
 void main() {
     gl_Position = transform(pos);
 
-    out_pos = ((mvp.model * vec4(pos, 1.0))).xyz;
+    out_pos = ((mvp.model * vec4(normalize_data(pos), 1.0))).xyz;
     out_normal = ((transpose(inverse(mvp.model)) * vec4(normal, 1.0))).xyz;
 
     out_uv = uv;
@@ -35,4 +41,9 @@ void main() {
     // custom colors
     if (uv.y < 0)
         out_color = unpack_color(uv).xyz;
+
+#ifdef SCALAR_COLOR
+    // NOTE: the tex coords are then only used for the textures.
+    out_color = COLOR(color).xyz;
+#endif
 }
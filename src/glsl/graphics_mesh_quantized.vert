@@ -0,0 +1,36 @@
+#version 450
+#include "common.glsl"
+
+layout (std140, binding = USER_BINDING) uniform Params {
+    mat4 lights_pos_0; // lights 0-3
+    mat4 lights_params_0; // for each light, coefs for ambient, diffuse, specular, specular expon
+    vec4 tex_coefs; // blending coefficients for the textures
+    vec4 clip_coefs;
+} params;
+
+// Compressed vertex attributes, converted to floats by the vertex input stage.
+layout (location = 0) in vec3 pos; // snorm16
+layout (location = 1) in vec2 normal; // snorm16, octahedral-encoded
+layout (location = 2) in vec2 uv; // half floats
+layout (location = 3) in vec4 color; // unorm8
+
+layout (location = 0) out vec3 out_pos;
+layout (location = 1) out vec3 out_normal;
+layout (location = 2) out vec2 out_uv;
+layout (location = 3) out vec3 out_color;
+layout (location = 4) out float out_clip;
+layout (location = 5) out float out_alpha;
+
+void main() {
+    gl_Position = transform(pos);
+
+    out_pos = ((mvp.model * vec4(normalize_data(pos), 1.0))).xyz;
+    out_normal = ((transpose(inverse(mvp.model)) * vec4(oct_decode(normal), 1.0))).xyz;
+
+    out_uv = uv;
+    out_clip = dot(vec4(pos, 1.0), params.clip_coefs);
+    out_alpha = color.a;
+
+    // NOTE: if uv.y is negative, the RGB color is used instead of the textures
+    out_color = uv.y < 0 ? color.rgb : vec3(0);
+}
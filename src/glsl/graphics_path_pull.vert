@@ -0,0 +1,66 @@
+#version 450
+#include "common.glsl"
+
+// Raw path points, fetched from a storage buffer (vertex pulling), see DvzGraphicsPathPullVertex.
+#define POINT_STRIDE 6u
+
+layout (std140, binding = USER_BINDING) uniform Params {
+    float linewidth;
+    float miter_limit;
+    int cap_type;
+    int round_join;
+} params;
+
+layout (std430, binding = USER_BINDING + 1) readonly buffer Points {
+    uint data[];
+} points;
+
+layout (location = 0) out vec4 out_color;
+layout (location = 1) out vec2 out_caps;
+layout (location = 2) out float out_length;
+layout (location = 3) out vec2 out_texcoord;
+layout (location = 4) out vec2 out_bevel_distance;
+
+#include "path.glsl"
+
+vec3 fetch_pos(int i) {
+    uint o = POINT_STRIDE * uint(i);
+    return vec3(
+        uintBitsToFloat(points.data[o + 0]),
+        uintBitsToFloat(points.data[o + 1]),
+        uintBitsToFloat(points.data[o + 2]));
+}
+
+
+void main() {
+    // Current point, 4 vertices per point.
+    int i = gl_VertexIndex / 4;
+    uint o = POINT_STRIDE * uint(i);
+    vec4 color = unpackUnorm4x8(points.data[o + 3]);
+    int first = int(points.data[o + 4]);
+    int size = int(points.data[o + 5]);
+
+    // Closed paths have a negative size.
+    bool closed = size < 0;
+    size = abs(size);
+
+    // Neighbor points, same logic as in the path visual baking function.
+    int j = i - first;
+    int j0 = j - 1;
+    int j2 = j + 1;
+    int j3 = j + 2;
+    if (!closed) {
+        j0 = max(j0, 0);
+        j2 = min(j2, size - 1);
+        j3 = min(j3, size - 1);
+    }
+    else {
+        j0 = j0 < 0 ? size - 2 : j0;
+        j2 = j2 >= size ? 0 : j2;
+        j3 = j3 >= size ? 1 : j3;
+    }
+
+    path_vertex(
+        gl_VertexIndex % 4, fetch_pos(first + j0), fetch_pos(i),
+        fetch_pos(first + j2), fetch_pos(first + j3), color);
+}
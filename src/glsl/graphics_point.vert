@@ -1,6 +1,9 @@
 #version 450
 #include "common.glsl"
 
+#define CMAP_BINDING (USER_BINDING + 1)
+#include "scalar_color.glsl"
+
 layout (std140, binding = USER_BINDING) uniform Params {
     float point_size;
 } params;
@@ -12,6 +15,6 @@ layout (location = 0) out vec4 out_color;
 
 void main() {
     gl_Position = transform(pos);
-    out_color = color;
+    out_color = COLOR(color);
     gl_PointSize = params.point_size;
 }
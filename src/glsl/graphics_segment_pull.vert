@@ -0,0 +1,47 @@
+#version 450
+#include "common.glsl"
+
+// Raw segments, fetched from a storage buffer (vertex pulling), see DvzGraphicsSegmentPullVertex.
+#define SEGMENT_STRIDE 13u
+
+layout (std430, binding = USER_BINDING) readonly buffer Segments {
+    uint data[];
+} segments;
+
+layout (location = 0) out vec4  out_color;
+layout (location = 1) out vec2  out_texcoord;
+layout (location = 2) out float out_length;
+layout (location = 3) out float out_linewidth;
+layout (location = 4) out float out_cap;
+
+#include "segment.glsl"
+
+// Two triangles per segment, no index buffer.
+const int corners[6] = int[6](0, 1, 2, 0, 2, 3);
+
+float fetch_float(uint offset) {
+    return uintBitsToFloat(segments.data[offset]);
+}
+
+vec3 fetch_vec3(uint offset) {
+    return vec3(fetch_float(offset), fetch_float(offset + 1), fetch_float(offset + 2));
+}
+
+
+void main (void)
+{
+    uint o = SEGMENT_STRIDE * uint(gl_VertexIndex / 6);
+
+    vec3 P0 = fetch_vec3(o + 0);
+    vec3 P1 = fetch_vec3(o + 3);
+    vec4 shift = vec4(fetch_vec3(o + 6), fetch_float(o + 9));
+    vec4 color = unpackUnorm4x8(segments.data[o + 10]);
+    float linewidth = fetch_float(o + 11);
+    uint flags = segments.data[o + 12];
+    int cap0 = int(flags & 0xFF);
+    int cap1 = int((flags >> 8) & 0xFF);
+    uint transform_mode = (flags >> 16) & 0xFF;
+
+    segment_vertex(
+        corners[gl_VertexIndex % 6], P0, P1, shift, color, linewidth, cap0, cap1, transform_mode);
+}
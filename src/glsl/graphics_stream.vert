@@ -0,0 +1,50 @@
+#version 450
+#include "common.glsl"
+
+// Streaming time series, the samples are fetched from a ring buffer (vertex pulling), see
+// DvzGraphicsStreamParams. Item #i is the sample #(i / channel_count) of the channel
+// #(i % channel_count), where i is the logical index of the item (0 is the oldest item).
+
+layout (std140, binding = USER_BINDING) uniform Params {
+    uint capacity;
+    uint head;
+    uint count;
+    uint channel_count;
+    uint color;
+    float y_scale;
+} params;
+
+layout (std430, binding = USER_BINDING + 1) readonly buffer Samples {
+    float data[];
+} samples;
+
+layout (location = 0) out vec4 out_color;
+
+// Unwrap the logical index of an item into its index in the ring buffer.
+uint ring_index(uint i) {
+    return (params.head + params.capacity - params.count + i) % params.capacity;
+}
+
+void main() {
+    uint nc = max(params.channel_count, 1u);
+
+    // 2 vertices per item: the first vertex is the previous sample of the same channel.
+    uint i = uint(gl_VertexIndex) / 2u;
+    if (gl_VertexIndex % 2 == 0 && i >= nc)
+        i -= nc;
+    uint channel = i % nc;
+    uint sample_idx = i / nc;
+
+    // The x coordinate only depends on the head and count of the ring buffer, the last sample is
+    // on the right edge. Scrolling only requires updating this uniform, not the vertex buffer.
+    uint n_samples = params.count / nc;
+    uint capacity = max(params.capacity / nc, 2u);
+    float x = -1.0 + 2.0 * float(sample_idx + capacity - n_samples) / float(capacity - 1u);
+
+    // The channels are stacked vertically.
+    float y = -1.0 + (2.0 * float(channel) + 1.0) / float(nc);
+    y += params.y_scale * samples.data[ring_index(i)];
+
+    gl_Position = transform(vec3(x, y, 0));
+    out_color = unpackUnorm4x8(params.color);
+}
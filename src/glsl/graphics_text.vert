@@ -2,7 +2,7 @@
 #include "common.glsl"
 
 layout (std140, binding = USER_BINDING) uniform Params {
-    ivec2 grid_size;  // (6, 16)
+    ivec2 grid_size;  // (6, 16), only used with the fixed font atlas
     ivec2 tex_size;  // (400, 200)
 } params;
 
@@ -13,7 +13,10 @@ layout (location = 3) in vec2 glyph_size;
 layout (location = 4) in vec2 anchor;
 layout (location = 5) in float angle;
 layout (location = 6) in uvec4 glyph;  // char, char_index, str_len, str_index
-layout (location = 7) in uint transform_mode; // TODO
+layout (location = 7) in uvec4 glyph_rect;  // x, y, w, h in the atlas texture, in texels
+layout (location = 8) in vec2 glyph_offset;  // top left corner within the string box, in pixels
+layout (location = 9) in vec2 string_size;  // size of the string box, in pixels
+layout (location = 10) in uint transform_mode; // TODO
 
 layout (location = 0) out vec4 out_color;
 layout (location = 1) out vec2 out_tex_coords;
@@ -43,36 +46,25 @@ void main() {
     float dx = int(i / 2.0);
     float dy = mod(i, 2.0);
 
-    // Position of the glyph.
-    vec2 origin = .5 * vec2(glyph.z * w, h) * (anchor - 1);
-    vec2 p = origin + vec2(w * glyph.y, 0);
+    // Position of the glyph, the anchor refers to the box of the whole string.
+    vec2 origin = string_size * (anchor - 1);
+    vec2 p = origin + 2 * glyph_offset;
 
     // gl_Position = pos_tr;
     gl_Position = ortho_inv * pos_tr;
     gl_Position.xy += gl_Position.w * rotation * (p + vec2(dx * w, dy * h));  // bottom left of the glyph
     gl_Position = ortho * gl_Position;
 
-    // Index in the texture
-    float rows = params.grid_size.x;
-    float cols = params.grid_size.y;
-
-    float row = floor(glyph.x / cols);
-    float col = mod(glyph.x, cols);
-
-    // uv position in the texture for the glyph.
-    vec2 uv = vec2(col, row);
-    uv /= vec2(cols, rows);
-
     // Little margin to avoid edge effects between glyphs.
     float eps = .005;
     dx = eps + (1.0 - 2 * eps) * dx;
     dy = eps + (1.0 - 2 * eps) * dy;
 
-    // Texture coordinates for the fragment shader.
-    vec2 duv = vec2(dx / cols, dy /rows);
+    // Texture coordinates for the fragment shader, from the glyph rectangle in the atlas.
+    vec2 uv = glyph_rect.xy + vec2(dx, dy) * glyph_rect.zw;
 
     // Output variables.
-    out_tex_coords = uv + duv;
+    out_tex_coords = uv / params.tex_size;
 
     // String index, used to discard between different strings.
     out_str_index = float(glyph.w);
@@ -0,0 +1,461 @@
+#include "../include/datoviz/glyphs.h"
+#include "../include/datoviz/array.h"
+#include "../include/datoviz/common.h"
+#include "../include/datoviz/transfers.h"
+
+BEGIN_INCL_NO_WARN
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "../external/imgui/imstb_truetype.h"
+END_INCL_NO_WARN
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+// The key 0 marks the empty slots of the hash table.
+static inline uint64_t _glyph_key(uint32_t font, uint32_t codepoint)
+{
+    return (((uint64_t)font << 32) | codepoint) + 1;
+}
+
+
+
+static inline uint32_t _glyph_hash(uint64_t key, uint32_t table_size)
+{
+    // Fibonacci hashing, the table size is a power of two.
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & (table_size - 1);
+}
+
+
+
+static void _table_insert(DvzGlyphAtlas* atlas, uint64_t key, uint32_t glyph_idx)
+{
+    ASSERT(atlas != NULL);
+    uint32_t mask = atlas->table_size - 1;
+    uint32_t slot = _glyph_hash(key, atlas->table_size);
+    while (atlas->table_keys[slot] != 0)
+        slot = (slot + 1) & mask;
+    atlas->table_keys[slot] = key;
+    atlas->table_glyphs[slot] = glyph_idx;
+}
+
+
+
+static void _table_alloc(DvzGlyphAtlas* atlas, uint32_t table_size)
+{
+    ASSERT(atlas != NULL);
+    ASSERT(table_size > 0);
+    ASSERT((table_size & (table_size - 1)) == 0);
+    atlas->table_size = table_size;
+    atlas->table_keys = calloc(table_size, sizeof(uint64_t));
+    atlas->table_glyphs = calloc(table_size, sizeof(uint32_t));
+}
+
+
+
+// Double the size of the hash table and reinsert all glyphs.
+static void _table_grow(DvzGlyphAtlas* atlas)
+{
+    ASSERT(atlas != NULL);
+    FREE(atlas->table_keys);
+    FREE(atlas->table_glyphs);
+    _table_alloc(atlas, 2 * atlas->table_size);
+
+    DvzGlyph* glyph = NULL;
+    for (uint32_t i = 0; i < atlas->glyphs.item_count; i++)
+    {
+        glyph = dvz_array_item(&atlas->glyphs, i);
+        _table_insert(atlas, _glyph_key(glyph->font, glyph->codepoint), i);
+    }
+}
+
+
+
+static void _atlas_dirty(DvzGlyphAtlas* atlas, uint32_t y, uint32_t height)
+{
+    ASSERT(atlas != NULL);
+    if (atlas->dirty_count == 0)
+    {
+        atlas->dirty_first = y;
+        atlas->dirty_count = height;
+        return;
+    }
+    uint32_t first = MIN(atlas->dirty_first, y);
+    uint32_t last = MAX(atlas->dirty_first + atlas->dirty_count, y + height);
+    atlas->dirty_first = first;
+    atlas->dirty_count = last - first;
+}
+
+
+
+// Double the height of the atlas texture. Returns false if the maximum height is reached.
+static bool _atlas_grow(DvzGlyphAtlas* atlas)
+{
+    ASSERT(atlas != NULL);
+    if (atlas->height >= DVZ_GLYPH_ATLAS_MAX_HEIGHT)
+        return false;
+
+    // Flush the pending uploads, which point to the current pixel buffer.
+    dvz_process_transfers(atlas->ctx);
+
+    uint32_t height = 2 * atlas->height;
+    log_debug("grow the glyph atlas to %dx%d", atlas->width, height);
+    VkDeviceSize row_size = atlas->width * 4;
+    REALLOC(atlas->pixels, row_size * height);
+    memset(atlas->pixels + row_size * atlas->height, 0, row_size * (height - atlas->height));
+    atlas->height = height;
+
+    // NOTE: the texture data is lost when resizing, so that the whole atlas must be uploaded, and
+    // the visuals must update their bindings.
+    dvz_texture_resize(atlas->texture, (uvec3){atlas->width, atlas->height, 1});
+    _atlas_dirty(atlas, 0, atlas->height);
+    atlas->generation++;
+    return true;
+}
+
+
+
+// Find a free rectangle in the atlas, in the best fitting shelf or in a new shelf.
+static bool _atlas_pack(DvzGlyphAtlas* atlas, uint32_t w, uint32_t h, uint32_t* x, uint32_t* y)
+{
+    ASSERT(atlas != NULL);
+    ASSERT(w > 0);
+    ASSERT(h > 0);
+
+    // 1 texel gap between the glyphs, so that linear filtering does not bleed.
+    w += 1;
+    h += 1;
+    if (w > atlas->width)
+        return false;
+
+    DvzGlyphShelf* shelf = NULL;
+    DvzGlyphShelf* best = NULL;
+    for (uint32_t i = 0; i < atlas->shelves.item_count; i++)
+    {
+        shelf = dvz_array_item(&atlas->shelves, i);
+        if (shelf->height < h || shelf->x + w > atlas->width)
+            continue;
+        // Skip the shelves that would waste too much space.
+        if (shelf->height > h + h / 4 + 2)
+            continue;
+        if (best == NULL || shelf->height < best->height)
+            best = shelf;
+    }
+
+    if (best == NULL)
+    {
+        while (atlas->shelf_y + h > atlas->height)
+        {
+            if (!_atlas_grow(atlas))
+                return false;
+        }
+        dvz_array_resize(&atlas->shelves, atlas->shelves.item_count + 1);
+        best = dvz_array_item(&atlas->shelves, atlas->shelves.item_count - 1);
+        best->y = atlas->shelf_y;
+        best->height = h;
+        best->x = 0;
+        atlas->shelf_y += h;
+    }
+
+    *x = best->x;
+    *y = best->y;
+    best->x += w;
+    return true;
+}
+
+
+
+// Rasterize a glyph as a signed distance field and copy it to the atlas.
+static void _glyph_rasterize(DvzGlyphAtlas* atlas, DvzGlyph* glyph)
+{
+    ASSERT(atlas != NULL);
+    ASSERT(glyph != NULL);
+    ASSERT(glyph->font < atlas->font_count);
+
+    DvzGlyphFont* font = &atlas->fonts[glyph->font];
+    stbtt_fontinfo* info = (stbtt_fontinfo*)font->info;
+    ASSERT(info != NULL);
+    const float unit = 1.0f / DVZ_GLYPH_RASTER_SIZE;
+
+    // NOTE: missing codepoints are mapped to the glyph 0, usually a box.
+    int gi = stbtt_FindGlyphIndex(info, (int)glyph->codepoint);
+    int advance = 0, lsb = 0;
+    stbtt_GetGlyphHMetrics(info, gi, &advance, &lsb);
+    glyph->advance = advance * font->scale * unit;
+
+    int w = 0, h = 0, xoff = 0, yoff = 0;
+    unsigned char* sdf = stbtt_GetGlyphSDF(
+        info, font->scale, gi, DVZ_GLYPH_PADDING, 128, DVZ_GLYPH_DIST_SCALE, //
+        &w, &h, &xoff, &yoff);
+    // Blank glyphs such as spaces have no bitmap.
+    if (sdf == NULL)
+        return;
+
+    uint32_t x = 0, y = 0;
+    if (!_atlas_pack(atlas, (uint32_t)w, (uint32_t)h, &x, &y))
+    {
+        log_error("the glyph atlas is full, unable to add codepoint %d", glyph->codepoint);
+        stbtt_FreeSDF(sdf, NULL);
+        return;
+    }
+
+    uint8_t* dst = NULL;
+    uint8_t v = 0;
+    for (int j = 0; j < h; j++)
+    {
+        dst = atlas->pixels + ((y + (uint32_t)j) * atlas->width + x) * 4;
+        for (int i = 0; i < w; i++)
+        {
+            v = sdf[j * w + i];
+            dst[4 * i + 0] = v;
+            dst[4 * i + 1] = v;
+            dst[4 * i + 2] = v;
+            dst[4 * i + 3] = 255;
+        }
+    }
+    stbtt_FreeSDF(sdf, NULL);
+    _atlas_dirty(atlas, y, (uint32_t)h);
+
+    glyph->rect[0] = (uint16_t)x;
+    glyph->rect[1] = (uint16_t)y;
+    glyph->rect[2] = (uint16_t)w;
+    glyph->rect[3] = (uint16_t)h;
+    glyph->offset[0] = xoff * unit;
+    glyph->offset[1] = yoff * unit;
+    glyph->size[0] = w * unit;
+    glyph->size[1] = h * unit;
+}
+
+
+
+/*************************************************************************************************/
+/*  UTF-8                                                                                        */
+/*************************************************************************************************/
+
+uint32_t dvz_utf8_next(const char** str)
+{
+    ASSERT(str != NULL);
+    const unsigned char* s = (const unsigned char*)*str;
+    if (s == NULL || s[0] == 0)
+        return 0;
+
+    uint32_t cp = 0;
+    uint32_t n = 0; // number of continuation bytes
+    if (s[0] < 0x80)
+        cp = s[0];
+    else if ((s[0] & 0xE0) == 0xC0)
+    {
+        cp = s[0] & 0x1F;
+        n = 1;
+    }
+    else if ((s[0] & 0xF0) == 0xE0)
+    {
+        cp = s[0] & 0x0F;
+        n = 2;
+    }
+    else if ((s[0] & 0xF8) == 0xF0)
+    {
+        cp = s[0] & 0x07;
+        n = 3;
+    }
+    else
+    {
+        *str += 1;
+        return 0xFFFD;
+    }
+
+    for (uint32_t i = 1; i <= n; i++)
+    {
+        // NOTE: this also stops at the null terminator of truncated sequences.
+        if ((s[i] & 0xC0) != 0x80)
+        {
+            *str += i;
+            return 0xFFFD;
+        }
+        cp = (cp << 6) | (s[i] & 0x3F);
+    }
+    *str += n + 1;
+    return cp;
+}
+
+
+
+uint32_t dvz_utf8_count(const char* str)
+{
+    uint32_t count = 0;
+    while (dvz_utf8_next(&str) != 0)
+        count++;
+    return count;
+}
+
+
+
+/*************************************************************************************************/
+/*  Glyph atlas                                                                                  */
+/*************************************************************************************************/
+
+DvzGlyphAtlas* dvz_glyph_atlas(DvzContext* ctx)
+{
+    ASSERT(ctx != NULL);
+
+    DvzGlyphAtlas* atlas = calloc(1, sizeof(DvzGlyphAtlas));
+    ASSERT(atlas != NULL);
+    dvz_obj_init(&atlas->obj);
+    atlas->ctx = ctx;
+
+    atlas->glyphs = dvz_array_struct(0, sizeof(DvzGlyph));
+    atlas->shelves = dvz_array_struct(0, sizeof(DvzGlyphShelf));
+    _table_alloc(atlas, DVZ_GLYPH_TABLE_SIZE);
+
+    atlas->width = DVZ_GLYPH_ATLAS_WIDTH;
+    atlas->height = DVZ_GLYPH_ATLAS_HEIGHT;
+    atlas->pixels = calloc(atlas->width * atlas->height, 4);
+
+    atlas->texture = dvz_ctx_texture(
+        ctx, 2, (uvec3){atlas->width, atlas->height, 1}, VK_FORMAT_R8G8B8A8_UNORM);
+    dvz_texture_filter(atlas->texture, DVZ_FILTER_MIN, VK_FILTER_LINEAR);
+    dvz_texture_filter(atlas->texture, DVZ_FILTER_MAG, VK_FILTER_LINEAR);
+    dvz_texture_address_mode(
+        atlas->texture, DVZ_TEXTURE_AXIS_U, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+    dvz_texture_address_mode(
+        atlas->texture, DVZ_TEXTURE_AXIS_V, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+
+    // Default font.
+    unsigned long file_size = 0;
+    unsigned char* buffer = dvz_resource_font("Roboto_Medium", &file_size);
+    ASSERT(buffer != NULL);
+    ASSERT(file_size > 0);
+    int32_t font = dvz_glyph_atlas_font(atlas, file_size, buffer);
+    ASSERT(font == 0);
+
+    dvz_obj_created(&atlas->obj);
+    return atlas;
+}
+
+
+
+int32_t dvz_glyph_atlas_font(DvzGlyphAtlas* atlas, unsigned long size, const unsigned char* ttf)
+{
+    ASSERT(atlas != NULL);
+    ASSERT(size > 0);
+    ASSERT(ttf != NULL);
+
+    if (atlas->font_count >= DVZ_GLYPH_MAX_FONTS)
+    {
+        log_error("maximum number of fonts %d reached", DVZ_GLYPH_MAX_FONTS);
+        return -1;
+    }
+
+    DvzGlyphFont* font = &atlas->fonts[atlas->font_count];
+    font->data = malloc(size);
+    memcpy(font->data, ttf, size);
+    stbtt_fontinfo* info = calloc(1, sizeof(stbtt_fontinfo));
+    if (!stbtt_InitFont(info, font->data, stbtt_GetFontOffsetForIndex(font->data, 0)))
+    {
+        log_error("unable to load the TrueType font");
+        FREE(info);
+        FREE(font->data);
+        return -1;
+    }
+    font->info = info;
+
+    int ascent = 0, descent = 0, line_gap = 0;
+    stbtt_GetFontVMetrics(info, &ascent, &descent, &line_gap);
+    font->scale = stbtt_ScaleForPixelHeight(info, DVZ_GLYPH_RASTER_SIZE);
+    font->ascent = ascent * font->scale / DVZ_GLYPH_RASTER_SIZE;
+
+    return (int32_t)atlas->font_count++;
+}
+
+
+
+DvzGlyph* dvz_glyph_atlas_get(DvzGlyphAtlas* atlas, uint32_t font, uint32_t codepoint)
+{
+    ASSERT(atlas != NULL);
+    ASSERT(atlas->table_size > 0);
+    if (font >= atlas->font_count)
+    {
+        log_warn("unknown font %d, fallback to the default font", font);
+        font = 0;
+    }
+
+    // Lookup.
+    uint64_t key = _glyph_key(font, codepoint);
+    uint32_t mask = atlas->table_size - 1;
+    uint32_t slot = _glyph_hash(key, atlas->table_size);
+    while (atlas->table_keys[slot] != 0)
+    {
+        if (atlas->table_keys[slot] == key)
+            return dvz_array_item(&atlas->glyphs, atlas->table_glyphs[slot]);
+        slot = (slot + 1) & mask;
+    }
+
+    // The glyph is not in the atlas yet: rasterize it.
+    uint32_t glyph_idx = atlas->glyphs.item_count;
+    dvz_array_resize(&atlas->glyphs, glyph_idx + 1);
+    DvzGlyph* glyph = dvz_array_item(&atlas->glyphs, glyph_idx);
+    memset(glyph, 0, sizeof(DvzGlyph));
+    glyph->font = font;
+    glyph->codepoint = codepoint;
+    _glyph_rasterize(atlas, glyph);
+
+    // Keep the load factor of the table below 1/2.
+    if (2 * (glyph_idx + 1) > atlas->table_size)
+        _table_grow(atlas);
+    else
+    {
+        atlas->table_keys[slot] = key;
+        atlas->table_glyphs[slot] = glyph_idx;
+    }
+
+    return glyph;
+}
+
+
+
+void dvz_glyph_atlas_upload(DvzGlyphAtlas* atlas)
+{
+    ASSERT(atlas != NULL);
+    if (atlas->dirty_count == 0)
+        return;
+    ASSERT(atlas->dirty_first + atlas->dirty_count <= atlas->height);
+
+    // Upload the full-width band of the modified rows.
+    VkDeviceSize row_size = atlas->width * 4;
+    log_trace(
+        "upload rows %d to %d of the glyph atlas", atlas->dirty_first,
+        atlas->dirty_first + atlas->dirty_count);
+    dvz_upload_texture(
+        atlas->ctx, atlas->texture, (uvec3){0, atlas->dirty_first, 0},
+        (uvec3){atlas->width, atlas->dirty_count, 1}, row_size * atlas->dirty_count,
+        atlas->pixels + row_size * atlas->dirty_first);
+
+    atlas->dirty_first = 0;
+    atlas->dirty_count = 0;
+}
+
+
+
+void dvz_glyph_atlas_destroy(DvzGlyphAtlas* atlas)
+{
+    ASSERT(atlas != NULL);
+    if (!dvz_obj_is_created(&atlas->obj))
+        return;
+
+    for (uint32_t i = 0; i < atlas->font_count; i++)
+    {
+        FREE(atlas->fonts[i].info);
+        FREE(atlas->fonts[i].data);
+    }
+    dvz_array_destroy(&atlas->glyphs);
+    dvz_array_destroy(&atlas->shelves);
+    FREE(atlas->table_keys);
+    FREE(atlas->table_glyphs);
+    FREE(atlas->pixels);
+    // NOTE: the texture is destroyed with the context.
+
+    dvz_obj_destroyed(&atlas->obj);
+}
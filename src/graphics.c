@@ -3,6 +3,7 @@
 #include "../include/datoviz/atlas.h"
 #include "../include/datoviz/canvas.h"
 #include "../include/datoviz/context.h"
+#include "../include/datoviz/glyphs.h"
 
 
 /*************************************************************************************************/
@@ -36,6 +37,9 @@ static inline void _load_shader(
         _load_shader(graphics, VK_SHADER_STAGE_##stage##_BIT, size, buffer);                      \
     }
 
+// Vertex shader, or its variant compiled with SCALAR_COLOR defined (see CMakeLists.txt).
+#define SHADER_VERTEX(x) SHADER(VERTEX, SCALAR_COLOR ? x "_cmap_vert" : x "_vert")
+
 #define PRIMITIVE(x)                                                                              \
     dvz_graphics_renderpass(graphics, &canvas->renderpass, 0);                                    \
     dvz_graphics_topology(graphics, VK_PRIMITIVE_TOPOLOGY_##x);                                   \
@@ -52,7 +56,33 @@ static inline void _load_shader(
 
 #define ATTR_POS(t, f) ATTR(t, VK_FORMAT_R32G32B32_SFLOAT, f)
 
-#define ATTR_COL(t, f) ATTR(t, VK_FORMAT_R8G8B8A8_UNORM, f)
+#define SCALAR_COLOR ((graphics->flags & DVZ_GRAPHICS_FLAGS_SCALAR_COLOR) != 0)
+
+// With DVZ_GRAPHICS_FLAGS_DRAW_BATCH, the shaders are the variants compiled with DRAW_BATCH
+// defined (see CMakeLists.txt), the viewport and the params of each draw are read from a storage
+// buffer.
+#define DRAW_BATCH ((graphics->flags & DVZ_GRAPHICS_FLAGS_DRAW_BATCH) != 0)
+
+// With DVZ_GRAPHICS_FLAGS_SCALAR_COLOR, one float per vertex is read from a separate vertex buffer
+// bound at the vertex binding 1. The shader receives the value in the red channel of the color.
+#define ATTR_SCALAR                                                                               \
+    dvz_graphics_vertex_binding(graphics, 1, sizeof(float));                                      \
+    dvz_graphics_vertex_attr(graphics, 1, attr_idx++, VK_FORMAT_R32_SFLOAT, 0);
+
+// With DVZ_GRAPHICS_FLAGS_SPLIT_COLOR, the colors are read from a separate cvec4 vertex buffer
+// bound at the vertex binding 1, the color field of the vertex struct is then unused.
+#define ATTR_COL(t, f)                                                                            \
+    if (SCALAR_COLOR)                                                                             \
+    {                                                                                             \
+        ATTR_SCALAR                                                                               \
+    }                                                                                             \
+    else if ((graphics->flags & DVZ_GRAPHICS_FLAGS_SPLIT_COLOR) != 0)                             \
+    {                                                                                             \
+        dvz_graphics_vertex_binding(graphics, 1, sizeof(cvec4));                                  \
+        dvz_graphics_vertex_attr(graphics, 1, attr_idx++, VK_FORMAT_R8G8B8A8_UNORM, 0);           \
+    }                                                                                             \
+    else                                                                                          \
+        ATTR(t, VK_FORMAT_R8G8B8A8_UNORM, f)
 
 
 
@@ -63,10 +93,23 @@ static inline void _load_shader(
 static void _common_slots(DvzGraphics* graphics)
 {
     dvz_graphics_slot(graphics, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER); // MVP
-    dvz_graphics_slot(graphics, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER); // viewport
+    // Viewport, or the per-draw data of a draw batch (DvzGraphicsBatchDraw structs).
+    dvz_graphics_slot(
+        graphics, 1,
+        DRAW_BATCH ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
     // dvz_graphics_slot(graphics, 2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER); // color texture
 }
 
+// Slots of the scalar colors, after the slots of the graphics: the colormap params and the
+// colormap texture. The binding must match CMAP_BINDING in the vertex shader.
+static void _scalar_color_slots(DvzGraphics* graphics, uint32_t binding)
+{
+    if (!SCALAR_COLOR)
+        return;
+    dvz_graphics_slot(graphics, binding, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    dvz_graphics_slot(graphics, binding + 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+}
+
 
 
 /*************************************************************************************************/
@@ -75,7 +118,7 @@ static void _common_slots(DvzGraphics* graphics)
 
 static void _graphics_point(DvzCanvas* canvas, DvzGraphics* graphics)
 {
-    SHADER(VERTEX, "graphics_point_vert")
+    SHADER_VERTEX("graphics_point")
     SHADER(FRAGMENT, "graphics_point_frag")
     PRIMITIVE(POINT_LIST)
 
@@ -89,14 +132,46 @@ static void _graphics_point(DvzCanvas* canvas, DvzGraphics* graphics)
 
     _common_slots(graphics);
     dvz_graphics_slot(graphics, DVZ_USER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    _scalar_color_slots(graphics, DVZ_USER_BINDING + 1);
+
+    CREATE
+}
+
+static void _graphics_point_quantized(DvzCanvas* canvas, DvzGraphics* graphics)
+{
+    SHADER_VERTEX("graphics_point")
+    SHADER(FRAGMENT, "graphics_point_frag")
+    PRIMITIVE(POINT_LIST)
+
+    // Depth test flag.
+    if ((graphics->flags & DVZ_GRAPHICS_FLAGS_DEPTH_TEST) != 0)
+        dvz_graphics_depth_test(graphics, DVZ_DEPTH_TEST_ENABLE);
+
+    // NOTE: the shader is the same as the non-quantized version, the snorm16 positions are
+    // converted to floats by the vertex input stage.
+    ATTR_BEGIN(DvzGraphicsPointQuantizedVertex)
+    ATTR(DvzGraphicsPointQuantizedVertex, VK_FORMAT_R16G16B16A16_SNORM, pos)
+    ATTR_COL(DvzGraphicsPointQuantizedVertex, color)
+
+    _common_slots(graphics);
+    dvz_graphics_slot(graphics, DVZ_USER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    _scalar_color_slots(graphics, DVZ_USER_BINDING + 1);
 
     CREATE
 }
 
 static void _graphics_basic(DvzCanvas* canvas, DvzGraphics* graphics, VkPrimitiveTopology topology)
 {
-    SHADER(VERTEX, "graphics_basic_vert")
-    SHADER(FRAGMENT, "graphics_basic_frag")
+    if (DRAW_BATCH)
+    {
+        SHADER(VERTEX, "graphics_basic_batch_vert")
+        SHADER(FRAGMENT, "graphics_basic_batch_frag")
+    }
+    else
+    {
+        SHADER_VERTEX("graphics_basic")
+        SHADER(FRAGMENT, "graphics_basic_frag")
+    }
 
     dvz_graphics_renderpass(graphics, &canvas->renderpass, 0);
     dvz_graphics_topology(graphics, topology);
@@ -114,6 +189,7 @@ static void _graphics_basic(DvzCanvas* canvas, DvzGraphics* graphics, VkPrimitiv
     ATTR_COL(DvzVertex, color)
 
     _common_slots(graphics);
+    _scalar_color_slots(graphics, DVZ_USER_BINDING);
 
     CREATE
 }
@@ -126,8 +202,16 @@ static void _graphics_basic(DvzCanvas* canvas, DvzGraphics* graphics, VkPrimitiv
 
 static void _graphics_marker(DvzCanvas* canvas, DvzGraphics* graphics)
 {
-    SHADER(VERTEX, "graphics_marker_vert")
-    SHADER(FRAGMENT, "graphics_marker_frag")
+    if (DRAW_BATCH)
+    {
+        SHADER(VERTEX, "graphics_marker_batch_vert")
+        SHADER(FRAGMENT, "graphics_marker_batch_frag")
+    }
+    else
+    {
+        SHADER_VERTEX("graphics_marker")
+        SHADER(FRAGMENT, "graphics_marker_frag")
+    }
     PRIMITIVE(POINT_LIST)
 
     // Depth test flag.
@@ -142,8 +226,43 @@ static void _graphics_marker(DvzCanvas* canvas, DvzGraphics* graphics)
     ATTR(DvzGraphicsMarkerVertex, VK_FORMAT_R8_UNORM, angle)
     ATTR(DvzGraphicsMarkerVertex, VK_FORMAT_R8_UINT, transform)
 
+    _common_slots(graphics);
+    // In a draw batch, the marker params are part of the per-draw data.
+    if (!DRAW_BATCH)
+        dvz_graphics_slot(graphics, DVZ_USER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    _scalar_color_slots(graphics, DVZ_USER_BINDING + 1);
+
+    CREATE
+}
+
+
+
+// Instanced markers: one instance per marker, drawn as a quad instead of a point sprite.
+static void _graphics_marker_instanced(DvzCanvas* canvas, DvzGraphics* graphics)
+{
+    SHADER_VERTEX("graphics_marker_instanced")
+    SHADER(FRAGMENT, "graphics_marker_instanced_frag")
+    PRIMITIVE(TRIANGLE_STRIP)
+
+    // Depth test flag.
+    if ((graphics->flags & DVZ_GRAPHICS_FLAGS_DEPTH_TEST) != 0)
+        dvz_graphics_depth_test(graphics, DVZ_DEPTH_TEST_ENABLE);
+
+    ATTR_BEGIN(DvzGraphicsMarkerVertex)
+    ATTR_POS(DvzGraphicsMarkerVertex, pos)
+    ATTR_COL(DvzGraphicsMarkerVertex, color)
+    ATTR(DvzGraphicsMarkerVertex, VK_FORMAT_R32_SFLOAT, size)
+    ATTR(DvzGraphicsMarkerVertex, VK_FORMAT_R8_UINT, marker)
+    ATTR(DvzGraphicsMarkerVertex, VK_FORMAT_R8_UNORM, angle)
+    ATTR(DvzGraphicsMarkerVertex, VK_FORMAT_R8_UINT, transform)
+    dvz_graphics_vertex_input_rate(graphics, 0, VK_VERTEX_INPUT_RATE_INSTANCE);
+    if ((graphics->flags & DVZ_GRAPHICS_FLAGS_SPLIT_COLOR) != 0 || SCALAR_COLOR)
+        dvz_graphics_vertex_input_rate(graphics, 1, VK_VERTEX_INPUT_RATE_INSTANCE);
+    dvz_graphics_instancing(graphics, 4);
+
     _common_slots(graphics);
     dvz_graphics_slot(graphics, DVZ_USER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    _scalar_color_slots(graphics, DVZ_USER_BINDING + 1);
 
     CREATE
 }
@@ -211,6 +330,55 @@ static void _graphics_segment(DvzCanvas* canvas, DvzGraphics* graphics)
 
 
 
+// Vertex pulling: the segments are stored once, without indices.
+static void
+_graphics_segment_pull_callback(DvzGraphicsData* data, uint32_t item_count, const void* item)
+{
+    ASSERT(data != NULL);
+    ASSERT(data->vertices != NULL);
+
+    ASSERT(item_count > 0);
+    dvz_array_resize(data->vertices, item_count);
+    // no indices
+
+    if (item == NULL)
+        return;
+    ASSERT(item != NULL);
+    ASSERT(data->current_idx < item_count);
+
+    // Pack the segment vertex.
+    const DvzGraphicsSegmentVertex* segment = (const DvzGraphicsSegmentVertex*)item;
+    DvzGraphicsSegmentPullVertex vertex = {0};
+    _vec3_copy(segment->P0, vertex.P0);
+    _vec3_copy(segment->P1, vertex.P1);
+    memcpy(vertex.shift, segment->shift, sizeof(vertex.shift));
+    memcpy(vertex.color, segment->color, sizeof(cvec4));
+    vertex.linewidth = segment->linewidth;
+    vertex.cap0 = (uint8_t)segment->cap0;
+    vertex.cap1 = (uint8_t)segment->cap1;
+    vertex.transform = segment->transform;
+
+    dvz_array_data(data->vertices, data->current_idx, 1, 1, &vertex);
+
+    data->current_idx++;
+}
+
+static void _graphics_segment_pull(DvzCanvas* canvas, DvzGraphics* graphics)
+{
+    SHADER(VERTEX, "graphics_segment_pull_vert")
+    SHADER(FRAGMENT, "graphics_segment_frag")
+    PRIMITIVE(TRIANGLE_LIST)
+
+    // No vertex attributes, 6 vertices (2 triangles) per segment.
+    _common_slots(graphics);
+    dvz_graphics_vertex_pulling(graphics, DVZ_USER_BINDING, 6);
+    dvz_graphics_callback(graphics, _graphics_segment_pull_callback);
+
+    CREATE
+}
+
+
+
 /*************************************************************************************************/
 /*  Path graphics                                                                                */
 /*************************************************************************************************/
@@ -239,7 +407,7 @@ static void _graphics_path_callback(DvzGraphicsData* data, uint32_t item_count,
 
 static void _graphics_path(DvzCanvas* canvas, DvzGraphics* graphics)
 {
-    SHADER(VERTEX, "graphics_path_vert")
+    SHADER_VERTEX("graphics_path")
     SHADER(FRAGMENT, "graphics_path_frag")
     PRIMITIVE(TRIANGLE_STRIP)
     // PRIMITIVE(POINT_LIST)
@@ -253,6 +421,7 @@ static void _graphics_path(DvzCanvas* canvas, DvzGraphics* graphics)
 
     _common_slots(graphics);
     dvz_graphics_slot(graphics, DVZ_USER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    _scalar_color_slots(graphics, DVZ_USER_BINDING + 1);
 
     dvz_graphics_callback(graphics, _graphics_path_callback);
 
@@ -261,10 +430,256 @@ static void _graphics_path(DvzCanvas* canvas, DvzGraphics* graphics)
 
 
 
+static void _graphics_path_pull(DvzCanvas* canvas, DvzGraphics* graphics)
+{
+    SHADER(VERTEX, "graphics_path_pull_vert")
+    SHADER(FRAGMENT, "graphics_path_frag")
+    PRIMITIVE(TRIANGLE_STRIP)
+
+    // No vertex attributes, 4 vertices per point, the vertex shader fetches the neighbors.
+    _common_slots(graphics);
+    dvz_graphics_slot(graphics, DVZ_USER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    dvz_graphics_vertex_pulling(graphics, DVZ_USER_BINDING + 1, 4);
+
+    CREATE
+}
+
+
+
+/*************************************************************************************************/
+/*  Stream graphics                                                                              */
+/*************************************************************************************************/
+
+static void _graphics_stream(DvzCanvas* canvas, DvzGraphics* graphics)
+{
+    SHADER(VERTEX, "graphics_stream_vert")
+    SHADER(FRAGMENT, "graphics_basic_frag")
+    PRIMITIVE(LINE_LIST)
+
+    // No vertex attributes, 2 vertices per sample: a line segment from the previous sample of
+    // the same channel. The vertex shader unwraps the ring buffer indices.
+    _common_slots(graphics);
+    dvz_graphics_slot(graphics, DVZ_USER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    dvz_graphics_vertex_pulling(graphics, DVZ_USER_BINDING + 1, 2);
+
+    CREATE
+}
+
+
+
+/*************************************************************************************************/
+/*  Density graphics                                                                             */
+/*************************************************************************************************/
+
+static void _graphics_density(DvzCanvas* canvas, DvzGraphics* graphics)
+{
+    SHADER(VERTEX, "graphics_density_vert")
+    SHADER(FRAGMENT, "graphics_density_frag")
+    PRIMITIVE(TRIANGLE_LIST)
+
+    // No vertex attributes: a single triangle covering the viewport, each fragment reads the
+    // count of its bin.
+    _common_slots(graphics);
+
+    // Params buffer.
+    dvz_graphics_slot(graphics, DVZ_USER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+
+    // Colormap texture.
+    dvz_graphics_slot(graphics, DVZ_USER_BINDING + 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+
+    // Bins.
+    dvz_graphics_slot(graphics, DVZ_USER_BINDING + 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+    CREATE
+}
+
+
+
+/*************************************************************************************************/
+/*  Histogram graphics                                                                           */
+/*************************************************************************************************/
+
+static void _graphics_histogram(DvzCanvas* canvas, DvzGraphics* graphics)
+{
+    SHADER(VERTEX, "graphics_histogram_vert")
+    SHADER(FRAGMENT, "graphics_basic_frag")
+    PRIMITIVE(TRIANGLE_LIST)
+
+    // No vertex attributes: the bars are pulled from the bins buffer, 6 vertices per bin.
+    _common_slots(graphics);
+
+    // Params buffer.
+    dvz_graphics_slot(graphics, DVZ_USER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+
+    // Bins.
+    dvz_graphics_slot(graphics, DVZ_USER_BINDING + 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+    CREATE
+}
+
+
+
+/*************************************************************************************************/
+/*  Axes graphics                                                                                */
+/*************************************************************************************************/
+
+static void _graphics_axes_tick(DvzCanvas* canvas, DvzGraphics* graphics)
+{
+    SHADER(VERTEX, "graphics_axes_tick_vert")
+    SHADER(FRAGMENT, "graphics_segment_frag")
+    PRIMITIVE(TRIANGLE_LIST)
+
+    // No vertex attributes: the segments are expanded from the major ticks, 6 vertices per
+    // segment.
+    _common_slots(graphics);
+
+    // Params buffer.
+    dvz_graphics_slot(graphics, DVZ_USER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+
+    // Major ticks.
+    dvz_graphics_vertex_pulling(graphics, DVZ_USER_BINDING + 1, 6 * DVZ_AXES_TICK_SEGMENTS);
+
+    CREATE
+}
+
+static void _graphics_axes_label(DvzCanvas* canvas, DvzGraphics* graphics)
+{
+    SHADER(VERTEX, "graphics_axes_label_vert")
+    SHADER(FRAGMENT, "graphics_text_frag")
+    PRIMITIVE(TRIANGLE_LIST)
+
+    // No vertex attributes: the glyph quads of the label of each major tick are expanded from
+    // its glyph run, 6 vertices per glyph.
+    _common_slots(graphics);
+
+    // Text params buffer and glyph atlas texture, as with the text graphics.
+    dvz_graphics_slot(graphics, DVZ_USER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    dvz_graphics_slot(graphics, DVZ_USER_BINDING + 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+
+    // Axes params buffer.
+    dvz_graphics_slot(graphics, DVZ_USER_BINDING + 2, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+
+    // Glyph runs and glyphs.
+    dvz_graphics_slot(graphics, DVZ_USER_BINDING + 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    dvz_graphics_slot(graphics, DVZ_USER_BINDING + 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+    // Major ticks.
+    dvz_graphics_vertex_pulling(graphics, DVZ_USER_BINDING + 5, 6 * DVZ_AXES_LABEL_MAX_GLYPHS);
+
+    CREATE
+}
+
+
+
 /*************************************************************************************************/
 /*  Text graphics                                                                             */
 /*************************************************************************************************/
 
+// Layout of a string of glyph indices in the fixed monospace font atlas.
+static void _text_glyphs(
+    DvzGraphicsData* data, uint32_t reps, DvzFontAtlas* atlas,
+    const DvzGraphicsTextItem* str_item, DvzGraphicsTextVertex* vertex)
+{
+    uint32_t n = str_item->strlen;
+    ASSERT(n > 0);
+    ASSERT(data->current_idx + n <= data->item_count);
+    ASSERT(str_item->glyphs != NULL);
+    ASSERT(atlas->rows > 0);
+    ASSERT(atlas->cols > 0);
+
+    // Glyph size.
+    _font_atlas_glyph_size(atlas, str_item->font_size, vertex->glyph_size);
+    vertex->string_size[0] = n * vertex->glyph_size[0];
+    vertex->string_size[1] = vertex->glyph_size[1];
+
+    uint32_t cw = (uint32_t)atlas->width / atlas->cols;
+    uint32_t ch = (uint32_t)atlas->height / atlas->rows;
+    uint16_t g = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        g = str_item->glyphs[i];
+
+        // Glyph.
+        vertex->glyph[0] = g;                   // char
+        vertex->glyph[1] = i;                   // char idx
+        vertex->glyph[2] = n;                   // str len
+        vertex->glyph[3] = data->current_group; // str idx
+
+        // Cell of the glyph in the atlas grid.
+        vertex->glyph_rect[0] = (g % atlas->cols) * cw;
+        vertex->glyph_rect[1] = (g / atlas->cols) * ch;
+        vertex->glyph_rect[2] = cw;
+        vertex->glyph_rect[3] = ch;
+        vertex->glyph_offset[0] = i * vertex->glyph_size[0];
+        vertex->glyph_offset[1] = 0;
+
+        // Glyph colors.
+        if (str_item->glyph_colors != NULL)
+            memcpy(vertex->color, str_item->glyph_colors[i], sizeof(cvec4));
+
+        // Fill the vertices array by simply repeating them 4 times (or once with instancing).
+        dvz_array_data(data->vertices, reps * data->current_idx, reps, 1, vertex);
+        data->current_idx++; // glyph index
+    }
+}
+
+
+
+// Layout of a UTF-8 string with the proportional glyphs of the dynamic glyph atlas.
+static void _text_string(
+    DvzGraphicsData* data, uint32_t reps, DvzGlyphAtlas* atlas,
+    const DvzGraphicsTextItem* str_item, DvzGraphicsTextVertex* vertex)
+{
+    const char* s = str_item->string;
+    ASSERT(s != NULL);
+    uint32_t n = dvz_utf8_count(s);
+    ASSERT(n > 0);
+    ASSERT(data->current_idx + n <= data->item_count);
+
+    uint32_t font = str_item->font < atlas->font_count ? str_item->font : 0;
+    float fs = str_item->font_size;
+    float ascent = atlas->fonts[font].ascent;
+    uint32_t cp = 0;
+
+    // First pass: rasterize the missing glyphs and compute the width of the string.
+    float width = 0;
+    while ((cp = dvz_utf8_next(&s)) != 0)
+        width += dvz_glyph_atlas_get(atlas, font, cp)->advance * fs;
+    vertex->string_size[0] = width;
+    vertex->string_size[1] = fs;
+
+    // Second pass: the glyph vertices.
+    // NOTE: the glyph pointers are only valid until the next lookup, so we make a copy.
+    DvzGlyph glyph = {0};
+    float pen = 0;
+    s = str_item->string;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        cp = dvz_utf8_next(&s);
+        glyph = *dvz_glyph_atlas_get(atlas, font, cp);
+
+        vertex->glyph[0] = (uint16_t)MIN(cp, UINT16_MAX); // char
+        vertex->glyph[1] = i;                             // char idx
+        vertex->glyph[2] = n;                             // str len
+        vertex->glyph[3] = data->current_group;           // str idx
+
+        memcpy(vertex->glyph_rect, glyph.rect, sizeof(usvec4));
+        vertex->glyph_offset[0] = pen + glyph.offset[0] * fs;
+        vertex->glyph_offset[1] = (ascent + glyph.offset[1]) * fs;
+        vertex->glyph_size[0] = glyph.size[0] * fs;
+        vertex->glyph_size[1] = glyph.size[1] * fs;
+        pen += glyph.advance * fs;
+
+        if (str_item->glyph_colors != NULL)
+            memcpy(vertex->color, str_item->glyph_colors[i], sizeof(cvec4));
+
+        dvz_array_data(data->vertices, reps * data->current_idx, reps, 1, vertex);
+        data->current_idx++; // glyph index
+    }
+}
+
+
+
 static void _graphics_text_callback(DvzGraphicsData* data, uint32_t item_count, const void* item)
 {
     // NOTE: item_count is the total number of glyphs
@@ -272,10 +687,13 @@ static void _graphics_text_callback(DvzGraphicsData* data, uint32_t item_count,
     ASSERT(data != NULL);
     ASSERT(data->vertices != NULL);
 
+    // Instanced glyphs are stored once, otherwise they are repeated for the 4 vertices.
+    uint32_t reps = data->graphics->vertices_per_instance > 0 ? 1 : 4;
+
     ASSERT(item_count > 0);
-    dvz_array_resize(data->vertices, 4 * item_count);
-    DvzFontAtlas* atlas = &data->graphics->gpu->context->font_atlas;
-    ASSERT(atlas != NULL);
+    dvz_array_resize(data->vertices, reps * item_count);
+    DvzContext* ctx = data->graphics->gpu->context;
+    ASSERT(ctx != NULL);
 
     if (item == NULL)
         return;
@@ -283,46 +701,23 @@ static void _graphics_text_callback(DvzGraphicsData* data, uint32_t item_count,
     ASSERT(data->current_idx < item_count);
 
     const DvzGraphicsTextItem* str_item = item;
-    // Whether the string is set or the glyph indices directly.
-    bool glyph = str_item->string == NULL;
-    if (glyph)
-    {
-        ASSERT(str_item->strlen > 0);
-        ASSERT(str_item->glyphs != NULL);
-    }
-    uint32_t n = glyph ? str_item->strlen : strlen(str_item->string);
-    ASSERT(n > 0);
-    ASSERT(data->current_idx + n <= item_count);
 
     // Make a copy of the vertex stored in the text item. We'll copy a modified version of it to
     // the source array buffer.
     DvzGraphicsTextVertex vertex = {0};
     vertex = str_item->vertex;
-    for (uint32_t i = 0; i < n; i++)
-    {
-        size_t g = glyph ? str_item->glyphs[i] : _font_atlas_glyph(atlas, str_item->string, i);
-
-        // Glyph size.
-        _font_atlas_glyph_size(atlas, str_item->font_size, vertex.glyph_size);
-
-        // Glyph.
-        vertex.glyph[0] = g;                   // char
-        vertex.glyph[1] = i;                   // char idx
-        vertex.glyph[2] = n;                   // str len
-        vertex.glyph[3] = data->current_group; // str idx
-
-        // Glyph colors.
-        if (str_item->glyph_colors != NULL)
-            memcpy(vertex.color, str_item->glyph_colors[i], sizeof(cvec4));
 
-        // Fill the vertices array by simply repeating them 4 times.
-        dvz_array_data(data->vertices, 4 * data->current_idx, 4, 1, &vertex);
-        data->current_idx++; // glyph index
-    }
+    // Whether the string is set or the glyph indices directly: the glyph indices refer to the
+    // fixed font atlas, whereas the strings are rendered with the dynamic glyph atlas.
+    if (str_item->string == NULL)
+        _text_glyphs(data, reps, &ctx->font_atlas, str_item, &vertex);
+    else
+        _text_string(data, reps, ctx->glyph_atlas, str_item, &vertex);
+    ASSERT(data->current_idx <= item_count);
     data->current_group++; // glyph index
 }
 
-static void _graphics_text(DvzCanvas* canvas, DvzGraphics* graphics)
+static void _graphics_text_setup(DvzCanvas* canvas, DvzGraphics* graphics)
 {
     SHADER(VERTEX, "graphics_text_vert")
     SHADER(FRAGMENT, "graphics_text_frag")
@@ -336,6 +731,9 @@ static void _graphics_text(DvzCanvas* canvas, DvzGraphics* graphics)
     ATTR(DvzGraphicsTextVertex, VK_FORMAT_R32G32_SFLOAT, anchor)
     ATTR(DvzGraphicsTextVertex, VK_FORMAT_R32_SFLOAT, angle)
     ATTR(DvzGraphicsTextVertex, VK_FORMAT_R16G16B16A16_UINT, glyph)
+    ATTR(DvzGraphicsTextVertex, VK_FORMAT_R16G16B16A16_UINT, glyph_rect)
+    ATTR(DvzGraphicsTextVertex, VK_FORMAT_R32G32_SFLOAT, glyph_offset)
+    ATTR(DvzGraphicsTextVertex, VK_FORMAT_R32G32_SFLOAT, string_size)
     ATTR(DvzGraphicsTextVertex, VK_FORMAT_R8_UINT, transform)
 
     _common_slots(graphics);
@@ -343,6 +741,24 @@ static void _graphics_text(DvzCanvas* canvas, DvzGraphics* graphics)
     dvz_graphics_slot(graphics, DVZ_USER_BINDING + 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
 
     dvz_graphics_callback(graphics, _graphics_text_callback);
+}
+
+static void _graphics_text(DvzCanvas* canvas, DvzGraphics* graphics)
+{
+    _graphics_text_setup(canvas, graphics);
+
+    CREATE
+}
+
+
+
+// Instanced glyphs: one instance per glyph, the vertex shader is the same as the glyph quad is
+// computed from gl_VertexIndex.
+static void _graphics_text_instanced(DvzCanvas* canvas, DvzGraphics* graphics)
+{
+    _graphics_text_setup(canvas, graphics);
+    dvz_graphics_vertex_input_rate(graphics, 0, VK_VERTEX_INPUT_RATE_INSTANCE);
+    dvz_graphics_instancing(graphics, 4);
 
     CREATE
 }
@@ -614,9 +1030,18 @@ static void _graphics_volume(DvzCanvas* canvas, DvzGraphics* graphics)
 /*  3D mesh                                                                                      */
 /*************************************************************************************************/
 
+static void _mesh_slots(DvzGraphics* graphics)
+{
+    _common_slots(graphics);
+    dvz_graphics_slot(graphics, DVZ_USER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    for (uint32_t i = 1; i <= 4; i++)
+        dvz_graphics_slot(
+            graphics, DVZ_USER_BINDING + i, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+}
+
 static void _graphics_mesh(DvzCanvas* canvas, DvzGraphics* graphics)
 {
-    SHADER(VERTEX, "graphics_mesh_vert")
+    SHADER_VERTEX("graphics_mesh")
     SHADER(FRAGMENT, "graphics_mesh_frag")
     PRIMITIVE(TRIANGLE_LIST)
     dvz_graphics_depth_test(graphics, DVZ_DEPTH_TEST_ENABLE);
@@ -628,12 +1053,32 @@ static void _graphics_mesh(DvzCanvas* canvas, DvzGraphics* graphics)
     ATTR(DvzGraphicsMeshVertex, VK_FORMAT_R32G32B32_SFLOAT, normal)
     ATTR(DvzGraphicsMeshVertex, VK_FORMAT_R32G32_SFLOAT, uv)
     ATTR(DvzGraphicsMeshVertex, VK_FORMAT_R8_UNORM, alpha)
+    if (SCALAR_COLOR)
+    {
+        // The scalar values replace the RGB colors packed in the tex coords.
+        ATTR_SCALAR
+    }
 
-    _common_slots(graphics);
-    dvz_graphics_slot(graphics, DVZ_USER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
-    for (uint32_t i = 1; i <= 4; i++)
-        dvz_graphics_slot(
-            graphics, DVZ_USER_BINDING + i, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+    _mesh_slots(graphics);
+    _scalar_color_slots(graphics, DVZ_USER_BINDING + 5);
+
+    CREATE
+}
+
+static void _graphics_mesh_quantized(DvzCanvas* canvas, DvzGraphics* graphics)
+{
+    SHADER(VERTEX, "graphics_mesh_quantized_vert")
+    SHADER(FRAGMENT, "graphics_mesh_frag")
+    PRIMITIVE(TRIANGLE_LIST)
+    dvz_graphics_depth_test(graphics, DVZ_DEPTH_TEST_ENABLE);
+
+    ATTR_BEGIN(DvzGraphicsMeshQuantizedVertex)
+    ATTR(DvzGraphicsMeshQuantizedVertex, VK_FORMAT_R16G16B16A16_SNORM, pos)
+    ATTR(DvzGraphicsMeshQuantizedVertex, VK_FORMAT_R16G16_SNORM, normal)
+    ATTR(DvzGraphicsMeshQuantizedVertex, VK_FORMAT_R16G16_SFLOAT, uv)
+    ATTR_COL(DvzGraphicsMeshQuantizedVertex, color)
+
+    _mesh_slots(graphics);
 
     CREATE
 }
@@ -734,7 +1179,7 @@ static DvzGraphics* _find_graphics(DvzCanvas* canvas, DvzGraphicsType type, int
 
     DvzContainerIterator iter = dvz_container_iterator(&canvas->graphics);
     DvzGraphics* graphics = NULL;
-    if (iter.item != NULL)
+    while (iter.item != NULL)
     {
         graphics = iter.item;
         if (graphics->type == type && graphics->flags == flags)
@@ -774,6 +1219,10 @@ DvzGraphics* dvz_graphics_builtin(DvzCanvas* canvas, DvzGraphicsType type, int f
         _graphics_point(canvas, graphics);
         break;
 
+    case DVZ_GRAPHICS_POINT_QUANTIZED:
+        _graphics_point_quantized(canvas, graphics);
+        break;
+
     case DVZ_GRAPHICS_LINE:
         _graphics_basic(canvas, graphics, VK_PRIMITIVE_TOPOLOGY_LINE_LIST);
         break;
@@ -808,6 +1257,22 @@ DvzGraphics* dvz_graphics_builtin(DvzCanvas* canvas, DvzGraphicsType type, int f
         _graphics_path(canvas, graphics);
         break;
 
+    case DVZ_GRAPHICS_MARKER_INSTANCED:
+        _graphics_marker_instanced(canvas, graphics);
+        break;
+
+    case DVZ_GRAPHICS_TEXT_INSTANCED:
+        _graphics_text_instanced(canvas, graphics);
+        break;
+
+    case DVZ_GRAPHICS_SEGMENT_PULL:
+        _graphics_segment_pull(canvas, graphics);
+        break;
+
+    case DVZ_GRAPHICS_PATH_PULL:
+        _graphics_path_pull(canvas, graphics);
+        break;
+
     case DVZ_GRAPHICS_TEXT:
         _graphics_text(canvas, graphics);
         break;
@@ -839,6 +1304,34 @@ DvzGraphics* dvz_graphics_builtin(DvzCanvas* canvas, DvzGraphicsType type, int f
         _graphics_mesh(canvas, graphics);
         break;
 
+    case DVZ_GRAPHICS_MESH_QUANTIZED:
+        _graphics_mesh_quantized(canvas, graphics);
+        break;
+
+        // Streaming
+    case DVZ_GRAPHICS_STREAM:
+        _graphics_stream(canvas, graphics);
+        break;
+
+        // Density
+    case DVZ_GRAPHICS_DENSITY:
+        _graphics_density(canvas, graphics);
+        break;
+
+        // Histogram
+    case DVZ_GRAPHICS_HISTOGRAM:
+        _graphics_histogram(canvas, graphics);
+        break;
+
+        // Axes
+    case DVZ_GRAPHICS_AXES_TICK:
+        _graphics_axes_tick(canvas, graphics);
+        break;
+
+    case DVZ_GRAPHICS_AXES_LABEL:
+        _graphics_axes_label(canvas, graphics);
+        break;
+
     case DVZ_GRAPHICS_CUSTOM:
         break;
 
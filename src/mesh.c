@@ -145,49 +145,280 @@ void dvz_mesh_normalize(DvzMesh* mesh)
 
 
 
-void dvz_mesh_normals(DvzMesh* mesh)
+// Minimum number of faces or vertices processed by each thread when computing the normals.
+#define DVZ_MESH_NORMALS_CHUNK_SIZE 16384
+
+typedef struct
 {
-    ASSERT(mesh != NULL);
-    log_debug("recompute mesh normals");
+    DvzMeshNormalsWeight weight;
+    uint32_t vertex_count;
+    uint32_t face_count;
+    const uint8_t* pos; // vec3 positions
+    VkDeviceSize pos_stride;
+    const DvzIndex* indices;
+    uint8_t* normals; // vec3 normals
+    VkDeviceSize normal_stride;
+
+    float* face_normals;       // 3 floats per face
+    float* corner_weights;     // angle of every face at each of its 3 corners, or NULL
+    atomic(uint32_t, *cursor); // number of corners of every vertex, then insertion cursor
+    uint32_t* offsets;         // first corner of every vertex, vertex_count + 1 items
+    uint32_t* corners;         // corners (3 * face + k) of every vertex, grouped by vertex
+} DvzMeshNormalsKernel;
+
+#define _POS(k, i)    ((const float*)((k)->pos + (VkDeviceSize)(i) * (k)->pos_stride))
+#define _NORMAL(k, i) ((float*)((k)->normals + (VkDeviceSize)(i) * (k)->normal_stride))
+
+// Angle between two vectors, more accurate than acos() for small angles.
+static inline float _vec_angle(const float* u, const float* v)
+{
+    float uu = u[0] * u[0] + u[1] * u[1] + u[2] * u[2];
+    float vv = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+    float dot = u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+    float cross2 = uu * vv - dot * dot;
+    return atan2f(sqrtf(MAX(cross2, 0)), dot);
+}
+
+// Normal of a face, unit length except with area weights (the length of the cross product is
+// twice the area of the face), and the angles at its corners with angle weights. Plain float
+// arithmetic on local arrays, that the compiler can vectorize.
+static inline void _face_normal(DvzMeshNormalsKernel* k, uint32_t face, float* n, float* angles)
+{
+    const DvzIndex* idx = &k->indices[3 * (uint64_t)face];
+    const float* p0 = _POS(k, idx[0]);
+    const float* p1 = _POS(k, idx[1]);
+    const float* p2 = _POS(k, idx[2]);
+
+    float u[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+    float v[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+    n[0] = u[1] * v[2] - u[2] * v[1];
+    n[1] = u[2] * v[0] - u[0] * v[2];
+    n[2] = u[0] * v[1] - u[1] * v[0];
+
+    if (k->weight != DVZ_MESH_NORMALS_AREA)
+    {
+        float norm = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        // Degenerate faces do not contribute to the vertex normals.
+        float a = norm > 0 ? 1 / norm : 0;
+        n[0] *= a;
+        n[1] *= a;
+        n[2] *= a;
+    }
+
+    if (angles != NULL)
+    {
+        float w[3] = {p2[0] - p1[0], p2[1] - p1[1], p2[2] - p1[2]};
+        angles[0] = _vec_angle(u, v);
+        angles[1] = (float)M_PI - _vec_angle(u, w);
+        angles[2] = (float)M_PI - angles[0] - angles[1];
+    }
+}
+
+// Face normals, and number of corners of every vertex.
+static void _mesh_face_normals(uint32_t item_first, uint32_t item_count, void* user_data)
+{
+    DvzMeshNormalsKernel* k = (DvzMeshNormalsKernel*)user_data;
+    ASSERT(k != NULL);
+
+    for (uint32_t i = item_first; i < item_first + item_count; i++)
+    {
+        _face_normal(
+            k, i, &k->face_normals[3 * (uint64_t)i],
+            k->corner_weights != NULL ? &k->corner_weights[3 * (uint64_t)i] : NULL);
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            ASSERT(k->indices[3 * (uint64_t)i + j] < k->vertex_count);
+            atomic_fetch_add_explicit(
+                &k->cursor[k->indices[3 * (uint64_t)i + j]], 1, memory_order_relaxed);
+        }
+    }
+}
+
+// Face-to-vertex adjacency in compressed sparse row format.
+static void _mesh_corners(uint32_t item_first, uint32_t item_count, void* user_data)
+{
+    DvzMeshNormalsKernel* k = (DvzMeshNormalsKernel*)user_data;
+    ASSERT(k != NULL);
+
+    uint32_t pos = 0;
+    for (uint32_t i = 3 * item_first; i < 3 * (item_first + item_count); i++)
+    {
+        pos = atomic_fetch_add_explicit(&k->cursor[k->indices[i]], 1, memory_order_relaxed);
+        k->corners[pos] = i;
+    }
+}
 
-    DvzIndex i0, i1, i2;
-    DvzGraphicsMeshVertex *v0, *v1, *v2;
-    vec3 u, v, n;
+// Every vertex gathers the normals of its faces, so that the threads never write to the same
+// vertex.
+static void _mesh_vertex_normals(uint32_t item_first, uint32_t item_count, void* user_data)
+{
+    DvzMeshNormalsKernel* k = (DvzMeshNormalsKernel*)user_data;
+    ASSERT(k != NULL);
 
-    uint32_t vertex_count = mesh->vertices.item_count;
-    uint32_t face_count = mesh->indices.item_count / 3;
+    for (uint32_t i = item_first; i < item_first + item_count; i++)
+    {
+        uint32_t* corners = &k->corners[k->offsets[i]];
+        uint32_t count = k->offsets[i + 1] - k->offsets[i];
+        // Vertices that do not belong to any face keep their normal.
+        if (count == 0)
+            continue;
+
+        // The corners were inserted in any order by the threads: sort them (there are only a few
+        // of them) so that the result does not depend on the thread scheduling.
+        for (uint32_t j = 1; j < count; j++)
+        {
+            uint32_t c = corners[j], l = j;
+            for (; l > 0 && corners[l - 1] > c; l--)
+                corners[l] = corners[l - 1];
+            corners[l] = c;
+        }
 
-    // Go through all triangle faces.
+        float n[3] = {0};
+        for (uint32_t j = 0; j < count; j++)
+        {
+            const float* fn = &k->face_normals[corners[j] - corners[j] % 3];
+            float w = k->corner_weights != NULL ? k->corner_weights[corners[j]] : 1;
+            n[0] += w * fn[0];
+            n[1] += w * fn[1];
+            n[2] += w * fn[2];
+        }
+
+        float norm = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        float a = norm > 0 ? 1 / norm : 0;
+        float* normal = _NORMAL(k, i);
+        normal[0] = a * n[0];
+        normal[1] = a * n[1];
+        normal[2] = a * n[2];
+    }
+}
+
+// Serial version, used when there are not enough faces or processors for several threads: the
+// face normals are directly added to the vertex normals.
+static void _mesh_normals_serial(DvzMeshNormalsKernel* k)
+{
+    ASSERT(k != NULL);
+    uint32_t vertex_count = k->vertex_count;
+    uint32_t face_count = k->face_count;
+
+    float* sums = calloc(vertex_count, sizeof(vec3));
+    bool* used = calloc(vertex_count, sizeof(bool));
+    float n[3] = {0}, angles[3] = {1, 1, 1};
+    bool angle = k->weight == DVZ_MESH_NORMALS_ANGLE;
+    DvzIndex v = 0;
     for (uint32_t i = 0; i < face_count; i++)
     {
-        i0 = ((DvzIndex*)mesh->indices.data)[3 * i + 0];
-        i1 = ((DvzIndex*)mesh->indices.data)[3 * i + 1];
-        i2 = ((DvzIndex*)mesh->indices.data)[3 * i + 2];
-
-        v0 = &((DvzGraphicsMeshVertex*)mesh->vertices.data)[i0];
-        v1 = &((DvzGraphicsMeshVertex*)mesh->vertices.data)[i1];
-        v2 = &((DvzGraphicsMeshVertex*)mesh->vertices.data)[i2];
-
-        glm_vec3_sub(v1->pos, v0->pos, u);
-        glm_vec3_sub(v2->pos, v0->pos, v);
-        // n is the normalized vector orthogonal to the current face
-        glm_vec3_crossn(u, v, n);
-
-        // Add the face normal to the current vertex normal.
-        glm_vec3_add(v0->normal, n, v0->normal);
-        glm_vec3_add(v1->normal, n, v1->normal);
-        glm_vec3_add(v2->normal, n, v2->normal);
+        _face_normal(k, i, n, angle ? angles : NULL);
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            v = k->indices[3 * (uint64_t)i + j];
+            ASSERT(v < vertex_count);
+            sums[3 * v + 0] += angles[j] * n[0];
+            sums[3 * v + 1] += angles[j] * n[1];
+            sums[3 * v + 2] += angles[j] * n[2];
+            used[v] = true;
+        }
     }
 
-    // Normalize all normals since every vertex might contain the sum of many normals.
-    vec4* normal = NULL;
+    float norm = 0, a = 0;
+    float* normal = NULL;
     for (uint32_t i = 0; i < vertex_count; i++)
     {
-        normal = &((DvzGraphicsMeshVertex*)dvz_array_item(&mesh->vertices, i))->normal;
-        glm_vec3_normalize(*normal);
+        if (!used[i])
+            continue;
+        norm = sqrtf(
+            sums[3 * i] * sums[3 * i] + sums[3 * i + 1] * sums[3 * i + 1] +
+            sums[3 * i + 2] * sums[3 * i + 2]);
+        a = norm > 0 ? 1 / norm : 0;
+        normal = _NORMAL(k, i);
+        normal[0] = a * sums[3 * i + 0];
+        normal[1] = a * sums[3 * i + 1];
+        normal[2] = a * sums[3 * i + 2];
     }
+
+    FREE(sums);
+    FREE(used);
 }
 
+void dvz_normals(
+    uint32_t vertex_count, const float* pos, VkDeviceSize pos_stride, //
+    uint32_t face_count, const DvzIndex* indices, DvzMeshNormalsWeight weight, float* normals,
+    VkDeviceSize normal_stride)
+{
+    ASSERT(pos != NULL);
+    ASSERT(normals != NULL);
+    if (vertex_count == 0 || face_count == 0)
+        return;
+    ASSERT(indices != NULL);
+    log_debug("compute the normals of %d vertices and %d faces", vertex_count, face_count);
+
+    DvzMeshNormalsKernel k = {0};
+    k.weight = weight;
+    k.vertex_count = vertex_count;
+    k.face_count = face_count;
+    k.pos = (const uint8_t*)pos;
+    k.pos_stride = pos_stride > 0 ? pos_stride : sizeof(vec3);
+    k.indices = indices;
+    k.normals = (uint8_t*)normals;
+    k.normal_stride = normal_stride > 0 ? normal_stride : sizeof(vec3);
+
+    // The parallel version has a higher total cost (the adjacency table), it is only worth it
+    // with several threads.
+    if (dvz_num_procs() <= 1 || face_count < 2 * DVZ_MESH_NORMALS_CHUNK_SIZE)
+    {
+        _mesh_normals_serial(&k);
+        return;
+    }
+
+    // Face normals and corner counts, in parallel.
+    k.face_normals = calloc(face_count, sizeof(vec3));
+    if (weight == DVZ_MESH_NORMALS_ANGLE)
+        k.corner_weights = calloc(3 * (uint64_t)face_count, sizeof(float));
+    k.cursor = calloc(vertex_count, sizeof(*k.cursor));
+    dvz_parallel(face_count, DVZ_MESH_NORMALS_CHUNK_SIZE, _mesh_face_normals, &k);
+
+    // Prefix sum of the corner counts.
+    k.offsets = calloc(vertex_count + 1, sizeof(uint32_t));
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < vertex_count; i++)
+    {
+        count = atomic_load_explicit(&k.cursor[i], memory_order_relaxed);
+        k.offsets[i + 1] = k.offsets[i] + count;
+        atomic_store_explicit(&k.cursor[i], k.offsets[i], memory_order_relaxed);
+    }
+    ASSERT(k.offsets[vertex_count] == 3 * face_count);
+
+    // Face-to-vertex adjacency, then vertex normals, in parallel.
+    k.corners = calloc(3 * (uint64_t)face_count, sizeof(uint32_t));
+    dvz_parallel(face_count, DVZ_MESH_NORMALS_CHUNK_SIZE, _mesh_corners, &k);
+    dvz_parallel(vertex_count, DVZ_MESH_NORMALS_CHUNK_SIZE, _mesh_vertex_normals, &k);
+
+    FREE(k.face_normals);
+    FREE(k.corner_weights);
+    FREE(k.cursor);
+    FREE(k.offsets);
+    FREE(k.corners);
+}
+
+
+
+void dvz_mesh_normals_weighted(DvzMesh* mesh, DvzMeshNormalsWeight weight)
+{
+    ASSERT(mesh != NULL);
+    log_debug("recompute mesh normals");
+
+    DvzGraphicsMeshVertex* vertices = (DvzGraphicsMeshVertex*)mesh->vertices.data;
+    if (vertices == NULL)
+        return;
+    dvz_normals(
+        mesh->vertices.item_count, vertices[0].pos, sizeof(DvzGraphicsMeshVertex),
+        mesh->indices.item_count / 3, (const DvzIndex*)mesh->indices.data, weight,
+        vertices[0].normal, sizeof(DvzGraphicsMeshVertex));
+}
+
+
+
+void dvz_mesh_normals(DvzMesh* mesh) { dvz_mesh_normals_weighted(mesh, DVZ_MESH_NORMALS_UNIFORM); }
+
 
 
 /*************************************************************************************************/
@@ -0,0 +1,768 @@
+#include "../include/datoviz/array.h"
+#include "../include/datoviz/colormaps.h"
+#include "../include/datoviz/common.h"
+#include "../include/datoviz/mesh.h"
+
+#include <sys/stat.h>
+
+// Number of bytes of OBJ text parsed by every task.
+#define DVZ_OBJ_BLOCK_SIZE 4194304
+// Minimum number of vertices or chunks processed by each thread when writing a mesh file.
+#define DVZ_MESH_FILE_TASK_SIZE 16384
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+static inline uint64_t _align(uint64_t offset)
+{
+    return (offset + DVZ_MESH_FILE_ALIGNMENT - 1) / DVZ_MESH_FILE_ALIGNMENT *
+           DVZ_MESH_FILE_ALIGNMENT;
+}
+
+
+
+// Key of an OBJ file: its path, size and modification time, and the mesh file format.
+static uint64_t _obj_key(const char* file_path, int flags)
+{
+    ASSERT(file_path != NULL);
+    struct stat st;
+    if (stat(file_path, &st) != 0)
+        return 0;
+
+    uint64_t h = DVZ_HASH_SEED;
+    uint32_t version = DVZ_MESH_FILE_VERSION;
+    int64_t size = (int64_t)st.st_size;
+    int64_t mtime = (int64_t)st.st_mtime;
+    h = dvz_hash(h, &version, sizeof(version));
+    h = dvz_hash(h, &flags, sizeof(flags));
+    h = dvz_hash(h, file_path, strlen(file_path));
+    h = dvz_hash(h, &size, sizeof(size));
+    h = dvz_hash(h, &mtime, sizeof(mtime));
+    // NOTE: 0 means that there is no source file.
+    return h != 0 ? h : 1;
+}
+
+
+
+/*************************************************************************************************/
+/*  OBJ parser                                                                                   */
+/*************************************************************************************************/
+
+typedef struct DvzObjCounts DvzObjCounts;
+typedef struct DvzObjParser DvzObjParser;
+
+// Number of elements of each kind in a block of OBJ text, then index of the first element of
+// each kind of the block.
+struct DvzObjCounts
+{
+    uint32_t positions;
+    uint32_t normals;
+    uint32_t texcoords;
+    uint32_t triangles;
+};
+
+struct DvzObjParser
+{
+    const char* text;
+    uint32_t block_count;
+    uint64_t* block_starts; // offset of each block in the text, block_count + 1 items
+    DvzObjCounts* counts;   // one item per block
+    DvzObjCounts total;
+
+    DvzGraphicsMeshVertex* vertices;
+    DvzIndex* indices;
+    atomic(uint32_t, invalid); // number of invalid vertex indices and positions
+};
+
+
+
+static inline bool _obj_space(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+static inline const char* _obj_skip(const char* p, const char* end)
+{
+    while (p < end && _obj_space(*p))
+        p++;
+    return p;
+}
+
+static inline const char* _obj_token_end(const char* p, const char* end)
+{
+    while (p < end && !_obj_space(*p) && *p != '\n')
+        p++;
+    return p;
+}
+
+// Number of whitespace-separated tokens until the end of the line or a trailing comment, so that
+// the number of triangles of the faces matches the parsing pass.
+static inline uint32_t _obj_token_count(const char* p, const char* end)
+{
+    uint32_t count = 0;
+    while ((p = _obj_skip(p, end)) < end && *p != '\n' && *p != '#')
+    {
+        p = _obj_token_end(p, end);
+        count++;
+    }
+    return count;
+}
+
+
+
+// Parse a decimal number bounded by the end of the text (strtof() requires a null-terminated
+// string, which a mapped file is not).
+static bool _obj_float(const char** ptr, const char* end, float* out)
+{
+    static const double POW10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                   1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                   1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char* p = _obj_skip(*ptr, end);
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        neg = *p++ == '-';
+
+    uint64_t mantissa = 0;
+    int32_t exponent = 0, digits = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++, digits++)
+    {
+        if (mantissa < 100000000000000000ull)
+            mantissa = 10 * mantissa + (uint64_t)(*p - '0');
+        else
+            exponent++;
+    }
+    if (p < end && *p == '.')
+    {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++, digits++)
+        {
+            if (mantissa < 100000000000000000ull)
+            {
+                mantissa = 10 * mantissa + (uint64_t)(*p - '0');
+                exponent--;
+            }
+        }
+    }
+    if (digits == 0)
+        return false;
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char* q = p + 1;
+        bool eneg = false;
+        if (q < end && (*q == '-' || *q == '+'))
+            eneg = *q++ == '-';
+        int32_t e = 0;
+        const char* q0 = q;
+        for (; q < end && *q >= '0' && *q <= '9'; q++)
+            e = MIN(10 * e + (*q - '0'), 10000);
+        if (q > q0)
+        {
+            exponent += eneg ? -e : e;
+            p = q;
+        }
+    }
+
+    double value = (double)mantissa;
+    if (exponent < 0)
+        value = -exponent <= 22 ? value / POW10[-exponent] : value * pow(10, exponent);
+    else if (exponent > 0)
+        value = exponent <= 22 ? value * POW10[exponent] : value * pow(10, exponent);
+    *out = (float)(neg ? -value : value);
+    *ptr = p;
+    return true;
+}
+
+static bool _obj_int(const char** ptr, const char* end, int64_t* out)
+{
+    const char* p = _obj_skip(*ptr, end);
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        neg = *p++ == '-';
+    const char* p0 = p;
+    int64_t value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++)
+        value = MIN(10 * value + (*p - '0'), (int64_t)UINT32_MAX + 1);
+    if (p == p0)
+        return false;
+    *out = neg ? -value : value;
+    *ptr = p;
+    return true;
+}
+
+
+
+// Kind of an OBJ line: v, vn, vt, f, or 0 for the ignored lines (comments, groups, materials...).
+static inline char _obj_line_kind(const char** ptr, const char* end)
+{
+    const char* p = _obj_skip(*ptr, end);
+    char kind = 0;
+    if (p + 1 < end && p[0] == 'v' && _obj_space(p[1]))
+        kind = 'v';
+    else if (p + 2 < end && p[0] == 'v' && p[1] == 'n' && _obj_space(p[2]))
+        kind = 'n';
+    else if (p + 2 < end && p[0] == 'v' && p[1] == 't' && _obj_space(p[2]))
+        kind = 't';
+    else if (p + 1 < end && p[0] == 'f' && _obj_space(p[1]))
+        kind = 'f';
+    *ptr = kind == 'v' || kind == 'f' ? p + 1 : kind != 0 ? p + 2 : p;
+    return kind;
+}
+
+static inline const char* _obj_next_line(const char* p, const char* end)
+{
+    const char* eol = (const char*)memchr(p, '\n', (size_t)(end - p));
+    return eol != NULL ? eol + 1 : end;
+}
+
+
+
+// First pass: count the elements of every block.
+static void _obj_count(uint32_t item_first, uint32_t item_count, void* user_data)
+{
+    DvzObjParser* parser = (DvzObjParser*)user_data;
+    ASSERT(parser != NULL);
+
+    for (uint32_t i = item_first; i < item_first + item_count; i++)
+    {
+        const char* p = parser->text + parser->block_starts[i];
+        const char* end = parser->text + parser->block_starts[i + 1];
+        DvzObjCounts counts = {0};
+        uint32_t n = 0;
+        for (; p < end; p = _obj_next_line(p, end))
+        {
+            switch (_obj_line_kind(&p, end))
+            {
+            case 'v':
+                counts.positions++;
+                break;
+            case 'n':
+                counts.normals++;
+                break;
+            case 't':
+                counts.texcoords++;
+                break;
+            case 'f':
+                n = _obj_token_count(p, end);
+                counts.triangles += n >= 3 ? n - 2 : 0;
+                break;
+            default:
+                break;
+            }
+        }
+        parser->counts[i] = counts;
+    }
+}
+
+
+
+// Vertex index of a face vertex (v, v/vt, v//vn or v/vt/vn), negative indices are relative to
+// the last position.
+static inline DvzIndex _obj_vertex_index(DvzObjParser* parser, int64_t index, uint32_t position)
+{
+    int64_t idx = index < 0 ? (int64_t)position + index : index - 1;
+    if (idx < 0 || idx >= parser->total.positions)
+    {
+        atomic_fetch_add_explicit(&parser->invalid, 1, memory_order_relaxed);
+        return 0;
+    }
+    return (DvzIndex)idx;
+}
+
+// Second pass: parse every block, and write its elements directly at their final location.
+static void _obj_parse(uint32_t item_first, uint32_t item_count, void* user_data)
+{
+    DvzObjParser* parser = (DvzObjParser*)user_data;
+    ASSERT(parser != NULL);
+    const uint32_t nv = parser->total.positions;
+    const bool use_colors = parser->total.texcoords == 0;
+
+    for (uint32_t i = item_first; i < item_first + item_count; i++)
+    {
+        const char* p = parser->text + parser->block_starts[i];
+        const char* end = parser->text + parser->block_starts[i + 1];
+        DvzObjCounts cur = parser->counts[i]; // index of the next element of each kind
+
+        float x[6] = {0};
+        int64_t index = 0;
+        DvzIndex face[3] = {0};
+        DvzGraphicsMeshVertex* vertex = NULL;
+        uint32_t n = 0;
+        cvec3 color = {0};
+
+        for (; p < end; p = _obj_next_line(p, end))
+        {
+            switch (_obj_line_kind(&p, end))
+            {
+
+            case 'v':
+                vertex = &parser->vertices[cur.positions++];
+                n = 0;
+                while (n < 6 && _obj_float(&p, end, &x[n]))
+                    n++;
+                // Missing coordinates are set to 0 rather than kept from the previous position.
+                if (n < 3)
+                {
+                    atomic_fetch_add_explicit(&parser->invalid, 1, memory_order_relaxed);
+                    memset(&x[n], 0, (3 - n) * sizeof(float));
+                }
+                vertex->pos[0] = x[0];
+                vertex->pos[1] = x[1];
+                vertex->pos[2] = x[2];
+                vertex->alpha = 255;
+                // Optional vertex colors, after the position.
+                if (n == 6 && use_colors)
+                {
+                    color[0] = TO_BYTE(x[3]);
+                    color[1] = TO_BYTE(x[4]);
+                    color[2] = TO_BYTE(x[5]);
+                    dvz_colormap_packuv(color, vertex->uv);
+                }
+                break;
+
+            // NOTE: the normals and tex coords are associated to the vertex with the same index.
+            case 'n':
+                if (cur.normals < nv)
+                {
+                    vertex = &parser->vertices[cur.normals];
+                    for (n = 0; n < 3 && _obj_float(&p, end, &vertex->normal[n]); n++)
+                        ;
+                }
+                cur.normals++;
+                break;
+
+            case 't':
+                if (cur.texcoords < nv)
+                {
+                    vertex = &parser->vertices[cur.texcoords];
+                    for (n = 0; n < 2 && _obj_float(&p, end, &vertex->uv[n]); n++)
+                        ;
+                }
+                cur.texcoords++;
+                break;
+
+            // Faces with more than 3 vertices are triangulated as fans around their first vertex.
+            case 'f':
+                for (n = 0; _obj_int(&p, end, &index); n++)
+                {
+                    face[MIN(n, 2)] = _obj_vertex_index(parser, index, cur.positions);
+                    // Skip the tex coord and normal indices.
+                    p = _obj_token_end(p, end);
+                    if (n < 2)
+                        continue;
+                    memcpy(&parser->indices[3 * (uint64_t)cur.triangles++], face, sizeof(face));
+                    face[1] = face[2];
+                }
+                break;
+
+            default:
+                break;
+            }
+        }
+    }
+}
+
+
+
+DvzMesh dvz_mesh_obj_parse(const char* file_path)
+{
+    ASSERT(file_path != NULL);
+    log_trace("parsing OBJ file %s", file_path);
+    DvzMesh mesh = dvz_mesh();
+
+    DvzMappedFile file = dvz_map_file(file_path);
+    if (file.data == NULL)
+    {
+        log_error("error loading obj file %s", file_path);
+        return mesh;
+    }
+
+    // Split the text in blocks of whole lines.
+    DvzObjParser parser = {0};
+    parser.text = (const char*)file.data;
+    uint64_t size = file.size;
+    parser.block_count = (uint32_t)((size + DVZ_OBJ_BLOCK_SIZE - 1) / DVZ_OBJ_BLOCK_SIZE);
+    parser.block_starts = (uint64_t*)calloc(parser.block_count + 1, sizeof(uint64_t));
+    parser.counts = (DvzObjCounts*)calloc(parser.block_count, sizeof(DvzObjCounts));
+    for (uint32_t i = 1; i < parser.block_count; i++)
+    {
+        uint64_t start = MAX(i * (uint64_t)DVZ_OBJ_BLOCK_SIZE, parser.block_starts[i - 1]);
+        parser.block_starts[i] =
+            (uint64_t)(_obj_next_line(parser.text + start, parser.text + size) - parser.text);
+    }
+    parser.block_starts[parser.block_count] = size;
+
+    // Count the elements of each block in parallel, then index of the first element of each kind
+    // of every block.
+    dvz_parallel(parser.block_count, 1, _obj_count, &parser);
+    DvzObjCounts counts = {0};
+    for (uint32_t i = 0; i < parser.block_count; i++)
+    {
+        counts = parser.counts[i];
+        parser.counts[i] = parser.total;
+        parser.total.positions += counts.positions;
+        parser.total.normals += counts.normals;
+        parser.total.texcoords += counts.texcoords;
+        parser.total.triangles += counts.triangles;
+    }
+
+    uint32_t nv = parser.total.positions;
+    uint32_t ni = 3 * parser.total.triangles;
+    log_debug("loading OBJ file %s: %d vertices, %d indices", file_path, nv, ni);
+    if (nv == 0 || ni == 0)
+    {
+        log_error("empty OBJ file %s", file_path);
+        goto end;
+    }
+
+    // Parse all blocks in parallel.
+    dvz_array_resize(&mesh.vertices, nv);
+    dvz_array_resize(&mesh.indices, ni);
+    memset(mesh.vertices.data, 0, mesh.vertices.buffer_size);
+    parser.vertices = (DvzGraphicsMeshVertex*)mesh.vertices.data;
+    parser.indices = (DvzIndex*)mesh.indices.data;
+    atomic_init(&parser.invalid, 0);
+    dvz_parallel(parser.block_count, 1, _obj_parse, &parser);
+    if (atomic_load(&parser.invalid) > 0)
+        log_warn(
+            "%d invalid vertex indices or positions in OBJ file %s", atomic_load(&parser.invalid),
+            file_path);
+
+    // Compute the normals if the file does not have one normal per vertex.
+    if (parser.total.normals < nv)
+        dvz_mesh_normals(&mesh);
+
+    // Mesh normalization.
+    dvz_mesh_normalize(&mesh);
+
+end:
+    FREE(parser.block_starts);
+    FREE(parser.counts);
+    dvz_unmap_file(&file);
+    return mesh;
+}
+
+
+
+/*************************************************************************************************/
+/*  Mesh files                                                                                   */
+/*************************************************************************************************/
+
+typedef struct
+{
+    DvzMesh* mesh;
+    DvzGraphicsMeshQuantizedVertex* quantized;
+    DvzMeshChunk* chunks;
+    uint32_t chunk_size;
+} DvzMeshFileKernel;
+
+static void _mesh_quantize(uint32_t item_first, uint32_t item_count, void* user_data)
+{
+    DvzMeshFileKernel* k = (DvzMeshFileKernel*)user_data;
+    ASSERT(k != NULL);
+    DvzGraphicsMeshVertex* vertices = (DvzGraphicsMeshVertex*)k->mesh->vertices.data;
+
+    for (uint32_t i = item_first; i < item_first + item_count; i++)
+    {
+        DvzGraphicsMeshVertex* v = &vertices[i];
+        DvzGraphicsMeshQuantizedVertex* q = &k->quantized[i];
+        for (uint32_t j = 0; j < 3; j++)
+            q->pos[j] = _snorm16(v->pos[j]);
+        q->pos[3] = 0;
+        _oct16(v->normal, q->normal);
+        q->color[0] = q->color[1] = q->color[2] = 0;
+        q->color[3] = v->alpha;
+        if (v->uv[1] < 0)
+        {
+            // Unpack the RGB color packed by dvz_colormap_packuv(), half floats cannot hold it.
+            uint32_t rgb = (uint32_t)v->uv[0];
+            q->color[0] = rgb & 0xff;
+            q->color[1] = (rgb >> 8) & 0xff;
+            q->color[2] = (rgb >> 16) & 0xff;
+            q->uv[0] = _half(0);
+            q->uv[1] = _half(-1);
+        }
+        else
+        {
+            q->uv[0] = _half(v->uv[0]);
+            q->uv[1] = _half(v->uv[1]);
+        }
+    }
+}
+
+static void _mesh_chunk_bounds(uint32_t item_first, uint32_t item_count, void* user_data)
+{
+    DvzMeshFileKernel* k = (DvzMeshFileKernel*)user_data;
+    ASSERT(k != NULL);
+    DvzGraphicsMeshVertex* vertices = (DvzGraphicsMeshVertex*)k->mesh->vertices.data;
+    DvzIndex* indices = (DvzIndex*)k->mesh->indices.data;
+    uint64_t index_count = k->mesh->indices.item_count;
+
+    for (uint32_t i = item_first; i < item_first + item_count; i++)
+    {
+        DvzMeshChunk* chunk = &k->chunks[i];
+        glm_vec3_fill(chunk->box_min, +INFINITY);
+        glm_vec3_fill(chunk->box_max, -INFINITY);
+        uint64_t first = 3 * (uint64_t)i * k->chunk_size;
+        uint64_t last = MIN(first + 3 * (uint64_t)k->chunk_size, index_count);
+        for (uint64_t j = first; j < last; j++)
+        {
+            glm_vec3_minv(chunk->box_min, vertices[indices[j]].pos, chunk->box_min);
+            glm_vec3_maxv(chunk->box_max, vertices[indices[j]].pos, chunk->box_max);
+        }
+    }
+}
+
+static void _mesh_file_pad(FILE* f, uint64_t offset)
+{
+    static const uint8_t zeros[DVZ_MESH_FILE_ALIGNMENT] = {0};
+    fwrite(zeros, 1, (size_t)(_align(offset) - offset), f);
+}
+
+static int _mesh_write(DvzMesh* mesh, const char* file_path, int flags, uint64_t key)
+{
+    ASSERT(mesh != NULL);
+    ASSERT(file_path != NULL);
+    bool quantized = (flags & DVZ_MESH_FILE_FLAGS_QUANTIZED) != 0;
+    uint32_t vertex_count = mesh->vertices.item_count;
+    uint32_t face_count = mesh->indices.item_count / 3;
+
+    DvzMeshFileHeader header = {0};
+    header.magic = DVZ_MESH_FILE_MAGIC;
+    header.version = DVZ_MESH_FILE_VERSION;
+    header.flags = (uint32_t)flags;
+    header.vertex_size = quantized ? sizeof(DvzGraphicsMeshQuantizedVertex)
+                                   : sizeof(DvzGraphicsMeshVertex);
+    header.key = key;
+    header.vertex_count = vertex_count;
+    header.index_count = 3 * face_count;
+    header.chunk_size = DVZ_MESH_FILE_CHUNK;
+    header.chunk_count = (face_count + DVZ_MESH_FILE_CHUNK - 1) / DVZ_MESH_FILE_CHUNK;
+    header.vertex_offset = _align(sizeof(DvzMeshFileHeader));
+    header.index_offset =
+        _align(header.vertex_offset + (uint64_t)vertex_count * header.vertex_size);
+    header.chunk_offset = _align(header.index_offset + header.index_count * sizeof(DvzIndex));
+    header.file_size = header.chunk_offset + header.chunk_count * sizeof(DvzMeshChunk);
+
+    // Quantized vertices and chunk bounds, in parallel.
+    DvzMeshFileKernel k = {0};
+    k.mesh = mesh;
+    k.chunk_size = header.chunk_size;
+    k.chunks = (DvzMeshChunk*)calloc(MAX(header.chunk_count, 1), sizeof(DvzMeshChunk));
+    dvz_parallel(header.chunk_count, 1, _mesh_chunk_bounds, &k);
+    if (quantized)
+    {
+        k.quantized = (DvzGraphicsMeshQuantizedVertex*)calloc(
+            MAX(vertex_count, 1), sizeof(DvzGraphicsMeshQuantizedVertex));
+        dvz_parallel(vertex_count, DVZ_MESH_FILE_TASK_SIZE, _mesh_quantize, &k);
+    }
+
+    // The file is written under a temporary name first, so that another process never maps a
+    // partially written file.
+    char tmp_path[1024 + 8];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", file_path);
+    FILE* f = fopen(tmp_path, "wb");
+    int res = 1;
+    if (f == NULL)
+    {
+        log_warn("could not write mesh file %s", tmp_path);
+        goto end;
+    }
+    fwrite(&header, sizeof(DvzMeshFileHeader), 1, f);
+    _mesh_file_pad(f, sizeof(DvzMeshFileHeader));
+    fwrite(
+        quantized ? (const void*)k.quantized : mesh->vertices.data, header.vertex_size,
+        vertex_count, f);
+    _mesh_file_pad(f, header.vertex_offset + (uint64_t)vertex_count * header.vertex_size);
+    fwrite(mesh->indices.data, sizeof(DvzIndex), header.index_count, f);
+    _mesh_file_pad(f, header.index_offset + header.index_count * sizeof(DvzIndex));
+    fwrite(k.chunks, sizeof(DvzMeshChunk), header.chunk_count, f);
+
+    res = ferror(f) ? 1 : 0;
+    fclose(f);
+    if (res == 0)
+    {
+        remove(file_path);
+        res = rename(tmp_path, file_path) != 0 ? 1 : 0;
+    }
+    if (res != 0)
+    {
+        log_warn("error while writing mesh file %s", file_path);
+        remove(tmp_path);
+        goto end;
+    }
+    log_debug("wrote mesh file %s with %d vertices", file_path, vertex_count);
+
+end:
+    FREE(k.chunks);
+    FREE(k.quantized);
+    return res;
+}
+
+
+
+int dvz_mesh_save(DvzMesh* mesh, const char* file_path, int flags)
+{
+    return _mesh_write(mesh, file_path, flags, 0);
+}
+
+
+
+DvzMeshFile dvz_mesh_file(const char* file_path)
+{
+    ASSERT(file_path != NULL);
+    DvzMeshFile mf = {0};
+    mf.file = dvz_map_file(file_path);
+    if (mf.file.data == NULL)
+        return mf;
+
+    // Check the header and the location of the blocks, a truncated or corrupted file is
+    // discarded. The blocks themselves are not read.
+    const DvzMeshFileHeader* h = (const DvzMeshFileHeader*)mf.file.data;
+    const uint64_t size = mf.file.size;
+    bool quantized = size >= sizeof(DvzMeshFileHeader) &&
+                     (h->flags & DVZ_MESH_FILE_FLAGS_QUANTIZED) != 0;
+    bool ok = size >= sizeof(DvzMeshFileHeader) && h->magic == DVZ_MESH_FILE_MAGIC &&
+              h->version == DVZ_MESH_FILE_VERSION && h->file_size == size &&
+              h->vertex_size == (quantized ? sizeof(DvzGraphicsMeshQuantizedVertex)
+                                           : sizeof(DvzGraphicsMeshVertex)) &&
+              h->index_count % 3 == 0 && h->chunk_size > 0 &&
+              h->chunk_count == (h->index_count / 3 + h->chunk_size - 1) / h->chunk_size &&
+              h->vertex_offset % DVZ_MESH_FILE_ALIGNMENT == 0 &&
+              h->index_offset % DVZ_MESH_FILE_ALIGNMENT == 0 &&
+              h->chunk_offset % DVZ_MESH_FILE_ALIGNMENT == 0 &&
+              h->vertex_offset >= sizeof(DvzMeshFileHeader) &&
+              h->index_offset >= h->vertex_offset + (uint64_t)h->vertex_count * h->vertex_size &&
+              h->chunk_offset >= h->index_offset + (uint64_t)h->index_count * sizeof(DvzIndex) &&
+              size >= h->chunk_offset + (uint64_t)h->chunk_count * sizeof(DvzMeshChunk);
+    if (!ok)
+    {
+        log_warn("ignore invalid mesh file %s", file_path);
+        dvz_unmap_file(&mf.file);
+        return mf;
+    }
+
+    const uint8_t* data = (const uint8_t*)mf.file.data;
+    mf.header = h;
+    mf.vertices = data + h->vertex_offset;
+    mf.indices = (const DvzIndex*)(data + h->index_offset);
+    mf.chunks = (const DvzMeshChunk*)(data + h->chunk_offset);
+    return mf;
+}
+
+
+
+DvzMesh dvz_mesh_file_mesh(DvzMeshFile* file)
+{
+    ASSERT(file != NULL);
+    DvzMesh mesh = dvz_mesh();
+    if (file->header == NULL)
+        return mesh;
+    if ((file->header->flags & DVZ_MESH_FILE_FLAGS_QUANTIZED) != 0)
+    {
+        log_error("quantized mesh files can only be uploaded to the GPU as such");
+        return mesh;
+    }
+
+    dvz_array_resize(&mesh.vertices, file->header->vertex_count);
+    dvz_array_resize(&mesh.indices, file->header->index_count);
+    if (mesh.vertices.item_count > 0)
+        memcpy(mesh.vertices.data, file->vertices, mesh.vertices.buffer_size);
+    if (mesh.indices.item_count > 0)
+        memcpy(mesh.indices.data, file->indices, mesh.indices.buffer_size);
+    return mesh;
+}
+
+
+
+void dvz_mesh_file_close(DvzMeshFile* file)
+{
+    ASSERT(file != NULL);
+    dvz_unmap_file(&file->file);
+    memset(file, 0, sizeof(DvzMeshFile));
+}
+
+
+
+/*************************************************************************************************/
+/*  OBJ import                                                                                   */
+/*************************************************************************************************/
+
+// Open the mesh file of an OBJ file if it exists and is up to date.
+static DvzMeshFile _obj_cached(uint64_t key, const char* cache_path)
+{
+    DvzMeshFile mf = {0};
+    struct stat st;
+    if (key == 0 || stat(cache_path, &st) != 0)
+        return mf;
+    mf = dvz_mesh_file(cache_path);
+    if (mf.header != NULL && mf.header->key != key)
+    {
+        log_warn("ignore outdated mesh file %s", cache_path);
+        dvz_mesh_file_close(&mf);
+    }
+    return mf;
+}
+
+
+
+DvzMeshFile dvz_mesh_obj_file(const char* file_path, const char* cache_dir, int flags)
+{
+    ASSERT(file_path != NULL);
+    DvzMeshFile mf = {0};
+    uint64_t key = _obj_key(file_path, flags);
+    char cache_path[1024] = {0};
+    if (key == 0)
+    {
+        log_error("OBJ file %s not found", file_path);
+        return mf;
+    }
+    if (!dvz_cache_path(cache_dir, "mesh", key, cache_path, sizeof(cache_path)))
+    {
+        log_warn("the disk cache is disabled, no mesh file for %s", file_path);
+        return mf;
+    }
+
+    // Subsequent loads: the mesh file is mapped, without any parsing.
+    mf = _obj_cached(key, cache_path);
+    if (mf.header != NULL)
+    {
+        log_debug("loaded mesh file %s", cache_path);
+        return mf;
+    }
+
+    // First import.
+    DvzMesh mesh = dvz_mesh_obj_parse(file_path);
+    if (mesh.indices.item_count > 0 && _mesh_write(&mesh, cache_path, flags, key) == 0)
+        mf = dvz_mesh_file(cache_path);
+    dvz_mesh_destroy(&mesh);
+    return mf;
+}
+
+
+
+DvzMesh dvz_mesh_obj(const char* file_path)
+{
+    ASSERT(file_path != NULL);
+    log_trace("loading file %s", file_path);
+
+    uint64_t key = _obj_key(file_path, 0);
+    char cache_path[1024] = {0};
+    bool use_cache = key != 0 && dvz_cache_path(NULL, "mesh", key, cache_path, sizeof(cache_path));
+
+    // OBJ files loaded in a previous session are read from their mesh file.
+    if (use_cache)
+    {
+        DvzMeshFile mf = _obj_cached(key, cache_path);
+        if (mf.header != NULL)
+        {
+            log_debug("loaded mesh file %s", cache_path);
+            DvzMesh mesh = dvz_mesh_file_mesh(&mf);
+            dvz_mesh_file_close(&mf);
+            return mesh;
+        }
+    }
+
+    DvzMesh mesh = dvz_mesh_obj_parse(file_path);
+    if (use_cache && mesh.indices.item_count > 0)
+        _mesh_write(&mesh, cache_path, 0, key);
+    return mesh;
+}
@@ -0,0 +1,684 @@
+#include "../include/datoviz/octree.h"
+#include "../include/datoviz/array.h"
+#include "../include/datoviz/common.h"
+
+#include <float.h>
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+// 64-bit file offsets, as the files of large point clouds exceed 2 GB.
+static int _octree_seek(FILE* f, uint64_t offset)
+{
+#if OS_WIN32
+    return _fseeki64(f, (int64_t)offset, SEEK_SET);
+#else
+    return fseeko(f, (off_t)offset, SEEK_SET);
+#endif
+}
+
+
+
+// Octant of a point relative to the center of a node, bit i is set for the upper half of axis i.
+static inline uint8_t _octree_octant(vec3 center, vec3 p)
+{
+    return (uint8_t)((p[0] >= center[0]) | ((p[1] >= center[1]) << 1) |
+                     ((p[2] >= center[2]) << 2));
+}
+
+
+
+static inline float _octree_dot(vec4 plane, vec3 p)
+{
+    return plane[0] * p[0] + plane[1] * p[1] + plane[2] * p[2] + plane[3];
+}
+
+
+
+static inline float _octree_norm(vec4 plane)
+{
+    return sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+}
+
+
+
+/*************************************************************************************************/
+/*  Build                                                                                        */
+/*************************************************************************************************/
+
+typedef struct DvzOctreeRange DvzOctreeRange;
+typedef struct DvzOctreeBuilder DvzOctreeBuilder;
+
+// Range of the permutation array covered by a node during the build. After the split, the range
+// starts with the points kept in the node, followed by the remaining points sorted by octant.
+struct DvzOctreeRange
+{
+    uint32_t first;
+    uint32_t count;
+    uint32_t kept;
+    uint32_t octants[8];
+};
+
+struct DvzOctreeBuilder
+{
+    dvec3* pos;
+    dvec3 center; // center of the bounding cube
+    double half;  // half size of the bounding cube
+    uint32_t capacity;
+    uint32_t* perm; // permutation of the points
+
+    uint32_t node_count;
+    uint32_t node_alloc;
+    DvzOctreeNode* nodes;
+    DvzOctreeRange* ranges;
+    uint32_t level_first; // first node of the level being split
+};
+
+
+
+static inline void _octree_normalize(DvzOctreeBuilder* b, uint32_t i, vec3 out)
+{
+    for (uint32_t j = 0; j < 3; j++)
+        out[j] = (float)((b->pos[i][j] - b->center[j]) / b->half);
+}
+
+
+
+static uint32_t _octree_node_add(
+    DvzOctreeBuilder* b, vec3 center, float half_size, uint32_t depth, uint32_t first,
+    uint32_t count)
+{
+    ASSERT(b != NULL);
+    if (b->node_count == b->node_alloc)
+    {
+        b->node_alloc = MAX(64, 2 * b->node_alloc);
+        REALLOC(b->nodes, b->node_alloc * sizeof(DvzOctreeNode));
+        REALLOC(b->ranges, b->node_alloc * sizeof(DvzOctreeRange));
+    }
+    uint32_t idx = b->node_count++;
+
+    DvzOctreeNode* node = &b->nodes[idx];
+    memset(node, 0, sizeof(DvzOctreeNode));
+    glm_vec3_copy(center, node->center);
+    node->half_size = half_size;
+    node->depth = depth;
+    memset(node->children, 0xFF, sizeof(node->children));
+
+    DvzOctreeRange* range = &b->ranges[idx];
+    memset(range, 0, sizeof(DvzOctreeRange));
+    range->first = first;
+    range->count = count;
+    return idx;
+}
+
+
+
+// Split the nodes of the current level: keep a regular subsample of the points of each node, and
+// sort the other points by octant. The nodes of a level cover disjoint ranges of the permutation.
+static void _octree_split(uint32_t item_first, uint32_t item_count, void* user_data)
+{
+    DvzOctreeBuilder* b = (DvzOctreeBuilder*)user_data;
+    ASSERT(b != NULL);
+    uint32_t cap = b->capacity;
+    vec3 p = {0};
+
+    for (uint32_t i = item_first; i < item_first + item_count; i++)
+    {
+        DvzOctreeNode* node = &b->nodes[b->level_first + i];
+        DvzOctreeRange* range = &b->ranges[b->level_first + i];
+        uint32_t* perm = &b->perm[range->first];
+        uint32_t n = range->count;
+
+        // Leaves keep all of their points. At the maximum depth, the extra points are dropped.
+        if (n <= cap || node->depth >= DVZ_OCTREE_MAX_DEPTH)
+        {
+            range->kept = MIN(n, cap);
+            continue;
+        }
+
+        // Move the subsample to the start of the range.
+        uint32_t src = 0, tmp = 0;
+        for (uint32_t k = 0; k < cap; k++)
+        {
+            src = (uint32_t)((uint64_t)k * n / cap);
+            ASSERT(src >= k);
+            tmp = perm[k];
+            perm[k] = perm[src];
+            perm[src] = tmp;
+        }
+        range->kept = cap;
+
+        // Counting sort of the other points by octant.
+        uint32_t rest = n - cap;
+        uint8_t* octs = (uint8_t*)calloc(rest, sizeof(uint8_t));
+        uint32_t* sorted = (uint32_t*)calloc(rest, sizeof(uint32_t));
+        for (uint32_t k = 0; k < rest; k++)
+        {
+            _octree_normalize(b, perm[cap + k], p);
+            octs[k] = _octree_octant(node->center, p);
+            range->octants[octs[k]]++;
+        }
+        uint32_t offsets[8] = {0};
+        for (uint32_t o = 1; o < 8; o++)
+            offsets[o] = offsets[o - 1] + range->octants[o - 1];
+        for (uint32_t k = 0; k < rest; k++)
+            sorted[offsets[octs[k]]++] = perm[cap + k];
+        memcpy(&perm[cap], sorted, rest * sizeof(uint32_t));
+
+        FREE(octs);
+        FREE(sorted);
+    }
+}
+
+
+
+static int _octree_write(DvzOctreeBuilder* b, const char* path, cvec4* color)
+{
+    ASSERT(b != NULL);
+
+    DvzOctreeHeader header = {0};
+    header.magic = DVZ_OCTREE_MAGIC;
+    header.version = DVZ_OCTREE_VERSION;
+    header.node_count = b->node_count;
+    header.node_capacity = b->capacity;
+    for (uint32_t j = 0; j < 3; j++)
+    {
+        header.box.p0[j] = b->center[j] - b->half;
+        header.box.p1[j] = b->center[j] + b->half;
+    }
+
+    // The points of the nodes follow the table of nodes.
+    uint64_t offset = sizeof(DvzOctreeHeader) + b->node_count * sizeof(DvzOctreeNode);
+    for (uint32_t i = 0; i < b->node_count; i++)
+    {
+        b->nodes[i].offset = offset;
+        offset += b->nodes[i].point_count * sizeof(DvzVertex);
+        header.point_count += b->nodes[i].point_count;
+    }
+
+    FILE* f = fopen(path, "wb");
+    if (f == NULL)
+    {
+        log_error("could not write octree file %s", path);
+        return 1;
+    }
+    fwrite(&header, sizeof(DvzOctreeHeader), 1, f);
+    fwrite(b->nodes, sizeof(DvzOctreeNode), b->node_count, f);
+
+    DvzVertex* vertices = (DvzVertex*)calloc(b->capacity, sizeof(DvzVertex));
+    uint32_t idx = 0;
+    for (uint32_t i = 0; i < b->node_count; i++)
+    {
+        for (uint32_t k = 0; k < b->nodes[i].point_count; k++)
+        {
+            idx = b->perm[b->ranges[i].first + k];
+            _octree_normalize(b, idx, vertices[k].pos);
+            if (color != NULL)
+                memcpy(vertices[k].color, color[idx], sizeof(cvec4));
+            else
+                memset(vertices[k].color, 255, sizeof(cvec4));
+        }
+        fwrite(vertices, sizeof(DvzVertex), b->nodes[i].point_count, f);
+    }
+    FREE(vertices);
+
+    int res = ferror(f) ? 1 : 0;
+    fclose(f);
+    if (res != 0)
+        log_error("error while writing octree file %s", path);
+    log_debug(
+        "wrote octree with %d nodes and %" PRIu64 " points to %s", header.node_count,
+        header.point_count, path);
+    return res;
+}
+
+
+
+int dvz_octree_build(
+    const char* path, uint32_t point_count, dvec3* pos, cvec4* color,
+    uint32_t node_capacity)
+{
+    ASSERT(path != NULL);
+    ASSERT(pos != NULL);
+    if (point_count == 0)
+    {
+        log_error("cannot build an octree without points");
+        return 1;
+    }
+
+    DvzOctreeBuilder b = {0};
+    b.pos = pos;
+    b.capacity = node_capacity > 0 ? node_capacity : DVZ_OCTREE_DEFAULT_CAPACITY;
+
+    // Bounding cube.
+    dvec3 p0 = {PLUS_INF, PLUS_INF, PLUS_INF};
+    dvec3 p1 = {MINUS_INF, MINUS_INF, MINUS_INF};
+    for (uint32_t i = 0; i < point_count; i++)
+    {
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            p0[j] = MIN(p0[j], pos[i][j]);
+            p1[j] = MAX(p1[j], pos[i][j]);
+        }
+    }
+    for (uint32_t j = 0; j < 3; j++)
+    {
+        b.center[j] = .5 * (p0[j] + p1[j]);
+        b.half = MAX(b.half, .5 * (p1[j] - p0[j]));
+    }
+    if (b.half <= 0)
+        b.half = 1;
+
+    b.perm = (uint32_t*)calloc(point_count, sizeof(uint32_t));
+    for (uint32_t i = 0; i < point_count; i++)
+        b.perm[i] = i;
+
+    // Root node.
+    _octree_node_add(&b, (vec3){0, 0, 0}, 1, 0, 0, point_count);
+
+    // Split the tree level by level, the nodes of a level are split in parallel.
+    uint32_t level_count = 1;
+    uint64_t dropped = 0;
+    while (level_count > 0)
+    {
+        dvz_parallel(level_count, 1, _octree_split, &b);
+
+        // Create the children of the nodes of the level.
+        uint32_t level_end = b.level_first + level_count;
+        for (uint32_t i = b.level_first; i < level_end; i++)
+        {
+            DvzOctreeRange range = b.ranges[i];
+            b.nodes[i].point_count = range.kept;
+            if (b.nodes[i].depth >= DVZ_OCTREE_MAX_DEPTH)
+                dropped += range.count - range.kept;
+
+            uint32_t first = range.first + range.kept;
+            float half = .5f * b.nodes[i].half_size;
+            vec3 center = {0};
+            for (uint32_t o = 0; o < 8; o++)
+            {
+                if (range.octants[o] == 0)
+                    continue;
+                for (uint32_t j = 0; j < 3; j++)
+                    center[j] = b.nodes[i].center[j] + ((o >> j) & 1 ? half : -half);
+                uint32_t child = _octree_node_add(
+                    &b, center, half, b.nodes[i].depth + 1, first, range.octants[o]);
+                b.nodes[i].children[o] = child;
+                first += range.octants[o];
+            }
+        }
+        b.level_first = level_end;
+        level_count = b.node_count - level_end;
+    }
+    if (dropped > 0)
+        log_warn(
+            "%" PRIu64 " points dropped at the maximum octree depth %d", dropped,
+            DVZ_OCTREE_MAX_DEPTH);
+
+    int res = _octree_write(&b, path, color);
+
+    FREE(b.perm);
+    FREE(b.nodes);
+    FREE(b.ranges);
+    return res;
+}
+
+
+
+/*************************************************************************************************/
+/*  Loading                                                                                      */
+/*************************************************************************************************/
+
+DvzOctree dvz_octree_open(const char* path)
+{
+    ASSERT(path != NULL);
+    DvzOctree octree = {0};
+
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        log_error("could not open octree file %s", path);
+        return octree;
+    }
+
+    DvzOctreeHeader* header = &octree.header;
+    if (fread(header, sizeof(DvzOctreeHeader), 1, f) != 1 || header->magic != DVZ_OCTREE_MAGIC ||
+        header->version != DVZ_OCTREE_VERSION || header->node_count == 0)
+    {
+        log_error("invalid octree file %s", path);
+        fclose(f);
+        return octree;
+    }
+
+    octree.nodes = (DvzOctreeNode*)calloc(header->node_count, sizeof(DvzOctreeNode));
+    if (fread(octree.nodes, sizeof(DvzOctreeNode), header->node_count, f) != header->node_count)
+    {
+        log_error("truncated octree file %s", path);
+        FREE(octree.nodes);
+        fclose(f);
+        return octree;
+    }
+    octree.file = f;
+
+    // Every node is pushed at most once to the traversal heap.
+    octree.selected = (uint32_t*)calloc(header->node_count, sizeof(uint32_t));
+    octree.heap_sizes = (float*)calloc(header->node_count, sizeof(float));
+    octree.heap_nodes = (uint32_t*)calloc(header->node_count, sizeof(uint32_t));
+
+    log_debug(
+        "opened octree %s with %d nodes and %" PRIu64 " points", path, header->node_count,
+        header->point_count);
+    dvz_obj_created(&octree.obj);
+    return octree;
+}
+
+
+
+uint32_t dvz_octree_budget(DvzOctree* octree, uint64_t point_budget)
+{
+    ASSERT(octree != NULL);
+    ASSERT(dvz_obj_is_created(&octree->obj));
+    uint32_t capacity = octree->header.node_capacity;
+    uint32_t node_count = octree->header.node_count;
+    ASSERT(capacity > 0);
+
+    uint32_t slot_count = (uint32_t)MIN(MAX(point_budget / capacity, 1), node_count);
+    octree->slot_count = slot_count;
+    octree->frame = 0;
+    octree->load_count = 0;
+
+    REALLOC(octree->node_slots, node_count * sizeof(uint32_t));
+    REALLOC(octree->slot_nodes, slot_count * sizeof(uint32_t));
+    REALLOC(octree->slot_frames, slot_count * sizeof(uint64_t));
+    memset(octree->node_slots, 0xFF, node_count * sizeof(uint32_t));
+    memset(octree->slot_nodes, 0xFF, slot_count * sizeof(uint32_t));
+    memset(octree->slot_frames, 0, slot_count * sizeof(uint64_t));
+
+    dvz_array_destroy(&octree->staging);
+    octree->staging = dvz_array_struct(2 * DVZ_OCTREE_MAX_LOADS * capacity, sizeof(DvzVertex));
+
+    dvz_array_destroy(&octree->draws);
+    octree->draws = dvz_array_struct(2 * slot_count, sizeof(VkDrawIndirectCommand));
+
+    log_debug("octree budget of %d slots of %d points", slot_count, capacity);
+    return slot_count;
+}
+
+
+
+uint32_t dvz_octree_load(DvzOctree* octree, uint32_t node_idx, DvzVertex* vertices)
+{
+    ASSERT(octree != NULL);
+    ASSERT(octree->file != NULL);
+    ASSERT(node_idx < octree->header.node_count);
+    ASSERT(vertices != NULL);
+
+    DvzOctreeNode* node = &octree->nodes[node_idx];
+    uint32_t n = node->point_count;
+    ASSERT(n <= octree->header.node_capacity);
+    if (n == 0)
+        return 0;
+    if (_octree_seek(octree->file, node->offset) != 0 ||
+        fread(vertices, sizeof(DvzVertex), n, octree->file) != n)
+    {
+        log_error("could not read the points of octree node %d", node_idx);
+        return 0;
+    }
+    return n;
+}
+
+
+
+/*************************************************************************************************/
+/*  Selection                                                                                    */
+/*************************************************************************************************/
+
+// Projected diameter of the bounding sphere of a node, in pixels, or a negative value if the
+// node is outside of the view frustum.
+static float _octree_projected_size(mat4 mvp, DvzOctreeNode* node, vec2 size)
+{
+    ASSERT(node != NULL);
+
+    // Rows of the column-major matrix.
+    vec4 rows[4] = {0};
+    for (uint32_t r = 0; r < 4; r++)
+        for (uint32_t c = 0; c < 4; c++)
+            rows[r][c] = mvp[c][r];
+
+    // Clipping planes, with Vulkan depth between 0 and w.
+    vec4 planes[6] = {0};
+    glm_vec4_add(rows[3], rows[0], planes[0]);
+    glm_vec4_sub(rows[3], rows[0], planes[1]);
+    glm_vec4_add(rows[3], rows[1], planes[2]);
+    glm_vec4_sub(rows[3], rows[1], planes[3]);
+    glm_vec4_copy(rows[2], planes[4]);
+    glm_vec4_sub(rows[3], rows[2], planes[5]);
+
+    float radius = node->half_size * sqrtf(3.f);
+    for (uint32_t i = 0; i < 6; i++)
+        if (_octree_dot(planes[i], node->center) + radius * _octree_norm(planes[i]) < 0)
+            return -1;
+
+    // The nodes that intersect the plane of the camera have the highest priority.
+    float w = _octree_dot(rows[3], node->center) - radius * _octree_norm(rows[3]);
+    if (w <= 1e-6f)
+        return FLT_MAX;
+    return radius * MAX(_octree_norm(rows[0]) * size[0], _octree_norm(rows[1]) * size[1]) / w;
+}
+
+
+
+static void _octree_heap_push(DvzOctree* octree, uint32_t* count, float size, uint32_t node)
+{
+    ASSERT(*count < octree->header.node_count);
+    uint32_t i = (*count)++;
+    uint32_t parent = 0;
+    while (i > 0)
+    {
+        parent = (i - 1) / 2;
+        if (octree->heap_sizes[parent] >= size)
+            break;
+        octree->heap_sizes[i] = octree->heap_sizes[parent];
+        octree->heap_nodes[i] = octree->heap_nodes[parent];
+        i = parent;
+    }
+    octree->heap_sizes[i] = size;
+    octree->heap_nodes[i] = node;
+}
+
+
+
+static uint32_t _octree_heap_pop(DvzOctree* octree, uint32_t* count, float* size)
+{
+    ASSERT(*count > 0);
+    uint32_t node = octree->heap_nodes[0];
+    *size = octree->heap_sizes[0];
+
+    // Sift down the last item from the top of the heap.
+    uint32_t n = --(*count);
+    float last_size = octree->heap_sizes[n];
+    uint32_t last_node = octree->heap_nodes[n];
+    uint32_t i = 0, child = 0;
+    while ((child = 2 * i + 1) < n)
+    {
+        if (child + 1 < n && octree->heap_sizes[child + 1] > octree->heap_sizes[child])
+            child++;
+        if (last_size >= octree->heap_sizes[child])
+            break;
+        octree->heap_sizes[i] = octree->heap_sizes[child];
+        octree->heap_nodes[i] = octree->heap_nodes[child];
+        i = child;
+    }
+    octree->heap_sizes[i] = last_size;
+    octree->heap_nodes[i] = last_node;
+    return node;
+}
+
+
+
+uint32_t dvz_octree_select(DvzOctree* octree, DvzMVP* mvp, vec2 viewport_size)
+{
+    ASSERT(octree != NULL);
+    ASSERT(mvp != NULL);
+    ASSERT(octree->slot_count > 0);
+
+    mat4 m = {0};
+    glm_mat4_mul(mvp->proj, mvp->view, m);
+    glm_mat4_mul(m, mvp->model, m);
+
+    // Traverse the tree from the root, by decreasing projected size, until the budget is full.
+    octree->selected_count = 0;
+    uint32_t heap_count = 0;
+    float size = _octree_projected_size(m, &octree->nodes[0], viewport_size);
+    if (size >= 0)
+        _octree_heap_push(octree, &heap_count, size, 0);
+
+    uint32_t node = 0, child = 0;
+    while (heap_count > 0 && octree->selected_count < octree->slot_count)
+    {
+        node = _octree_heap_pop(octree, &heap_count, &size);
+        octree->selected[octree->selected_count++] = node;
+
+        // The points of small nodes are already denser than the pixels.
+        if (size < DVZ_OCTREE_MIN_NODE_SIZE)
+            continue;
+        for (uint32_t o = 0; o < 8; o++)
+        {
+            child = octree->nodes[node].children[o];
+            if (child == DVZ_OCTREE_NONE)
+                continue;
+            size = _octree_projected_size(m, &octree->nodes[child], viewport_size);
+            if (size >= 0)
+                _octree_heap_push(octree, &heap_count, size, child);
+        }
+    }
+    return octree->selected_count;
+}
+
+
+
+/*************************************************************************************************/
+/*  Residency                                                                                    */
+/*************************************************************************************************/
+
+// Least recently used slot among the slots that are not selected at the current frame.
+static uint32_t _octree_lru_slot(DvzOctree* octree)
+{
+    uint32_t slot = DVZ_OCTREE_NONE;
+    for (uint32_t s = 0; s < octree->slot_count; s++)
+    {
+        if (octree->slot_frames[s] == octree->frame)
+            continue;
+        if (slot == DVZ_OCTREE_NONE || octree->slot_frames[s] < octree->slot_frames[slot])
+            slot = s;
+    }
+    return slot;
+}
+
+
+
+uint32_t dvz_octree_update(DvzOctree* octree)
+{
+    ASSERT(octree != NULL);
+    ASSERT(octree->slot_count > 0);
+
+    uint64_t frame = ++octree->frame;
+    uint32_t parity = frame % 2;
+    uint32_t capacity = octree->header.node_capacity;
+    octree->load_count = 0;
+
+    // The selected nodes that are already resident keep their slots.
+    uint32_t node = 0, slot = 0;
+    for (uint32_t i = 0; i < octree->selected_count; i++)
+    {
+        slot = octree->node_slots[octree->selected[i]];
+        if (slot != DVZ_OCTREE_NONE)
+            octree->slot_frames[slot] = frame;
+    }
+
+    // Load the missing nodes by decreasing priority, in the least recently used slots.
+    DvzOctreeLoad* load = NULL;
+    for (uint32_t i = 0; i < octree->selected_count; i++)
+    {
+        if (octree->load_count >= DVZ_OCTREE_MAX_LOADS)
+            break;
+        node = octree->selected[i];
+        if (octree->node_slots[node] != DVZ_OCTREE_NONE)
+            continue;
+        slot = _octree_lru_slot(octree);
+        if (slot == DVZ_OCTREE_NONE)
+            break;
+
+        // Evict the previous node of the slot.
+        if (octree->slot_nodes[slot] != DVZ_OCTREE_NONE)
+            octree->node_slots[octree->slot_nodes[slot]] = DVZ_OCTREE_NONE;
+        octree->slot_nodes[slot] = DVZ_OCTREE_NONE;
+
+        load = &octree->loads[octree->load_count];
+        load->vertices = (DvzVertex*)dvz_array_item(
+            &octree->staging, (parity * DVZ_OCTREE_MAX_LOADS + octree->load_count) * capacity);
+        load->point_count = dvz_octree_load(octree, node, load->vertices);
+        if (load->point_count == 0)
+            continue;
+        load->node = node;
+        load->slot = slot;
+        octree->node_slots[node] = slot;
+        octree->slot_nodes[slot] = node;
+        octree->slot_frames[slot] = frame;
+        octree->load_count++;
+    }
+
+    // Only draw the selected resident nodes.
+    VkDrawIndirectCommand* draws = dvz_array_item(&octree->draws, parity * octree->slot_count);
+    VkDrawIndirectCommand* prev =
+        dvz_array_item(&octree->draws, (1 - parity) * octree->slot_count);
+    for (uint32_t s = 0; s < octree->slot_count; s++)
+    {
+        node = octree->slot_nodes[s];
+        draws[s].vertexCount = node != DVZ_OCTREE_NONE && octree->slot_frames[s] == frame
+                                   ? octree->nodes[node].point_count
+                                   : 0;
+        draws[s].instanceCount = 1;
+        draws[s].firstVertex = s * capacity;
+        draws[s].firstInstance = 0;
+    }
+    octree->draws_changed =
+        frame == 1 ||
+        memcmp(draws, prev, octree->slot_count * sizeof(VkDrawIndirectCommand)) != 0;
+
+    return octree->load_count;
+}
+
+
+
+VkDrawIndirectCommand* dvz_octree_draws(DvzOctree* octree)
+{
+    ASSERT(octree != NULL);
+    ASSERT(octree->slot_count > 0);
+    return (VkDrawIndirectCommand*)dvz_array_item(
+        &octree->draws, (octree->frame % 2) * octree->slot_count);
+}
+
+
+
+void dvz_octree_destroy(DvzOctree* octree)
+{
+    ASSERT(octree != NULL);
+    if (octree->file != NULL)
+        fclose(octree->file);
+    octree->file = NULL;
+
+    FREE(octree->nodes);
+    FREE(octree->selected);
+    FREE(octree->heap_sizes);
+    FREE(octree->heap_nodes);
+    FREE(octree->node_slots);
+    FREE(octree->slot_nodes);
+    FREE(octree->slot_frames);
+    dvz_array_destroy(&octree->staging);
+    dvz_array_destroy(&octree->draws);
+    dvz_obj_destroyed(&octree->obj);
+}
@@ -533,5 +533,11 @@ void dvz_panel_destroy(DvzPanel* panel)
     {
         dvz_visual_destroy(panel->visuals[i]);
     }
+    // The draw batch slots that have been used have their own bindings.
+    for (uint32_t i = 0; i < DVZ_MAX_DRAW_BATCHES; i++)
+    {
+        if (dvz_obj_is_created(&panel->batches[i].bindings.obj))
+            dvz_bindings_destroy(&panel->batches[i].bindings);
+    }
     dvz_obj_destroyed(&panel->obj);
 }
@@ -0,0 +1,422 @@
+#include "../include/datoviz/pslg.h"
+#include "../include/datoviz/common.h"
+
+// Triangle is compiled in double precision, see external/triangle.c.
+#define REAL double
+#ifndef VOID
+#define VOID void
+#endif
+#include <triangle.h>
+
+#define DVZ_PSLG_CHUNK_SIZE 64
+
+
+
+/*************************************************************************************************/
+/*  Cache                                                                                        */
+/*************************************************************************************************/
+
+static bool _pslg_read(const char* path, uint64_t key, DvzPslgMesh* mesh)
+{
+    ASSERT(path != NULL);
+    ASSERT(mesh != NULL);
+
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+        return false;
+
+    DvzPslgHeader header = {0};
+    if (fread(&header, sizeof(DvzPslgHeader), 1, f) != 1 || header.magic != DVZ_PSLG_MAGIC ||
+        header.version != DVZ_PSLG_VERSION || header.key != key)
+    {
+        log_warn("ignore invalid PSLG cache file %s", path);
+        fclose(f);
+        return false;
+    }
+
+    DvzPslgMesh m = {0};
+    m.key = key;
+    m.pslg_count = header.pslg_count;
+    m.vertex_count = header.vertex_count;
+    m.index_count = header.index_count;
+    m.vertex_counts = (uint32_t*)calloc(MAX(m.pslg_count, 1), sizeof(uint32_t));
+    m.vertices = (dvec2*)calloc(MAX(m.vertex_count, 1), sizeof(dvec2));
+    m.indices = (DvzIndex*)calloc(MAX(m.index_count, 1), sizeof(DvzIndex));
+    bool ok =
+        fread(m.vertex_counts, sizeof(uint32_t), m.pslg_count, f) == m.pslg_count &&
+        fread(m.vertices, sizeof(dvec2), m.vertex_count, f) == m.vertex_count &&
+        fread(m.indices, sizeof(DvzIndex), m.index_count, f) == m.index_count;
+    fclose(f);
+
+    // Check the consistency of the file, a truncated or corrupted file is discarded.
+    uint64_t total = 0;
+    for (uint32_t i = 0; ok && i < m.pslg_count; i++)
+        total += m.vertex_counts[i];
+    ok = ok && total == m.vertex_count && m.index_count % 3 == 0;
+    for (uint32_t i = 0; ok && i < m.index_count; i++)
+        ok = m.indices[i] < m.vertex_count;
+    if (!ok)
+    {
+        log_warn("ignore corrupted PSLG cache file %s", path);
+        dvz_pslg_destroy(&m);
+        return false;
+    }
+
+    *mesh = m;
+    return true;
+}
+
+
+
+static int _pslg_write(const char* path, DvzPslgMesh* mesh)
+{
+    ASSERT(path != NULL);
+    ASSERT(mesh != NULL);
+
+    DvzPslgHeader header = {0};
+    header.magic = DVZ_PSLG_MAGIC;
+    header.version = DVZ_PSLG_VERSION;
+    header.key = mesh->key;
+    header.pslg_count = mesh->pslg_count;
+    header.vertex_count = mesh->vertex_count;
+    header.index_count = mesh->index_count;
+
+    // The file is written under a temporary name first, so that another process never reads a
+    // partially written file.
+    char tmp_path[1024 + 8];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    FILE* f = fopen(tmp_path, "wb");
+    if (f == NULL)
+    {
+        log_warn("could not write PSLG cache file %s", tmp_path);
+        return 1;
+    }
+    fwrite(&header, sizeof(DvzPslgHeader), 1, f);
+    fwrite(mesh->vertex_counts, sizeof(uint32_t), mesh->pslg_count, f);
+    fwrite(mesh->vertices, sizeof(dvec2), mesh->vertex_count, f);
+    fwrite(mesh->indices, sizeof(DvzIndex), mesh->index_count, f);
+
+    int res = ferror(f) ? 1 : 0;
+    fclose(f);
+    if (res == 0)
+    {
+        remove(path);
+        res = rename(tmp_path, path) != 0 ? 1 : 0;
+    }
+    if (res != 0)
+    {
+        log_warn("error while writing PSLG cache file %s", path);
+        remove(tmp_path);
+        return res;
+    }
+    log_debug("wrote the triangulation of %d PSLGs to %s", mesh->pslg_count, path);
+    return 0;
+}
+
+
+
+/*************************************************************************************************/
+/*  Triangulation                                                                                */
+/*************************************************************************************************/
+
+typedef struct DvzPslgKernel DvzPslgKernel;
+
+// Triangulation of the PSLGs in parallel, the output of every PSLG is then copied at its offset
+// in the mesh.
+struct DvzPslgKernel
+{
+    const DvzPslgInput* input;
+    const uint32_t* point_offsets;   // index of the first point of each PSLG
+    const uint32_t* segment_offsets; // index of the first segment of each PSLG
+    char switches[2][32];            // Triangle switches, with segments and without
+    struct triangulateio* out;       // output of Triangle for each PSLG
+    const uint32_t* vertex_offsets;  // index of the first vertex of each PSLG in the mesh
+    const uint32_t* index_offsets;   // position of the indices of each PSLG in the mesh
+    DvzPslgMesh* mesh;
+};
+
+// NOTE: Triangle exits the process on degenerate input, it must be checked beforehand.
+static bool _pslg_valid(
+    uint32_t idx, const dvec2* points, uint32_t n, const uvec2* segments, uint32_t n_segments)
+{
+    if (n < 3)
+    {
+        log_error("skip PSLG #%d with %d points, at least 3 are required", idx, n);
+        return false;
+    }
+    for (uint32_t j = 0; j < n; j++)
+    {
+        if (!isfinite(points[j][0]) || !isfinite(points[j][1]))
+        {
+            log_error("skip PSLG #%d with a non-finite point #%d", idx, j);
+            return false;
+        }
+    }
+
+    // Look for a point distinct from the first one, then for a point outside of the line going
+    // through both, up to a relative tolerance as Triangle uses exact arithmetic.
+    const double* a = points[0];
+    const double* b = NULL;
+    double u0 = 0, u1 = 0, v0 = 0, v1 = 0;
+    uint32_t j = 1;
+    for (; j < n && b == NULL; j++)
+        if (points[j][0] != a[0] || points[j][1] != a[1])
+            b = points[j];
+    if (b == NULL)
+    {
+        log_error("skip PSLG #%d with %d identical points", idx, n);
+        return false;
+    }
+    u0 = b[0] - a[0];
+    u1 = b[1] - a[1];
+    for (; j < n; j++)
+    {
+        v0 = points[j][0] - a[0];
+        v1 = points[j][1] - a[1];
+        if (fabs(u0 * v1 - u1 * v0) > 1e-12 * sqrt((u0 * u0 + u1 * u1) * (v0 * v0 + v1 * v1)))
+            break;
+    }
+    if (j == n)
+    {
+        log_error("skip PSLG #%d with %d collinear points", idx, n);
+        return false;
+    }
+
+    const double *p = NULL, *q = NULL;
+    for (j = 0; j < n_segments; j++)
+    {
+        if (segments[j][0] >= n || segments[j][1] >= n)
+        {
+            log_error("skip PSLG #%d with an out-of-bounds segment #%d", idx, j);
+            return false;
+        }
+        p = points[segments[j][0]];
+        q = points[segments[j][1]];
+        if (p[0] == q[0] && p[1] == q[1])
+        {
+            log_error("skip PSLG #%d with a zero-length segment #%d", idx, j);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void _pslg_triangulate(uint32_t item_first, uint32_t item_count, void* user_data)
+{
+    DvzPslgKernel* k = (DvzPslgKernel*)user_data;
+    ASSERT(k != NULL);
+    const DvzPslgInput* input = k->input;
+
+    struct triangulateio in = {0};
+    const dvec2* points = NULL;
+    const uvec2* segments = NULL;
+    uint32_t n = 0, n_segments = 0, n_holes = 0;
+    double* holes = NULL;
+    for (uint32_t i = item_first; i < item_first + item_count; i++)
+    {
+        n = input->point_counts[i];
+        n_segments = input->segment_counts != NULL ? input->segment_counts[i] : 0;
+        points = &input->points[k->point_offsets[i]];
+        segments = n_segments > 0 ? &input->segments[k->segment_offsets[i]] : NULL;
+
+        if (!_pslg_valid(i, points, n, segments, n_segments))
+            continue;
+
+        // Only keep the holes within the bounding box of the PSLG.
+        dvec2 p0 = {PLUS_INF, PLUS_INF};
+        dvec2 p1 = {MINUS_INF, MINUS_INF};
+        for (uint32_t j = 0; j < n; j++)
+        {
+            p0[0] = MIN(p0[0], points[j][0]);
+            p0[1] = MIN(p0[1], points[j][1]);
+            p1[0] = MAX(p1[0], points[j][0]);
+            p1[1] = MAX(p1[1], points[j][1]);
+        }
+        n_holes = 0;
+        if (n_segments > 0 && input->hole_count > 0)
+        {
+            holes = (double*)calloc(2 * input->hole_count, sizeof(double));
+            for (uint32_t j = 0; j < input->hole_count; j++)
+            {
+                if (input->holes[j][0] < p0[0] || input->holes[j][0] > p1[0] ||
+                    input->holes[j][1] < p0[1] || input->holes[j][1] > p1[1])
+                    continue;
+                holes[2 * n_holes + 0] = input->holes[j][0];
+                holes[2 * n_holes + 1] = input->holes[j][1];
+                n_holes++;
+            }
+        }
+
+        // NOTE: Triangle only reads the input lists, uvec2 segments are valid int pairs as the
+        // indices are smaller than the number of points.
+        memset(&in, 0, sizeof(in));
+        in.pointlist = (double*)points;
+        in.numberofpoints = (int)n;
+        in.segmentlist = (int*)segments;
+        in.numberofsegments = (int)n_segments;
+        in.holelist = holes;
+        in.numberofholes = (int)n_holes;
+
+        triangulate(k->switches[n_segments > 0 ? 0 : 1], &in, &k->out[i], NULL);
+        ASSERT(k->out[i].numberofcorners == 3);
+        FREE(holes);
+    }
+}
+
+static void _pslg_concatenate(uint32_t item_first, uint32_t item_count, void* user_data)
+{
+    DvzPslgKernel* k = (DvzPslgKernel*)user_data;
+    ASSERT(k != NULL);
+    DvzPslgMesh* mesh = k->mesh;
+    ASSERT(mesh != NULL);
+
+    struct triangulateio* out = NULL;
+    DvzIndex* indices = NULL;
+    uint32_t offset = 0;
+    for (uint32_t i = item_first; i < item_first + item_count; i++)
+    {
+        out = &k->out[i];
+        offset = k->vertex_offsets[i];
+        if (out->numberofpoints > 0)
+            memcpy(
+                &mesh->vertices[offset], out->pointlist,
+                (size_t)out->numberofpoints * sizeof(dvec2));
+        indices = &mesh->indices[k->index_offsets[i]];
+        for (uint32_t j = 0; j < 3 * (uint32_t)out->numberoftriangles; j++)
+            indices[j] = offset + (DvzIndex)out->trianglelist[j];
+        trifree(out->pointlist);
+        trifree(out->trianglelist);
+    }
+}
+
+
+
+uint64_t dvz_pslg_key(const DvzPslgInput* input)
+{
+    ASSERT(input != NULL);
+    uint32_t n_points = 0, n_segments = 0;
+    for (uint32_t i = 0; i < input->pslg_count; i++)
+    {
+        n_points += input->point_counts[i];
+        n_segments += input->segment_counts != NULL ? input->segment_counts[i] : 0;
+    }
+
+    uint64_t h = DVZ_HASH_SEED;
+    uint32_t version = DVZ_PSLG_VERSION;
+    h = dvz_hash(h, &version, sizeof(version));
+    h = dvz_hash(h, input->point_counts, input->pslg_count * sizeof(uint32_t));
+    if (input->segment_counts != NULL)
+        h = dvz_hash(h, input->segment_counts, input->pslg_count * sizeof(uint32_t));
+    h = dvz_hash(h, input->points, n_points * sizeof(dvec2));
+    h = dvz_hash(h, input->segments, n_segments * sizeof(uvec2));
+    h = dvz_hash(h, input->holes, input->hole_count * sizeof(dvec2));
+    h = dvz_hash(h, &input->min_angle, sizeof(float));
+    // NOTE: 0 means that there is no triangulation.
+    return h != 0 ? h : 1;
+}
+
+
+
+DvzPslgMesh dvz_pslg_triangulate(const DvzPslgInput* input, const char* cache_dir)
+{
+    ASSERT(input != NULL);
+    DvzPslgMesh mesh = {0};
+    uint32_t n_pslgs = input->pslg_count;
+    if (n_pslgs == 0)
+    {
+        log_error("cannot triangulate an empty PSLG");
+        return mesh;
+    }
+    ASSERT(input->point_counts != NULL);
+    ASSERT(input->points != NULL);
+
+    // Triangulations of the same input made in a previous session are loaded from the disk.
+    uint64_t key = dvz_pslg_key(input);
+    char path[1024] = {0};
+    bool use_cache = dvz_cache_path(cache_dir, "pslg", key, path, sizeof(path));
+    if (use_cache && _pslg_read(path, key, &mesh))
+    {
+        log_debug("loaded the triangulation of %d PSLGs from %s", n_pslgs, path);
+        return mesh;
+    }
+
+    DvzPslgKernel k = {0};
+    k.input = input;
+    k.out = (struct triangulateio*)calloc(n_pslgs, sizeof(struct triangulateio));
+
+    // Index of the first point and segment of each PSLG.
+    uint32_t* point_offsets = (uint32_t*)calloc(n_pslgs, sizeof(uint32_t));
+    uint32_t* segment_offsets = (uint32_t*)calloc(n_pslgs, sizeof(uint32_t));
+    for (uint32_t i = 1; i < n_pslgs; i++)
+    {
+        point_offsets[i] = point_offsets[i - 1] + input->point_counts[i - 1];
+        if (input->segment_counts != NULL)
+            segment_offsets[i] = segment_offsets[i - 1] + input->segment_counts[i - 1];
+    }
+    k.point_offsets = point_offsets;
+    k.segment_offsets = segment_offsets;
+
+    // Triangle switches: PSLG, zero-based indices, quiet, no boundary markers, no output
+    // segments, and quality refinement with a minimum angle. Without segments, the convex hull
+    // of the points is triangulated.
+    float min_angle = input->min_angle;
+    if (min_angle > DVZ_PSLG_MAX_ANGLE)
+    {
+        log_warn("clip the minimum angle %.1f to %d degrees", min_angle, DVZ_PSLG_MAX_ANGLE);
+        min_angle = DVZ_PSLG_MAX_ANGLE;
+    }
+    char quality[16] = {0};
+    if (min_angle > 0)
+        snprintf(quality, sizeof(quality), "q%.3f", min_angle);
+    snprintf(k.switches[0], sizeof(k.switches[0]), "pzQBP%s", quality);
+    snprintf(k.switches[1], sizeof(k.switches[1]), "pzQBPc%s", quality);
+
+    // Triangulate all PSLGs in parallel, one task per PSLG as their sizes may vary a lot.
+    dvz_parallel(n_pslgs, 1, _pslg_triangulate, &k);
+
+    // Prefix sums of the vertex and index counts, then concatenate all triangulations in
+    // parallel.
+    uint32_t* vertex_offsets = (uint32_t*)calloc(n_pslgs, sizeof(uint32_t));
+    uint32_t* index_offsets = (uint32_t*)calloc(n_pslgs, sizeof(uint32_t));
+    mesh.key = key;
+    mesh.pslg_count = n_pslgs;
+    mesh.vertex_counts = (uint32_t*)calloc(n_pslgs, sizeof(uint32_t));
+    for (uint32_t i = 0; i < n_pslgs; i++)
+    {
+        vertex_offsets[i] = mesh.vertex_count;
+        index_offsets[i] = mesh.index_count;
+        mesh.vertex_counts[i] = (uint32_t)k.out[i].numberofpoints;
+        mesh.vertex_count += mesh.vertex_counts[i];
+        mesh.index_count += 3 * (uint32_t)k.out[i].numberoftriangles;
+    }
+    mesh.vertices = (dvec2*)calloc(MAX(mesh.vertex_count, 1), sizeof(dvec2));
+    mesh.indices = (DvzIndex*)calloc(MAX(mesh.index_count, 1), sizeof(DvzIndex));
+    k.vertex_offsets = vertex_offsets;
+    k.index_offsets = index_offsets;
+    k.mesh = &mesh;
+    dvz_parallel(n_pslgs, DVZ_PSLG_CHUNK_SIZE, _pslg_concatenate, &k);
+
+    log_debug(
+        "triangulated %d PSLGs into %d vertices and %d triangles", n_pslgs, mesh.vertex_count,
+        mesh.index_count / 3);
+    if (use_cache)
+        _pslg_write(path, &mesh);
+
+    FREE(k.out);
+    FREE(point_offsets);
+    FREE(segment_offsets);
+    FREE(vertex_offsets);
+    FREE(index_offsets);
+    return mesh;
+}
+
+
+
+void dvz_pslg_destroy(DvzPslgMesh* mesh)
+{
+    ASSERT(mesh != NULL);
+    FREE(mesh->vertex_counts);
+    FREE(mesh->vertices);
+    FREE(mesh->indices);
+    memset(mesh, 0, sizeof(DvzPslgMesh));
+}
@@ -1,7 +1,9 @@
 #ifndef DVZ_SCENE_UTILS_HEADER
 #define DVZ_SCENE_UTILS_HEADER
 
+#include "../include/datoviz/octree.h"
 #include "../include/datoviz/scene.h"
+#include "visuals_utils.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,6 +22,18 @@ static inline bool _is_visual_to_transform(DvzVisual* visual)
 
 
 
+// Whether the data normalization of a visual is done in the vertex shader. Only linear transforms
+// can be expressed as a GPU affine transform, other transforms fall back to the CPU.
+static inline bool _is_visual_transformed_on_gpu(DvzVisual* visual, DvzDataCoords* coords)
+{
+    return _is_visual_to_transform(visual) &&
+           (visual->flags & DVZ_VISUAL_FLAGS_TRANSFORM_GPU) != 0 &&
+           (coords->transform == DVZ_TRANSFORM_NONE ||
+            coords->transform == DVZ_TRANSFORM_CARTESIAN);
+}
+
+
+
 static inline bool _is_aspect_fixed(DvzDataCoords* coords)
 {
     return (coords->flags & DVZ_TRANSFORM_FLAGS_FIXED_ASPECT) != 0;
@@ -27,6 +41,22 @@ static inline bool _is_aspect_fixed(DvzDataCoords* coords)
 
 
 
+// Whether a change in the number of vertices/indices of a graphics pipeline requires a command
+// buffer refill.
+static inline bool
+_is_count_change_refill(DvzVisual* visual, uint32_t old_count, uint32_t new_count)
+{
+    if (old_count == new_count)
+        return false;
+    // With indirect draws, the command buffers only need to be refilled when a graphics pipeline
+    // becomes empty or non-empty, as empty pipelines are skipped by the fill callback.
+    if (visual->indirect.buffer != NULL)
+        return old_count == 0 || new_count == 0;
+    return true;
+}
+
+
+
 static bool _has_item_count_changed(DvzVisual* visual)
 {
     ASSERT(visual != NULL);
@@ -37,23 +67,26 @@ static bool _has_item_count_changed(DvzVisual* visual)
     {
         // Detect a change in vertex_count.
         source = dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, pidx);
-        if (source->arr.item_count != visual->prev_vertex_count[pidx])
+        uint32_t vertex_count = _source_item_count(source);
+        if (_is_count_change_refill(visual, visual->prev_vertex_count[pidx], vertex_count))
         {
             // log_debug("automatic detection of a change in vertex count, will trigger full
             // refill");
             has_changed = true;
-            visual->prev_vertex_count[pidx] = source->arr.item_count;
         }
+        visual->prev_vertex_count[pidx] = vertex_count;
 
         // Detect a change in index_count.
         source = dvz_source_get(visual, DVZ_SOURCE_TYPE_INDEX, pidx);
-        if (source != NULL && source->arr.item_count != visual->prev_index_count[pidx])
+        if (source != NULL &&
+            _is_count_change_refill(visual, visual->prev_index_count[pidx], source->arr.item_count))
         {
             // log_debug("automatic detection of a change in index count, will trigger full
             // refill");
             has_changed = true;
-            visual->prev_index_count[pidx] = source->arr.item_count;
         }
+        if (source != NULL)
+            visual->prev_index_count[pidx] = source->arr.item_count;
     }
     return has_changed;
 }
@@ -106,13 +139,38 @@ static void _viewport_print(DvzViewport v)
 
 
 
+// Return the bounding box of a non-empty POS prop. Only the items appended since the last call
+// are scanned, unless the cached box has been invalidated or the prop has shrunk.
+static DvzBox _prop_box(DvzProp* prop)
+{
+    ASSERT(prop != NULL);
+    DvzArray* arr = &prop->arr_orig;
+    uint32_t n = arr->item_count;
+    ASSERT(n > 0);
+
+    if (prop->box_count == 0 || prop->box_count > n)
+    {
+        prop->box = DVZ_BOX_INF;
+        prop->box_count = 0;
+    }
+    if (prop->box_count < n)
+    {
+        _box_extend(&prop->box, arr, prop->box_count, n - prop->box_count);
+        prop->box_count = n;
+    }
+    return prop->box;
+}
+
+
+
 // Return the box surrounding all POS props of a visual.
 static DvzBox _visual_box(DvzVisual* visual)
 {
     ASSERT(visual != NULL);
+    if (visual->box_valid)
+        return visual->box;
 
     DvzProp* prop = NULL;
-    DvzArray* arr = NULL;
 
     // The POS props that will need to be transformed.
     uint32_t n_pos_props = 0;
@@ -125,19 +183,26 @@ static DvzBox _visual_box(DvzVisual* visual)
         prop = dvz_prop_get(visual, DVZ_PROP_POS, i);
         if (prop == NULL)
             break;
-        arr = &prop->arr_orig;
-        ASSERT(arr != NULL);
-        if (arr->item_count == 0)
+        if (prop->arr_orig.item_count == 0)
             continue;
-        boxes[n_pos_props++] = _box_bounding(arr);
+        boxes[n_pos_props++] = _prop_box(prop);
     }
 
-    if (n_pos_props == 0)
-        return DVZ_BOX_NDC;
-
     // Merge the boxes of the visual.
-    DvzBox box = _box_merge(n_pos_props, boxes);
-    return box;
+    visual->box = n_pos_props == 0 ? DVZ_BOX_NDC : _box_merge(n_pos_props, boxes);
+    visual->box_valid = true;
+    return visual->box;
+}
+
+
+
+// Whether only the modified items of a POS prop need to be recomputed in the transformed array.
+static inline bool _is_pos_prop_partial(DvzProp* prop)
+{
+    ASSERT(prop != NULL);
+    uint32_t n = prop->arr_orig.item_count;
+    return prop->arr_trans.item_count == n && prop->arr_trans.dtype == prop->arr_orig.dtype &&
+           prop->dirty_count > 0 && prop->dirty_first + prop->dirty_count <= n;
 }
 
 
@@ -159,11 +224,93 @@ static void _transform_pos_prop(DvzDataCoords coords, DvzProp* prop)
         return;
     }
 
+    // Only renormalize the modified items, using array views on the modified range.
+    if (_is_pos_prop_partial(prop))
+    {
+        log_trace(
+            "normalizing POS prop, %d items from #%d", prop->dirty_count, prop->dirty_first);
+        DvzArray view = *arr;
+        DvzArray view_tr = *arr_tr;
+        view.item_count = view_tr.item_count = prop->dirty_count;
+        view.data = dvz_array_item(arr, prop->dirty_first);
+        view_tr.data = dvz_array_item(arr_tr, prop->dirty_first);
+        dvz_transform_pos(coords, &view, &view_tr, false);
+        return;
+    }
+
     // Create the transformed prop array.
     log_trace("normalizing POS prop, %d items", arr->item_count);
     // _box_print(coords.box);
+    dvz_array_destroy(arr_tr);
     *arr_tr = dvz_array(arr->item_count, arr->dtype);
     dvz_transform_pos(coords, arr, arr_tr, false);
+    _prop_set_dirty(prop, 0, arr->item_count);
+}
+
+
+
+// Express a POS prop relative to the visual origin, for GPU data normalization. If the origin has
+// not moved, only the modified items are recomputed.
+static void _relative_pos_prop(DvzVisual* visual, DvzProp* prop, bool origin_moved)
+{
+    ASSERT(visual != NULL);
+    ASSERT(prop != NULL);
+    ASSERT(prop->prop_type == DVZ_PROP_POS);
+
+    DvzArray* arr = &prop->arr_orig;
+    DvzArray* arr_tr = &prop->arr_trans;
+    if (arr->item_count == 0)
+        return;
+
+    uint32_t first = 0;
+    uint32_t count = arr->item_count;
+    if (!origin_moved && _is_pos_prop_partial(prop))
+    {
+        first = prop->dirty_first;
+        count = prop->dirty_count;
+    }
+    else
+    {
+        // Reuse the transformed prop array if possible.
+        if (arr_tr->item_count != arr->item_count || arr_tr->dtype != arr->dtype)
+        {
+            dvz_array_destroy(arr_tr);
+            *arr_tr = dvz_array(arr->item_count, arr->dtype);
+        }
+        _prop_set_dirty(prop, 0, arr->item_count);
+    }
+
+    // NOTE: the subtraction is done in double precision, so that the relative positions keep
+    // their precision once cast to single-precision vertex attributes.
+    log_trace("relative POS prop, %d items from #%d", count, first);
+    dvec3 pos = {0};
+    for (uint32_t i = first; i < first + count; i++)
+    {
+        _pos_get(arr->dtype, dvz_array_item(arr, i), pos);
+        for (uint32_t j = 0; j < 3; j++)
+            pos[j] -= visual->data_origin[j];
+        _pos_set(arr_tr->dtype, pos, dvz_array_item(arr_tr, i));
+    }
+}
+
+
+
+// Compute the affine transform from the visual origin-relative positions to NDC.
+static void _gpu_data_transform(DvzBox box, dvec3 origin, DvzViewport* viewport)
+{
+    ASSERT(viewport != NULL);
+
+    DvzTransform tr = _transform_interp(box, DVZ_BOX_NDC);
+    double scale = 0;
+    for (uint32_t j = 0; j < 3; j++)
+    {
+        // NOTE: the origin is folded into the shift in double precision.
+        scale = tr.mat[j][j];
+        viewport->data_scale[j] = (float)scale;
+        viewport->data_shift[j] = (float)(tr.mat[3][j] + scale * origin[j]);
+    }
+    viewport->data_scale[3] = 1; // enable GPU data normalization
+    viewport->data_shift[3] = 0;
 }
 
 
@@ -174,9 +321,10 @@ static DvzBox _compute_panel_box(DvzPanel* panel, DvzVisual* skip_visual)
     DvzDataCoords* coords = &panel->data_coords;
     ASSERT(coords != NULL);
 
-    // We'll compute the box surrounding each visual, and we'll merge them.
-    DvzBox* boxes = calloc(panel->visual_count, sizeof(DvzBox));
-    // number of boxes to compute, depends on the number of visuals to be transformed
+    // We'll merge the cached box of each visual. The number of visuals to merge depends on the
+    // number of visuals to be transformed.
+    DvzBox box = DVZ_BOX_INF;
+    DvzBox visual_box = {0};
     uint32_t count = 0;
 
     // Get the bounding box of each visual.
@@ -193,14 +341,14 @@ static DvzBox _compute_panel_box(DvzPanel* panel, DvzVisual* skip_visual)
         // NOTE: skip visuals that should not be transformed.
         if (_is_visual_to_transform(visual))
         {
-            boxes[count++] = _visual_box(visual);
+            visual_box = _visual_box(visual);
+            box = _box_merge(2, (DvzBox[]){box, visual_box});
+            count++;
         }
     }
-
-    // Merge the visual box with the existing box.
-    DvzBox box = _box_merge(count, boxes);
+    if (count == 0)
+        box = DVZ_BOX_NDC;
     // _box_print(box);
-    FREE(boxes);
 
     // Make the box square if needed.
     if (_is_aspect_fixed(coords))
@@ -236,6 +384,9 @@ static void _update_visual_viewport(DvzPanel* panel, DvzVisual* visual)
 {
     visual->viewport = panel->viewport;
     log_trace("update visual viewport");
+    // GPU data normalization: the panel box is passed to the vertex shader as an affine transform.
+    if (_is_visual_transformed_on_gpu(visual, &panel->data_coords))
+        _gpu_data_transform(panel->data_coords.box, visual->data_origin, &visual->viewport);
     // Each graphics pipeline in the visual has its own transform/clip viewport options
     for (uint32_t pidx = 0; pidx < visual->graphics_count; pidx++)
     {
@@ -251,6 +402,540 @@ static void _update_visual_viewport(DvzPanel* panel, DvzVisual* visual)
 
 
 
+// Recompute the origin of a GPU-normalized visual, and express its POS props relative to it.
+static void _update_visual_origin(DvzPanel* panel, DvzVisual* visual)
+{
+    ASSERT(panel != NULL);
+    ASSERT(visual != NULL);
+
+    // The origin is the center of the visual box.
+    DvzBox box = _visual_box(visual);
+    dvec3 origin = {0};
+    for (uint32_t j = 0; j < 3; j++)
+        origin[j] = .5 * (box.p0[j] + box.p1[j]);
+    bool origin_moved = memcmp(origin, visual->data_origin, sizeof(dvec3)) != 0;
+    memcpy(visual->data_origin, origin, sizeof(dvec3));
+
+    DvzProp* prop = NULL;
+    for (uint32_t i = 0; i < 32; i++)
+    {
+        prop = dvz_prop_get(visual, DVZ_PROP_POS, i);
+        if (prop == NULL)
+            break;
+        _relative_pos_prop(visual, prop, origin_moved);
+    }
+
+    // The shift of the GPU transform depends on the origin.
+    _update_visual_viewport(panel, visual);
+}
+
+
+
+// Select the level of detail of a line strip or path from the panel width in pixels and the
+// panzoom zoom level. The vertex source is baked again when the level changes.
+static void _update_visual_lod(DvzPanel* panel, DvzVisual* visual)
+{
+    ASSERT(panel != NULL);
+    ASSERT(visual != NULL);
+    if ((visual->flags & DVZ_VISUAL_FLAGS_LOD) == 0)
+        return;
+
+    DvzProp* prop = dvz_prop_get(visual, DVZ_PROP_POS, 0);
+    if (prop == NULL || prop->arr_orig.item_count == 0)
+        return;
+    DvzLod* lod = &visual->lod;
+
+    // Only single line strips or paths are decimated.
+    DvzProp* prop_length = dvz_prop_get(visual, DVZ_PROP_LENGTH, 0);
+    uint32_t level = 0;
+    if (prop_length == NULL || prop_length->arr_orig.item_count <= 1)
+    {
+        // Rebuild the pyramid when the positions have changed.
+        if (!lod->valid)
+            _lod_build(lod, &prop->arr_orig);
+
+        // Number of pixels spanned by the samples, assumed to be uniformly spaced along x.
+        double width = panel->viewport.viewport.width;
+        DvzBox box = _visual_box(visual);
+        DvzBox panel_box = panel->data_coords.box;
+        double dx = panel_box.p1[0] - panel_box.p0[0];
+        if (dx > 0)
+            width *= (box.p1[0] - box.p0[0]) / dx;
+
+        DvzController* controller = panel->controller;
+        if (controller != NULL && controller->interact_count > 0 &&
+            (controller->interacts[0].type == DVZ_INTERACT_PANZOOM ||
+             controller->interacts[0].type == DVZ_INTERACT_PANZOOM_FIXED_ASPECT))
+            width *= controller->interacts[0].u.p.zoom[0];
+
+        level = _lod_level(lod, width);
+    }
+    if (level == lod->level)
+        return;
+
+    log_debug("level of detail changed from %d to %d", lod->level, level);
+    lod->level = level;
+    _source_set_changed(prop->source, true);
+}
+
+
+
+// Select the octree nodes of a point cloud visual from the panel MVP, and upload the nodes loaded
+// from disk along with the indirect draw commands.
+static void _update_visual_octree(DvzPanel* panel, DvzVisual* visual)
+{
+    ASSERT(panel != NULL);
+    ASSERT(visual != NULL);
+    DvzOctree* octree = visual->octree;
+    if (octree == NULL || octree->slot_count == 0)
+        return;
+    DvzContext* ctx = visual->canvas->gpu->context;
+    ASSERT(ctx != NULL);
+
+    DvzMVP mvp = {0};
+    DvzController* controller = panel->controller;
+    if (controller != NULL && controller->interact_count > 0)
+        mvp = controller->interacts[0].mvp;
+    else
+    {
+        glm_mat4_identity(mvp.model);
+        glm_mat4_identity(mvp.view);
+        glm_mat4_identity(mvp.proj);
+    }
+    vec2 size = {panel->viewport.viewport.width, panel->viewport.viewport.height};
+    dvz_octree_select(octree, &mvp, size);
+
+    // Upload the loaded nodes to their slots in the vertex buffer.
+    uint32_t load_count = dvz_octree_update(octree);
+    DvzSource* source = dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    ASSERT(source != NULL);
+    VkDeviceSize slot_size = octree->header.node_capacity * sizeof(DvzVertex);
+    DvzOctreeLoad* load = NULL;
+    for (uint32_t i = 0; i < load_count; i++)
+    {
+        load = &octree->loads[i];
+        dvz_upload_buffer(
+            ctx, source->u.br, load->slot * slot_size, load->point_count * sizeof(DvzVertex),
+            load->vertices);
+    }
+
+    if (octree->draws_changed)
+        dvz_upload_buffer(
+            ctx, visual->indirect, 0, octree->slot_count * sizeof(VkDrawIndirectCommand),
+            dvz_octree_draws(octree));
+}
+
+
+
+// Whether a box, in scene coordinates, is entirely out of the view of a model-view-projection
+// matrix. The box is culled if its 8 corners are on the outer side of the same clipping plane,
+// the planes being slightly enlarged so that markers and thick lines crossing the edges of the
+// viewport are kept.
+static bool _is_box_culled(mat4 mvp, DvzBox box)
+{
+    const float m = 1 + DVZ_CULL_MARGIN;
+    vec4 corner = {0}, clip = {0};
+    int outside[5] = {0};
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        corner[0] = (float)((i & 1) ? box.p1[0] : box.p0[0]);
+        corner[1] = (float)((i & 2) ? box.p1[1] : box.p0[1]);
+        corner[2] = (float)((i & 4) ? box.p1[2] : box.p0[2]);
+        corner[3] = 1;
+        glm_mat4_mulv(mvp, corner, clip);
+        outside[0] += clip[0] > +m * clip[3];
+        outside[1] += clip[0] < -m * clip[3];
+        outside[2] += clip[1] > +m * clip[3];
+        outside[3] += clip[1] < -m * clip[3];
+        outside[4] += clip[3] <= 0; // behind the camera
+    }
+    for (uint32_t j = 0; j < 5; j++)
+        if (outside[j] == 8)
+            return true;
+    return false;
+}
+
+
+
+// Cull the chunks of a visual that are out of view, by emptying their indirect draw commands.
+// The boxes of the chunks are only recomputed when the POS props change, and the visibility of
+// the chunks when the boxes, the data coordinates or the panel MVP change.
+static void _update_visual_chunks(DvzPanel* panel, DvzVisual* visual)
+{
+    ASSERT(panel != NULL);
+    ASSERT(visual != NULL);
+    DvzChunks* chunks = &visual->chunks;
+    DvzCanvas* canvas = visual->canvas;
+    ASSERT(canvas != NULL);
+
+    // NOTE: wait for the visual to be baked, so that the vertex buffer matches the POS props.
+    if ((visual->flags & DVZ_VISUAL_FLAGS_CULL) == 0 ||
+        visual->obj.request == DVZ_VISUAL_REQUEST_UPLOAD)
+        return;
+
+    // NOTE: the vertices of decimated line strips do not match the POS items anymore.
+    uint32_t r =
+        (visual->flags & DVZ_VISUAL_FLAGS_LOD) == 0 ? _chunks_vertices_per_item(visual) : 0;
+    if (r == 0)
+    {
+        if (chunks->active)
+        {
+            log_debug("visual cannot be drawn chunk by chunk anymore");
+            chunks->active = false;
+            dvz_canvas_to_refill(canvas);
+        }
+        return;
+    }
+
+    DvzProp* prop = dvz_prop_get(visual, DVZ_PROP_POS, 0);
+    ASSERT(prop != NULL);
+    uint32_t n = prop->arr_orig.item_count;
+    bool changed = _chunks_update_boxes(visual, n) || r != chunks->vertices_per_item;
+
+    // Combined model-view-projection matrix of the panel.
+    mat4 mvp = GLM_MAT4_IDENTITY_INIT;
+    DvzController* controller = panel->controller;
+    if (controller != NULL && controller->interact_count > 0)
+    {
+        DvzMVP* m = &controller->interacts[0].mvp;
+        mat4 vm = GLM_MAT4_IDENTITY_INIT;
+        glm_mat4_mul(m->view, m->model, vm);
+        glm_mat4_mul(m->proj, vm, mvp);
+    }
+    DvzBox data_box = panel->data_coords.box;
+    if (!changed && chunks->active && memcmp(mvp, chunks->mvp, sizeof(mat4)) == 0 &&
+        memcmp(&data_box, &chunks->data_box, sizeof(DvzBox)) == 0)
+        return;
+    glm_mat4_copy(mvp, chunks->mvp);
+    chunks->data_box = data_box;
+    chunks->vertices_per_item = r;
+
+    // Allocate the indirect draw commands, the command buffers must be refilled when the number
+    // of draw commands or the buffer change.
+    DvzContext* ctx = canvas->gpu->context;
+    ASSERT(ctx != NULL);
+    if (chunks->chunk_count > chunks->capacity)
+    {
+        chunks->capacity = MAX(16, dvz_next_pow2(chunks->chunk_count));
+        VkDeviceSize size = chunks->capacity * sizeof(VkDrawIndirectCommand);
+        if (chunks->draws.item_size == 0)
+            chunks->draws = dvz_array_struct(chunks->capacity, sizeof(VkDrawIndirectCommand));
+        else
+            dvz_array_resize(&chunks->draws, chunks->capacity);
+        chunks->indirect = dvz_ctx_buffers(ctx, DVZ_BUFFER_TYPE_STORAGE, 1, size);
+        chunks->active = false;
+    }
+    if (!chunks->active)
+    {
+        chunks->active = true;
+        dvz_canvas_to_refill(canvas);
+    }
+
+    // Visibility of the chunks, the boxes are transformed from the data coordinates to the
+    // scene coordinates as the POS props.
+    bool transform = (visual->flags & DVZ_VISUAL_FLAGS_TRANSFORM_NONE) == 0;
+    DvzTransformChain tc = _transforms_cds(panel, DVZ_CDS_DATA, DVZ_CDS_SCENE);
+    DvzBox* boxes = (DvzBox*)chunks->boxes.data;
+    VkDrawIndirectCommand* draws = (VkDrawIndirectCommand*)chunks->draws.data;
+    DvzBox box = {0};
+    dvec3 p0 = {0}, p1 = {0};
+    uint32_t first = 0, count = 0, visible = 0;
+    bool draws_changed = changed;
+    VkDrawIndirectCommand draw = {0};
+    for (uint32_t c = 0; c < chunks->capacity; c++)
+    {
+        memset(&draw, 0, sizeof(draw));
+        if (c < chunks->chunk_count)
+        {
+            box = boxes[c];
+            if (transform)
+            {
+                _transforms_apply(&tc, boxes[c].p0, p0);
+                _transforms_apply(&tc, boxes[c].p1, p1);
+                for (uint32_t j = 0; j < 3; j++)
+                {
+                    box.p0[j] = MIN(p0[j], p1[j]);
+                    box.p1[j] = MAX(p0[j], p1[j]);
+                }
+            }
+            first = c * DVZ_CHUNK_SIZE;
+            count = MIN(DVZ_CHUNK_SIZE, n - first);
+            draw.vertexCount = _is_box_culled(mvp, box) ? 0 : count * r;
+            draw.instanceCount = 1;
+            draw.firstVertex = first * r;
+            visible += draw.vertexCount > 0;
+        }
+        if (memcmp(&draws[c], &draw, sizeof(draw)) != 0)
+        {
+            draws[c] = draw;
+            draws_changed = true;
+        }
+    }
+    if (!draws_changed)
+        return;
+    log_trace("%d/%d chunks visible", visible, chunks->chunk_count);
+    dvz_upload_buffer(
+        ctx, chunks->indirect, 0, chunks->capacity * sizeof(VkDrawIndirectCommand),
+        chunks->draws.data);
+}
+
+
+
+// Number of workgroups of a binning compute task, the shaders loop over the remaining items.
+static uint32_t _group_count(uint32_t item_count, uint32_t group_size, uint32_t max_groups)
+{
+    uint32_t n = (item_count + group_size - 1) / group_size;
+    return MIN(n, max_groups);
+}
+
+// Bin the points of a density visual on the GPU. The bins are reallocated when the panel is
+// resized, and recomputed during a few frames when the view or the points change: the compute
+// tasks are dispatched indirectly, and are empty the rest of the time.
+static void _update_visual_density(DvzPanel* panel, DvzVisual* visual)
+{
+    ASSERT(panel != NULL);
+    ASSERT(visual != NULL);
+    DvzDensity* density = &visual->density;
+    if (!density->enabled)
+        return;
+
+    // NOTE: wait for the visual to be baked, so that the vertex buffer contains the new points.
+    if (visual->obj.request == DVZ_VISUAL_REQUEST_UPLOAD)
+    {
+        density->changed = true;
+        return;
+    }
+
+    DvzCanvas* canvas = visual->canvas;
+    ASSERT(canvas != NULL);
+    DvzContext* ctx = canvas->gpu->context;
+    ASSERT(ctx != NULL);
+    DvzSource* points = dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    DvzSource* viewport = dvz_source_get(visual, DVZ_SOURCE_TYPE_VIEWPORT, 0);
+    ASSERT(points != NULL);
+    ASSERT(viewport != NULL);
+    if (points->u.br.buffer == NULL || viewport->u.br.buffer == NULL)
+        return;
+    bool changed = density->changed;
+
+    // One bin per framebuffer pixel of the panel.
+    DvzGraphicsDensityHeader header = {0};
+    header.point_count = points->arr.item_count;
+    header.size[0] = panel->viewport.size_framebuffer[0];
+    header.size[1] = panel->viewport.size_framebuffer[1];
+    uint32_t bin_count = header.size[0] * header.size[1];
+    if (bin_count == 0)
+        return;
+    if (header.size[0] != density->header.size[0] || header.size[1] != density->header.size[1])
+    {
+        log_debug("allocate %dx%d density bins", header.size[0], header.size[1]);
+        density->bins = dvz_ctx_buffers(
+            ctx, DVZ_BUFFER_TYPE_STORAGE, 1,
+            sizeof(DvzGraphicsDensityHeader) + bin_count * sizeof(uint32_t));
+        dvz_visual_buffer(visual, DVZ_SOURCE_TYPE_OTHER, 0, density->bins);
+    }
+    if (density->dispatch.buffer == NULL)
+        density->dispatch = dvz_ctx_buffers(
+            ctx, DVZ_BUFFER_TYPE_STORAGE, 1, 2 * sizeof(VkDispatchIndirectCommand));
+
+    // Bind the buffers to the compute pipelines, the command buffers must then be refilled.
+    DvzBufferRegions bound[4] = {panel->br_mvp, viewport->u.br, points->u.br, density->bins};
+    if (memcmp(bound, density->bound, sizeof(bound)) != 0)
+    {
+        DvzBindings* bindings = NULL;
+        for (uint32_t i = 0; i < visual->compute_count; i++)
+        {
+            bindings = dvz_container_get(&visual->bindings_comp, i);
+            ASSERT(bindings != NULL);
+            for (uint32_t j = 0; j < 4; j++)
+                dvz_bindings_buffer(bindings, j, bound[j]);
+            dvz_bindings_update(bindings);
+        }
+        memcpy(density->bound, bound, sizeof(bound));
+        density->ready = true;
+        changed = true;
+        dvz_canvas_to_refill(canvas);
+    }
+
+    // The header is uploaded when the number of points or the panel size change.
+    if (memcmp(&header, &density->header, sizeof(header)) != 0)
+    {
+        density->header = header;
+        dvz_upload_buffer(ctx, density->bins, 0, sizeof(header), &density->header);
+        changed = true;
+    }
+
+    // The view.
+    mat4 mvp = GLM_MAT4_IDENTITY_INIT;
+    DvzController* controller = panel->controller;
+    if (controller != NULL && controller->interact_count > 0)
+    {
+        DvzMVP* m = &controller->interacts[0].mvp;
+        mat4 vm = GLM_MAT4_IDENTITY_INIT;
+        glm_mat4_mul(m->view, m->model, vm);
+        glm_mat4_mul(m->proj, vm, mvp);
+    }
+    if (memcmp(mvp, density->mvp, sizeof(mat4)) != 0 ||
+        memcmp(&visual->viewport, &density->viewport, sizeof(DvzViewport)) != 0)
+    {
+        glm_mat4_copy(mvp, density->mvp);
+        density->viewport = visual->viewport;
+        changed = true;
+    }
+    density->changed = false;
+
+    // The bins are recomputed in every command buffer in flight.
+    if (changed)
+        density->frames = canvas->swapchain.img_count + 1;
+    VkDispatchIndirectCommand cmds[2] = {{0, 1, 1}, {0, 1, 1}};
+    if (density->frames > 0)
+    {
+        cmds[0].x = _group_count(bin_count, DVZ_DENSITY_WORKGROUP_SIZE, DVZ_DENSITY_MAX_GROUPS);
+        cmds[1].x = _group_count(
+            header.point_count, DVZ_DENSITY_WORKGROUP_SIZE, DVZ_DENSITY_MAX_GROUPS);
+        if (density->frame_idx != canvas->frame_idx)
+        {
+            density->frame_idx = canvas->frame_idx;
+            density->frames--;
+        }
+    }
+    if (memcmp(cmds, density->dispatch_cmds, sizeof(cmds)) == 0)
+        return;
+    memcpy(density->dispatch_cmds, cmds, sizeof(cmds));
+    dvz_upload_buffer(ctx, density->dispatch, 0, sizeof(cmds), density->dispatch_cmds);
+}
+
+
+
+// Bin the samples of a histogram visual on the GPU. The bins are recomputed during a few frames
+// when the samples, the number of bins, or the range change. Only the params uniform buffer is
+// uploaded in the latter cases, the samples stay on the GPU.
+static void _update_visual_histogram(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    DvzHistogram* histogram = &visual->histogram;
+    if (!histogram->enabled)
+        return;
+
+    // NOTE: wait for the visual to be baked, so that the vertex buffer contains the new samples.
+    if (visual->obj.request == DVZ_VISUAL_REQUEST_UPLOAD)
+    {
+        histogram->changed = true;
+        return;
+    }
+
+    DvzCanvas* canvas = visual->canvas;
+    ASSERT(canvas != NULL);
+    DvzContext* ctx = canvas->gpu->context;
+    ASSERT(ctx != NULL);
+    DvzSource* samples = dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    DvzSource* params = dvz_source_get(visual, DVZ_SOURCE_TYPE_PARAM, 0);
+    ASSERT(samples != NULL);
+    ASSERT(params != NULL);
+    if (samples->u.br.buffer == NULL || params->u.br.buffer == NULL ||
+        params->arr.item_count == 0)
+        return;
+    bool changed = histogram->changed;
+
+    // The bins buffer is allocated once, with the maximum number of bins.
+    if (histogram->bins.buffer == NULL)
+    {
+        histogram->bins = dvz_ctx_buffers(
+            ctx, DVZ_BUFFER_TYPE_STORAGE, 1,
+            sizeof(DvzGraphicsHistogramHeader) + DVZ_HISTOGRAM_MAX_BINS * sizeof(uint32_t));
+        dvz_visual_buffer(visual, DVZ_SOURCE_TYPE_OTHER, 0, histogram->bins);
+        histogram->dispatch = dvz_ctx_buffers(
+            ctx, DVZ_BUFFER_TYPE_STORAGE, 1, 2 * sizeof(VkDispatchIndirectCommand));
+    }
+
+    // Bind the buffers to the compute pipelines, the command buffers must then be refilled.
+    DvzBufferRegions bound[3] = {params->u.br, samples->u.br, histogram->bins};
+    if (memcmp(bound, histogram->bound, sizeof(bound)) != 0)
+    {
+        DvzBindings* bindings = NULL;
+        for (uint32_t i = 0; i < visual->compute_count; i++)
+        {
+            bindings = dvz_container_get(&visual->bindings_comp, i);
+            ASSERT(bindings != NULL);
+            for (uint32_t j = 0; j < 3; j++)
+                dvz_bindings_buffer(bindings, j, bound[j]);
+            dvz_bindings_update(bindings);
+        }
+        memcpy(histogram->bound, bound, sizeof(bound));
+        histogram->ready = true;
+        changed = true;
+        dvz_canvas_to_refill(canvas);
+    }
+
+    // The number of samples is stored in the header of the bins buffer.
+    uint32_t sample_count = samples->arr.item_count;
+    if (sample_count != histogram->sample_count)
+    {
+        histogram->sample_count = sample_count;
+        dvz_upload_buffer(
+            ctx, histogram->bins, offsetof(DvzGraphicsHistogramHeader, sample_count),
+            sizeof(uint32_t), &histogram->sample_count);
+        changed = true;
+    }
+
+    // Number of bins and range.
+    DvzGraphicsHistogramParams* p = (DvzGraphicsHistogramParams*)params->arr.data;
+    ASSERT(p != NULL);
+    if (memcmp(p, &histogram->params, sizeof(DvzGraphicsHistogramParams)) != 0)
+    {
+        if (p->bin_count > DVZ_HISTOGRAM_MAX_BINS)
+            log_warn("only %d bins of the histogram are computed", DVZ_HISTOGRAM_MAX_BINS);
+        histogram->params = *p;
+        changed = true;
+    }
+    histogram->changed = false;
+
+    // The bins are recomputed in every command buffer in flight.
+    if (changed)
+        histogram->frames = canvas->swapchain.img_count + 1;
+    VkDispatchIndirectCommand cmds[2] = {{0, 1, 1}, {0, 1, 1}};
+    if (histogram->frames > 0)
+    {
+        // NOTE: the clear task also writes the draw command, it needs at least one workgroup.
+        uint32_t bin_count = MIN(p->bin_count, DVZ_HISTOGRAM_MAX_BINS);
+        cmds[0].x = _group_count(
+            MAX(bin_count, 1), DVZ_HISTOGRAM_WORKGROUP_SIZE, DVZ_HISTOGRAM_MAX_GROUPS);
+        cmds[1].x =
+            _group_count(sample_count, DVZ_HISTOGRAM_WORKGROUP_SIZE, DVZ_HISTOGRAM_MAX_GROUPS);
+        if (histogram->frame_idx != canvas->frame_idx)
+        {
+            histogram->frame_idx = canvas->frame_idx;
+            histogram->frames--;
+        }
+    }
+    if (memcmp(cmds, histogram->dispatch_cmds, sizeof(cmds)) == 0)
+        return;
+    memcpy(histogram->dispatch_cmds, cmds, sizeof(cmds));
+    dvz_upload_buffer(ctx, histogram->dispatch, 0, sizeof(cmds), histogram->dispatch_cmds);
+}
+
+
+
+// Rebind the glyph atlas of text visuals when its texture has been resized while baking another
+// visual, as the resized texture is a new image with a new size.
+static void _update_visual_glyphs(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    DvzGlyphAtlas* atlas = visual->canvas->gpu->context->glyph_atlas;
+    ASSERT(atlas != NULL);
+    if (visual->glyph_generation == atlas->generation)
+        return;
+    DvzSource* source = dvz_source_get(visual, DVZ_SOURCE_TYPE_FONT_ATLAS, 0);
+    if (source == NULL || source->u.tex != atlas->texture)
+        return;
+
+    log_debug("rebind the resized glyph atlas to visual");
+    _text_font_atlas(visual, false);
+    visual->obj.request = DVZ_VISUAL_REQUEST_UPLOAD;
+}
+
+
+
 // Bind the MVP and viewport buffers.
 static void _common_data(DvzPanel* panel, DvzVisual* visual)
 {
@@ -434,7 +1119,12 @@ static void _process_prop_changed(DvzSceneUpdate up)
     ASSERT(up.visual != NULL);
     if (up.prop->prop_type == DVZ_PROP_POS && _is_visual_to_transform(up.visual))
     {
-        _transform_pos_prop(coords, up.prop);
+        // With GPU data normalization, the positions are only made relative to the visual
+        // origin here, and the panel box is applied in the vertex shader.
+        if (_is_visual_transformed_on_gpu(up.visual, &coords))
+            _update_visual_origin(up.panel, up.visual);
+        else
+            _transform_pos_prop(coords, up.prop);
 
         if ((up.visual->flags & DVZ_VISUAL_FLAGS_TRANSFORM_BOX_INIT) == 0)
         {
@@ -501,6 +1191,13 @@ static void _process_coords_changed(DvzSceneUpdate up)
             continue;
         }
 
+        // GPU data normalization: only the viewport uniform needs to be updated.
+        if (_is_visual_transformed_on_gpu(visual, &panel->data_coords))
+        {
+            _update_visual_viewport(panel, visual);
+            continue;
+        }
+
         // Go through all visual props.
         iter = dvz_container_iterator(&visual->props);
         while (iter.item != NULL)
@@ -511,6 +1208,8 @@ static void _process_coords_changed(DvzSceneUpdate up)
             // Transform all POS props with the panel data coordinates.
             if (prop->prop_type == DVZ_PROP_POS)
             {
+                // All items need to be renormalized with the new coordinates.
+                _prop_set_dirty(prop, 0, prop->arr_orig.item_count);
                 _enqueue_prop_changed(panel, visual, prop);
             }
 
@@ -799,6 +1498,24 @@ static void _enqueue_all_visuals_changed(DvzScene* scene)
             // if (panel->obj.request == 1)
             //     _enqueue_panel_changed(panel);
 
+            // Level of detail depending on the zoom level, may require a new bake.
+            _update_visual_lod(panel, visual);
+
+            // Out-of-core point clouds, the visible octree nodes depend on the MVP.
+            _update_visual_octree(panel, visual);
+
+            // Skip the chunks of large visuals that are out of view.
+            _update_visual_chunks(panel, visual);
+
+            // GPU binning of the points of density visuals, depending on the MVP.
+            _update_visual_density(panel, visual);
+
+            // GPU binning of the samples of histogram visuals.
+            _update_visual_histogram(visual);
+
+            // Text visuals bound to the glyph atlas after it has grown.
+            _update_visual_glyphs(visual);
+
             // Process visual upload.
             if (visual->obj.request == DVZ_VISUAL_REQUEST_UPLOAD)
             {
@@ -879,6 +1596,324 @@ static void _process_scene_updates(DvzScene* scene)
 
 
 
+/*************************************************************************************************/
+/*  Draw batches                                                                                 */
+/*************************************************************************************************/
+
+// Whether the GPU supports draw batches: multi-draw indirect commands, and the draw index in the
+// shaders. Otherwise, all visuals are drawn separately.
+static inline bool _has_draw_batches(DvzGpu* gpu)
+{
+    ASSERT(gpu != NULL);
+    return gpu->requested_features.multiDrawIndirect && gpu->draw_parameters;
+}
+
+
+
+// Whether a graphics pipeline has a variant supporting draw batches.
+static inline bool _is_graphics_batchable(DvzGraphics* graphics)
+{
+    ASSERT(graphics != NULL);
+    // The other vertex bindings (split or scalar colors) are not supported.
+    int flags = DVZ_GRAPHICS_FLAGS_SPLIT_COLOR | DVZ_GRAPHICS_FLAGS_SCALAR_COLOR;
+    if ((graphics->flags & flags) != 0)
+        return false;
+    switch (graphics->type)
+    {
+    case DVZ_GRAPHICS_LINE:
+    case DVZ_GRAPHICS_LINE_STRIP:
+    case DVZ_GRAPHICS_TRIANGLE:
+    case DVZ_GRAPHICS_TRIANGLE_STRIP:
+    case DVZ_GRAPHICS_TRIANGLE_FAN:
+    case DVZ_GRAPHICS_MARKER:
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+
+// Whether a visual can be drawn in a draw batch: a single basic or marker graphics pipeline drawn
+// by the default fill callback, with vertex and index buffer regions that can be addressed by
+// index from the start of the buffers.
+static bool _is_visual_batchable(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    if (!_has_draw_batches(visual->canvas->gpu))
+        return false;
+    if (visual->callback_fill != _default_visual_fill || visual->graphics_count != 1 ||
+        visual->chunks.active || !_is_graphics_batchable(visual->graphics[0]))
+        return false;
+
+    DvzSource* source = _get_pipeline_source(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    if (source == NULL || source->arr.item_count == 0 || source->u.br.buffer == NULL ||
+        source->u.br.count != 1 || (source->flags & DVZ_SOURCE_FLAG_RING) != 0 ||
+        source->u.br.offsets[0] % source->arr.item_size != 0)
+        return false;
+
+    source = _get_pipeline_source(visual, DVZ_SOURCE_TYPE_INDEX, 0);
+    if (source != NULL && source->arr.item_count > 0 &&
+        (source->u.br.buffer == NULL || source->u.br.count != 1 ||
+         source->u.br.offsets[0] % sizeof(DvzIndex) != 0))
+        return false;
+
+    return true;
+}
+
+
+
+static inline bool _is_visual_indexed(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    DvzSource* source = _get_pipeline_source(visual, DVZ_SOURCE_TYPE_INDEX, 0);
+    return source != NULL && source->arr.item_count > 0;
+}
+
+
+
+// Whether two batchable visuals can be drawn in the same draw batch: same graphics pipeline, and
+// vertices and indices in the same buffers.
+static bool _is_batch_compatible(DvzVisual* visual, DvzVisual* other)
+{
+    ASSERT(visual != NULL);
+    ASSERT(other != NULL);
+    if (visual->graphics[0] != other->graphics[0])
+        return false;
+    bool indexed = _is_visual_indexed(visual);
+    if (indexed != _is_visual_indexed(other))
+        return false;
+
+    DvzSourceType types[2] = {DVZ_SOURCE_TYPE_VERTEX, DVZ_SOURCE_TYPE_INDEX};
+    for (uint32_t i = 0; i < (indexed ? 2 : 1); i++)
+    {
+        if (_get_pipeline_source(visual, types[i], 0)->u.br.buffer !=
+            _get_pipeline_source(other, types[i], 0)->u.br.buffer)
+            return false;
+    }
+    return true;
+}
+
+
+
+// Per-draw data of a visual in a draw batch: its viewport and the params of its graphics.
+static void _batch_draw(DvzVisual* visual, DvzGraphicsBatchDraw* draw)
+{
+    ASSERT(visual != NULL);
+    ASSERT(draw != NULL);
+    memset(draw, 0, sizeof(DvzGraphicsBatchDraw));
+
+    DvzSource* source = dvz_source_get(visual, DVZ_SOURCE_TYPE_VIEWPORT, 0);
+    if (source != NULL && source->arr.item_count > 0)
+        memcpy(&draw->viewport, dvz_array_item(&source->arr, 0), sizeof(DvzViewport));
+
+    source = dvz_source_get(visual, DVZ_SOURCE_TYPE_PARAM, 0);
+    if (source != NULL && source->arr.item_count > 0)
+        memcpy(
+            draw->params, dvz_array_item(&source->arr, 0),
+            MIN(source->arr.item_size, sizeof(draw->params)));
+}
+
+
+
+// Indirect draw command of a visual in a draw batch. The vertices and indices are addressed from
+// the start of the vertex and index buffers shared by the visuals of the batch.
+static void _batch_cmd(DvzVisual* visual, bool indexed, VkDrawIndexedIndirectCommand* cmd)
+{
+    ASSERT(visual != NULL);
+    ASSERT(cmd != NULL);
+    memset(cmd, 0, sizeof(VkDrawIndexedIndirectCommand));
+    // The visual is skipped if it can no longer be drawn in the batch, until the next refill.
+    if (!_is_visual_batchable(visual) || _is_visual_indexed(visual) != indexed)
+        return;
+
+    DvzSource* vertex_source = _get_pipeline_source(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    ASSERT(vertex_source != NULL);
+    uint32_t first_vertex =
+        (uint32_t)(vertex_source->u.br.offsets[0] / vertex_source->arr.item_size);
+
+    if (indexed)
+    {
+        DvzSource* index_source = _get_pipeline_source(visual, DVZ_SOURCE_TYPE_INDEX, 0);
+        ASSERT(index_source != NULL);
+        cmd->indexCount = index_source->arr.item_count;
+        cmd->instanceCount = 1;
+        cmd->firstIndex = (uint32_t)(index_source->u.br.offsets[0] / sizeof(DvzIndex));
+        cmd->vertexOffset = (int32_t)first_vertex;
+        return;
+    }
+
+    // NOTE: non-indexed draw commands are stored in the same struct, see _update_indirect().
+    uint32_t vertex_count = 0, instance_count = 0;
+    _draw_counts(visual, vertex_source, &vertex_count, &instance_count);
+    VkDrawIndirectCommand* draw = (VkDrawIndirectCommand*)cmd;
+    draw->vertexCount = vertex_count;
+    draw->instanceCount = instance_count;
+    draw->firstVertex = first_vertex;
+}
+
+
+
+// Upload the per-draw data and the draw command of a visual in a draw batch, if they have changed.
+static void _update_batch_draw(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    DvzDrawBatch* batch = visual->batch;
+    if (batch == NULL)
+        return;
+    DvzContext* ctx = visual->canvas->gpu->context;
+    ASSERT(ctx != NULL);
+
+    // NOTE: the uploads are deferred while the app is running, so the uploaded data must outlive
+    // this function: the persistent copies in the visual are uploaded.
+    DvzGraphicsBatchDraw draw = {0};
+    _batch_draw(visual, &draw);
+    VkDeviceSize size = sizeof(DvzGraphicsBatchDraw);
+    if (memcmp(&draw, &visual->batch_draw, size) != 0)
+    {
+        memcpy(&visual->batch_draw, &draw, size);
+        dvz_upload_buffer(
+            ctx, batch->draws, visual->batch_idx * size, size, &visual->batch_draw);
+    }
+
+    VkDrawIndexedIndirectCommand cmd = {0};
+    _batch_cmd(visual, batch->indexed, &cmd);
+    size = batch->indexed ? sizeof(VkDrawIndexedIndirectCommand) : sizeof(VkDrawIndirectCommand);
+    if (memcmp(&cmd, &visual->batch_cmd, sizeof(cmd)) != 0)
+    {
+        memcpy(&visual->batch_cmd, &cmd, sizeof(cmd));
+        dvz_upload_buffer(
+            ctx, batch->indirect, visual->batch_idx * size, size, &visual->batch_cmd);
+    }
+}
+
+
+
+// Upload the per-draw data and the draw commands of the draw batches of a panel. This is called
+// at every frame, as the viewports, the params and the number of items of the visuals can change
+// without a command buffer refill.
+static void _update_panel_batches(DvzPanel* panel)
+{
+    ASSERT(panel != NULL);
+    for (uint32_t k = 0; k < panel->visual_count; k++)
+        _update_batch_draw(panel->visuals[k]);
+}
+
+
+
+// Assign a visual to a draw batch (or to none), and force the upload of its per-draw data and
+// draw command if its location in the batches has changed.
+static void _batch_assign(DvzVisual* visual, DvzDrawBatch* batch, uint32_t batch_idx)
+{
+    ASSERT(visual != NULL);
+    if (visual->batch == batch && visual->batch_idx == batch_idx)
+        return;
+    visual->batch = batch;
+    visual->batch_idx = batch_idx;
+    memset(&visual->batch_draw, 0, sizeof(DvzGraphicsBatchDraw));
+    memset(&visual->batch_cmd, 0, sizeof(VkDrawIndexedIndirectCommand));
+}
+
+
+
+// Create the GPU objects of a draw batch slot of a panel, the first time the slot is used.
+static void _batch_create(DvzPanel* panel, DvzDrawBatch* batch)
+{
+    ASSERT(panel != NULL);
+    ASSERT(batch != NULL);
+    ASSERT(batch->graphics != NULL);
+    if (dvz_obj_is_created(&batch->bindings.obj))
+        return;
+
+    DvzCanvas* canvas = panel->grid->canvas;
+    ASSERT(canvas != NULL);
+    DvzContext* ctx = canvas->gpu->context;
+    ASSERT(ctx != NULL);
+
+    log_debug("create the GPU objects of draw batch #%d", batch - panel->batches);
+    batch->draws = dvz_ctx_buffers(
+        ctx, DVZ_BUFFER_TYPE_STORAGE, 1, DVZ_MAX_VISUALS_PER_PANEL * sizeof(DvzGraphicsBatchDraw));
+    batch->indirect = dvz_ctx_buffers(
+        ctx, DVZ_BUFFER_TYPE_STORAGE, 1,
+        DVZ_MAX_VISUALS_PER_PANEL * sizeof(VkDrawIndexedIndirectCommand));
+
+    batch->bindings = dvz_bindings(&batch->graphics->slots, canvas->swapchain.img_count);
+    dvz_bindings_buffer(&batch->bindings, 0, panel->br_mvp);
+    dvz_bindings_buffer(&batch->bindings, 1, batch->draws);
+    dvz_bindings_update(&batch->bindings);
+}
+
+
+
+// Buffer regions covering a whole buffer.
+static inline DvzBufferRegions _whole_buffer(DvzBuffer* buffer)
+{
+    ASSERT(buffer != NULL);
+    DvzBufferRegions br = {0};
+    br.buffer = buffer;
+    br.count = 1;
+    br.size = buffer->size;
+    return br;
+}
+
+
+
+// Fill the command buffer with a draw batch: the vertex and index buffers and the graphics
+// pipeline are bound once, and all visuals are drawn with a single multi-draw indirect command.
+static void
+_batch_fill(DvzPanel* panel, DvzVisual** visuals, uint32_t count, DvzVisualFillEvent* fev)
+{
+    ASSERT(panel != NULL);
+    ASSERT(visuals != NULL);
+    ASSERT(fev != NULL);
+    ASSERT(count >= 2);
+    ASSERT(count <= DVZ_MAX_VISUALS_PER_PANEL);
+    ASSERT(panel->batch_count < DVZ_MAX_DRAW_BATCHES);
+
+    DvzVisual* visual = visuals[0];
+    DvzGraphics* graphics = visual->graphics[0];
+    DvzDrawBatch* batch = &panel->batches[panel->batch_count++];
+    batch->graphics = dvz_graphics_builtin(
+        visual->canvas, graphics->type, graphics->flags | DVZ_GRAPHICS_FLAGS_DRAW_BATCH);
+    // The depth test may have been changed on the pipeline of the visual, see _visual_marker().
+    batch->graphics->depth_test = graphics->depth_test;
+    batch->indexed = _is_visual_indexed(visual);
+    batch->draw_count = count;
+    _batch_create(panel, batch);
+    log_trace("draw batch of %d visuals", count);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        _batch_assign(visuals[i], batch, i);
+        _update_batch_draw(visuals[i]);
+    }
+
+    // Bind the vertex and index buffers shared by all visuals.
+    DvzCommands* cmds = fev->cmds;
+    uint32_t idx = fev->cmd_idx;
+    DvzSource* source = _get_pipeline_source(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    dvz_cmd_bind_vertex_buffer(cmds, idx, 0, _whole_buffer(source->u.br.buffer), 0);
+    if (batch->indexed)
+    {
+        source = _get_pipeline_source(visual, DVZ_SOURCE_TYPE_INDEX, 0);
+        dvz_cmd_bind_index_buffer(cmds, idx, _whole_buffer(source->u.br.buffer), 0);
+    }
+
+    // Bind the graphics pipeline, unless it is already bound.
+    if (fev->bound_graphics == batch->graphics)
+        dvz_cmd_bind_descriptors(cmds, idx, batch->graphics, &batch->bindings, 0);
+    else
+        dvz_cmd_bind_graphics(cmds, idx, batch->graphics, &batch->bindings, 0);
+    fev->bound_graphics = batch->graphics;
+
+    if (batch->indexed)
+        dvz_cmd_draw_indexed_indirect(cmds, idx, batch->indirect, count);
+    else
+        dvz_cmd_draw_indirect(cmds, idx, batch->indirect, count);
+}
+
+
+
 /*************************************************************************************************/
 /*  Scene callbacks                                                                              */
 /*************************************************************************************************/
@@ -918,6 +1953,120 @@ static void _scene_init(DvzCanvas* canvas, DvzEvent ev)
 
 
 
+// Return the graphics pipeline left bound in the command buffer after a visual has been drawn, or
+// NULL if it cannot be determined (custom fill callback, several graphics pipelines, etc.)
+static DvzGraphics* _visual_bound_graphics(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    if (visual->callback_fill != _default_visual_fill || visual->graphics_count != 1)
+        return NULL;
+    // Empty graphics pipelines are skipped by the default fill callback.
+    DvzSource* source = _get_pipeline_source(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    if (source == NULL || source->arr.item_count == 0)
+        return NULL;
+    return visual->graphics[0];
+}
+
+
+
+// Fill the command buffer with successive visuals that can be drawn in the same draw batch. A
+// single visual, or the visuals beyond the maximum number of batches per panel, are drawn
+// separately.
+static void
+_run_fill(DvzPanel* panel, DvzVisual** visuals, uint32_t count, DvzVisualFillEvent* fev)
+{
+    ASSERT(panel != NULL);
+    ASSERT(visuals != NULL);
+    ASSERT(fev != NULL);
+    if (count >= 2 && panel->batch_count < DVZ_MAX_DRAW_BATCHES)
+    {
+        _batch_fill(panel, visuals, count, fev);
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        _batch_assign(visuals[i], NULL, 0);
+        visuals[i]->callback_fill(visuals[i], *fev);
+        fev->bound_graphics = _visual_bound_graphics(visuals[i]);
+    }
+}
+
+
+
+// Fill the command buffer with the visuals of a panel having a given priority, in the order they
+// were added, which is the drawing order of overlapping 2D visuals. When successive visuals share
+// the same graphics pipeline, the pipeline is only bound once. When the GPU supports it,
+// successive basic and marker visuals sharing the same pipeline and buffers are drawn with a
+// single multi-draw indirect command.
+static void _panel_fill(
+    DvzPanel* panel, int priority, DvzCommands* cmds, uint32_t img_idx,
+    VkClearColorValue clear_color, DvzViewport viewport)
+{
+    ASSERT(panel != NULL);
+
+    DvzVisualFillEvent fev = {0};
+    fev.clear_color = clear_color;
+    fev.cmds = cmds;
+    fev.cmd_idx = img_idx;
+    fev.viewport = viewport;
+
+    // Successive visuals that can be drawn in the same draw batch.
+    DvzVisual* run[DVZ_MAX_VISUALS_PER_PANEL] = {0};
+    uint32_t run_count = 0;
+
+    DvzVisual* visual = NULL;
+    for (uint32_t k = 0; k < panel->visual_count; k++)
+    {
+        visual = panel->visuals[k];
+        if (visual->priority != priority)
+            continue;
+        ASSERT(visual->callback_fill != NULL);
+
+        if (_is_visual_batchable(visual))
+        {
+            if (run_count > 0 && !_is_batch_compatible(run[0], visual))
+            {
+                _run_fill(panel, run, run_count, &fev);
+                run_count = 0;
+            }
+            run[run_count++] = visual;
+            continue;
+        }
+
+        // The pending draw batch must be drawn first to keep the drawing order.
+        _run_fill(panel, run, run_count, &fev);
+        run_count = 0;
+
+        _batch_assign(visual, NULL, 0);
+        visual->callback_fill(visual, fev);
+        fev.bound_graphics = _visual_bound_graphics(visual);
+    }
+    _run_fill(panel, run, run_count, &fev);
+}
+
+
+
+// Record the compute commands of the visuals of a panel.
+static void _panel_fill_compute(DvzPanel* panel, DvzCommands* cmds, uint32_t img_idx)
+{
+    ASSERT(panel != NULL);
+
+    DvzVisualFillEvent fev = {0};
+    fev.cmds = cmds;
+    fev.cmd_idx = img_idx;
+    fev.viewport = dvz_panel_viewport(panel);
+
+    DvzVisual* visual = NULL;
+    for (uint32_t k = 0; k < panel->visual_count; k++)
+    {
+        visual = panel->visuals[k];
+        if (visual->callback_compute != NULL)
+            visual->callback_compute(visual, fev);
+    }
+}
+
+
+
 // Refill the command buffer with all panels and visuals.
 // NOTE: the panel viewports must have been updated first.
 static void _scene_fill(DvzCanvas* canvas, DvzEvent ev)
@@ -933,7 +2082,6 @@ static void _scene_fill(DvzCanvas* canvas, DvzEvent ev)
     DvzCommands* cmds = NULL;
     DvzPanel* panel = NULL;
     DvzContainerIterator iter;
-    DvzVisual* visual = NULL;
     uint32_t img_idx = 0;
 
     // Go through all the current command buffers.
@@ -943,7 +2091,16 @@ static void _scene_fill(DvzCanvas* canvas, DvzEvent ev)
         img_idx = ev.u.rf.img_idx;
 
         log_trace("visual fill cmd %d begin %d", i, img_idx);
-        dvz_visual_fill_begin(canvas, cmds, img_idx);
+        dvz_cmd_begin(cmds, img_idx);
+
+        // Compute commands must be recorded before the render pass.
+        iter = dvz_container_iterator(&grid->panels);
+        while (iter.item != NULL)
+        {
+            _panel_fill_compute(iter.item, cmds, img_idx);
+            dvz_container_iter(&iter);
+        }
+        dvz_cmd_begin_renderpass(cmds, img_idx, &canvas->renderpass, &canvas->framebuffers);
 
         iter = dvz_container_iterator(&grid->panels);
         while (iter.item != NULL)
@@ -955,19 +2112,9 @@ static void _scene_fill(DvzCanvas* canvas, DvzEvent ev)
             dvz_cmd_viewport(cmds, img_idx, viewport.viewport);
 
             // Go through all visuals in the panel.
-            visual = NULL;
+            panel->batch_count = 0;
             for (int priority = -panel->prority_max; priority <= panel->prority_max; priority++)
-            {
-                for (uint32_t k = 0; k < panel->visual_count; k++)
-                {
-                    visual = panel->visuals[k];
-                    if (visual->priority != priority)
-                        continue;
-
-                    dvz_visual_fill_event(
-                        visual, ev.u.rf.clear_color, cmds, img_idx, viewport, NULL);
-                }
-            }
+                _panel_fill(panel, priority, cmds, img_idx, ev.u.rf.clear_color, viewport);
 
             dvz_container_iter(&iter);
         }
@@ -1019,6 +2166,14 @@ static void _scene_frame(DvzCanvas* canvas, DvzEvent ev)
 
     // Process the scene updates.
     _process_scene_updates(scene);
+
+    // Upload the per-draw data of the draw batches, which may have changed with the updates.
+    DvzContainerIterator iter = dvz_container_iterator(&scene->grid.panels);
+    while (iter.item != NULL)
+    {
+        _update_panel_batches(iter.item);
+        dvz_container_iter(&iter);
+    }
 }
 
 
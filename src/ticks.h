@@ -511,6 +511,10 @@ static DvzAxesTicks wilk_ext(double dmin, double dmax, int32_t m, DvzAxesContext
         for (u = 0; u < n; u++)
         {
             // printf("u %d\n", u);
+            // Abort the search if the result is no longer needed.
+            if (ctx.cancel != NULL && atomic_load(ctx.cancel))
+                return best_ticks;
+
             q.i = u;
             q.value = DEFAULT_Q[q.i];
             sm = simplicity_max(q, j);
@@ -689,6 +693,11 @@ static DvzAxesTicks dvz_ticks(double dmin, double dmax, DvzAxesContext ctx)
         "viewport size %.1f, glyph size %.1f, extension %d",
         ctx.coord, label_count_req, dmin, dmax, ctx.size_viewport, ctx.size_glyph, ctx.extensions);
     ticks = wilk_ext(dmin, dmax, label_count_req, ctx);
+    if (ctx.cancel != NULL && atomic_load(ctx.cancel))
+    {
+        log_trace("tick computation cancelled");
+        return ticks;
+    }
 
     if (ticks.value_count == 0)
     {
@@ -727,4 +736,307 @@ static void dvz_ticks_destroy(DvzAxesTicks* ticks)
 
 
 
+/*************************************************************************************************/
+/*  Memoization                                                                                  */
+/*************************************************************************************************/
+
+#define TICKS_QUANTIZE_EPS 1e-6
+
+// Copy ticks, with their values and labels.
+static DvzAxesTicks _ticks_copy(DvzAxesTicks* ticks)
+{
+    ASSERT(ticks != NULL);
+    DvzAxesTicks out = *ticks;
+    uint32_t n = MAX(1, ticks->value_count);
+    out.values = (double*)calloc(n, sizeof(double));
+    out.labels = (char*)calloc(n * MAX_GLYPHS_PER_TICK, sizeof(char));
+    if (ticks->values != NULL)
+        memcpy(out.values, ticks->values, ticks->value_count * sizeof(double));
+    if (ticks->labels != NULL)
+        memcpy(out.labels, ticks->labels, ticks->value_count * MAX_GLYPHS_PER_TICK);
+    return out;
+}
+
+
+
+// Whether two tick sets have the same values and labels.
+static bool _ticks_equal(DvzAxesTicks* a, DvzAxesTicks* b)
+{
+    ASSERT(a != NULL);
+    ASSERT(b != NULL);
+    if (a->values == NULL || b->values == NULL)
+        return false;
+    return a->value_count == b->value_count && a->lmin_in == b->lmin_in &&
+           a->lstep == b->lstep && a->format == b->format && a->precision == b->precision;
+}
+
+
+
+// Memo key of a tick computation. The range is widened to multiples of a tenth of its order of
+// magnitude, so that ranges that differ by less than that share the same ticks.
+static DvzTicksMemo _ticks_key(dvec2 range, DvzAxesContext* ctx)
+{
+    ASSERT(range[0] < range[1]);
+    ASSERT(ctx != NULL);
+
+    DvzTicksMemo key = {0};
+    key.coord = ctx->coord;
+    key.size_viewport = ctx->size_viewport;
+    key.size_glyph = ctx->size_glyph;
+
+    double step = pow(10., floor(log10(range[1] - range[0])) - 1);
+    key.range[0] = floor(range[0] / step + TICKS_QUANTIZE_EPS) * step;
+    key.range[1] = ceil(range[1] / step - TICKS_QUANTIZE_EPS) * step;
+
+    // Loss of precision with huge values.
+    if (!(key.range[0] < key.range[1]))
+    {
+        key.range[0] = range[0];
+        key.range[1] = range[1];
+    }
+    return key;
+}
+
+
+
+static bool _ticks_key_equal(DvzTicksMemo* a, DvzTicksMemo* b)
+{
+    ASSERT(a != NULL);
+    ASSERT(b != NULL);
+    return a->coord == b->coord && a->range[0] == b->range[0] && a->range[1] == b->range[1] &&
+           a->size_viewport == b->size_viewport && a->size_glyph == b->size_glyph;
+}
+
+
+
+/**
+ * Find memoized ticks.
+ *
+ * @param worker the tick worker
+ * @param key the memo key, as returned by `_ticks_key()`
+ * @returns the memoized ticks, owned by the worker, or NULL
+ */
+static DvzAxesTicks* dvz_ticks_memo_get(DvzTicksWorker* worker, DvzTicksMemo* key)
+{
+    ASSERT(worker != NULL);
+    ASSERT(key != NULL);
+
+    for (uint32_t i = 0; i < DVZ_TICKS_MEMO_SIZE; i++)
+    {
+        if (worker->memo[i].last_used > 0 && _ticks_key_equal(&worker->memo[i], key))
+        {
+            worker->memo[i].last_used = ++worker->clock;
+            return &worker->memo[i].ticks;
+        }
+    }
+    return NULL;
+}
+
+
+
+/**
+ * Memoize ticks, evicting the least recently used entry if the memo is full.
+ *
+ * @param worker the tick worker
+ * @param key the memo key, as returned by `_ticks_key()`
+ * @param ticks the ticks, which are copied
+ */
+static void dvz_ticks_memo_set(DvzTicksWorker* worker, DvzTicksMemo* key, DvzAxesTicks* ticks)
+{
+    ASSERT(worker != NULL);
+    ASSERT(key != NULL);
+    ASSERT(ticks != NULL);
+
+    if (ticks->value_count == 0 || ticks->values == NULL)
+        return;
+
+    uint32_t idx = 0;
+    for (uint32_t i = 0; i < DVZ_TICKS_MEMO_SIZE; i++)
+    {
+        if (worker->memo[i].last_used < worker->memo[idx].last_used)
+            idx = i;
+        if (worker->memo[i].last_used > 0 && _ticks_key_equal(&worker->memo[i], key))
+        {
+            idx = i;
+            break;
+        }
+    }
+
+    DvzTicksMemo* memo = &worker->memo[idx];
+    dvz_ticks_destroy(&memo->ticks);
+    *memo = *key;
+    memo->ticks = _ticks_copy(ticks);
+    memo->last_used = ++worker->clock;
+}
+
+
+
+/*************************************************************************************************/
+/*  Tick worker                                                                                  */
+/*************************************************************************************************/
+
+static void* _ticks_thread(void* user_data)
+{
+    DvzTicksWorker* worker = (DvzTicksWorker*)user_data;
+    ASSERT(worker != NULL);
+
+    DvzTicksRequest* req = NULL;
+    while (true)
+    {
+        req = (DvzTicksRequest*)dvz_fifo_dequeue(&worker->requests, true);
+        if (req == NULL)
+            break;
+
+        // Skip the requests cancelled while they were waiting in the queue.
+        if (!atomic_load(&req->cancelled))
+        {
+            req->ctx.cancel = &req->cancelled;
+            req->memo.ticks = dvz_ticks(req->memo.range[0], req->memo.range[1], req->ctx);
+            req->ctx.cancel = NULL;
+        }
+
+        // The main thread takes the ownership of the request back.
+        dvz_fifo_enqueue(&worker->results, req);
+    }
+    return NULL;
+}
+
+
+
+/**
+ * Start a thread computing the ticks in the background.
+ *
+ * @returns the tick worker
+ */
+static DvzTicksWorker* dvz_ticks_worker(void)
+{
+    DvzTicksWorker* worker = (DvzTicksWorker*)calloc(1, sizeof(DvzTicksWorker));
+    worker->requests = dvz_fifo(8);
+    worker->results = dvz_fifo(8);
+    worker->thread = dvz_thread(_ticks_thread, worker);
+    return worker;
+}
+
+
+
+/**
+ * Whether a tick computation is in flight on an axis.
+ *
+ * @param worker the tick worker
+ * @param coord the axis coordinate
+ * @returns whether a request has been submitted and its result has not been polled yet
+ */
+static bool dvz_ticks_pending(DvzTicksWorker* worker, DvzAxisCoord coord)
+{
+    ASSERT(worker != NULL);
+    ASSERT(coord <= DVZ_AXES_COORD_Y);
+    return worker->pending[coord] != NULL;
+}
+
+
+
+/**
+ * Cancel the tick computation in flight on an axis, if any.
+ *
+ * @param worker the tick worker
+ * @param coord the axis coordinate
+ */
+static void dvz_ticks_cancel(DvzTicksWorker* worker, DvzAxisCoord coord)
+{
+    ASSERT(worker != NULL);
+    ASSERT(coord <= DVZ_AXES_COORD_Y);
+
+    // NOTE: the request is freed when the worker thread returns it, in dvz_ticks_poll().
+    if (worker->pending[coord] != NULL)
+        atomic_store(&worker->pending[coord]->cancelled, true);
+    worker->pending[coord] = NULL;
+}
+
+
+
+/**
+ * Submit a tick computation to the worker thread, cancelling the one in flight on the same axis.
+ *
+ * @param worker the tick worker
+ * @param key the memo key, as returned by `_ticks_key()`
+ * @param ctx the axes context
+ */
+static void dvz_ticks_submit(DvzTicksWorker* worker, DvzTicksMemo* key, DvzAxesContext ctx)
+{
+    ASSERT(worker != NULL);
+    ASSERT(key != NULL);
+    ASSERT(key->coord == ctx.coord);
+
+    dvz_ticks_cancel(worker, ctx.coord);
+
+    DvzTicksRequest* req = (DvzTicksRequest*)calloc(1, sizeof(DvzTicksRequest));
+    req->ctx = ctx;
+    req->ctx.cancel = NULL;
+    req->memo = *key;
+    req->memo.ticks = (DvzAxesTicks){0};
+    atomic_init(&req->cancelled, false);
+
+    worker->pending[ctx.coord] = req;
+    dvz_fifo_enqueue(&worker->requests, req);
+}
+
+
+
+/**
+ * Get the next tick computation completed by the worker thread.
+ *
+ * Cancelled requests are discarded, the other results are memoized.
+ *
+ * @param worker the tick worker
+ * @returns a completed request, that the caller must free along with its ticks, or NULL
+ */
+static DvzTicksRequest* dvz_ticks_poll(DvzTicksWorker* worker)
+{
+    ASSERT(worker != NULL);
+
+    DvzTicksRequest* req = NULL;
+    while ((req = (DvzTicksRequest*)dvz_fifo_dequeue(&worker->results, false)) != NULL)
+    {
+        if (!atomic_load(&req->cancelled) && worker->pending[req->ctx.coord] == req)
+        {
+            worker->pending[req->ctx.coord] = NULL;
+            dvz_ticks_memo_set(worker, &req->memo, &req->memo.ticks);
+            return req;
+        }
+        dvz_ticks_destroy(&req->memo.ticks);
+        FREE(req);
+    }
+    return NULL;
+}
+
+
+
+/**
+ * Stop the tick worker thread and free the memoized ticks.
+ *
+ * @param worker the tick worker
+ */
+static void dvz_ticks_worker_destroy(DvzTicksWorker* worker)
+{
+    ASSERT(worker != NULL);
+
+    dvz_ticks_cancel(worker, DVZ_AXES_COORD_X);
+    dvz_ticks_cancel(worker, DVZ_AXES_COORD_Y);
+    dvz_fifo_enqueue(&worker->requests, NULL);
+    dvz_thread_join(&worker->thread);
+
+    // Free the cancelled requests returned by the thread.
+    DvzTicksRequest* req = dvz_ticks_poll(worker);
+    ASSERT(req == NULL);
+
+    for (uint32_t i = 0; i < DVZ_TICKS_MEMO_SIZE; i++)
+        dvz_ticks_destroy(&worker->memo[i].ticks);
+
+    dvz_fifo_destroy(&worker->requests);
+    dvz_fifo_destroy(&worker->results);
+    FREE(worker);
+}
+
+
+
 #endif
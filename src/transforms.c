@@ -10,13 +10,15 @@
 
 void dvz_transform_pos(DvzDataCoords coords, DvzArray* pos_in, DvzArray* pos_out, bool inverse)
 {
-    // NOTE: this CPU transformation function is not optimized at all
+    // NOTE: the positions are transformed on the CPU, in parallel for large arrays
 
     ASSERT(pos_in != NULL);
     ASSERT(pos_out != NULL);
     ASSERT(pos_out->item_count == pos_in->item_count);
-    ASSERT(pos_out->item_size == pos_in->item_size);
-    ASSERT(pos_out->dtype == pos_in->dtype);
+    // NOTE: the input and output dtypes may differ (e.g. dvec3 input and vec3 output), the
+    // computations are always done in double precision.
+    ASSERT(_is_pos_dtype(pos_in->dtype));
+    ASSERT(_is_pos_dtype(pos_out->dtype));
 
     log_debug(
         "data normalization on %d position elements, transform %d", pos_in->item_count,
@@ -44,9 +46,6 @@ void dvz_transform_pos(DvzDataCoords coords, DvzArray* pos_in, DvzArray* pos_out
     //     // -1 + 2 * (t - u) / (v - u);
     // }
 
-    // TODO: support other dtypes
-    ASSERT(pos_out->dtype == DVZ_DTYPE_DVEC3);
-
     DvzArray* pos_temp = pos_in;
 
     // First, handle non-cartesian transforms.
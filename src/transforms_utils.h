@@ -37,25 +37,38 @@ static void _box_enlarge(DvzBox* box, float rel_increase)
 
 
 
-// Return the bounding box of a set of dvec3 points.
-static DvzBox _box_bounding(DvzArray* points_in)
+// Extend a box so that it contains a range of 1D, 2D or 3D points, in single or double precision.
+static void _box_extend(DvzBox* box, DvzArray* points_in, uint32_t first, uint32_t count)
 {
+    ASSERT(box != NULL);
     ASSERT(points_in != NULL);
-    ASSERT(points_in->item_count > 0);
     ASSERT(points_in->item_size > 0);
+    ASSERT(first + count <= points_in->item_count);
+    ASSERT(_is_pos_dtype(points_in->dtype));
 
-    dvec3* pos = NULL;
-    DvzBox box = DVZ_BOX_INF;
-    for (uint32_t i = 0; i < points_in->item_count; i++)
+    // NOTE: the box is always computed in double precision, whatever the dtype of the points.
+    dvec3 pos = {0};
+    for (uint32_t i = first; i < first + count; i++)
     {
-        pos = (dvec3*)dvz_array_item(points_in, i);
-        ASSERT(pos != NULL);
+        _pos_get(points_in->dtype, dvz_array_item(points_in, i), pos);
         for (uint32_t j = 0; j < 3; j++)
         {
-            box.p0[j] = MIN(box.p0[j], (*pos)[j]);
-            box.p1[j] = MAX(box.p1[j], (*pos)[j]);
+            box->p0[j] = MIN(box->p0[j], pos[j]);
+            box->p1[j] = MAX(box->p1[j], pos[j]);
         }
     }
+}
+
+
+
+// Return the bounding box of a set of 1D, 2D or 3D points, in single or double precision.
+static DvzBox _box_bounding(DvzArray* points_in)
+{
+    ASSERT(points_in != NULL);
+    ASSERT(points_in->item_count > 0);
+
+    DvzBox box = DVZ_BOX_INF;
+    _box_extend(&box, points_in, 0, points_in->item_count);
 
     // Enlarge the box by 10%.
     // _box_enlarge(&box, .1);
@@ -238,35 +251,152 @@ static inline void _transform_earth_mercator_web(DvzTransform* tr, dvec3 in, dve
 
 
 
-// NOTE: we use a macro here instead of doing a conditional test on the transform type at every
-// iteration, which is probably bad for performance
-#define MAKE_TRANSFORM_APPLY(func)                                                                \
-    static void _transform_array_##func(DvzTransform* tr, DvzArray* arr_in, DvzArray* arr_out)    \
+/*************************************************************************************************/
+/*  Transform kernels                                                                            */
+/*************************************************************************************************/
+
+// Minimum number of positions processed by each thread in the transform kernels.
+#define DVZ_TRANSFORM_CHUNK_SIZE 262144
+
+typedef struct DvzTransformKernel DvzTransformKernel;
+
+struct DvzTransformKernel
+{
+    dmat4 mat; // copy of the transformation matrix
+
+    DvzDataType dtype_in;
+    const void* data_in;
+    DvzDataType dtype_out;
+    void* data_out;
+};
+
+
+
+static inline void _kernel_cartesian(DvzTransformKernel* k, dvec3 p)
+{
+    double x = p[0], y = p[1], z = p[2];
+    p[0] = k->mat[0][0] * x + k->mat[1][0] * y + k->mat[2][0] * z + k->mat[3][0];
+    p[1] = k->mat[0][1] * x + k->mat[1][1] * y + k->mat[2][1] * z + k->mat[3][1];
+    p[2] = k->mat[0][2] * x + k->mat[1][2] * y + k->mat[2][2] * z + k->mat[3][2];
+}
+
+
+
+static inline void _kernel_earth_mercator_web(DvzTransformKernel* k, dvec3 p)
+{
+    // NOTE: discard last out component as 2D transform
+    _project_lonlat(p[0], p[1], p);
+    p[2] = 0;
+}
+
+
+
+// NOTE: we use macros here instead of doing a conditional test on the transform type and dtypes
+// at every iteration. Each combination of input and output dtypes has its own loop, with
+// compile-time strides and no per-item dispatch, that the compiler can unroll and vectorize.
+// The computation is always done in double precision, but single-precision arrays are read and
+// written directly, without any intermediate double-precision array. Missing input components
+// are set to 0. The input and output may be the same array.
+#define _TRANSFORM_LOOP(tin, nin, tout, nout, func)                                               \
     {                                                                                             \
-        ASSERT(arr_in->dtype == DVZ_DTYPE_DVEC3);                                                 \
-        ASSERT(arr_out->dtype == DVZ_DTYPE_DVEC3);                                                \
-        dvec3* pos_in = (dvec3*)arr_in->data;                                                     \
-        dvec3* pos_out = (dvec3*)arr_out->data;                                                   \
-        for (uint32_t i = 0; i < arr_in->item_count; i++)                                         \
+        const tin* in = (const tin*)k->data_in + (uint64_t)(nin)*first;                           \
+        tout* out = (tout*)k->data_out + (uint64_t)(nout)*first;                                  \
+        dvec3 p = {0};                                                                            \
+        for (uint64_t i = 0; i < count; i++)                                                      \
         {                                                                                         \
-            _transform_##func(tr, pos_in[i], pos_out[i]);                                         \
+            p[0] = (double)in[(nin)*i];                                                           \
+            p[1] = (nin) > 1 ? (double)in[(nin)*i + 1] : 0;                                       \
+            p[2] = (nin) > 2 ? (double)in[(nin)*i + 2] : 0;                                       \
+            _kernel_##func(k, p);                                                                 \
+            out[(nout)*i] = (tout)p[0];                                                           \
+            if ((nout) > 1)                                                                       \
+                out[(nout)*i + 1] = (tout)p[1];                                                   \
+            if ((nout) > 2)                                                                       \
+                out[(nout)*i + 2] = (tout)p[2];                                                   \
         }                                                                                         \
     }
 
+#define _TRANSFORM_LOOP_OUT(tin, nin, func)                                                       \
+    switch (k->dtype_out)                                                                         \
+    {                                                                                             \
+    case DVZ_DTYPE_DVEC3:                                                                         \
+        _TRANSFORM_LOOP(tin, nin, double, 3, func) break;                                         \
+    case DVZ_DTYPE_VEC3:                                                                          \
+        _TRANSFORM_LOOP(tin, nin, float, 3, func) break;                                          \
+    case DVZ_DTYPE_DVEC2:                                                                         \
+        _TRANSFORM_LOOP(tin, nin, double, 2, func) break;                                         \
+    case DVZ_DTYPE_VEC2:                                                                          \
+        _TRANSFORM_LOOP(tin, nin, float, 2, func) break;                                          \
+    case DVZ_DTYPE_DOUBLE:                                                                        \
+        _TRANSFORM_LOOP(tin, nin, double, 1, func) break;                                         \
+    case DVZ_DTYPE_FLOAT:                                                                         \
+        _TRANSFORM_LOOP(tin, nin, float, 1, func) break;                                          \
+    default:                                                                                      \
+        log_error("unsupported output dtype %d for position transform", k->dtype_out);            \
+        break;                                                                                    \
+    }
 
-MAKE_TRANSFORM_APPLY(cartesian)
-MAKE_TRANSFORM_APPLY(earth_mercator_web)
+#define MAKE_TRANSFORM_KERNEL(func)                                                               \
+    static void _transform_chunk_##func(uint32_t first, uint32_t count, void* user_data)          \
+    {                                                                                             \
+        ASSERT(user_data != NULL);                                                                \
+        /* NOTE: local copy so that the matrix does not alias with the output */                  \
+        DvzTransformKernel kernel = *(DvzTransformKernel*)user_data;                              \
+        DvzTransformKernel* k = &kernel;                                                          \
+        switch (k->dtype_in)                                                                      \
+        {                                                                                         \
+        case DVZ_DTYPE_DVEC3:                                                                     \
+            _TRANSFORM_LOOP_OUT(double, 3, func) break;                                           \
+        case DVZ_DTYPE_VEC3:                                                                      \
+            _TRANSFORM_LOOP_OUT(float, 3, func) break;                                            \
+        case DVZ_DTYPE_DVEC2:                                                                     \
+            _TRANSFORM_LOOP_OUT(double, 2, func) break;                                           \
+        case DVZ_DTYPE_VEC2:                                                                      \
+            _TRANSFORM_LOOP_OUT(float, 2, func) break;                                            \
+        case DVZ_DTYPE_DOUBLE:                                                                    \
+            _TRANSFORM_LOOP_OUT(double, 1, func) break;                                           \
+        case DVZ_DTYPE_FLOAT:                                                                     \
+            _TRANSFORM_LOOP_OUT(float, 1, func) break;                                            \
+        default:                                                                                  \
+            log_error("unsupported input dtype %d for position transform", k->dtype_in);          \
+            break;                                                                                \
+        }                                                                                         \
+    }
 
-static void _transform_array(DvzTransform* tr, DvzArray* arr_in, DvzArray* arr_out)
+MAKE_TRANSFORM_KERNEL(cartesian)
+MAKE_TRANSFORM_KERNEL(earth_mercator_web)
+
+
+
+// Transform positions with a given input and output dtype. The positions are split in chunks
+// processed in parallel.
+static void _transform_data(
+    DvzTransform* tr, uint32_t count, DvzDataType dtype_in, const void* data_in,
+    DvzDataType dtype_out, void* data_out)
 {
     ASSERT(tr != NULL);
+    ASSERT(_is_pos_dtype(dtype_in));
+    ASSERT(_is_pos_dtype(dtype_out));
+    if (count == 0)
+        return;
+    ASSERT(data_in != NULL);
+    ASSERT(data_out != NULL);
+
+    DvzTransformKernel k = {0};
+    memcpy(k.mat, tr->mat, sizeof(dmat4));
+    k.dtype_in = dtype_in;
+    k.data_in = data_in;
+    k.dtype_out = dtype_out;
+    k.data_out = data_out;
+
     if (tr->type == DVZ_TRANSFORM_CARTESIAN)
     {
-        _transform_array_cartesian(tr, arr_in, arr_out);
+        ASSERT(!tr->inverse);
+        dvz_parallel(count, DVZ_TRANSFORM_CHUNK_SIZE, _transform_chunk_cartesian, &k);
     }
     else if (tr->type == DVZ_TRANSFORM_EARTH_MERCATOR_WEB)
     {
-        _transform_array_earth_mercator_web(tr, arr_in, arr_out);
+        dvz_parallel(count, DVZ_TRANSFORM_CHUNK_SIZE, _transform_chunk_earth_mercator_web, &k);
     }
     else
     {
@@ -276,6 +406,18 @@ static void _transform_array(DvzTransform* tr, DvzArray* arr_in, DvzArray* arr_o
 
 
 
+static void _transform_array(DvzTransform* tr, DvzArray* arr_in, DvzArray* arr_out)
+{
+    ASSERT(tr != NULL);
+    ASSERT(arr_in != NULL);
+    ASSERT(arr_out != NULL);
+    ASSERT(arr_out->item_count >= arr_in->item_count);
+    _transform_data(
+        tr, arr_in->item_count, arr_in->dtype, arr_in->data, arr_out->dtype, arr_out->data);
+}
+
+
+
 static inline void _transform_apply(DvzTransform* tr, dvec3 in, dvec3 out)
 {
     ASSERT(tr != NULL);
@@ -3,6 +3,8 @@
 #include "../include/datoviz/graphics.h"
 #include "../include/datoviz/interact.h"
 #include "../include/datoviz/mesh.h"
+#include "../include/datoviz/octree.h"
+#include "../include/datoviz/pslg.h"
 #include "axes.h"
 #include "visuals_utils.h"
 
@@ -25,29 +27,42 @@ static void _visual_point(DvzVisual* visual)
     ASSERT(canvas != NULL);
     DvzProp* prop = NULL;
 
+    // Quantized positions: 12 bytes per vertex instead of 16.
+    bool quantized = (visual->flags & DVZ_POINT_FLAGS_QUANTIZED) != 0;
+
     // Graphics.
-    dvz_visual_graphics(visual, dvz_graphics_builtin(canvas, DVZ_GRAPHICS_POINT, visual->flags));
+    dvz_visual_graphics(
+        visual, dvz_graphics_builtin(
+                    canvas, quantized ? DVZ_GRAPHICS_POINT_QUANTIZED : DVZ_GRAPHICS_POINT,
+                    visual->flags));
 
     // Sources
     dvz_visual_source(
-        visual, DVZ_SOURCE_TYPE_VERTEX, 0, DVZ_PIPELINE_GRAPHICS, 0, 0, sizeof(DvzVertex), 0);
+        visual, DVZ_SOURCE_TYPE_VERTEX, 0, DVZ_PIPELINE_GRAPHICS, 0, 0,
+        quantized ? sizeof(DvzGraphicsPointQuantizedVertex) : sizeof(DvzVertex), 0);
     _common_sources(visual);
     dvz_visual_source(
         visual, DVZ_SOURCE_TYPE_PARAM, 0, DVZ_PIPELINE_GRAPHICS, 0, DVZ_USER_BINDING,
         sizeof(DvzGraphicsPointParams), 0);
+    _colormap_props(visual, DVZ_USER_BINDING + 1);
 
     // Props:
 
     // Vertex pos.
     prop = dvz_visual_prop(visual, DVZ_PROP_POS, 0, DVZ_DTYPE_DVEC3, DVZ_SOURCE_TYPE_VERTEX, 0);
-    dvz_visual_prop_cast(
-        prop, 0, offsetof(DvzVertex, pos), DVZ_DTYPE_VEC3, DVZ_ARRAY_COPY_SINGLE, 1);
+    if (quantized)
+        dvz_visual_prop_cast(
+            prop, 0, offsetof(DvzGraphicsPointQuantizedVertex, pos), DVZ_DTYPE_SNORM16_VEC4,
+            DVZ_ARRAY_COPY_SINGLE, 1);
+    else
+        dvz_visual_prop_cast(
+            prop, 0, offsetof(DvzVertex, pos), DVZ_DTYPE_VEC3, DVZ_ARRAY_COPY_SINGLE, 1);
 
     // Vertex color.
-    prop = dvz_visual_prop(visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_CVEC4, DVZ_SOURCE_TYPE_VERTEX, 0);
-    dvz_visual_prop_copy(prop, 1, offsetof(DvzVertex, color), DVZ_ARRAY_COPY_SINGLE, 1);
-    cvec4 color = {200, 200, 200, 255};
-    dvz_visual_prop_default(prop, &color);
+    _color_prop(
+        visual, 1,
+        quantized ? offsetof(DvzGraphicsPointQuantizedVertex, color) : offsetof(DvzVertex, color),
+        DVZ_ARRAY_COPY_SINGLE, 1, &(cvec4){200, 200, 200, 255});
 
     // Common props.
     _common_props(visual);
@@ -82,6 +97,7 @@ static void _visual_line(DvzVisual* visual)
     dvz_visual_source(
         visual, DVZ_SOURCE_TYPE_VERTEX, 0, DVZ_PIPELINE_GRAPHICS, 0, 0, sizeof(DvzVertex), 0);
     _common_sources(visual);
+    _colormap_props(visual, DVZ_USER_BINDING);
 
     // Props:
 
@@ -98,8 +114,7 @@ static void _visual_line(DvzVisual* visual)
 
 
     // Vertex color.
-    prop = dvz_visual_prop(visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_CVEC4, DVZ_SOURCE_TYPE_VERTEX, 0);
-    dvz_visual_prop_copy(prop, 1, offsetof(DvzVertex, color), DVZ_ARRAY_COPY_REPEAT, 2);
+    _color_prop(visual, 1, offsetof(DvzVertex, color), DVZ_ARRAY_COPY_REPEAT, 2, NULL);
 
     // Common props.
     _common_props(visual);
@@ -115,6 +130,9 @@ static void _line_strip_bake(DvzVisual* visual, DvzVisualDataEvent ev)
 {
     ASSERT(visual != NULL);
 
+    // Decimated samples at the current level of detail, if any.
+    _lod_stage(visual);
+
     DvzProp* prop_pos = dvz_prop_get(visual, DVZ_PROP_POS, 0);
     DvzProp* prop_color = dvz_prop_get(visual, DVZ_PROP_COLOR, 0);
 
@@ -378,9 +396,9 @@ static void _rectangle_bake(DvzVisual* visual, DvzVisualDataEvent ev)
     // triangles).
     dvz_array_resize(arr_vertex, 6 * rectangle_count);
 
-    // Pointers to the input data.
-    dvec3* p0 = NULL;
-    dvec3* p1 = NULL;
+    // Input data. The positions may be stored in single or double precision.
+    dvec3 p0 = {0};
+    dvec3 p1 = {0};
     cvec4* color = NULL;
 
     // Pointer to the output vertex.
@@ -389,38 +407,38 @@ static void _rectangle_bake(DvzVisual* visual, DvzVisualDataEvent ev)
     // Here, we triangulate each rectangle by computing the position of each rectangle corner.
     for (uint32_t i = 0; i < rectangle_count; i++)
     {
-        // We get a pointer to the current item in each prop array.
-        p0 = dvz_array_item(arr_p0, i);
-        p1 = dvz_array_item(arr_p1, i);
+        // We get the current item in each prop array.
+        _pos_get(arr_p0->dtype, dvz_array_item(arr_p0, i), p0);
+        _pos_get(arr_p1->dtype, dvz_array_item(arr_p1, i), p1);
         color = dvz_array_item(arr_color, i);
 
         // First triangle:
 
         // Bottom-left corner.
-        vertex[6 * i + 0].pos[0] = p0[0][0];
-        vertex[6 * i + 0].pos[1] = p0[0][1];
+        vertex[6 * i + 0].pos[0] = p0[0];
+        vertex[6 * i + 0].pos[1] = p0[1];
 
         // Bottom-right corner.
-        vertex[6 * i + 1].pos[0] = p1[0][0];
-        vertex[6 * i + 1].pos[1] = p0[0][1];
+        vertex[6 * i + 1].pos[0] = p1[0];
+        vertex[6 * i + 1].pos[1] = p0[1];
 
         // Top-right corner.
-        vertex[6 * i + 2].pos[0] = p1[0][0];
-        vertex[6 * i + 2].pos[1] = p1[0][1];
+        vertex[6 * i + 2].pos[0] = p1[0];
+        vertex[6 * i + 2].pos[1] = p1[1];
 
         // Second triangle:
 
         // Top-right corner again.
-        vertex[6 * i + 3].pos[0] = p1[0][0];
-        vertex[6 * i + 3].pos[1] = p1[0][1];
+        vertex[6 * i + 3].pos[0] = p1[0];
+        vertex[6 * i + 3].pos[1] = p1[1];
 
         // Top-left corner.
-        vertex[6 * i + 4].pos[0] = p0[0][0];
-        vertex[6 * i + 4].pos[1] = p1[0][1];
+        vertex[6 * i + 4].pos[0] = p0[0];
+        vertex[6 * i + 4].pos[1] = p1[1];
 
         // Bottom-left corner (again).
-        vertex[6 * i + 5].pos[0] = p0[0][0];
-        vertex[6 * i + 5].pos[1] = p0[0][1];
+        vertex[6 * i + 5].pos[0] = p0[0];
+        vertex[6 * i + 5].pos[1] = p0[1];
 
         // We copy the rectangle color to each of the six vertices making the current rectangle.
         // This is a choice made in this example, and it is up to the custom visual creator
@@ -484,7 +502,11 @@ static void _visual_marker(DvzVisual* visual)
     DvzProp* prop = NULL;
 
     // Graphics.
-    dvz_visual_graphics(visual, dvz_graphics_builtin(canvas, DVZ_GRAPHICS_MARKER, visual->flags));
+    bool instanced = (visual->flags & DVZ_MARKER_FLAGS_INSTANCED) != 0;
+    dvz_visual_graphics(
+        visual, dvz_graphics_builtin(
+                    canvas, instanced ? DVZ_GRAPHICS_MARKER_INSTANCED : DVZ_GRAPHICS_MARKER,
+                    visual->flags));
     dvz_graphics_depth_test(visual->graphics[0], DVZ_DEPTH_TEST_DISABLE);
 
     // Sources
@@ -495,6 +517,7 @@ static void _visual_marker(DvzVisual* visual)
     dvz_visual_source(
         visual, DVZ_SOURCE_TYPE_PARAM, 0, DVZ_PIPELINE_GRAPHICS, 0, DVZ_USER_BINDING,
         sizeof(DvzGraphicsMarkerParams), 0);
+    _colormap_props(visual, DVZ_USER_BINDING + 1);
 
     // Props:
 
@@ -504,11 +527,9 @@ static void _visual_marker(DvzVisual* visual)
         prop, 0, offsetof(DvzGraphicsMarkerVertex, pos), DVZ_DTYPE_VEC3, DVZ_ARRAY_COPY_SINGLE, 1);
 
     // Marker color.
-    prop = dvz_visual_prop(visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_CVEC4, DVZ_SOURCE_TYPE_VERTEX, 0);
-    dvz_visual_prop_copy(
-        prop, 1, offsetof(DvzGraphicsMarkerVertex, color), DVZ_ARRAY_COPY_SINGLE, 1);
-    cvec4 color = {200, 200, 200, 255};
-    dvz_visual_prop_default(prop, &color);
+    _color_prop(
+        visual, 1, offsetof(DvzGraphicsMarkerVertex, color), DVZ_ARRAY_COPY_SINGLE, 1,
+        &(cvec4){200, 200, 200, 255});
 
     // Marker size.
     prop = dvz_visual_prop(
@@ -562,17 +583,203 @@ static void _visual_marker(DvzVisual* visual)
 
 
 
+/*************************************************************************************************/
+/*  Segment                                                                                      */
+/*************************************************************************************************/
+
+static void _segment_bake(DvzVisual* visual, DvzVisualDataEvent ev)
+{
+    ASSERT(visual != NULL);
+
+    DvzProp* prop_p0 = dvz_prop_get(visual, DVZ_PROP_POS, 0);              // dvec3
+    DvzProp* prop_p1 = dvz_prop_get(visual, DVZ_PROP_POS, 1);              // dvec3
+    DvzProp* prop_color = dvz_prop_get(visual, DVZ_PROP_COLOR, 0);         // cvec4
+    DvzProp* prop_lw = dvz_prop_get(visual, DVZ_PROP_LINE_WIDTH, 0);       // float
+    DvzProp* prop_cap0 = dvz_prop_get(visual, DVZ_PROP_CAP_TYPE, 0);       // int
+    DvzProp* prop_cap1 = dvz_prop_get(visual, DVZ_PROP_CAP_TYPE, 1);       // int
+    DvzProp* prop_transform = dvz_prop_get(visual, DVZ_PROP_TRANSFORM, 0); // char
+
+    DvzArray* arr_p0 = _prop_array(prop_p0, DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_p1 = _prop_array(prop_p1, DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_color = _prop_array(prop_color, DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_lw = _prop_array(prop_lw, DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_cap0 = _prop_array(prop_cap0, DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_cap1 = _prop_array(prop_cap1, DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_transform = _prop_array(prop_transform, DVZ_PROP_ARRAY_DEFAULT);
+
+    DvzSource* src_vertex = dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    // NOTE: there is no index buffer with vertex pulling.
+    DvzSource* src_index = dvz_source_get(visual, DVZ_SOURCE_TYPE_INDEX, 0);
+
+    // The baking function doesn't run if the VERTEX source is handled by the user.
+    if (src_vertex->origin != DVZ_SOURCE_ORIGIN_LIB)
+        return;
+    if (src_vertex->obj.request != DVZ_VISUAL_REQUEST_UPLOAD)
+    {
+        log_trace(
+            "skip bake source for source %d that doesn't need updating", src_vertex->source_kind);
+        return;
+    }
+
+    // Number of segments.
+    uint32_t n = arr_p0->item_count;
+    if (n == 0)
+    {
+        log_debug("empty segment visual");
+        return;
+    }
+    if (arr_p1->item_count != n)
+    {
+        log_error("the segment visual needs %d end positions, got %d", n, arr_p1->item_count);
+        return;
+    }
+
+    // The segment graphics repeats each segment for its 4 vertices and fills the index buffer,
+    // whereas the vertex pulling graphics stores each segment once in the vertex buffer.
+    DvzGraphicsData data = dvz_graphics_data(
+        visual->graphics[0], &src_vertex->arr, src_index != NULL ? &src_index->arr : NULL,
+        visual);
+    dvz_graphics_alloc(&data, n);
+
+    DvzGraphicsSegmentVertex vertex = {0};
+    for (uint32_t i = 0; i < n; i++)
+    {
+        _pos_vec3(arr_p0->dtype, dvz_array_item(arr_p0, i), vertex.P0);
+        _pos_vec3(arr_p1->dtype, dvz_array_item(arr_p1, i), vertex.P1);
+        memcpy(vertex.color, dvz_array_item(arr_color, i), sizeof(cvec4));
+        vertex.linewidth = *(float*)dvz_array_item(arr_lw, i) * prop_lw->dpi_scaling;
+        vertex.cap0 = *(DvzCapType*)dvz_array_item(arr_cap0, i);
+        vertex.cap1 = *(DvzCapType*)dvz_array_item(arr_cap1, i);
+        vertex.transform =
+            arr_transform->item_count > 0 ? *(uint8_t*)dvz_array_item(arr_transform, i) : 0;
+        dvz_graphics_append(&data, &vertex);
+    }
+}
+
+static void _visual_segment(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    DvzCanvas* canvas = visual->canvas;
+    ASSERT(canvas != NULL);
+    DvzProp* prop = NULL;
+    bool pull = (visual->flags & DVZ_SEGMENT_FLAGS_VERTEX_PULLING) != 0;
+
+    // Graphics.
+    dvz_visual_graphics(
+        visual, dvz_graphics_builtin(
+                    canvas, pull ? DVZ_GRAPHICS_SEGMENT_PULL : DVZ_GRAPHICS_SEGMENT,
+                    visual->flags));
+
+    // Sources
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_VERTEX, 0, DVZ_PIPELINE_GRAPHICS, 0, 0,
+        pull ? sizeof(DvzGraphicsSegmentPullVertex) : sizeof(DvzGraphicsSegmentVertex), 0);
+    if (!pull)
+        dvz_visual_source(
+            visual, DVZ_SOURCE_TYPE_INDEX, 0, DVZ_PIPELINE_GRAPHICS, 0, 0, sizeof(DvzIndex), 0);
+    _common_sources(visual);
+
+    // Props:
+
+    // Segment start and end positions, copied by the baking function.
+    dvz_visual_prop(visual, DVZ_PROP_POS, 0, DVZ_DTYPE_DVEC3, DVZ_SOURCE_TYPE_VERTEX, 0);
+    dvz_visual_prop(visual, DVZ_PROP_POS, 1, DVZ_DTYPE_DVEC3, DVZ_SOURCE_TYPE_VERTEX, 0);
+
+    // Segment color.
+    prop = dvz_visual_prop(visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_CVEC4, DVZ_SOURCE_TYPE_VERTEX, 0);
+    dvz_visual_prop_default(prop, (cvec4[]){{200, 200, 200, 255}});
+
+    // Line width.
+    prop = dvz_visual_prop(
+        visual, DVZ_PROP_LINE_WIDTH, 0, DVZ_DTYPE_FLOAT, DVZ_SOURCE_TYPE_VERTEX, 0);
+    dvz_visual_prop_dpi(prop, canvas->dpi_scaling);
+    dvz_visual_prop_default(prop, (float[]){5.0f});
+
+    // Start and end cap types.
+    prop = dvz_visual_prop(visual, DVZ_PROP_CAP_TYPE, 0, DVZ_DTYPE_INT, DVZ_SOURCE_TYPE_VERTEX, 0);
+    dvz_visual_prop_default(prop, (int32_t[]){DVZ_CAP_ROUND});
+    prop = dvz_visual_prop(visual, DVZ_PROP_CAP_TYPE, 1, DVZ_DTYPE_INT, DVZ_SOURCE_TYPE_VERTEX, 0);
+    dvz_visual_prop_default(prop, (int32_t[]){DVZ_CAP_ROUND});
+
+    // Segment transform.
+    dvz_visual_prop(visual, DVZ_PROP_TRANSFORM, 0, DVZ_DTYPE_CHAR, DVZ_SOURCE_TYPE_VERTEX, 0);
+
+    // Common props.
+    _common_props(visual);
+
+    dvz_visual_callback_bake(visual, _segment_bake);
+}
+
+
+
 /*************************************************************************************************/
 /*  Polygon                                                                                      */
 /*************************************************************************************************/
 
+#define DVZ_POLYGON_CHUNK_SIZE 256
+
+typedef struct DvzPolygonKernel DvzPolygonKernel;
+
+// Triangulation of the polygons in parallel, the indices of every polygon are then copied at
+// their offset in the index buffer.
+struct DvzPolygonKernel
+{
+    const dvec3* points;           // polygon points, in double precision
+    const uint32_t* lengths;       // number of points of each polygon
+    const uint32_t* point_offsets; // index of the first point of each polygon
+    uint32_t* index_counts;        // number of indices of each polygon
+    uint32_t** indices;            // indices of each polygon, relative to its first point
+    const uint32_t* index_offsets; // position of the indices of each polygon in the index buffer
+    DvzIndex* out;                 // index buffer
+};
+
+static void _polygon_triangulate(uint32_t item_first, uint32_t item_count, void* user_data)
+{
+    DvzPolygonKernel* k = (DvzPolygonKernel*)user_data;
+    ASSERT(k != NULL);
+    for (uint32_t i = item_first; i < item_first + item_count; i++)
+    {
+        dvz_triangulate_polygon(
+            k->lengths[i], &k->points[k->point_offsets[i]], &k->index_counts[i], &k->indices[i]);
+        ASSERT(k->indices[i] != NULL);
+        ASSERT(k->index_counts[i] > 0);
+    }
+}
+
+static void _polygon_concatenate(uint32_t item_first, uint32_t item_count, void* user_data)
+{
+    DvzPolygonKernel* k = (DvzPolygonKernel*)user_data;
+    ASSERT(k != NULL);
+    DvzIndex* out = NULL;
+    for (uint32_t i = item_first; i < item_first + item_count; i++)
+    {
+        out = &k->out[k->index_offsets[i]];
+        for (uint32_t j = 0; j < k->index_counts[i]; j++)
+            out[j] = k->point_offsets[i] + k->indices[i][j];
+        FREE(k->indices[i]);
+    }
+}
+
+// Hash of the POS and LENGTH props of a polygon visual, the polygons are only triangulated again
+// when it changes.
+static uint64_t _polygon_key(DvzArray* arr_pos, DvzArray* arr_length)
+{
+    ASSERT(arr_pos != NULL);
+    ASSERT(arr_length != NULL);
+    uint64_t h = DVZ_HASH_SEED;
+    h = dvz_hash(h, arr_pos->data, arr_pos->item_count * arr_pos->item_size);
+    h = dvz_hash(h, arr_length->data, arr_length->item_count * arr_length->item_size);
+    // NOTE: 0 means that the polygons have not been triangulated yet.
+    return h != 0 ? h : 1;
+}
+
 static void _polygon_bake(DvzVisual* visual, DvzVisualDataEvent ev)
 {
     ASSERT(visual != NULL);
 
     DvzProp* prop_pos = dvz_prop_get(visual, DVZ_PROP_POS, 0);       // dvec3
     DvzProp* prop_length = dvz_prop_get(visual, DVZ_PROP_LENGTH, 0); // uint
-    DvzProp* prop_color = dvz_prop_get(visual, DVZ_PROP_COLOR, 0);   // cvec4
+    DvzProp* prop_color = dvz_prop_get(visual, DVZ_PROP_COLOR, 0);   // cvec4, or float
 
     DvzArray* arr_pos = _prop_array(prop_pos, DVZ_PROP_ARRAY_DEFAULT);
     DvzArray* arr_length = _prop_array(prop_length, DVZ_PROP_ARRAY_DEFAULT);
@@ -580,11 +787,15 @@ static void _polygon_bake(DvzVisual* visual, DvzVisualDataEvent ev)
 
     DvzSource* src_vertex = dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
     DvzSource* src_index = dvz_source_get(visual, DVZ_SOURCE_TYPE_INDEX, 0);
+    // Scalar values, in their own vertex buffer, with DVZ_GRAPHICS_FLAGS_SCALAR_COLOR.
+    DvzSource* src_scalar = dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, 1);
 
     // The baking function doesn't run if the VERTEX source is handled by the user.
     if (src_vertex->origin != DVZ_SOURCE_ORIGIN_LIB)
         return;
-    if (src_vertex->obj.request != DVZ_VISUAL_REQUEST_UPLOAD)
+    bool scalar_changed =
+        src_scalar != NULL && src_scalar->obj.request == DVZ_VISUAL_REQUEST_UPLOAD;
+    if (src_vertex->obj.request != DVZ_VISUAL_REQUEST_UPLOAD && !scalar_changed)
     {
         log_trace(
             "skip bake source for source %d that doesn't need updating", src_vertex->source_kind);
@@ -601,74 +812,93 @@ static void _polygon_bake(DvzVisual* visual, DvzVisualDataEvent ev)
 
     ASSERT(n_points > 0);
     ASSERT(n_polys > 0);
-
-    dvec3* points = (dvec3*)arr_pos->data;
     uint32_t* poly_lengths = (uint32_t*)arr_length->data;
 
-    // Triangulate the polygons.
-    uint32_t index_count = 0;
-    uint32_t total_index_count = 0;
-    uint32_t* indices = NULL;
-    uint32_t* index_count_list = (uint32_t*)calloc(n_polys, sizeof(uint32_t));
-    uint32_t** indices_list = (uint32_t**)calloc(n_polys, sizeof(uint32_t*));
-    uint32_t offset = 0;
+    // Index of the first point of each polygon.
+    uint32_t* point_offsets = (uint32_t*)calloc(n_polys, sizeof(uint32_t));
+    for (uint32_t i = 1; i < n_polys; i++)
+        point_offsets[i] = point_offsets[i - 1] + poly_lengths[i - 1];
+    ASSERT(point_offsets[n_polys - 1] + poly_lengths[n_polys - 1] == n_points);
 
-    // Triangulate all polygons.
-    for (uint32_t i = 0; i < n_polys; i++)
+    // The triangulation only depends on the POS and LENGTH props, the index buffer is kept when
+    // only the colors have changed.
+    uint64_t key = _polygon_key(arr_pos, arr_length);
+    if (key != visual->polygon_key || arr_index->item_count == 0)
     {
-        dvz_triangulate_polygon(
-            poly_lengths[i], (const dvec3*)&points[offset], &index_count, &indices);
-        ASSERT(indices != NULL);
-        ASSERT(index_count > 0);
-        total_index_count += index_count;
-        // Save each triangulation's indices in order to concatenate them afterwards.
-        index_count_list[i] = index_count;
-        indices_list[i] = indices;
-        offset += poly_lengths[i];
-    }
-
-    // Concatenate all triangulations.
-    uint32_t* total_indices = (uint32_t*)calloc(total_index_count, sizeof(uint32_t));
-    offset = 0;
-    uint32_t voffset = 0;
-    for (uint32_t i = 0; i < n_polys; i++)
-    {
-        for (uint32_t j = 0; j < index_count_list[i]; j++)
+        // NOTE: the triangulation is always done in double precision.
+        dvec3* points = (dvec3*)arr_pos->data;
+        dvec3* points_double = NULL;
+        if (arr_pos->dtype != DVZ_DTYPE_DVEC3)
         {
-            total_indices[offset + j] = voffset + indices_list[i][j];
+            points_double = (dvec3*)calloc(n_points, sizeof(dvec3));
+            for (uint32_t i = 0; i < n_points; i++)
+                _pos_get(arr_pos->dtype, dvz_array_item(arr_pos, i), points_double[i]);
+            points = points_double;
         }
-        offset += index_count_list[i];
-        voffset += poly_lengths[i];
-        FREE(indices_list[i]);
+
+        // Triangulate all polygons in parallel.
+        DvzPolygonKernel k = {0};
+        k.points = (const dvec3*)points;
+        k.lengths = poly_lengths;
+        k.point_offsets = point_offsets;
+        k.index_counts = (uint32_t*)calloc(n_polys, sizeof(uint32_t));
+        k.indices = (uint32_t**)calloc(n_polys, sizeof(uint32_t*));
+        dvz_parallel(n_polys, DVZ_POLYGON_CHUNK_SIZE, _polygon_triangulate, &k);
+
+        // Prefix sum of the index counts, then concatenate all triangulations in parallel
+        // directly in the index buffer.
+        uint32_t* index_offsets = (uint32_t*)calloc(n_polys, sizeof(uint32_t));
+        for (uint32_t i = 1; i < n_polys; i++)
+            index_offsets[i] = index_offsets[i - 1] + k.index_counts[i - 1];
+        uint32_t total_index_count = index_offsets[n_polys - 1] + k.index_counts[n_polys - 1];
+
+        dvz_array_resize(arr_index, total_index_count);
+        k.index_offsets = index_offsets;
+        k.out = (DvzIndex*)arr_index->data;
+        dvz_parallel(n_polys, DVZ_POLYGON_CHUNK_SIZE, _polygon_concatenate, &k);
+
+        src_index->obj.request = DVZ_VISUAL_REQUEST_UPLOAD;
+        visual->polygon_key = key;
+
+        FREE(k.index_counts);
+        FREE(k.indices);
+        FREE(index_offsets);
+        FREE(points_double);
     }
+    else
+        log_debug("reuse the triangulation of %d polygons", n_polys);
 
     // Reesize and fill the vertex buffer.
     dvz_array_resize(arr_vertex, n_points);
     // Copy the positions from the pos prop to the vertex buffer.
     _prop_copy(visual, prop_pos);
 
-    // Resize and fill the index buffer.
-    dvz_array_resize(arr_index, total_index_count);
-    dvz_array_data(arr_index, 0, total_index_count, total_index_count, total_indices);
+    // The scalar values go to their own vertex buffer, which is the only one uploaded when only
+    // the values have changed.
+    DvzArray* arr_color_out = arr_vertex;
+    VkDeviceSize color_offset = offsetof(DvzVertex, color);
+    if (src_scalar != NULL)
+    {
+        arr_color_out = &src_scalar->arr;
+        color_offset = 0;
+        dvz_array_resize(arr_color_out, n_points);
+        _source_set_changed(src_scalar, true);
+    }
 
     // Copy the polygon colors to the vertices.
-    cvec4* color = NULL;
+    void* color = NULL;
     // Go through the polygons.
-    uint32_t k = 0;
     for (uint32_t i = 0; i < n_polys; i++)
     {
         // Color prop for the current polygon.
-        color = (cvec4*)dvz_array_item(arr_color, i);
+        color = dvz_array_item(arr_color, i);
         // Copy the color to the vertex buffer, repeating it for each vertex in the polygon.
         dvz_array_column(
-            arr_vertex, offsetof(DvzVertex, color), sizeof(cvec4), k, poly_lengths[i], 1, color,
-            DVZ_DTYPE_NONE, DVZ_DTYPE_NONE, DVZ_ARRAY_COPY_SINGLE, 1);
-        k += poly_lengths[i];
+            arr_color_out, color_offset, arr_color->item_size, point_offsets[i], poly_lengths[i],
+            1, color, DVZ_DTYPE_NONE, DVZ_DTYPE_NONE, DVZ_ARRAY_COPY_SINGLE, 1);
     }
 
-    FREE(index_count_list);
-    FREE(indices_list);
-    FREE(total_indices);
+    FREE(point_offsets);
 }
 
 static void _visual_polygon(DvzVisual* visual)
@@ -690,6 +920,7 @@ static void _visual_polygon(DvzVisual* visual)
         visual, DVZ_SOURCE_TYPE_INDEX, 0, DVZ_PIPELINE_GRAPHICS, 0, 0, sizeof(DvzIndex), 0);
 
     _common_sources(visual);
+    _colormap_props(visual, DVZ_USER_BINDING);
 
     // Props:
 
@@ -703,8 +934,15 @@ static void _visual_polygon(DvzVisual* visual)
     // Polygon lengths, 1 length per polygon.
     prop = dvz_visual_prop(visual, DVZ_PROP_LENGTH, 0, DVZ_DTYPE_UINT, DVZ_SOURCE_TYPE_VERTEX, 0);
 
-    // Polygon colors, 1 color per polygon.
-    prop = dvz_visual_prop(visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_CVEC4, DVZ_SOURCE_TYPE_VERTEX, 0);
+    // Polygon colors, 1 color (or 1 scalar value) per polygon, copied by the baking function.
+    if ((visual->flags & DVZ_GRAPHICS_FLAGS_SCALAR_COLOR) != 0)
+    {
+        dvz_visual_source(
+            visual, DVZ_SOURCE_TYPE_VERTEX, 1, DVZ_PIPELINE_GRAPHICS, 0, 1, sizeof(float), 0);
+        dvz_visual_prop(visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_FLOAT, DVZ_SOURCE_TYPE_VERTEX, 1);
+    }
+    else
+        dvz_visual_prop(visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_CVEC4, DVZ_SOURCE_TYPE_VERTEX, 0);
 
     // Common props.
     _common_props(visual);
@@ -714,6 +952,194 @@ static void _visual_polygon(DvzVisual* visual)
 
 
 
+/*************************************************************************************************/
+/*  PSLG                                                                                         */
+/*************************************************************************************************/
+
+// Copy the xy coordinates of a POS prop array in double precision.
+static dvec2* _pslg_points(DvzArray* arr)
+{
+    ASSERT(arr != NULL);
+    uint32_t n = arr->item_count;
+    dvec2* points = (dvec2*)calloc(MAX(n, 1), sizeof(dvec2));
+    dvec3 pos = {0};
+    for (uint32_t i = 0; i < n; i++)
+    {
+        _pos_get(arr->dtype, dvz_array_item(arr, i), pos);
+        points[i][0] = pos[0];
+        points[i][1] = pos[1];
+    }
+    return points;
+}
+
+static void _pslg_bake(DvzVisual* visual, DvzVisualDataEvent ev)
+{
+    ASSERT(visual != NULL);
+
+    DvzProp* prop_pos = dvz_prop_get(visual, DVZ_PROP_POS, 0);          // dvec3
+    DvzProp* prop_hole = dvz_prop_get(visual, DVZ_PROP_POS, 1);         // dvec3
+    DvzProp* prop_segment = dvz_prop_get(visual, DVZ_PROP_INDEX, 0);    // uvec2
+    DvzProp* prop_length = dvz_prop_get(visual, DVZ_PROP_LENGTH, 0);    // uint
+    DvzProp* prop_seglength = dvz_prop_get(visual, DVZ_PROP_LENGTH, 1); // uint
+    DvzProp* prop_color = dvz_prop_get(visual, DVZ_PROP_COLOR, 0);      // cvec4
+    DvzProp* prop_angle = dvz_prop_get(visual, DVZ_PROP_ANGLE, 0);      // float
+
+    DvzArray* arr_pos = _prop_array(prop_pos, DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_hole = _prop_array(prop_hole, DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_segment = _prop_array(prop_segment, DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_length = _prop_array(prop_length, DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_seglength = _prop_array(prop_seglength, DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_color = _prop_array(prop_color, DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_angle = _prop_array(prop_angle, DVZ_PROP_ARRAY_DEFAULT);
+
+    DvzSource* src_vertex = dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    DvzSource* src_index = dvz_source_get(visual, DVZ_SOURCE_TYPE_INDEX, 0);
+
+    // The baking function doesn't run if the VERTEX source is handled by the user.
+    if (src_vertex->origin != DVZ_SOURCE_ORIGIN_LIB)
+        return;
+    if (src_vertex->obj.request != DVZ_VISUAL_REQUEST_UPLOAD)
+    {
+        log_trace(
+            "skip bake source for source %d that doesn't need updating", src_vertex->source_kind);
+        return;
+    }
+
+    // Source arrays.
+    DvzArray* arr_vertex = &src_vertex->arr;
+    DvzArray* arr_index = &src_index->arr;
+
+    uint32_t n_points = arr_pos->item_count;
+    uint32_t n_segments = arr_segment->item_count;
+    if (n_points < 3)
+        return;
+
+    // Without LENGTH props, all points and segments make up a single PSLG.
+    uint32_t n_pslgs = arr_length->item_count > 0 ? arr_length->item_count : 1;
+    uint32_t* point_counts = arr_length->item_count > 0 ? (uint32_t*)arr_length->data : &n_points;
+    uint32_t* segment_counts =
+        arr_seglength->item_count > 0 ? (uint32_t*)arr_seglength->data : &n_segments;
+    if (n_pslgs > 1 && arr_seglength->item_count != n_pslgs && n_segments > 0)
+    {
+        log_error("the PSLG visual needs the number of segments of each of the %d PSLGs", n_pslgs);
+        return;
+    }
+    if (arr_seglength->item_count == 0 && n_segments == 0)
+        segment_counts = NULL;
+
+    dvec2* points = _pslg_points(arr_pos);
+    dvec2* holes = arr_hole->item_count > 0 ? _pslg_points(arr_hole) : NULL;
+
+    DvzPslgInput input = {0};
+    input.pslg_count = n_pslgs;
+    input.point_counts = point_counts;
+    input.segment_counts = segment_counts;
+    input.points = (const dvec2*)points;
+    input.segments = (const uvec2*)arr_segment->data;
+    input.hole_count = arr_hole->item_count;
+    input.holes = (const dvec2*)holes;
+    input.min_angle = arr_angle->item_count > 0 ? *(float*)arr_angle->data : 0;
+
+    // The triangulation only depends on the geometry, the index buffer is kept when only the
+    // colors have changed. Otherwise, the triangulation may be loaded from the disk cache.
+    uint64_t key = dvz_pslg_key(&input);
+    if (key != visual->pslg.key)
+    {
+        dvz_pslg_destroy(&visual->pslg);
+        visual->pslg = dvz_pslg_triangulate(&input, NULL);
+        DvzPslgMesh* mesh = &visual->pslg;
+        if (mesh->index_count > 0)
+        {
+            dvz_array_resize(arr_index, mesh->index_count);
+            memcpy(arr_index->data, mesh->indices, mesh->index_count * sizeof(DvzIndex));
+            src_index->obj.request = DVZ_VISUAL_REQUEST_UPLOAD;
+        }
+    }
+    else
+        log_debug("reuse the triangulation of %d PSLGs", n_pslgs);
+    FREE(points);
+    FREE(holes);
+
+    DvzPslgMesh* mesh = &visual->pslg;
+    if (mesh->index_count == 0)
+    {
+        log_warn("empty PSLG triangulation");
+        return;
+    }
+
+    // Vertices of each PSLG, with the color of the PSLG.
+    dvz_array_resize(arr_vertex, mesh->vertex_count);
+    DvzVertex* vertex = (DvzVertex*)arr_vertex->data;
+    uint32_t n_colors = arr_color->item_count;
+    cvec4 white = {255, 255, 255, 255};
+    cvec4* color = NULL;
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < mesh->pslg_count; i++)
+    {
+        color = n_colors > 0 ? (cvec4*)dvz_array_item(arr_color, MIN(i, n_colors - 1)) : &white;
+        for (uint32_t j = 0; j < mesh->vertex_counts[i]; j++, k++)
+        {
+            vertex[k].pos[0] = (float)mesh->vertices[k][0];
+            vertex[k].pos[1] = (float)mesh->vertices[k][1];
+            vertex[k].pos[2] = 0;
+            memcpy(vertex[k].color, *color, sizeof(cvec4));
+        }
+    }
+    ASSERT(k == mesh->vertex_count);
+}
+
+static void _visual_pslg(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    DvzCanvas* canvas = visual->canvas;
+    ASSERT(canvas != NULL);
+    DvzProp* prop = NULL;
+
+    // Graphics.
+    dvz_visual_graphics(
+        visual, dvz_graphics_builtin(canvas, DVZ_GRAPHICS_TRIANGLE, visual->flags));
+
+    // Sources
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_VERTEX, 0, DVZ_PIPELINE_GRAPHICS, 0, 0, sizeof(DvzVertex), 0);
+
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_INDEX, 0, DVZ_PIPELINE_GRAPHICS, 0, 0, sizeof(DvzIndex), 0);
+
+    _common_sources(visual);
+
+    // Props:
+
+    // PSLG points, the vertex buffer is filled by the triangulation which adds Steiner points.
+    prop = dvz_visual_prop(visual, DVZ_PROP_POS, 0, DVZ_DTYPE_DVEC3, DVZ_SOURCE_TYPE_VERTEX, 0);
+
+    // One point inside each hole.
+    prop = dvz_visual_prop(visual, DVZ_PROP_POS, 1, DVZ_DTYPE_DVEC3, DVZ_SOURCE_TYPE_VERTEX, 0);
+
+    // Segments, as pairs of point indices relative to the first point of their PSLG.
+    prop = dvz_visual_prop(visual, DVZ_PROP_INDEX, 0, DVZ_DTYPE_UVEC2, DVZ_SOURCE_TYPE_VERTEX, 0);
+
+    // Number of points and segments of each PSLG, a single PSLG if not set.
+    prop = dvz_visual_prop(visual, DVZ_PROP_LENGTH, 0, DVZ_DTYPE_UINT, DVZ_SOURCE_TYPE_VERTEX, 0);
+    prop = dvz_visual_prop(visual, DVZ_PROP_LENGTH, 1, DVZ_DTYPE_UINT, DVZ_SOURCE_TYPE_VERTEX, 0);
+
+    // PSLG colors, 1 color per PSLG.
+    prop = dvz_visual_prop(visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_CVEC4, DVZ_SOURCE_TYPE_VERTEX, 0);
+
+    // Minimum angle of the triangles in degrees, 0 for a constrained Delaunay triangulation
+    // without refinement.
+    prop = dvz_visual_prop(visual, DVZ_PROP_ANGLE, 0, DVZ_DTYPE_FLOAT, DVZ_SOURCE_TYPE_VERTEX, 0);
+    float min_angle = DVZ_PSLG_DEFAULT_ANGLE;
+    dvz_visual_prop_default(prop, &min_angle);
+
+    // Common props.
+    _common_props(visual);
+
+    dvz_visual_callback_bake(visual, _pslg_bake);
+}
+
+
+
 /*************************************************************************************************/
 /*  Path                                                                                         */
 /*************************************************************************************************/
@@ -722,6 +1148,9 @@ static void _path_bake(DvzVisual* visual, DvzVisualDataEvent ev)
 {
     ASSERT(visual != NULL);
 
+    // Decimated samples at the current level of detail, if any.
+    _lod_stage(visual);
+
     DvzProp* prop_pos = dvz_prop_get(visual, DVZ_PROP_POS, 0);     // dvec3
     DvzProp* prop_color = dvz_prop_get(visual, DVZ_PROP_COLOR, 0); // cvec4
 
@@ -742,6 +1171,8 @@ static void _path_bake(DvzVisual* visual, DvzVisualDataEvent ev)
     {
         log_trace(
             "skip bake source for source %d that doesn't need updating", src_vertex->source_kind);
+        // The scalar values may have changed on their own.
+        _bake_source(visual, dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, 1), true);
         return;
     }
 
@@ -764,7 +1195,7 @@ static void _path_bake(DvzVisual* visual, DvzVisualDataEvent ev)
     ASSERT(n_points > 0);
     ASSERT(n_paths > 0);
 
-    dvec3* point = NULL;
+    void* point = NULL;
     cvec4* color = NULL;
     uint32_t* path_length = NULL;
     int32_t* is_closed = NULL;
@@ -799,10 +1230,10 @@ static void _path_bake(DvzVisual* visual, DvzVisualDataEvent ev)
         {
             point = dvz_array_item(arr_pos, (uint32_t)idx);
 
-            _vec3_cast((const dvec3*)point, &item.p0);
-            _vec3_cast((const dvec3*)point, &item.p1);
-            _vec3_cast((const dvec3*)point, &item.p2);
-            _vec3_cast((const dvec3*)point, &item.p3);
+            _pos_vec3(arr_pos->dtype, point, item.p0);
+            _pos_vec3(arr_pos->dtype, point, item.p1);
+            _pos_vec3(arr_pos->dtype, point, item.p2);
+            _pos_vec3(arr_pos->dtype, point, item.p3);
 
             memset(item.color, 0, sizeof(cvec4));
 
@@ -837,16 +1268,16 @@ static void _path_bake(DvzVisual* visual, DvzVisualDataEvent ev)
             ASSERT(0 <= j3 && j3 < path_size);
 
             point = dvz_array_item(arr_pos, (uint32_t)(idx + j0));
-            _vec3_cast((const dvec3*)point, &item.p0);
+            _pos_vec3(arr_pos->dtype, point, item.p0);
 
             point = dvz_array_item(arr_pos, (uint32_t)(idx + j1));
-            _vec3_cast((const dvec3*)point, &item.p1);
+            _pos_vec3(arr_pos->dtype, point, item.p1);
 
             point = dvz_array_item(arr_pos, (uint32_t)(idx + j2));
-            _vec3_cast((const dvec3*)point, &item.p2);
+            _pos_vec3(arr_pos->dtype, point, item.p2);
 
             point = dvz_array_item(arr_pos, (uint32_t)(idx + j3));
-            _vec3_cast((const dvec3*)point, &item.p3);
+            _pos_vec3(arr_pos->dtype, point, item.p3);
 
             color = dvz_array_item(arr_color, (uint32_t)(idx + j1));
             memcpy(item.color, color, sizeof(cvec4));
@@ -858,10 +1289,10 @@ static void _path_bake(DvzVisual* visual, DvzVisualDataEvent ev)
         {
             point = dvz_array_item(arr_pos, (uint32_t)(idx + path_size - 1));
 
-            _vec3_cast((const dvec3*)point, &item.p0);
-            _vec3_cast((const dvec3*)point, &item.p1);
-            _vec3_cast((const dvec3*)point, &item.p2);
-            _vec3_cast((const dvec3*)point, &item.p3);
+            _pos_vec3(arr_pos->dtype, point, item.p0);
+            _pos_vec3(arr_pos->dtype, point, item.p1);
+            _pos_vec3(arr_pos->dtype, point, item.p2);
+            _pos_vec3(arr_pos->dtype, point, item.p3);
 
             memset(item.color, 0, sizeof(cvec4));
 
@@ -871,37 +1302,123 @@ static void _path_bake(DvzVisual* visual, DvzVisualDataEvent ev)
         idx += path_size;
     }
     ASSERT(idx == (int32_t)n_points);
+
+    // Scalar values, with one value per vertex.
+    _bake_source(visual, dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, 1), false);
 }
 
-static void _visual_path(DvzVisual* visual)
+// Vertex pulling: the raw points are stored once, the vertex shader fetches the neighbors using
+// the path index and size stored with each point.
+static void _path_pull_bake(DvzVisual* visual, DvzVisualDataEvent ev)
 {
     ASSERT(visual != NULL);
-    DvzCanvas* canvas = visual->canvas;
-    ASSERT(canvas != NULL);
-    DvzProp* prop = NULL;
 
-    // Graphics.
-    dvz_visual_graphics(visual, dvz_graphics_builtin(canvas, DVZ_GRAPHICS_PATH, visual->flags));
+    // Decimated samples at the current level of detail, if any.
+    _lod_stage(visual);
 
-    // Sources
-    dvz_visual_source(
-        visual, DVZ_SOURCE_TYPE_VERTEX, 0, DVZ_PIPELINE_GRAPHICS, 0, 0,
-        sizeof(DvzGraphicsPathVertex), 0);
+    DvzProp* prop_length = dvz_prop_get(visual, DVZ_PROP_LENGTH, 0);     // uint
+    DvzProp* prop_topology = dvz_prop_get(visual, DVZ_PROP_TOPOLOGY, 0); // int
 
-    _common_sources(visual);
+    DvzArray* arr_length = _prop_array(prop_length, DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_topology = _prop_array(prop_topology, DVZ_PROP_ARRAY_DEFAULT);
 
-    dvz_visual_source(                                              // params
-        visual, DVZ_SOURCE_TYPE_PARAM, 0, DVZ_PIPELINE_GRAPHICS, 0, //
-        DVZ_USER_BINDING, sizeof(DvzGraphicsPathParams), 0);        //
+    DvzSource* src_vertex = dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
 
-    // Props:
+    // The baking function doesn't run if the VERTEX source is handled by the user.
+    if (src_vertex->origin != DVZ_SOURCE_ORIGIN_LIB)
+        return;
+    if (src_vertex->obj.request != DVZ_VISUAL_REQUEST_UPLOAD)
+    {
+        log_trace(
+            "skip bake source for source %d that doesn't need updating", src_vertex->source_kind);
+        return;
+    }
 
-    // Path points, 1 position per point.
+    // Copy the positions and colors to the vertex buffer.
+    _bake_source(visual, src_vertex, false);
+
+    DvzArray* arr_vertex = &src_vertex->arr;
+    uint32_t n_points = arr_vertex->item_count;
+    if (n_points == 0)
+    {
+        log_debug("empty path visual");
+        return;
+    }
+    uint32_t n_paths = MAX(1, arr_length->item_count);
+
+    uint32_t* path_length = NULL;
+    int32_t* is_closed = NULL;
+    int32_t path_size = 0;
+    uint32_t idx = 0; // index of the first point in the current path
+    DvzGraphicsPathPullVertex* vertex = NULL;
+    for (uint32_t i = 0; i < n_paths; i++)
+    {
+        path_length = dvz_array_item(arr_length, i);
+        path_size = path_length != NULL ? (int32_t)*path_length : (int32_t)n_points;
+        ASSERT(idx + (uint32_t)path_size <= n_points);
+
+        is_closed = dvz_array_item(arr_topology, i);
+        bool closed = is_closed != NULL ? *is_closed : false;
+
+        for (uint32_t j = 0; j < (uint32_t)path_size; j++)
+        {
+            vertex = dvz_array_item(arr_vertex, idx + j);
+            vertex->path_first = idx;
+            vertex->path_size = closed ? -path_size : path_size;
+        }
+        idx += (uint32_t)path_size;
+    }
+    ASSERT(idx == n_points);
+}
+
+static void _visual_path(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    DvzCanvas* canvas = visual->canvas;
+    ASSERT(canvas != NULL);
+    DvzProp* prop = NULL;
+    bool pull = (visual->flags & DVZ_PATH_FLAGS_VERTEX_PULLING) != 0;
+
+    // Graphics.
+    dvz_visual_graphics(
+        visual, dvz_graphics_builtin(
+                    canvas, pull ? DVZ_GRAPHICS_PATH_PULL : DVZ_GRAPHICS_PATH, visual->flags));
+
+    // Sources
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_VERTEX, 0, DVZ_PIPELINE_GRAPHICS, 0, 0,
+        pull ? sizeof(DvzGraphicsPathPullVertex) : sizeof(DvzGraphicsPathVertex), 0);
+
+    _common_sources(visual);
+
+    dvz_visual_source(                                              // params
+        visual, DVZ_SOURCE_TYPE_PARAM, 0, DVZ_PIPELINE_GRAPHICS, 0, //
+        DVZ_USER_BINDING, sizeof(DvzGraphicsPathParams), 0);        //
+
+    _colormap_props(visual, DVZ_USER_BINDING + 1);
+
+    // Props:
+
+    // Path points, 1 position per point.
     prop = dvz_visual_prop(visual, DVZ_PROP_POS, 0, DVZ_DTYPE_DVEC3, DVZ_SOURCE_TYPE_VERTEX, 0);
+    if (pull)
+        dvz_visual_prop_cast(
+            prop, 0, offsetof(DvzGraphicsPathPullVertex, pos), DVZ_DTYPE_VEC3,
+            DVZ_ARRAY_COPY_SINGLE, 1);
 
-    // Path colors, 1 color per point.
-    prop = dvz_visual_prop(visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_CVEC4, DVZ_SOURCE_TYPE_VERTEX, 0);
-    dvz_visual_prop_default(prop, (cvec4[]){{255, 0, 0, 255}});
+    // Path colors, 1 color per point. The scalar values are repeated for the 4 vertices of
+    // every point.
+    if ((visual->flags & DVZ_GRAPHICS_FLAGS_SCALAR_COLOR) != 0)
+        _color_prop(visual, 0, 0, DVZ_ARRAY_COPY_REPEAT, 4, NULL);
+    else
+    {
+        prop = dvz_visual_prop(
+            visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_CVEC4, DVZ_SOURCE_TYPE_VERTEX, 0);
+        if (pull)
+            dvz_visual_prop_copy(
+                prop, 1, offsetof(DvzGraphicsPathPullVertex, color), DVZ_ARRAY_COPY_SINGLE, 1);
+        dvz_visual_prop_default(prop, (cvec4[]){{255, 0, 0, 255}});
+    }
 
     // Path lengths, 1 length per path.
     prop = dvz_visual_prop(visual, DVZ_PROP_LENGTH, 0, DVZ_DTYPE_UINT, DVZ_SOURCE_TYPE_VERTEX, 0);
@@ -940,7 +1457,102 @@ static void _visual_path(DvzVisual* visual)
         prop, 3, offsetof(DvzGraphicsPathParams, round_join), DVZ_ARRAY_COPY_SINGLE, 1);
     dvz_visual_prop_default(prop, (int32_t[]){DVZ_JOIN_ROUND});
 
-    dvz_visual_callback_bake(visual, _path_bake);
+    dvz_visual_callback_bake(visual, pull ? _path_pull_bake : _path_bake);
+}
+
+
+
+/*************************************************************************************************/
+/*  Stream                                                                                       */
+/*************************************************************************************************/
+
+// The samples are directly written to the ring buffer by dvz_visual_data_ring(), the baking
+// function only copies the state of the ring buffer to the params.
+static void _visual_stream_bake(DvzVisual* visual, DvzVisualDataEvent ev)
+{
+    ASSERT(visual != NULL);
+
+    DvzSource* src_vertex = dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    DvzSource* src_params = dvz_source_get(visual, DVZ_SOURCE_TYPE_PARAM, 0);
+    ASSERT(src_vertex != NULL);
+    ASSERT(src_params != NULL);
+    if ((src_vertex->flags & DVZ_SOURCE_FLAG_RING) == 0)
+    {
+        log_debug("the ring buffer of the stream visual has not been created yet");
+        return;
+    }
+
+    // The channels stay aligned as long as whole frames (one sample per channel) are appended.
+    uint32_t channel_count = 1;
+    PARAM(uint32_t, channel_count, LENGTH, 0)
+    ASSERT(channel_count > 0);
+    ASSERT(src_vertex->arr.item_count % channel_count == 0);
+    ASSERT(src_vertex->ring_head % channel_count == 0);
+
+    // NOTE: the params array is allocated here so that the ring buffer state can be written
+    // before the props are copied to it.
+    DvzArray* arr = &src_params->arr;
+    if (arr->item_count == 0)
+        dvz_array_resize(arr, 1);
+    DvzGraphicsStreamParams* params = dvz_array_item(arr, 0);
+    ASSERT(params != NULL);
+
+    // Only the params uniform is updated when the ring buffer scrolls.
+    if (params->capacity == src_vertex->arr.item_count &&
+        params->head == src_vertex->ring_head && params->count == src_vertex->ring_count)
+        return;
+    params->capacity = src_vertex->arr.item_count;
+    params->head = src_vertex->ring_head;
+    params->count = src_vertex->ring_count;
+    _source_set_changed(src_params, true);
+}
+
+static void _visual_stream(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    DvzCanvas* canvas = visual->canvas;
+    ASSERT(canvas != NULL);
+    DvzProp* prop = NULL;
+
+    // Graphics.
+    dvz_visual_graphics(visual, dvz_graphics_builtin(canvas, DVZ_GRAPHICS_STREAM, visual->flags));
+
+    // Sources
+    // NOTE: the vertex buffer must be turned into a ring buffer with dvz_visual_ring().
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_VERTEX, 0, DVZ_PIPELINE_GRAPHICS, 0, 0, sizeof(float), 0);
+
+    _common_sources(visual);
+
+    dvz_visual_source(                                              // params
+        visual, DVZ_SOURCE_TYPE_PARAM, 0, DVZ_PIPELINE_GRAPHICS, 0, //
+        DVZ_USER_BINDING, sizeof(DvzGraphicsStreamParams), 0);      //
+
+    // Props:
+
+    // Number of interleaved channels.
+    prop = dvz_visual_prop(visual, DVZ_PROP_LENGTH, 0, DVZ_DTYPE_UINT, DVZ_SOURCE_TYPE_PARAM, 0);
+    dvz_visual_prop_copy(
+        prop, 3, offsetof(DvzGraphicsStreamParams, channel_count), DVZ_ARRAY_COPY_SINGLE, 1);
+    dvz_visual_prop_default(prop, (uint32_t[]){1});
+
+    // Line color.
+    prop = dvz_visual_prop(visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_CVEC4, DVZ_SOURCE_TYPE_PARAM, 0);
+    dvz_visual_prop_copy(
+        prop, 4, offsetof(DvzGraphicsStreamParams, color), DVZ_ARRAY_COPY_SINGLE, 1);
+    dvz_visual_prop_default(prop, (cvec4[]){{255, 255, 255, 255}});
+
+    // Vertical scaling of the samples.
+    prop = dvz_visual_prop(visual, DVZ_PROP_SCALE, 0, DVZ_DTYPE_FLOAT, DVZ_SOURCE_TYPE_PARAM, 0);
+    dvz_visual_prop_copy(
+        prop, 5, offsetof(DvzGraphicsStreamParams, y_scale), DVZ_ARRAY_COPY_SINGLE, 1);
+    dvz_visual_prop_default(prop, (float[]){1});
+
+    // Common props.
+    _common_props(visual);
+
+    // Baking function.
+    dvz_visual_callback_bake(visual, _visual_stream_bake);
 }
 
 
@@ -988,8 +1600,6 @@ static void _text_bake(DvzVisual* visual, DvzVisualDataEvent ev)
 
     // Number of strings.
     uint32_t n_strings = arr_text->item_count; // number of strings
-    // Total number of characters, so that we can resize the vertex source array.
-    uint32_t n_chars = 0;
 
     // Alternatively, look at the GLYPH prop instead of TEXT.
     bool glyphs = false; // whether the user has set glyphs directly instead of text
@@ -999,85 +1609,179 @@ static void _text_bake(DvzVisual* visual, DvzVisualDataEvent ev)
     {
         glyphs = true;
         // NOTE: when setting glyphs directly, there is no notion of \0 null-termination of strings
-        n_chars = arr_glyph->item_count;
         // NOTE: must compute n_strings
         n_strings = arr_length->item_count;
     }
+    if (n_strings == 0)
+    {
+        log_debug("empty text visual");
+        return;
+    }
 
-    // Or strings are used instead:
-    else
+    // Text layout cache: the glyph runs of the strings at the previous bake.
+    DvzTextCache* cache = &visual->text_cache;
+    uint32_t n_cached = cache->runs.item_count;
+    DvzTextRun* cached = NULL;
+    uint32_t cached_idx = 0;
+
+    // Compute the layout key and the number of glyphs of every string, so that we can resize the
+    // vertex source array and only lay out the new or modified strings.
+    DvzArray runs = dvz_array_struct(n_strings, sizeof(DvzTextRun));
+    DvzTextRun* run = NULL;
+    uint32_t n_chars = 0; // total number of characters
+    bool same_counts = n_cached == n_strings;
+    const uint16_t* glyph = (const uint16_t*)arr_glyph->data;
+    const char* str = NULL;
+    for (uint32_t i = 0; i < n_strings; i++)
     {
-        // NOTE: must compute n_chars
-        char* str = NULL;
-        for (uint32_t i = 0; i < n_strings; i++)
+        run = dvz_array_item(&runs, i);
+        if (glyphs)
+        {
+            run->glyph_count = *(uint32_t*)dvz_array_item(arr_length, i);
+            ASSERT(n_chars + run->glyph_count <= arr_glyph->item_count);
+            run->key = _text_key(
+                glyph, run->glyph_count * sizeof(uint16_t), true,
+                *(float*)dvz_array_item(arr_size, i), dvz_array_item(arr_anchor, i),
+                *(float*)dvz_array_item(arr_angle, i));
+            glyph += run->glyph_count;
+        }
+        else
         {
             str = *(char**)dvz_array_item(arr_text, i);
             ASSERT(str != NULL);
             // WARNING: not safe
-            n_chars += strlen(str);
+            run->glyph_count = dvz_utf8_count(str);
+            run->key = _text_key(
+                str, strlen(str), false, *(float*)dvz_array_item(arr_size, i),
+                dvz_array_item(arr_anchor, i), *(float*)dvz_array_item(arr_angle, i));
         }
+        run->first = n_chars;
+        n_chars += run->glyph_count;
+        _pos_vec3(arr_pos->dtype, dvz_array_item(arr_pos, i), run->pos);
+        memcpy(run->color, dvz_array_item(arr_color, i), sizeof(cvec4));
+
+        if (same_counts)
+            same_counts = ((DvzTextRun*)dvz_array_item(&cache->runs, i))->glyph_count ==
+                          run->glyph_count;
     }
 
-    if (n_strings == 0 || n_chars == 0)
+    if (n_chars == 0)
     {
         log_debug("empty text visual");
+        dvz_array_destroy(&runs);
         return;
     }
-
-    ASSERT(n_strings > 0);
     ASSERT(n_chars > 0);
     log_debug("found %d string(s) in text visual, for a total of %d chars", n_strings, n_chars);
 
     // Graphics data.
     DvzGraphicsData data = dvz_graphics_data(visual->graphics[0], arr_vertex, NULL, NULL);
+    // Instanced glyphs are stored once, otherwise they are repeated for the 4 vertices.
+    uint32_t reps = visual->graphics[0]->vertices_per_instance > 0 ? 1 : 4;
+
+    // If the number of glyphs of every string is unchanged, the glyphs of the modified strings are
+    // laid out in place and only their range is uploaded. Otherwise, the vertex array is
+    // assembled from the cached glyph runs of the unchanged strings.
+    bool in_place = same_counts && arr_vertex->item_count == reps * n_chars;
+    DvzArray old_vertex = {0};
+    if (!in_place && n_cached > 0 && arr_vertex->item_count == reps * cache->glyph_count)
+        old_vertex = dvz_array_copy(arr_vertex);
+    else if (!in_place)
+        n_cached = 0;
     dvz_graphics_alloc(&data, n_chars);
+    src_vertex->dirty_first = 0;
+    src_vertex->dirty_count = 0;
 
     DvzGraphicsTextItem item = {0};
-    // Add all of the strings.
-    cvec4* colors = calloc(n_chars, sizeof(cvec4));
-    cvec4* color = NULL;
-    uint32_t string_len = 0;
-    uint32_t k = 0;
+    uint32_t dirty_first = UINT32_MAX, dirty_last = 0;
+    uint32_t n_layout = 0;
+    bool moved = false;
+    glyph = (const uint16_t*)arr_glyph->data;
     for (uint32_t i = 0; i < n_strings; i++)
     {
-        // String.
+        run = dvz_array_item(&runs, i);
         if (glyphs)
         {
-            string_len = *(uint32_t*)dvz_array_item(arr_length, i);
-            item.strlen = string_len;
-            ASSERT(item.strlen > 0);
             // NOTE: pointer to the glyph array, increasing of strlen at every string.
-            item.glyphs = (uint16_t*)dvz_array_item(arr_glyph, k);
-            k += item.strlen;
+            item.strlen = run->glyph_count;
+            item.glyphs = glyph;
+            glyph += run->glyph_count;
         }
         else
-        {
             item.string = *(char**)dvz_array_item(arr_text, i);
-            string_len = strlen(item.string);
+
+        // Reuse the glyphs of the previous layout of an identical string, wherever it was. In
+        // place, only the glyphs of the string with the same index can be reused, the other glyph
+        // runs may have been overwritten already.
+        cached_idx = n_cached > 0 ? _text_cache_find(cache, run->key, i) : UINT32_MAX;
+        cached = cached_idx != UINT32_MAX && (!in_place || cached_idx == i)
+                     ? dvz_array_item(&cache->runs, cached_idx)
+                     : NULL;
+        if (cached != NULL && cached->glyph_count == run->glyph_count)
+        {
+            moved = cached_idx != i || memcmp(cached->pos, run->pos, sizeof(vec3)) != 0 ||
+                    memcmp(cached->color, run->color, sizeof(cvec4)) != 0;
+            if (in_place && !moved)
+                continue;
+            if (!in_place)
+                memcpy(
+                    dvz_array_item(arr_vertex, reps * run->first),
+                    dvz_array_item(&old_vertex, reps * cached->first),
+                    reps * run->glyph_count * sizeof(DvzGraphicsTextVertex));
+            if (moved)
+                _text_run_patch(arr_vertex, reps, run, i);
         }
 
-        // Font size for this string.
-        item.font_size = *(float*)dvz_array_item(arr_size, i);
+        // Or lay out the string.
+        else if (run->glyph_count > 0)
+        {
+            // Font size for this string.
+            item.font_size = *(float*)dvz_array_item(arr_size, i);
 
-        // String position.
-        _vec3_cast(dvz_array_item(arr_pos, i), &item.vertex.pos);
-        // Anchor.
-        memcpy(item.vertex.anchor, dvz_array_item(arr_anchor, i), sizeof(vec2));
+            // String position.
+            glm_vec3_copy(run->pos, item.vertex.pos);
+            // Anchor.
+            memcpy(item.vertex.anchor, dvz_array_item(arr_anchor, i), sizeof(vec2));
 
-        // Angle.
-        item.vertex.angle = *(float*)dvz_array_item(arr_angle, i);
+            // Angle.
+            item.vertex.angle = *(float*)dvz_array_item(arr_angle, i);
 
-        // Repeat the color for each glyph.
-        color = (cvec4*)dvz_array_item(arr_color, i);
-        for (uint32_t j = 0; j < string_len; j++)
-        {
-            memcpy(colors[j], color, sizeof(cvec4));
+            // The color is the same for all glyphs of the string.
+            memcpy(item.vertex.color, run->color, sizeof(cvec4));
+
+            data.current_idx = run->first;
+            data.current_group = i;
+            dvz_graphics_append(&data, &item);
+            n_layout++;
         }
-        item.glyph_colors = colors;
 
-        dvz_graphics_append(&data, &item);
+        dirty_first = MIN(dirty_first, run->first);
+        dirty_last = MAX(dirty_last, run->first + run->glyph_count);
     }
-    FREE(colors);
+    log_debug("laid out %d/%d string(s) in text visual", n_layout, n_strings);
+
+    // Only upload the modified glyphs.
+    if (in_place)
+    {
+        if (dirty_last > dirty_first)
+        {
+            src_vertex->dirty_first = reps * dirty_first;
+            src_vertex->dirty_count = reps * (dirty_last - dirty_first);
+        }
+        else
+            // NOTE: no string has changed, skip the upload of the vertex source.
+            src_vertex->obj.request = DVZ_VISUAL_REQUEST_SET;
+    }
+
+    // Keep the glyph runs for the next bake.
+    dvz_array_destroy(&old_vertex);
+    dvz_array_destroy(&cache->runs);
+    cache->runs = runs;
+    cache->glyph_count = n_chars;
+    _text_cache_index(cache);
+
+    // The strings may have added new glyphs to the glyph atlas.
+    _text_font_atlas(visual, glyphs);
 }
 
 static void _visual_text(DvzVisual* visual)
@@ -1088,7 +1792,11 @@ static void _visual_text(DvzVisual* visual)
     DvzProp* prop = NULL;
 
     // Graphics.
-    dvz_visual_graphics(visual, dvz_graphics_builtin(canvas, DVZ_GRAPHICS_TEXT, visual->flags));
+    bool instanced = (visual->flags & DVZ_TEXT_FLAGS_INSTANCED) != 0;
+    dvz_visual_graphics(
+        visual, dvz_graphics_builtin(
+                    canvas, instanced ? DVZ_GRAPHICS_TEXT_INSTANCED : DVZ_GRAPHICS_TEXT,
+                    visual->flags));
 
     // Sources.
 
@@ -1150,22 +1858,9 @@ static void _visual_text(DvzVisual* visual)
 
     dvz_visual_callback_bake(visual, _text_bake);
 
-
-    // Connect the font atlas to the FONT_ATLAS and PARAM sources of the text visual.
-    // Text params.
-    ASSERT(canvas->gpu != NULL);
-    ASSERT(canvas->gpu->context != NULL);
-    DvzFontAtlas* atlas = &canvas->gpu->context->font_atlas;
-    ASSERT(atlas != NULL);
-    ASSERT(strlen(atlas->font_str) > 0);
-    dvz_visual_texture(visual, DVZ_SOURCE_TYPE_FONT_ATLAS, 0, atlas->texture);
-
-    DvzGraphicsTextParams params = {0};
-    params.grid_size[0] = (int32_t)atlas->rows;
-    params.grid_size[1] = (int32_t)atlas->cols;
-    params.tex_size[0] = (int32_t)atlas->width;
-    params.tex_size[1] = (int32_t)atlas->height;
-    dvz_visual_data_source(visual, DVZ_SOURCE_TYPE_PARAM, 0, 0, 1, 1, &params);
+    // Connect the glyph atlas to the FONT_ATLAS and PARAM sources of the text visual, the fixed
+    // font atlas is bound instead at bake time if the glyphs are set directly.
+    _text_font_atlas(visual, false);
 }
 
 
@@ -1218,10 +1913,10 @@ static void _visual_image_bake(DvzVisual* visual, DvzVisualDataEvent ev)
     DvzGraphicsImageItem item = {0};
     for (uint32_t i = 0; i < img_count; i++)
     {
-        _vec3_cast((const dvec3*)dvz_prop_item(pos0, i), &item.pos0);
-        _vec3_cast((const dvec3*)dvz_prop_item(pos1, i), &item.pos1);
-        _vec3_cast((const dvec3*)dvz_prop_item(pos2, i), &item.pos2);
-        _vec3_cast((const dvec3*)dvz_prop_item(pos3, i), &item.pos3);
+        _pos_vec3(pos0->dtype, dvz_prop_item(pos0, i), item.pos0);
+        _pos_vec3(pos1->dtype, dvz_prop_item(pos1, i), item.pos1);
+        _pos_vec3(pos2->dtype, dvz_prop_item(pos2, i), item.pos2);
+        _pos_vec3(pos3->dtype, dvz_prop_item(pos3, i), item.pos3);
 
         memcpy(&item.uv0, dvz_prop_item(uv0, i), sizeof(vec2));
         memcpy(&item.uv1, dvz_prop_item(uv1, i), sizeof(vec2));
@@ -1390,7 +2085,7 @@ static uint32_t _count_chars(DvzArray* arr_text)
     for (uint32_t i = 0; i < n_text; i++)
     {
         str = ((char**)arr_text->data)[i];
-        slen = strlen(str);
+        slen = dvz_utf8_count(str);
         ASSERT(slen > 0);
         char_count += slen;
     }
@@ -1654,6 +2349,190 @@ static void _visual_axes_2D_bake(DvzVisual* visual, DvzVisualDataEvent ev)
 
         dvz_graphics_append(&text_data, &str_item);
     }
+
+    // The labels may have added new glyphs to the glyph atlas.
+    _text_font_atlas(visual, false);
+}
+
+// Lay out a tick label with the glyph atlas, and append its glyph run to the labels and glyphs
+// sources, unless it was laid out by a previous bake. Returns the index of the glyph run.
+static uint32_t _axes_label_run(DvzVisual* visual, DvzGlyphAtlas* atlas, const char* text)
+{
+    ASSERT(visual != NULL);
+    ASSERT(atlas != NULL);
+    ASSERT(text != NULL);
+    DvzAxesLabels* labels = &visual->axes_labels;
+
+    // NOTE: the glyph runs are expressed in line heights, they do not depend on the font size.
+    uint64_t key = _text_key(text, strlen(text), false, 0, (vec2){0, 0}, 0);
+    uint32_t run_count = labels->keys.item_count;
+    for (uint32_t i = 0; i < run_count; i++)
+        if (((uint64_t*)labels->keys.data)[i] == key)
+            return i;
+
+    uint32_t n = dvz_utf8_count(text);
+    if (n > DVZ_AXES_LABEL_MAX_GLYPHS)
+    {
+        log_warn("tick label truncated to %d glyphs", DVZ_AXES_LABEL_MAX_GLYPHS);
+        n = DVZ_AXES_LABEL_MAX_GLYPHS;
+    }
+
+    // Same layout as the strings of the text graphics, with the default font.
+    DvzGraphicsAxesGlyph glyphs[DVZ_AXES_LABEL_MAX_GLYPHS] = {0};
+    DvzGlyph* glyph = NULL;
+    float ascent = atlas->fonts[0].ascent;
+    float pen = 0;
+    const char* s = text;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        glyph = dvz_glyph_atlas_get(atlas, 0, dvz_utf8_next(&s));
+        memcpy(glyphs[i].rect, glyph->rect, sizeof(usvec4));
+        glyphs[i].offset[0] = pen + glyph->offset[0];
+        glyphs[i].offset[1] = ascent + glyph->offset[1];
+        glyphs[i].size[0] = glyph->size[0];
+        glyphs[i].size[1] = glyph->size[1];
+        pen += glyph->advance;
+    }
+
+    DvzGraphicsAxesLabel run = {0};
+    run.first = labels->glyph_count;
+    run.count = n;
+    run.size[0] = pen;
+    run.size[1] = 1;
+    if (n > 0)
+        dvz_visual_data_source(visual, DVZ_SOURCE_TYPE_OTHER, 1, run.first, n, n, glyphs);
+    dvz_visual_data_source(visual, DVZ_SOURCE_TYPE_OTHER, 0, run_count, 1, 1, &run);
+    labels->glyph_count += n;
+
+    dvz_array_resize(&labels->keys, run_count + 1);
+    dvz_array_data(&labels->keys, run_count, 1, 1, &key);
+    return run_count;
+}
+
+// Only upload the items appended to a source since a given index, unless the GPU buffer needs to
+// be reallocated.
+static void _axes_label_dirty(DvzSource* source, uint32_t first)
+{
+    ASSERT(source != NULL);
+    uint32_t count = source->arr.item_count;
+    if (first >= count)
+        return;
+    if (source->u.br.buffer == NULL || source->u.br.size < count * source->arr.item_size)
+    {
+        source->dirty_first = 0;
+        source->dirty_count = 0;
+        return;
+    }
+    if (source->dirty_count > 0)
+        first = MIN(first, source->dirty_first);
+    source->dirty_first = first;
+    source->dirty_count = count - first;
+}
+
+// With DVZ_AXES_FLAGS_GPU, only the major ticks and the labels which have never been laid out
+// are uploaded, the tick marks, grid lines and label quads are expanded in the vertex shaders.
+static void _visual_axes_2D_gpu_bake(DvzVisual* visual, DvzVisualDataEvent ev)
+{
+    ASSERT(visual != NULL);
+    DvzCanvas* canvas = visual->canvas;
+    DvzGlyphAtlas* atlas = canvas->gpu->context->glyph_atlas;
+    ASSERT(atlas != NULL);
+
+    // Data sources.
+    DvzSource* tick_src = dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    DvzSource* label_tick_src = dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, 1);
+    DvzSource* run_src = dvz_source_get(visual, DVZ_SOURCE_TYPE_OTHER, 0);
+    DvzSource* glyph_src = dvz_source_get(visual, DVZ_SOURCE_TYPE_OTHER, 1);
+
+    // The props are all attached to the vertex sources, skip the bake if none has changed.
+    if (!_source_has_changed(tick_src) && !_source_has_changed(label_tick_src))
+        return;
+
+    DvzProp* prop_major = dvz_prop_get(visual, DVZ_PROP_POS, DVZ_AXES_LEVEL_MAJOR);
+    DvzArray* arr_text =
+        _prop_array(dvz_prop_get(visual, DVZ_PROP_TEXT, 0), DVZ_PROP_ARRAY_DEFAULT);
+    uint32_t n_major = prop_major->arr_orig.item_count;
+    uint32_t n_text = MIN(arr_text->item_count, n_major);
+    if (n_major == 0)
+        return;
+
+    // Glyph run #0 is the empty label of the ticks without text, it also ensures that the
+    // storage buffers are never empty. All runs are laid out again when there are too many.
+    DvzAxesLabels* labels = &visual->axes_labels;
+    uint32_t first_run = run_src->arr.item_count;
+    uint32_t first_glyph = glyph_src->arr.item_count;
+    if (labels->keys.item_count == 0 || labels->keys.item_count + n_text > DVZ_AXES_MAX_LABELS)
+    {
+        first_run = first_glyph = 0;
+        dvz_array_destroy(&labels->keys);
+        labels->keys = dvz_array_struct(0, sizeof(uint64_t));
+        dvz_visual_data_source(
+            visual, DVZ_SOURCE_TYPE_OTHER, 1, 0, 1, 1, (DvzGraphicsAxesGlyph[]){{0}});
+        labels->glyph_count = 1;
+        _axes_label_run(visual, atlas, "");
+    }
+
+    // Compact ticks: the normalized position of the major ticks, and their glyph runs.
+    DvzGraphicsAxesTick* ticks = calloc(n_major, sizeof(DvzGraphicsAxesTick));
+    ASSERT(ticks != NULL);
+    char* text = NULL;
+    for (uint32_t i = 0; i < n_major; i++)
+    {
+        ticks[i].value = (float)*(double*)dvz_prop_item(prop_major, i);
+        text = i < n_text ? ((char**)arr_text->data)[i] : NULL;
+        if (text != NULL)
+            ticks[i].label = _axes_label_run(visual, atlas, text);
+    }
+    // NOTE: the label pipeline pulls the same ticks, from its own vertex source.
+    dvz_visual_data_source(visual, DVZ_SOURCE_TYPE_VERTEX, 0, 0, n_major, n_major, ticks);
+    dvz_visual_data_source(visual, DVZ_SOURCE_TYPE_VERTEX, 1, 0, n_major, n_major, ticks);
+    FREE(ticks);
+
+    _axes_label_dirty(run_src, first_run);
+    _axes_label_dirty(glyph_src, first_glyph);
+
+    // Params of the two pipelines.
+    DvzGraphicsAxesParams params = {0};
+    params.coord = (int32_t)(visual->flags & 0x1);
+    ASSERT(params.coord < 2);
+    params.tick_count = n_major;
+
+    int flags = ((visual->flags >> 2) & 0x0003);
+    for (uint32_t level = 0; level < DVZ_AXES_LEVEL_COUNT; level++)
+    {
+        PARAM(cvec4, params.colors[level], COLOR, level)
+        PARAM(float, params.line_widths[level], LINE_WIDTH, level)
+        DPI_SCALE(params.line_widths[level])
+    }
+    // Hide minor and/or grid depending on the visual flags.
+    if (flags & 0x1)
+        params.colors[DVZ_AXES_LEVEL_MINOR][3] = 0;
+    if (flags & 0x2)
+        params.colors[DVZ_AXES_LEVEL_GRID][3] = 0;
+
+    PARAM(float, params.tick_lengths[0], LENGTH, DVZ_AXES_LEVEL_MINOR)
+    PARAM(float, params.tick_lengths[1], LENGTH, DVZ_AXES_LEVEL_MAJOR)
+    DPI_SCALE(params.tick_lengths[0])
+    DPI_SCALE(params.tick_lengths[1])
+
+    PARAM(float, params.font_size, TEXT_SIZE, 0)
+    DPI_SCALE(params.font_size)
+    PARAM(cvec4, params.label_color, COLOR, 4)
+    if (params.coord == DVZ_AXES_COORD_X)
+    {
+        params.label_anchor[1] = 1;
+        params.label_shift[1] = -10;
+    }
+    else
+    {
+        params.label_anchor[0] = -1;
+        params.label_shift[0] = -10;
+    }
+    dvz_visual_data_source(visual, DVZ_SOURCE_TYPE_PARAM, 1, 0, 1, 1, &params);
+    dvz_visual_data_source(visual, DVZ_SOURCE_TYPE_PARAM, 2, 0, 1, 1, &params);
+
+    // The labels may have added new glyphs to the glyph atlas.
+    _text_font_atlas(visual, false);
 }
 
 static void _visual_axes_2D(DvzVisual* visual)
@@ -1663,11 +2542,57 @@ static void _visual_axes_2D(DvzVisual* visual)
     ASSERT(canvas != NULL);
     DvzProp* prop = NULL;
 
+    // NOTE: the axes flags are shifted to the visual-specific bit range, see _axes_visual().
+    bool gpu = (visual->flags & (DVZ_AXES_FLAGS_GPU >> 8)) != 0;
+
     // Graphics.
-    dvz_visual_graphics(visual, dvz_graphics_builtin(canvas, DVZ_GRAPHICS_SEGMENT, visual->flags));
-    dvz_visual_graphics(visual, dvz_graphics_builtin(canvas, DVZ_GRAPHICS_TEXT, visual->flags));
+    dvz_visual_graphics(
+        visual, dvz_graphics_builtin(
+                    canvas, gpu ? DVZ_GRAPHICS_AXES_TICK : DVZ_GRAPHICS_SEGMENT, visual->flags));
+    dvz_visual_graphics(
+        visual, dvz_graphics_builtin(
+                    canvas, gpu ? DVZ_GRAPHICS_AXES_LABEL : DVZ_GRAPHICS_TEXT, visual->flags));
+
+    // GPU axes: sources.
+    if (gpu)
+    {
+        // Major ticks, pulled by both pipelines.
+        dvz_visual_source(
+            visual, DVZ_SOURCE_TYPE_VERTEX, 0, DVZ_PIPELINE_GRAPHICS, 0, //
+            0, sizeof(DvzGraphicsAxesTick), 0);
+        dvz_visual_source(
+            visual, DVZ_SOURCE_TYPE_VERTEX, 1, DVZ_PIPELINE_GRAPHICS, 1, //
+            0, sizeof(DvzGraphicsAxesTick), 0);
+
+        // Tick params.
+        dvz_visual_source(
+            visual, DVZ_SOURCE_TYPE_PARAM, 1, DVZ_PIPELINE_GRAPHICS, 0, //
+            DVZ_USER_BINDING, sizeof(DvzGraphicsAxesParams), 0);
+
+        // Text params and glyph atlas texture.
+        dvz_visual_source(
+            visual, DVZ_SOURCE_TYPE_PARAM, 0, DVZ_PIPELINE_GRAPHICS, 1, //
+            DVZ_USER_BINDING, sizeof(DvzGraphicsTextParams), 0);
+        dvz_visual_source(
+            visual, DVZ_SOURCE_TYPE_FONT_ATLAS, 0, DVZ_PIPELINE_GRAPHICS, 1, //
+            DVZ_USER_BINDING + 1, sizeof(cvec4), 0);
+
+        // Label params.
+        dvz_visual_source(
+            visual, DVZ_SOURCE_TYPE_PARAM, 2, DVZ_PIPELINE_GRAPHICS, 1, //
+            DVZ_USER_BINDING + 2, sizeof(DvzGraphicsAxesParams), 0);
+
+        // Glyph runs and glyphs of the labels.
+        dvz_visual_source(
+            visual, DVZ_SOURCE_TYPE_OTHER, 0, DVZ_PIPELINE_GRAPHICS, 1, //
+            DVZ_USER_BINDING + 3, sizeof(DvzGraphicsAxesLabel), 0);
+        dvz_visual_source(
+            visual, DVZ_SOURCE_TYPE_OTHER, 1, DVZ_PIPELINE_GRAPHICS, 1, //
+            DVZ_USER_BINDING + 4, sizeof(DvzGraphicsAxesGlyph), 0);
+    }
 
     // Segment graphics: sources.
+    else
     {
         // Vertex buffer.
         dvz_visual_source(
@@ -1681,6 +2606,7 @@ static void _visual_axes_2D(DvzVisual* visual)
     }
 
     // Text graphics: sources.
+    if (!gpu)
     {
         // Vertex buffer.
         dvz_visual_source(
@@ -1779,7 +2705,7 @@ static void _visual_axes_2D(DvzVisual* visual)
         dvz_visual_prop_copy(prop, 0, 0, DVZ_ARRAY_COPY_SINGLE, 1);
     }
 
-    dvz_visual_callback_bake(visual, _visual_axes_2D_bake);
+    dvz_visual_callback_bake(visual, gpu ? _visual_axes_2D_gpu_bake : _visual_axes_2D_bake);
 }
 
 
@@ -1807,8 +2733,24 @@ static void _mesh_bake(DvzVisual* visual, DvzVisualDataEvent ev)
     DvzArray* arr_texcoords = _prop_array(prop_texcoords, DVZ_PROP_ARRAY_DEFAULT);
     DvzArray* arr_alpha = _prop_array(prop_alpha, DVZ_PROP_ARRAY_DEFAULT);
 
-    // If colors have been specified, we need to override texcoords.
+    // Scalar values: they have their own vertex buffer, the tex coords are only used for the
+    // textures. Without tex coords, a negative v tells the shader not to use the textures.
     uint32_t N = arr_color->item_count;
+    if (arr_color->dtype == DVZ_DTYPE_FLOAT)
+    {
+        if (arr_texcoords->item_count == 0 && N > 0)
+        {
+            dvz_array_resize(arr_texcoords, N);
+            for (uint32_t i = 0; i < N; i++)
+            {
+                ((vec2*)arr_texcoords->data)[i][0] = 0;
+                ((vec2*)arr_texcoords->data)[i][1] = -1;
+            }
+        }
+        N = 0;
+    }
+
+    // If colors have been specified, we need to override texcoords.
     if (N > 0)
     {
         dvz_array_resize(arr_texcoords, N);
@@ -1859,6 +2801,82 @@ static void _mesh_bake(DvzVisual* visual, DvzVisualDataEvent ev)
     ASSERT(!(normal[0][0] == 0 && normal[0][1] == 0 && normal[0][2] == 0));
 }
 
+// Compute the normals of a quantized mesh from the POS and INDEX props, on the CPU, as the
+// vertex buffer only contains the compressed normals.
+static void _mesh_quantized_normals(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+
+    DvzProp* prop_normal = dvz_prop_get(visual, DVZ_PROP_NORMAL, 0); // vec3
+    DvzArray* arr_pos = _prop_array(dvz_prop_get(visual, DVZ_PROP_POS, 0), DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_index =
+        _prop_array(dvz_prop_get(visual, DVZ_PROP_INDEX, 0), DVZ_PROP_ARRAY_DEFAULT);
+
+    uint32_t vertex_count = arr_pos->item_count;
+    uint32_t face_count = arr_index->item_count / 3;
+    if (vertex_count == 0 || face_count == 0)
+        return;
+    log_debug("compute the normals of the quantized mesh");
+
+    dvz_array_resize(&prop_normal->arr_orig, vertex_count);
+    vec3* normals = (vec3*)prop_normal->arr_orig.data;
+    memset(normals, 0, vertex_count * sizeof(vec3));
+
+    // The positions are converted to single precision if needed.
+    vec3* pos = (vec3*)arr_pos->data;
+    if (arr_pos->dtype != DVZ_DTYPE_VEC3)
+    {
+        pos = calloc(vertex_count, sizeof(vec3));
+        for (uint32_t i = 0; i < vertex_count; i++)
+            _pos_vec3(arr_pos->dtype, dvz_array_item(arr_pos, i), pos[i]);
+    }
+
+    dvz_normals(
+        vertex_count, (const float*)pos, 0, face_count, (const DvzIndex*)arr_index->data,
+        DVZ_MESH_NORMALS_UNIFORM, (float*)normals, 0);
+
+    if (pos != (vec3*)arr_pos->data)
+        FREE(pos);
+}
+
+static void _mesh_quantized_bake(DvzVisual* visual, DvzVisualDataEvent ev)
+{
+    ASSERT(visual != NULL);
+
+    DvzProp* prop_color = dvz_prop_get(visual, DVZ_PROP_COLOR, 0);         // cvec4
+    DvzProp* prop_texcoords = dvz_prop_get(visual, DVZ_PROP_TEXCOORDS, 0); // vec2
+    DvzProp* prop_alpha = dvz_prop_get(visual, DVZ_PROP_ALPHA, 0);         // uint8_t
+    DvzProp* prop_normal = dvz_prop_get(visual, DVZ_PROP_NORMAL, 0);       // vec3
+
+    DvzArray* arr_color = _prop_array(prop_color, DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_texcoords = _prop_array(prop_texcoords, DVZ_PROP_ARRAY_DEFAULT);
+    DvzArray* arr_alpha = _prop_array(prop_alpha, DVZ_PROP_ARRAY_DEFAULT);
+
+    // The color is stored as such in the vertex, a negative v tex coord tells the shader to use
+    // it instead of the textures (half floats cannot hold the RGB values packed in a float).
+    uint32_t N = arr_color->item_count;
+    if (N > 0)
+    {
+        dvz_array_resize(arr_texcoords, N);
+        dvz_array_resize(arr_alpha, N);
+        for (uint32_t i = 0; i < N; i++)
+        {
+            ((vec2*)arr_texcoords->data)[i][0] = 0;
+            ((vec2*)arr_texcoords->data)[i][1] = -1;
+            ((uint8_t*)arr_alpha->data)[i] = ((cvec4*)arr_color->data)[i][3];
+        }
+    }
+
+    // Compute the normals if they were not specified.
+    if (_prop_array(prop_normal, DVZ_PROP_ARRAY_DEFAULT)->item_count == 0)
+        _mesh_quantized_normals(visual);
+
+    // The quantization itself happens when casting the props to the vertex buffer.
+    _default_visual_bake(visual, ev);
+}
+
+
+
 static void _visual_mesh(DvzVisual* visual)
 {
     ASSERT(visual != NULL);
@@ -1866,13 +2884,21 @@ static void _visual_mesh(DvzVisual* visual)
     ASSERT(canvas != NULL);
     DvzProp* prop = NULL;
 
+    // Compressed vertex format: 20 bytes per vertex instead of 48.
+    bool quantized = (visual->flags & DVZ_MESH_FLAGS_QUANTIZED) != 0;
+    VkDeviceSize vertex_size =
+        quantized ? sizeof(DvzGraphicsMeshQuantizedVertex) : sizeof(DvzGraphicsMeshVertex);
+
     // Graphics.
-    dvz_visual_graphics(visual, dvz_graphics_builtin(canvas, DVZ_GRAPHICS_MESH, visual->flags));
+    dvz_visual_graphics(
+        visual, dvz_graphics_builtin(
+                    canvas, quantized ? DVZ_GRAPHICS_MESH_QUANTIZED : DVZ_GRAPHICS_MESH,
+                    visual->flags));
 
     // Sources
     dvz_visual_source(                                               // vertex buffer
         visual, DVZ_SOURCE_TYPE_VERTEX, 0, DVZ_PIPELINE_GRAPHICS, 0, //
-        0, sizeof(DvzGraphicsMeshVertex), 0);                        //
+        0, vertex_size, 0);                                          //
 
     dvz_visual_source(                                              // index buffer
         visual, DVZ_SOURCE_TYPE_INDEX, 0, DVZ_PIPELINE_GRAPHICS, 0, //
@@ -1889,30 +2915,63 @@ static void _visual_mesh(DvzVisual* visual)
             visual, DVZ_SOURCE_TYPE_IMAGE, i, DVZ_PIPELINE_GRAPHICS, 0, //
             DVZ_USER_BINDING + i + 1, sizeof(cvec4), 0);                //
 
+    _colormap_props(visual, DVZ_USER_BINDING + 5); // scalar colors
+
     // Props:
 
     // Vertex pos.
     prop = dvz_visual_prop(visual, DVZ_PROP_POS, 0, DVZ_DTYPE_DVEC3, DVZ_SOURCE_TYPE_VERTEX, 0);
-    dvz_visual_prop_cast(
-        prop, 0, offsetof(DvzGraphicsMeshVertex, pos), DVZ_DTYPE_VEC3, DVZ_ARRAY_COPY_SINGLE, 1);
+    if (quantized)
+        dvz_visual_prop_cast(
+            prop, 0, offsetof(DvzGraphicsMeshQuantizedVertex, pos), DVZ_DTYPE_SNORM16_VEC4,
+            DVZ_ARRAY_COPY_SINGLE, 1);
+    else
+        dvz_visual_prop_cast(
+            prop, 0, offsetof(DvzGraphicsMeshVertex, pos), DVZ_DTYPE_VEC3, DVZ_ARRAY_COPY_SINGLE,
+            1);
 
     // Vertex normal.
     prop = dvz_visual_prop(visual, DVZ_PROP_NORMAL, 0, DVZ_DTYPE_VEC3, DVZ_SOURCE_TYPE_VERTEX, 0);
-    dvz_visual_prop_copy(
-        prop, 0, offsetof(DvzGraphicsMeshVertex, normal), DVZ_ARRAY_COPY_SINGLE, 1);
+    if (quantized)
+        dvz_visual_prop_cast(
+            prop, 0, offsetof(DvzGraphicsMeshQuantizedVertex, normal), DVZ_DTYPE_OCT16_VEC2,
+            DVZ_ARRAY_COPY_SINGLE, 1);
+    else
+        dvz_visual_prop_copy(
+            prop, 0, offsetof(DvzGraphicsMeshVertex, normal), DVZ_ARRAY_COPY_SINGLE, 1);
 
     // Vertex tex coords.
     prop =
         dvz_visual_prop(visual, DVZ_PROP_TEXCOORDS, 0, DVZ_DTYPE_VEC2, DVZ_SOURCE_TYPE_VERTEX, 0);
-    dvz_visual_prop_copy(prop, 0, offsetof(DvzGraphicsMeshVertex, uv), DVZ_ARRAY_COPY_SINGLE, 1);
+    if (quantized)
+        dvz_visual_prop_cast(
+            prop, 0, offsetof(DvzGraphicsMeshQuantizedVertex, uv), DVZ_DTYPE_HALF_VEC2,
+            DVZ_ARRAY_COPY_SINGLE, 1);
+    else
+        dvz_visual_prop_copy(
+            prop, 0, offsetof(DvzGraphicsMeshVertex, uv), DVZ_ARRAY_COPY_SINGLE, 1);
 
-    // Vertex color: override tex coords by packing 3 bytes into a float
-    prop = dvz_visual_prop(visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_CVEC4, DVZ_SOURCE_TYPE_VERTEX, 0);
+    // Vertex color: override tex coords by packing 3 bytes into a float (or stored as such in
+    // the quantized vertex). Scalar values have their own vertex buffer.
+    if ((visual->flags & DVZ_GRAPHICS_FLAGS_SCALAR_COLOR) != 0)
+        _color_prop(visual, 0, 0, DVZ_ARRAY_COPY_SINGLE, 1, NULL);
+    else
+    {
+        prop = dvz_visual_prop(
+            visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_CVEC4, DVZ_SOURCE_TYPE_VERTEX, 0);
+        if (quantized)
+            dvz_visual_prop_copy(
+                prop, 0, offsetof(DvzGraphicsMeshQuantizedVertex, color), DVZ_ARRAY_COPY_SINGLE,
+                1);
+    }
 
     // Vertex alpha.
     prop = dvz_visual_prop(visual, DVZ_PROP_ALPHA, 0, DVZ_DTYPE_CHAR, DVZ_SOURCE_TYPE_VERTEX, 0);
     dvz_visual_prop_copy(
-        prop, 0, offsetof(DvzGraphicsMeshVertex, alpha), DVZ_ARRAY_COPY_SINGLE, 1);
+        prop, 0,
+        quantized ? offsetof(DvzGraphicsMeshQuantizedVertex, color) + 3
+                  : offsetof(DvzGraphicsMeshVertex, alpha),
+        DVZ_ARRAY_COPY_SINGLE, 1);
     uint8_t alpha = 255;
     dvz_visual_prop_default(prop, &alpha);
 
@@ -1956,7 +3015,378 @@ static void _visual_mesh(DvzVisual* visual)
     // for (uint32_t i = 0; i < 4; i++)
     //     dvz_visual_prop(visual, DVZ_PROP_IMAGE, i, DVZ_DTYPE_UINT, DVZ_SOURCE_TYPE_IMAGE, i);
 
-    dvz_visual_callback_bake(visual, _mesh_bake);
+    dvz_visual_callback_bake(visual, quantized ? _mesh_quantized_bake : _mesh_bake);
+}
+
+
+
+/*************************************************************************************************/
+/*  Point cloud                                                                                  */
+/*************************************************************************************************/
+
+// One indirect draw command per octree slot, the slots that are not displayed have no vertex. The
+// command buffers are not refilled when other octree nodes are displayed.
+static void _visual_point_cloud_fill(DvzVisual* visual, DvzVisualFillEvent ev)
+{
+    ASSERT(visual != NULL);
+    if (visual->octree == NULL || visual->indirect.buffer == NULL)
+    {
+        log_debug("skip the point cloud visual as no octree has been set");
+        return;
+    }
+
+    DvzCommands* cmds = ev.cmds;
+    uint32_t idx = ev.cmd_idx;
+
+    DvzSource* source = dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    ASSERT(source != NULL);
+    DvzBindings* bindings = dvz_container_get(&visual->bindings, 0);
+    ASSERT(dvz_obj_is_created(&bindings->obj));
+    DvzGraphics* graphics = visual->graphics[0];
+    ASSERT(graphics != NULL);
+
+    dvz_cmd_bind_vertex_buffer(cmds, idx, 0, source->u.br, 0);
+    if (graphics == ev.bound_graphics)
+        dvz_cmd_bind_descriptors(cmds, idx, graphics, bindings, 0);
+    else
+        dvz_cmd_bind_graphics(cmds, idx, graphics, bindings, 0);
+    dvz_cmd_draw_indirect(cmds, idx, visual->indirect, visual->octree->slot_count);
+}
+
+static void _visual_point_cloud(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    DvzCanvas* canvas = visual->canvas;
+    ASSERT(canvas != NULL);
+    DvzProp* prop = NULL;
+
+    // The points are stored in the normalized coordinates of the octree.
+    visual->flags |= DVZ_VISUAL_FLAGS_TRANSFORM_NONE;
+
+    // Graphics.
+    dvz_visual_graphics(visual, dvz_graphics_builtin(canvas, DVZ_GRAPHICS_POINT, visual->flags));
+
+    // Sources
+    // NOTE: the vertex buffer is created by dvz_visual_octree().
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_VERTEX, 0, DVZ_PIPELINE_GRAPHICS, 0, 0, sizeof(DvzVertex), 0);
+    _common_sources(visual);
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_PARAM, 0, DVZ_PIPELINE_GRAPHICS, 0, DVZ_USER_BINDING,
+        sizeof(DvzGraphicsPointParams), 0);
+
+    // Props:
+
+    // Common props.
+    _common_props(visual);
+
+    // Param: marker size.
+    prop = dvz_visual_prop(
+        visual, DVZ_PROP_MARKER_SIZE, 0, DVZ_DTYPE_FLOAT, DVZ_SOURCE_TYPE_PARAM, 0);
+    dvz_visual_prop_copy(
+        prop, 0, offsetof(DvzGraphicsPointParams, point_size), DVZ_ARRAY_COPY_SINGLE, 1);
+    dvz_visual_prop_dpi(prop, canvas->dpi_scaling);
+    float size = 2;
+    dvz_visual_prop_default(prop, &size);
+
+    dvz_visual_fill_callback(visual, _visual_point_cloud_fill);
+}
+
+
+
+/*************************************************************************************************/
+/*  Density                                                                                      */
+/*************************************************************************************************/
+
+// Barrier on a buffer between the pipeline stages writing and reading it.
+static void _compute_barrier(
+    DvzVisual* visual, DvzCommands* cmds, uint32_t idx, DvzBufferRegions br, //
+    VkPipelineStageFlags src_stage, VkAccessFlags src_access,                //
+    VkPipelineStageFlags dst_stage, VkAccessFlags dst_access)
+{
+    DvzBarrier barrier = dvz_barrier(visual->canvas->gpu);
+    dvz_barrier_stages(&barrier, src_stage, dst_stage);
+    dvz_barrier_buffer(&barrier, br);
+    dvz_barrier_buffer_access(&barrier, src_access, dst_access);
+    dvz_cmd_barrier(cmds, idx, &barrier);
+}
+
+// Clear the bins and count the points in each bin, before the render pass. The shapes of the
+// compute tasks are read from a GPU buffer, they are empty when the bins are up to date.
+static void _visual_density_compute(DvzVisual* visual, DvzVisualFillEvent ev)
+{
+    ASSERT(visual != NULL);
+    DvzDensity* density = &visual->density;
+    if (!density->ready)
+        return;
+    ASSERT(visual->compute_count == 2);
+
+    DvzCommands* cmds = ev.cmds;
+    uint32_t idx = ev.cmd_idx;
+
+    // The fragment shader of the previous frame may still be reading the bins.
+    _compute_barrier(
+        visual, cmds, idx, density->bins,                                        //
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,        //
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+    dvz_cmd_compute_indirect(cmds, idx, visual->computes[0], density->dispatch);
+
+    _compute_barrier(
+        visual, cmds, idx, density->bins,                                        //
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,        //
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    DvzBufferRegions br = density->dispatch;
+    br.offsets[0] += sizeof(VkDispatchIndirectCommand);
+    br.size -= sizeof(VkDispatchIndirectCommand);
+    dvz_cmd_compute_indirect(cmds, idx, visual->computes[1], br);
+
+    _compute_barrier(
+        visual, cmds, idx, density->bins,                                        //
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,        //
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+}
+
+// Draw a single triangle covering the panel, colormapping the count of each bin.
+static void _visual_density_fill(DvzVisual* visual, DvzVisualFillEvent ev)
+{
+    ASSERT(visual != NULL);
+    if (!visual->density.ready)
+    {
+        log_debug("skip the density visual as the bins have not been allocated yet");
+        return;
+    }
+
+    DvzCommands* cmds = ev.cmds;
+    uint32_t idx = ev.cmd_idx;
+
+    DvzBindings* bindings = dvz_container_get(&visual->bindings, 0);
+    ASSERT(dvz_obj_is_created(&bindings->obj));
+    DvzGraphics* graphics = visual->graphics[0];
+    ASSERT(graphics != NULL);
+
+    if (graphics == ev.bound_graphics)
+        dvz_cmd_bind_descriptors(cmds, idx, graphics, bindings, 0);
+    else
+        dvz_cmd_bind_graphics(cmds, idx, graphics, bindings, 0);
+    dvz_cmd_draw(cmds, idx, 0, 3);
+}
+
+// Create a compute pipeline from a compute shader embedded in the library, with the given
+// descriptor types for the slots 0, 1, 2...
+static DvzCompute* _builtin_compute(
+    DvzVisual* visual, const char* name, uint32_t slot_count, const VkDescriptorType* types)
+{
+    ASSERT(visual != NULL);
+    DvzContext* ctx = visual->canvas->gpu->context;
+    ASSERT(ctx != NULL);
+    DvzCompute* compute = dvz_ctx_compute(ctx, NULL);
+
+    unsigned long size = 0;
+    unsigned char* buffer = dvz_resource_shader(name, &size);
+    ASSERT(size > 0);
+    ASSERT(buffer != NULL);
+    uint32_t* code = (uint32_t*)calloc(size, 1);
+    memcpy(code, buffer, size);
+    dvz_compute_spirv(compute, size, code);
+    FREE(code);
+
+    for (uint32_t i = 0; i < slot_count; i++)
+        dvz_compute_slot(compute, i, types[i]);
+
+    dvz_visual_compute(visual, compute);
+    dvz_compute_create(compute);
+    return compute;
+}
+
+static void _visual_density(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    DvzCanvas* canvas = visual->canvas;
+    ASSERT(canvas != NULL);
+    DvzProp* prop = NULL;
+
+    visual->density.enabled = true;
+
+    // Graphics and computes.
+    dvz_visual_graphics(
+        visual, dvz_graphics_builtin(canvas, DVZ_GRAPHICS_DENSITY, visual->flags));
+    // Slots: MVP, viewport, points, bins.
+    VkDescriptorType slots[] = {
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER};
+    _builtin_compute(visual, "compute_density_clear_comp", 4, slots);
+    _builtin_compute(visual, "compute_density_comp", 4, slots);
+
+    // Sources
+    // NOTE: the vertex buffer is not bound to the graphics pipeline, it is only read by the
+    // binning compute pipeline.
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_VERTEX, 0, DVZ_PIPELINE_GRAPHICS, 0, 0, sizeof(vec3), 0);
+    _common_sources(visual);
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_PARAM, 0, DVZ_PIPELINE_GRAPHICS, 0, DVZ_USER_BINDING,
+        sizeof(DvzGraphicsDensityParams), 0);
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_COLOR_TEXTURE, 0, DVZ_PIPELINE_GRAPHICS, 0, DVZ_USER_BINDING + 1,
+        sizeof(uint8_t), 0);
+    // NOTE: the bins buffer is allocated by the scene, as its size depends on the panel size.
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_OTHER, 0, DVZ_PIPELINE_GRAPHICS, 0, DVZ_USER_BINDING + 2,
+        sizeof(uint32_t), 0);
+
+    // Props:
+
+    // Point positions.
+    prop = dvz_visual_prop(visual, DVZ_PROP_POS, 0, DVZ_DTYPE_DVEC3, DVZ_SOURCE_TYPE_VERTEX, 0);
+    dvz_visual_prop_cast(prop, 0, 0, DVZ_DTYPE_VEC3, DVZ_ARRAY_COPY_SINGLE, 1);
+
+    // Common props.
+    _common_props(visual);
+
+    // Colormap.
+    prop = dvz_visual_prop(visual, DVZ_PROP_COLORMAP, 0, DVZ_DTYPE_INT, DVZ_SOURCE_TYPE_PARAM, 0);
+    dvz_visual_prop_copy(
+        prop, 0, offsetof(DvzGraphicsDensityParams, cmap), DVZ_ARRAY_COPY_SINGLE, 1);
+    dvz_visual_prop_default(prop, (DvzColormap[]){DVZ_CMAP_INFERNO});
+
+    dvz_visual_fill_callback(visual, _visual_density_fill);
+    dvz_visual_compute_callback(visual, _visual_density_compute);
+}
+
+
+
+/*************************************************************************************************/
+/*  Histogram                                                                                    */
+/*************************************************************************************************/
+
+// Clear the bins and count the samples in each bin, before the render pass.
+static void _visual_histogram_compute(DvzVisual* visual, DvzVisualFillEvent ev)
+{
+    ASSERT(visual != NULL);
+    DvzHistogram* histogram = &visual->histogram;
+    if (!histogram->ready)
+        return;
+    ASSERT(visual->compute_count == 2);
+
+    DvzCommands* cmds = ev.cmds;
+    uint32_t idx = ev.cmd_idx;
+
+    // The vertex shader and the indirect draw of the previous frame may still read the bins.
+    _compute_barrier(
+        visual, cmds, idx, histogram->bins,                                        //
+        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, //
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT,           //
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+    dvz_cmd_compute_indirect(cmds, idx, visual->computes[0], histogram->dispatch);
+
+    _compute_barrier(
+        visual, cmds, idx, histogram->bins,                                      //
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,        //
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    DvzBufferRegions br = histogram->dispatch;
+    br.offsets[0] += sizeof(VkDispatchIndirectCommand);
+    br.size -= sizeof(VkDispatchIndirectCommand);
+    dvz_cmd_compute_indirect(cmds, idx, visual->computes[1], br);
+
+    _compute_barrier(
+        visual, cmds, idx, histogram->bins,                                        //
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,          //
+        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, //
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+}
+
+// Draw the bars, the draw command at the beginning of the bins buffer is written by the GPU.
+static void _visual_histogram_fill(DvzVisual* visual, DvzVisualFillEvent ev)
+{
+    ASSERT(visual != NULL);
+    if (!visual->histogram.ready)
+    {
+        log_debug("skip the histogram visual as the bins have not been allocated yet");
+        return;
+    }
+
+    DvzCommands* cmds = ev.cmds;
+    uint32_t idx = ev.cmd_idx;
+
+    DvzBindings* bindings = dvz_container_get(&visual->bindings, 0);
+    ASSERT(dvz_obj_is_created(&bindings->obj));
+    DvzGraphics* graphics = visual->graphics[0];
+    ASSERT(graphics != NULL);
+
+    if (graphics == ev.bound_graphics)
+        dvz_cmd_bind_descriptors(cmds, idx, graphics, bindings, 0);
+    else
+        dvz_cmd_bind_graphics(cmds, idx, graphics, bindings, 0);
+    dvz_cmd_draw_indirect(cmds, idx, visual->histogram.bins, 1);
+}
+
+static void _visual_histogram(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    DvzCanvas* canvas = visual->canvas;
+    ASSERT(canvas != NULL);
+    DvzProp* prop = NULL;
+
+    visual->histogram.enabled = true;
+
+    // The samples are not positions, the bars are drawn in normalized coordinates.
+    visual->flags |= DVZ_VISUAL_FLAGS_TRANSFORM_NONE;
+
+    // Graphics and computes.
+    dvz_visual_graphics(
+        visual, dvz_graphics_builtin(canvas, DVZ_GRAPHICS_HISTOGRAM, visual->flags));
+    // Slots: params, samples, bins.
+    VkDescriptorType slots[] = {
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER};
+    _builtin_compute(visual, "compute_histogram_clear_comp", 3, slots);
+    _builtin_compute(visual, "compute_histogram_comp", 3, slots);
+
+    // Sources
+    // NOTE: the vertex buffer is not bound to the graphics pipeline, it is only read by the
+    // binning compute pipeline.
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_VERTEX, 0, DVZ_PIPELINE_GRAPHICS, 0, 0, sizeof(float), 0);
+    _common_sources(visual);
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_PARAM, 0, DVZ_PIPELINE_GRAPHICS, 0, DVZ_USER_BINDING,
+        sizeof(DvzGraphicsHistogramParams), 0);
+    // NOTE: the bins buffer is allocated by the scene.
+    dvz_visual_source(
+        visual, DVZ_SOURCE_TYPE_OTHER, 0, DVZ_PIPELINE_GRAPHICS, 0, DVZ_USER_BINDING + 1,
+        sizeof(uint32_t), 0);
+
+    // Props:
+
+    // Samples.
+    prop = dvz_visual_prop(visual, DVZ_PROP_POS, 0, DVZ_DTYPE_DOUBLE, DVZ_SOURCE_TYPE_VERTEX, 0);
+    dvz_visual_prop_cast(prop, 0, 0, DVZ_DTYPE_FLOAT, DVZ_ARRAY_COPY_SINGLE, 1);
+
+    // Common props.
+    _common_props(visual);
+
+    // Range of the bins.
+    prop = dvz_visual_prop(visual, DVZ_PROP_RANGE, 0, DVZ_DTYPE_VEC2, DVZ_SOURCE_TYPE_PARAM, 0);
+    dvz_visual_prop_copy(
+        prop, 0, offsetof(DvzGraphicsHistogramParams, range), DVZ_ARRAY_COPY_SINGLE, 1);
+    dvz_visual_prop_default(prop, (vec2){0, 1});
+
+    // Number of bins.
+    prop = dvz_visual_prop(visual, DVZ_PROP_LENGTH, 0, DVZ_DTYPE_UINT, DVZ_SOURCE_TYPE_PARAM, 0);
+    dvz_visual_prop_copy(
+        prop, 1, offsetof(DvzGraphicsHistogramParams, bin_count), DVZ_ARRAY_COPY_SINGLE, 1);
+    dvz_visual_prop_default(prop, (uint32_t[]){100});
+
+    // Color of the bars.
+    prop = dvz_visual_prop(visual, DVZ_PROP_COLOR, 0, DVZ_DTYPE_CVEC4, DVZ_SOURCE_TYPE_PARAM, 0);
+    dvz_visual_prop_copy(
+        prop, 2, offsetof(DvzGraphicsHistogramParams, color), DVZ_ARRAY_COPY_SINGLE, 1);
+    dvz_visual_prop_default(prop, (cvec4){128, 128, 128, 255});
+
+    dvz_visual_fill_callback(visual, _visual_histogram_fill);
+    dvz_visual_compute_callback(visual, _visual_histogram_compute);
 }
 
 
@@ -1993,8 +3423,8 @@ static void _visual_volume_bake(DvzVisual* visual, DvzVisualDataEvent ev)
     DvzGraphicsVolumeItem item = {0};
     for (uint32_t i = 0; i < img_count; i++)
     {
-        _vec3_cast((const dvec3*)dvz_prop_item(pos0, i), &item.pos0);
-        _vec3_cast((const dvec3*)dvz_prop_item(pos1, i), &item.pos1);
+        _pos_vec3(pos0->dtype, dvz_prop_item(pos0, i), item.pos0);
+        _pos_vec3(pos1->dtype, dvz_prop_item(pos1, i), item.pos1);
 
         dvz_graphics_append(&data, &item);
     }
@@ -2152,10 +3582,10 @@ static void _visual_volume_slice_bake(DvzVisual* visual, DvzVisualDataEvent ev)
     DvzGraphicsVolumeSliceItem item = {0};
     for (uint32_t i = 0; i < img_count; i++)
     {
-        _vec3_cast((const dvec3*)dvz_prop_item(pos0, i), &item.pos0);
-        _vec3_cast((const dvec3*)dvz_prop_item(pos1, i), &item.pos1);
-        _vec3_cast((const dvec3*)dvz_prop_item(pos2, i), &item.pos2);
-        _vec3_cast((const dvec3*)dvz_prop_item(pos3, i), &item.pos3);
+        _pos_vec3(pos0->dtype, dvz_prop_item(pos0, i), item.pos0);
+        _pos_vec3(pos1->dtype, dvz_prop_item(pos1, i), item.pos1);
+        _pos_vec3(pos2->dtype, dvz_prop_item(pos2, i), item.pos2);
+        _pos_vec3(pos3->dtype, dvz_prop_item(pos3, i), item.pos3);
 
         // memcpy(&item.pos0, dvz_prop_item(pos0, i), sizeof(vec3));
         // memcpy(&item.pos1, dvz_prop_item(pos1, i), sizeof(vec3));
@@ -2281,6 +3711,28 @@ static void _visual_volume_slice(DvzVisual* visual)
 void dvz_visual_builtin(DvzVisual* visual, DvzVisualType type, int flags)
 {
     ASSERT(visual != NULL);
+
+    // The split vertex colors are only supported by the point and marker visuals.
+    if ((flags & DVZ_GRAPHICS_FLAGS_SPLIT_COLOR) != 0 && type != DVZ_VISUAL_POINT &&
+        type != DVZ_VISUAL_MARKER)
+    {
+        log_warn("split vertex colors are not supported by the visual type %d", type);
+        flags &= ~DVZ_GRAPHICS_FLAGS_SPLIT_COLOR;
+    }
+
+    // The scalar colors need a colormapped variant of the vertex shader.
+    bool scalar_ok = type == DVZ_VISUAL_POINT || type == DVZ_VISUAL_MARKER ||
+                     type == DVZ_VISUAL_LINE || type == DVZ_VISUAL_POLYGON ||
+                     (type == DVZ_VISUAL_PATH && (flags & DVZ_PATH_FLAGS_VERTEX_PULLING) == 0) ||
+                     (type == DVZ_VISUAL_MESH && (flags & DVZ_MESH_FLAGS_QUANTIZED) == 0);
+    if ((flags & DVZ_GRAPHICS_FLAGS_SCALAR_COLOR) != 0 && !scalar_ok)
+    {
+        log_warn("scalar colors are not supported by the visual type %d", type);
+        flags &= ~DVZ_GRAPHICS_FLAGS_SCALAR_COLOR;
+    }
+    if ((flags & DVZ_GRAPHICS_FLAGS_SCALAR_COLOR) != 0)
+        flags &= ~DVZ_GRAPHICS_FLAGS_SPLIT_COLOR;
+
     visual->flags = flags;
     switch (type)
     {
@@ -2319,14 +3771,26 @@ void dvz_visual_builtin(DvzVisual* visual, DvzVisualType type, int flags)
         _visual_marker(visual);
         break;
 
+    case DVZ_VISUAL_SEGMENT:
+        _visual_segment(visual);
+        break;
+
     case DVZ_VISUAL_POLYGON:
         _visual_polygon(visual);
         break;
 
+    case DVZ_VISUAL_PSLG:
+        _visual_pslg(visual);
+        break;
+
     case DVZ_VISUAL_PATH:
         _visual_path(visual);
         break;
 
+    case DVZ_VISUAL_STREAM:
+        _visual_stream(visual);
+        break;
+
     case DVZ_VISUAL_IMAGE:
         _visual_image(visual);
         break;
@@ -2357,6 +3821,18 @@ void dvz_visual_builtin(DvzVisual* visual, DvzVisualType type, int flags)
         _visual_volume_slice(visual);
         break;
 
+    case DVZ_VISUAL_POINT_CLOUD:
+        _visual_point_cloud(visual);
+        break;
+
+    case DVZ_VISUAL_DENSITY:
+        _visual_density(visual);
+        break;
+
+    case DVZ_VISUAL_HISTOGRAM:
+        _visual_histogram(visual);
+        break;
+
 
     case DVZ_VISUAL_CUSTOM:
     case DVZ_VISUAL_NONE:
@@ -1,6 +1,7 @@
 #include "../include/datoviz/visuals.h"
 #include "../include/datoviz/canvas.h"
 #include "../include/datoviz/graphics.h"
+#include "../include/datoviz/octree.h"
 #include "visuals_utils.h"
 
 
@@ -71,6 +72,12 @@ void dvz_visual_destroy(DvzVisual* visual)
     CONTAINER_DESTROY_ITEMS(DvzBindings, visual->bindings_comp, dvz_bindings_destroy)
     dvz_container_destroy(&visual->bindings_comp);
 
+    _lod_destroy(&visual->lod);
+    _chunks_destroy(&visual->chunks);
+    _text_cache_destroy(&visual->text_cache);
+    _axes_labels_destroy(&visual->axes_labels);
+    dvz_pslg_destroy(&visual->pslg);
+
     dvz_obj_destroyed(&visual->obj);
 }
 
@@ -263,9 +270,10 @@ void dvz_visual_compute(DvzVisual* visual, DvzCompute* compute)
     }
     visual->computes[visual->compute_count] = compute;
 
-    DvzBindings* bindings = dvz_container_alloc(&visual->bindings);
-    ASSERT(visual->bindings.count == visual->compute_count + 1);
+    DvzBindings* bindings = dvz_container_alloc(&visual->bindings_comp);
+    ASSERT(visual->bindings_comp.count == visual->compute_count + 1);
     *bindings = dvz_bindings(&compute->slots, visual->canvas->swapchain.img_count);
+    dvz_compute_bindings(compute, bindings);
     visual->compute_count++;
 }
 
@@ -289,6 +297,72 @@ void dvz_visual_group(DvzVisual* visual, uint32_t group_idx, uint32_t size)
 
 
 
+void dvz_visual_dtype(
+    DvzVisual* visual, DvzPropType prop_type, uint32_t prop_idx, DvzDataType dtype)
+{
+    ASSERT(visual != NULL);
+    DvzProp* prop = dvz_prop_get(visual, prop_type, prop_idx);
+    ASSERT(prop != NULL);
+    if (prop->dtype == dtype)
+        return;
+
+    // Only position props can change their dtype at the moment.
+    if (!_is_pos_dtype(prop->dtype) || !_is_pos_dtype(dtype))
+    {
+        log_error("only position props can change their dtype");
+        return;
+    }
+    // The prop must be cast when it is copied to its source, otherwise the source struct layout
+    // would not match the new dtype.
+    if (prop->copy_type != DVZ_ARRAY_COPY_NONE && prop->target_dtype == DVZ_DTYPE_NONE)
+    {
+        log_error(
+            "prop %d #%d is copied to its source without cast, cannot change its dtype",
+            prop_type, prop_idx);
+        return;
+    }
+
+    // Convert the existing data.
+    dvec3 pos = {0};
+    DvzArray arr = dvz_array(prop->arr_orig.item_count, dtype);
+    for (uint32_t i = 0; i < arr.item_count; i++)
+    {
+        _pos_get(prop->dtype, dvz_array_item(&prop->arr_orig, i), pos);
+        _pos_set(dtype, pos, dvz_array_item(&arr, i));
+    }
+    dvz_array_destroy(&prop->arr_orig);
+    prop->arr_orig = arr;
+    _prop_set_dirty(prop, 0, arr.item_count);
+    prop->box_count = 0;
+    visual->box_valid = false;
+    visual->lod.valid = false;
+    _chunks_set_dirty(&visual->chunks, 0, arr.item_count);
+
+    // Convert the default value.
+    if (prop->default_value != NULL)
+    {
+        void* default_value = calloc(1, _get_dtype_size(dtype));
+        _pos_get(prop->dtype, prop->default_value, pos);
+        _pos_set(dtype, pos, default_value);
+        FREE(prop->default_value)
+        prop->default_value = default_value;
+    }
+
+    // The transformed and staging arrays will be recomputed at the next update.
+    dvz_array_destroy(&prop->arr_trans);
+    dvz_array_destroy(&prop->arr_staging);
+    memset(&prop->arr_trans, 0, sizeof(DvzArray));
+    memset(&prop->arr_staging, 0, sizeof(DvzArray));
+
+    prop->dtype = dtype;
+    prop->item_size = _get_dtype_size(dtype);
+    prop->obj.request = DVZ_VISUAL_REQUEST_UPLOAD;
+    if (prop->source != NULL)
+        _source_set_changed(prop->source, true);
+}
+
+
+
 static void _visual_data(
     DvzVisual* visual, DvzPropType prop_type, uint32_t prop_idx, //
     uint32_t first_item, uint32_t item_count, uint32_t data_item_count, const void* data,
@@ -322,6 +396,7 @@ static void _visual_data(
     }
 
     // Make sure the array has the right size.
+    uint32_t old_count = prop->arr_orig.item_count;
     if (!do_resize)
         count = MAX(count, prop->arr_orig.item_count);
     dvz_array_resize(&prop->arr_orig, count);
@@ -329,6 +404,23 @@ static void _visual_data(
     // Copy the specified array to the prop array.
     dvz_array_data(&prop->arr_orig, first_item, item_count, data_item_count, data);
 
+    // Mark the modified items, the whole prop if its size has changed.
+    if (do_resize || count != old_count)
+        _prop_set_dirty(prop, 0, count);
+    else
+        _prop_set_dirty(prop, first_item, item_count);
+
+    // Bounding box caches: appended items will be merged in the cached prop box, but overwritten
+    // items require a full recomputation.
+    if (prop_type == DVZ_PROP_POS)
+    {
+        if (first_item < old_count)
+            prop->box_count = 0;
+        visual->box_valid = false;
+        visual->lod.valid = false;
+        _chunks_set_dirty(&visual->chunks, first_item, item_count);
+    }
+
     prop->obj.request = DVZ_VISUAL_REQUEST_UPLOAD;
 
     if (source != NULL)
@@ -434,6 +526,120 @@ void dvz_visual_data_source(
 
 
 
+void dvz_visual_ring(
+    DvzVisual* visual, DvzSourceType source_type, uint32_t source_idx, uint32_t capacity)
+{
+    ASSERT(visual != NULL);
+    ASSERT(capacity > 0);
+
+    DvzSource* source = _assert_source_exists(visual, source_type, source_idx);
+    ASSERT(source != NULL);
+    ASSERT(_source_is_buffer(source->source_kind));
+
+    // The source array has a fixed size, equal to the capacity of the ring buffer.
+    dvz_array_resize(&source->arr, capacity);
+    ASSERT(source->arr.data != NULL);
+    memset(source->arr.data, 0, capacity * source->arr.item_size);
+
+    source->flags |= DVZ_SOURCE_FLAG_RING;
+    source->ring_head = 0;
+    source->ring_count = 0;
+    source->dirty_first = 0;
+    source->dirty_count = 0;
+
+    source->origin = DVZ_SOURCE_ORIGIN_NOBAKE;
+    _source_set_changed(source, true);
+}
+
+
+
+void dvz_visual_data_ring(
+    DvzVisual* visual, DvzSourceType source_type, uint32_t source_idx, //
+    uint32_t item_count, const void* data)
+{
+    ASSERT(visual != NULL);
+    if (item_count == 0 || data == NULL)
+        return;
+
+    DvzSource* source = _assert_source_exists(visual, source_type, source_idx);
+    ASSERT(source != NULL);
+    if ((source->flags & DVZ_SOURCE_FLAG_RING) == 0)
+    {
+        log_error(
+            "source %d #%d is not a ring buffer, call dvz_visual_ring() first", source_type,
+            source_idx);
+        return;
+    }
+
+    DvzArray* arr = &source->arr;
+    uint32_t capacity = arr->item_count;
+    VkDeviceSize item_size = arr->item_size;
+    ASSERT(capacity > 0);
+    ASSERT(source->ring_head < capacity);
+
+    // Only keep the last items if there are more items than the capacity.
+    const char* src = (const char*)data;
+    if (item_count > capacity)
+    {
+        src += (item_count - capacity) * item_size;
+        item_count = capacity;
+    }
+
+    // Write the items at the head, in two parts if they wrap around the end of the array.
+    uint32_t head = source->ring_head;
+    uint32_t n = MIN(item_count, capacity - head);
+    dvz_array_data(arr, head, n, n, src);
+    if (n < item_count)
+        dvz_array_data(arr, 0, item_count - n, item_count - n, src + n * item_size);
+
+    source->ring_head = (head + item_count) % capacity;
+    source->ring_count = MIN(capacity, source->ring_count + item_count);
+
+    // Extend the range of items to upload. The appended items always follow the pending ones,
+    // the range may wrap around the end of the array. A pending full upload is kept as is.
+    if (!_source_has_changed(source))
+    {
+        source->dirty_first = head;
+        source->dirty_count = item_count;
+    }
+    else if (source->dirty_count > 0)
+    {
+        ASSERT((source->dirty_first + source->dirty_count) % capacity == head);
+        source->dirty_count = MIN(capacity, source->dirty_count + item_count);
+    }
+    _source_set_changed(source, true);
+}
+
+
+
+void dvz_visual_octree(DvzVisual* visual, DvzOctree* octree, uint64_t point_budget)
+{
+    ASSERT(visual != NULL);
+    ASSERT(octree != NULL);
+    ASSERT(dvz_obj_is_created(&octree->obj));
+    DvzContext* ctx = visual->canvas->gpu->context;
+    ASSERT(ctx != NULL);
+
+    DvzSource* source = _assert_source_exists(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    ASSERT(source != NULL);
+    ASSERT(source->arr.item_size == sizeof(DvzVertex));
+
+    uint32_t slot_count = dvz_octree_budget(octree, point_budget);
+    VkDeviceSize slot_size = octree->header.node_capacity * sizeof(DvzVertex);
+
+    // The vertex buffer is directly updated by the scene when octree nodes are loaded.
+    dvz_visual_buffer(
+        visual, DVZ_SOURCE_TYPE_VERTEX, 0,
+        dvz_ctx_buffers(ctx, DVZ_BUFFER_TYPE_VERTEX, 1, slot_count * slot_size));
+
+    // One indirect draw command per slot.
+    visual->indirect = dvz_ctx_buffers(
+        ctx, DVZ_BUFFER_TYPE_STORAGE, 1, slot_count * sizeof(VkDrawIndirectCommand));
+    visual->octree = octree;
+}
+
+
+
 // Means that no data updates will be done by datoviz, it is up to the user to update the bound
 // buffer
 void dvz_visual_buffer(
@@ -523,6 +729,14 @@ void dvz_visual_fill_callback(DvzVisual* visual, DvzVisualFillCallback callback)
 
 
 
+void dvz_visual_compute_callback(DvzVisual* visual, DvzVisualFillCallback callback)
+{
+    ASSERT(visual != NULL);
+    visual->callback_compute = callback;
+}
+
+
+
 void dvz_visual_fill_event(
     DvzVisual* visual, VkClearColorValue clear_color, DvzCommands* cmds, uint32_t cmd_idx,
     DvzViewport viewport, void* user_data)
@@ -831,8 +1045,26 @@ void dvz_visual_update(
                 for (uint32_t i = 0; i < canvas->swapchain.img_count; i++)
                     dvz_buffer_upload(br->buffer, br->offsets[i], size, arr->data);
             }
+            else if (source->dirty_count > 0)
+            {
+                // Only upload the items modified by the last bake. With ring buffers, the range
+                // may wrap around the end of the array and is then uploaded in two parts.
+                ASSERT(source->dirty_first < arr->item_count);
+                ASSERT(source->dirty_count <= arr->item_count);
+                uint32_t first = source->dirty_first;
+                uint32_t n = MIN(source->dirty_count, arr->item_count - first);
+                log_trace("partial upload of %d items from #%d", source->dirty_count, first);
+                dvz_upload_buffer(
+                    ctx, *br, first * arr->item_size, n * arr->item_size,
+                    dvz_array_item(arr, first));
+                if (n < source->dirty_count)
+                    dvz_upload_buffer(
+                        ctx, *br, 0, (source->dirty_count - n) * arr->item_size, arr->data);
+            }
             else
                 dvz_upload_buffer(ctx, *br, 0, size, arr->data);
+            source->dirty_first = 0;
+            source->dirty_count = 0;
             _source_set(source);
             // source->obj.status = DVZ_OBJECT_STATUS_CREATED;
             // visual->obj.status = DVZ_OBJECT_STATUS_CREATED;
@@ -883,4 +1115,8 @@ void dvz_visual_update(
         if (bindings->obj.status == DVZ_OBJECT_STATUS_NEED_UPDATE)
             dvz_bindings_update(bindings);
     }
+
+    // Update the indirect draw commands used by the default fill callback.
+    if (visual->callback_fill == _default_visual_fill)
+        _update_indirect(visual);
 }
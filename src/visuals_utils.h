@@ -1,6 +1,7 @@
 #ifndef DVZ_VISUALS_UTILS_HEADER
 #define DVZ_VISUALS_UTILS_HEADER
 
+#include "../include/datoviz/glyphs.h"
 #include "../include/datoviz/visuals.h"
 
 
@@ -70,6 +71,9 @@ static DvzSourceKind _get_source_kind(DvzSourceType type)
     case DVZ_SOURCE_TYPE_VOLUME:
         return DVZ_SOURCE_KIND_TEXTURE_3D;
 
+    case DVZ_SOURCE_TYPE_OTHER:
+        return DVZ_SOURCE_KIND_STORAGE;
+
     default:
         log_error("source type %d not yet supported", type);
         return DVZ_SOURCE_KIND_NONE;
@@ -243,6 +247,25 @@ static DvzBindings* _get_bindings(DvzVisual* visual, DvzSource* source)
 
 
 
+// Extend the range of modified items of a prop.
+static void _prop_set_dirty(DvzProp* prop, uint32_t first, uint32_t count)
+{
+    ASSERT(prop != NULL);
+    if (count == 0)
+        return;
+    if (prop->dirty_count == 0)
+    {
+        prop->dirty_first = first;
+        prop->dirty_count = count;
+        return;
+    }
+    uint32_t last = MAX(prop->dirty_first + prop->dirty_count, first + count);
+    prop->dirty_first = MIN(prop->dirty_first, first);
+    prop->dirty_count = last - prop->dirty_first;
+}
+
+
+
 // Return the prop array, transformed if it exists, otherwise original.
 static DvzArray* _prop_array(DvzProp* prop, DvzPropArray choice)
 {
@@ -276,6 +299,27 @@ static DvzArray* _prop_array(DvzProp* prop, DvzPropArray choice)
 
 
 
+// Get the first source of a given type for the given pipeline, or none. VERTEX sources bound to
+// another vertex binding than 0 are skipped.
+static DvzSource*
+_get_pipeline_source(DvzVisual* visual, DvzSourceType source_type, uint32_t pipeline_idx)
+{
+    ASSERT(visual != NULL);
+    DvzSource* source = NULL;
+    DvzContainerIterator iter = dvz_container_iterator(&visual->sources);
+    while (iter.item != NULL)
+    {
+        source = iter.item;
+        if (source->source_type == source_type && source->pipeline_idx == pipeline_idx &&
+            (source_type != DVZ_SOURCE_TYPE_VERTEX || source->slot_idx == 0))
+            return source;
+        dvz_container_iter(&iter);
+    }
+    return NULL;
+}
+
+
+
 static uint32_t _source_size(DvzVisual* visual, DvzSource* source)
 {
     ASSERT(visual != NULL);
@@ -284,6 +328,17 @@ static uint32_t _source_size(DvzVisual* visual, DvzSource* source)
     DvzArray* arr = NULL;
     uint32_t item_count = 0;
 
+    // A VERTEX source bound to another vertex binding than 0 has one item per item of the main
+    // VERTEX source, whatever the size of its own props.
+    if (source->source_type == DVZ_SOURCE_TYPE_VERTEX && source->slot_idx > 0)
+    {
+        DvzSource* main_source =
+            _get_pipeline_source(visual, DVZ_SOURCE_TYPE_VERTEX, source->pipeline_idx);
+        if (main_source != NULL)
+            return main_source->arr.item_count > 0 ? main_source->arr.item_count
+                                                   : _source_size(visual, main_source);
+    }
+
     DvzContainerIterator iter = dvz_container_iterator(&visual->props);
     DvzProp* prop = NULL;
     while (iter.item != NULL)
@@ -325,6 +380,62 @@ static void _set_source_bindings(DvzVisual* visual, DvzSource* source)
             dvz_bindings_buffer(other, source->slot_idx, source->u.br);
         }
     }
+
+    // Vertex pulling: the main vertex buffer is also bound as a storage buffer.
+    else if (source->source_kind == DVZ_SOURCE_KIND_VERTEX && source->slot_idx == 0)
+    {
+        ASSERT(source->pipeline_idx < visual->graphics_count);
+        DvzGraphics* graphics = visual->graphics[source->pipeline_idx];
+        ASSERT(graphics != NULL);
+        if (graphics->vertices_per_item > 0)
+        {
+            DvzBindings* bindings = _get_bindings(visual, source);
+            ASSERT(bindings != NULL);
+            dvz_bindings_buffer(bindings, graphics->pull_slot, source->u.br);
+        }
+    }
+}
+
+
+
+// Number of valid items in a source. Ring buffers have a fixed-size array which is only
+// partially filled until the ring buffer is full.
+static inline uint32_t _source_item_count(DvzSource* source)
+{
+    ASSERT(source != NULL);
+    if ((source->flags & DVZ_SOURCE_FLAG_RING) != 0)
+        return source->ring_count;
+    return source->arr.item_count;
+}
+
+
+
+// Number of vertices and instances to draw for a VERTEX source. With vertex pulling, each item
+// stored in the vertex buffer is expanded into several vertices in the vertex shader. With
+// instancing, each item is an instance with a fixed number of vertices.
+static void _draw_counts(
+    DvzVisual* visual, DvzSource* source, uint32_t* vertex_count, uint32_t* instance_count)
+{
+    ASSERT(visual != NULL);
+    ASSERT(source != NULL);
+    ASSERT(source->source_kind == DVZ_SOURCE_KIND_VERTEX);
+    ASSERT(source->pipeline_idx < visual->graphics_count);
+    ASSERT(vertex_count != NULL);
+    ASSERT(instance_count != NULL);
+
+    DvzGraphics* graphics = visual->graphics[source->pipeline_idx];
+    ASSERT(graphics != NULL);
+    uint32_t item_count = _source_item_count(source);
+    if (graphics->vertices_per_instance > 0)
+    {
+        *vertex_count = item_count > 0 ? graphics->vertices_per_instance : 0;
+        *instance_count = item_count;
+    }
+    else
+    {
+        *vertex_count = item_count * MAX(1, graphics->vertices_per_item);
+        *instance_count = 1;
+    }
 }
 
 
@@ -354,7 +465,12 @@ static void _create_source_buffer(DvzCanvas* canvas, DvzSource* source, VkDevice
         break;
     }
     uint32_t buf_count = source->source_type == mappable ? canvas->swapchain.img_count : 1;
-    source->u.br = dvz_ctx_buffers(ctx, type, buf_count, size);
+    // The vertex buffer regions start at a multiple of the vertex size, so that draw batches can
+    // address the vertices of all visuals with a single bound vertex buffer.
+    if (type == DVZ_BUFFER_TYPE_VERTEX)
+        source->u.br = dvz_ctx_buffers_strided(ctx, type, buf_count, size, source->arr.item_size);
+    else
+        source->u.br = dvz_ctx_buffers(ctx, type, buf_count, size);
 }
 
 
@@ -382,6 +498,11 @@ static void _source_buffer(DvzVisual* visual, DvzSource* source)
         _create_source_buffer(canvas, source, size);
         // Set the pipeline bindings with the source buffer.
         _set_source_bindings(visual, source);
+        // The vertex and index buffers are bound in the command buffers, which need to be
+        // refilled when the buffers are reallocated.
+        if (source->source_kind == DVZ_SOURCE_KIND_VERTEX ||
+            source->source_kind == DVZ_SOURCE_KIND_INDEX)
+            dvz_canvas_to_refill(canvas);
     }
     ASSERT(source->u.br.buffer != VK_NULL_HANDLE);
 }
@@ -484,8 +605,60 @@ static void _prop_copy(DvzVisual* visual, DvzProp* prop)
     dvz_array_column(
         &source->arr, prop->offset, col_size, 0, source->arr.item_count, //
         arr->item_count, arr->data,                                      //
-        prop->arr_orig.dtype, prop->target_dtype,                        // optional cast
+        arr->dtype, prop->target_dtype,                                  // optional cast
         prop->copy_type, prop->reps);
+    prop->dirty_count = 0;
+}
+
+
+
+// Whether the modified items of a prop can be copied to its source without copying the whole
+// prop: one prop item per source item, and no array recomputed by the baking function.
+static bool _prop_is_copy_partial(DvzProp* prop, uint32_t count)
+{
+    ASSERT(prop != NULL);
+    if (prop->copy_type == DVZ_ARRAY_COPY_NONE || prop->dirty_count == 0)
+        return true;
+    DvzArray* arr = _prop_array(prop, DVZ_PROP_ARRAY_DEFAULT);
+    return arr->data != NULL && arr->item_count == count && prop->reps <= 1 &&
+           prop->dpi_scaling == 1 && prop->arr_staging.item_count == 0 &&
+           prop->dirty_first + prop->dirty_count <= count;
+}
+
+
+
+// Copy the modified items of a prop to its source, and extend the modified range of the source.
+static void _prop_copy_partial(DvzVisual* visual, DvzProp* prop)
+{
+    ASSERT(prop != NULL);
+    if (prop->copy_type == DVZ_ARRAY_COPY_NONE || prop->dirty_count == 0)
+        return;
+
+    DvzSource* source = prop->source;
+    ASSERT(source != NULL);
+    DvzArray* arr = _prop_array(prop, DVZ_PROP_ARRAY_DEFAULT);
+    ASSERT(arr->data != NULL);
+
+    uint32_t first = prop->dirty_first;
+    uint32_t count = prop->dirty_count;
+    log_debug(
+        "copy %d items from #%d of prop type %d to source buffer", count, first, prop->prop_type);
+    dvz_array_column(
+        &source->arr, prop->offset, prop->item_size, first, count, //
+        count, dvz_array_item(arr, first),                         //
+        arr->dtype, prop->target_dtype,                            // optional cast
+        prop->copy_type, 1);
+    prop->dirty_count = 0;
+
+    // Union of the modified ranges of all props of the source.
+    uint32_t last = first + count;
+    if (source->dirty_count > 0)
+    {
+        last = MAX(last, source->dirty_first + source->dirty_count);
+        first = MIN(first, source->dirty_first);
+    }
+    source->dirty_first = first;
+    source->dirty_count = last - first;
 }
 
 
@@ -520,30 +693,56 @@ static void _source_fill(DvzVisual* visual, DvzSource* source)
             _prop_copy(visual, prop);
         dvz_container_iter(&iter);
     }
+
+    // The whole source will be uploaded.
+    source->dirty_first = 0;
+    source->dirty_count = 0;
 }
 
 
 
-// Get the first source of a given type for the given pipeline, or none.
-static DvzSource*
-_get_pipeline_source(DvzVisual* visual, DvzSourceType source_type, uint32_t pipeline_idx)
+// Copy only the modified items of the props to an existing source array, if possible. Return
+// whether the source could be updated that way, otherwise the source must be filled entirely.
+static bool _source_fill_partial(DvzVisual* visual, DvzSource* source, uint32_t count)
 {
     ASSERT(visual != NULL);
-    DvzSource* source = NULL;
-    DvzContainerIterator iter = dvz_container_iterator(&visual->sources);
+    ASSERT(source != NULL);
+
+    // The number of items must not have changed since the last bake.
+    if (source->arr.data == NULL || source->arr.item_count != count)
+        return false;
+
+    // Check that all associated props support partial copies.
+    DvzProp* prop = NULL;
+    DvzContainerIterator iter = dvz_container_iterator(&visual->props);
     while (iter.item != NULL)
     {
-        source = iter.item;
-        if (source->source_type == source_type && source->pipeline_idx == pipeline_idx)
-            return source;
+        prop = iter.item;
+        if (prop->source == source && !_prop_is_copy_partial(prop, count))
+            return false;
         dvz_container_iter(&iter);
     }
-    return NULL;
+
+    source->dirty_first = 0;
+    source->dirty_count = 0;
+    iter = dvz_container_iterator(&visual->props);
+    while (iter.item != NULL)
+    {
+        prop = iter.item;
+        if (prop->source == source)
+            _prop_copy_partial(visual, prop);
+        dvz_container_iter(&iter);
+    }
+
+    // NOTE: if no prop was modified, we upload the whole source.
+    return true;
 }
 
 
 
-static void _bake_source(DvzVisual* visual, DvzSource* source)
+// Bake a source from its props. If partial is true, only the modified items are copied when
+// possible.
+static void _bake_source(DvzVisual* visual, DvzSource* source, bool partial)
 {
     ASSERT(visual != NULL);
     if (source == NULL)
@@ -552,6 +751,13 @@ static void _bake_source(DvzVisual* visual, DvzSource* source)
     // The baking function doesn't run if the VERTEX source is handled by the user.
     if (source->origin != DVZ_SOURCE_ORIGIN_LIB)
         return;
+
+    // A VERTEX source bound to another vertex binding must follow the size of the main VERTEX
+    // source even if its own props have not changed.
+    if (source->source_type == DVZ_SOURCE_TYPE_VERTEX && source->slot_idx > 0 &&
+        source->arr.item_count != _source_size(visual, source))
+        _source_set_changed(source, true);
+
     if (source->obj.request != DVZ_VISUAL_REQUEST_UPLOAD)
     {
         log_trace(
@@ -567,6 +773,15 @@ static void _bake_source(DvzVisual* visual, DvzSource* source)
         return;
     }
 
+    // Only copy the modified items if the number of items has not changed.
+    if (partial && _source_fill_partial(visual, source, count))
+    {
+        log_debug(
+            "partial baking of source %d, %d items from #%d", source->source_kind,
+            source->dirty_count, source->dirty_first);
+        return;
+    }
+
     log_debug("baking source %d", source->source_kind);
 
     // Allocate the source array.
@@ -610,6 +825,563 @@ static void _bake_uniforms(DvzVisual* visual)
 
 
 
+// Update the indirect draw commands of the graphics pipelines of a visual.
+static void _update_indirect(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    DvzContext* ctx = visual->canvas->gpu->context;
+    ASSERT(ctx != NULL);
+
+    VkDrawIndexedIndirectCommand cmds[DVZ_MAX_GRAPHICS_PER_VISUAL] = {0};
+    VkDrawIndirectCommand* cmd = NULL;
+    DvzSource* source = NULL;
+    for (uint32_t pidx = 0; pidx < visual->graphics_count; pidx++)
+    {
+        source = _get_pipeline_source(visual, DVZ_SOURCE_TYPE_INDEX, pidx);
+        if (source != NULL && source->arr.item_count > 0)
+        {
+            cmds[pidx].indexCount = source->arr.item_count;
+            cmds[pidx].instanceCount = 1;
+            continue;
+        }
+
+        // NOTE: non-indexed draw commands are stored with the same stride as the indexed ones,
+        // the VkDrawIndirectCommand struct is smaller than VkDrawIndexedIndirectCommand.
+        source = _get_pipeline_source(visual, DVZ_SOURCE_TYPE_VERTEX, pidx);
+        cmd = (VkDrawIndirectCommand*)&cmds[pidx];
+        if (source != NULL)
+            _draw_counts(visual, source, &cmd->vertexCount, &cmd->instanceCount);
+    }
+
+    VkDeviceSize size = visual->graphics_count * sizeof(VkDrawIndexedIndirectCommand);
+    if (visual->indirect.buffer == NULL)
+    {
+        visual->indirect = dvz_ctx_buffers(
+            ctx, DVZ_BUFFER_TYPE_STORAGE, 1,
+            DVZ_MAX_GRAPHICS_PER_VISUAL * sizeof(VkDrawIndexedIndirectCommand));
+    }
+    // Only upload the draw commands if they have changed.
+    else if (memcmp(visual->indirect_cmds, cmds, size) == 0)
+        return;
+
+    // NOTE: the upload is deferred while the app is running, so the uploaded data must outlive
+    // this function: the persistent copy in the visual is uploaded, not the stack array.
+    memcpy(visual->indirect_cmds, cmds, size);
+    dvz_upload_buffer(ctx, visual->indirect, 0, size, visual->indirect_cmds);
+}
+
+
+
+// Return the buffer regions with the indirect draw command of a given graphics pipeline.
+static DvzBufferRegions _indirect_region(DvzVisual* visual, uint32_t pipeline_idx)
+{
+    ASSERT(visual != NULL);
+    ASSERT(pipeline_idx < visual->graphics_count);
+    DvzBufferRegions br = visual->indirect;
+    VkDeviceSize offset = pipeline_idx * sizeof(VkDrawIndexedIndirectCommand);
+    for (uint32_t i = 0; i < br.count; i++)
+        br.offsets[i] += offset;
+    br.size -= offset;
+    return br;
+}
+
+
+
+/*************************************************************************************************/
+/*  Level of detail                                                                              */
+/*************************************************************************************************/
+
+#define DVZ_LOD_CHUNK_SIZE 16384
+
+typedef struct DvzLodKernel DvzLodKernel;
+
+// Compute one level of the min/max pyramid from the previous level, or from the samples.
+struct DvzLodKernel
+{
+    DvzArray* pos;       // POS prop
+    const uint32_t* src; // sample indices of the previous level, NULL for the samples themselves
+    uint32_t src_count;  // number of sample indices in the previous level
+    uint32_t* dst;       // sample indices of the new level, 2 per bin
+};
+
+// Each bin of a level merges 4 items of the previous level: 2 bins of the previous level with 2
+// samples each, or 4 samples for the first level.
+static void _lod_chunk(uint32_t item_first, uint32_t item_count, void* user_data)
+{
+    DvzLodKernel* k = (DvzLodKernel*)user_data;
+    ASSERT(k != NULL);
+    ASSERT(k->pos != NULL);
+    ASSERT(k->dst != NULL);
+
+    dvec3 pos = {0};
+    uint32_t i = 0, imin = 0, imax = 0, end = 0;
+    double ymin = 0, ymax = 0;
+    for (uint32_t b = item_first; b < item_first + item_count; b++)
+    {
+        end = MIN(4 * b + 4, k->src_count);
+        ASSERT(4 * b < end);
+        imin = imax = k->src != NULL ? k->src[4 * b] : 4 * b;
+        _pos_get(k->pos->dtype, dvz_array_item(k->pos, imin), pos);
+        ymin = ymax = pos[1];
+        for (uint32_t e = 4 * b + 1; e < end; e++)
+        {
+            i = k->src != NULL ? k->src[e] : e;
+            _pos_get(k->pos->dtype, dvz_array_item(k->pos, i), pos);
+            if (pos[1] < ymin)
+            {
+                ymin = pos[1];
+                imin = i;
+            }
+            if (pos[1] > ymax)
+            {
+                ymax = pos[1];
+                imax = i;
+            }
+        }
+
+        // Keep the samples in their original order.
+        k->dst[2 * b + 0] = MIN(imin, imax);
+        k->dst[2 * b + 1] = MAX(imin, imax);
+    }
+}
+
+
+
+static void _lod_destroy(DvzLod* lod)
+{
+    ASSERT(lod != NULL);
+    for (uint32_t l = 2; l < lod->level_count; l++)
+        dvz_array_destroy(&lod->levels[l]);
+    lod->level_count = 0;
+    lod->item_count = 0;
+    lod->valid = false;
+}
+
+
+
+// Build the min/max pyramid of a POS prop, each level is computed in parallel.
+static void _lod_build(DvzLod* lod, DvzArray* pos)
+{
+    ASSERT(lod != NULL);
+    ASSERT(pos != NULL);
+
+    _lod_destroy(lod);
+    uint32_t n = pos->item_count;
+    lod->item_count = n;
+    lod->valid = true;
+
+    // Levels 0 and 1 would have as many vertices as there are samples.
+    DvzLodKernel k = {.pos = pos, .src = NULL, .src_count = n};
+    uint32_t bins = (n + 3) / 4;
+    for (uint32_t l = 2; l < DVZ_MAX_LOD_LEVELS && bins >= 2; l++)
+    {
+        lod->levels[l] = dvz_array(2 * bins, DVZ_DTYPE_UINT);
+        k.dst = (uint32_t*)lod->levels[l].data;
+        dvz_parallel(bins, DVZ_LOD_CHUNK_SIZE, _lod_chunk, &k);
+        lod->level_count = l + 1;
+
+        k.src = k.dst;
+        k.src_count = 2 * bins;
+        bins = (bins + 1) / 2;
+    }
+    log_debug("built %d levels of detail for %d samples", lod->level_count, n);
+}
+
+
+
+// Select the level of detail such that each bin spans at most one pixel, given the number of
+// pixels spanned by all samples.
+static uint32_t _lod_level(DvzLod* lod, double width)
+{
+    ASSERT(lod != NULL);
+    if (!lod->valid || lod->level_count <= 2 || width <= 0)
+        return 0;
+    double ratio = lod->item_count / width; // number of samples per pixel
+    if (ratio < 4)
+        return 0;
+    uint32_t level = (uint32_t)floor(log2(ratio));
+    return MIN(level, lod->level_count - 1);
+}
+
+
+
+// Whether a prop has one item per sample and should be decimated.
+static inline bool _lod_prop(DvzLod* lod, DvzProp* prop)
+{
+    return prop->prop_type != DVZ_PROP_LENGTH && prop->arr_orig.item_count == lod->item_count;
+}
+
+// Replace the props by their decimated version at the current level of detail, in the staging
+// arrays which take precedence when the props are copied to the sources. The staging arrays are
+// removed when the level goes back to 0.
+static void _lod_stage(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    DvzLod* lod = &visual->lod;
+    bool active = lod->valid && lod->level >= 2 && lod->level < lod->level_count;
+    if (!active && !lod->staged)
+        return;
+
+    uint32_t* indices = active ? (uint32_t*)lod->levels[lod->level].data : NULL;
+    uint32_t n = active ? lod->levels[lod->level].item_count : 0;
+
+    DvzProp* prop = NULL;
+    DvzArray* arr = NULL;
+    DvzContainerIterator iter = dvz_container_iterator(&visual->props);
+    while (iter.item != NULL)
+    {
+        prop = iter.item;
+        bool is_length = prop->prop_type == DVZ_PROP_LENGTH && prop->arr_orig.item_count == 1;
+
+        // NOTE: the number of samples may have changed since the props were staged, so all
+        // staging arrays are removed when going back to level 0, except for DPI scaling.
+        if (is_length || _lod_prop(lod, prop) || (!active && prop->dpi_scaling == 1))
+        {
+            dvz_array_destroy(&prop->arr_staging);
+            memset(&prop->arr_staging, 0, sizeof(DvzArray));
+        }
+
+        // A single line strip or path has the decimated number of samples.
+        if (active && is_length)
+        {
+            prop->arr_staging = dvz_array(1, DVZ_DTYPE_UINT);
+            dvz_array_data(&prop->arr_staging, 0, 1, 1, &n);
+        }
+
+        // Gather the selected samples.
+        else if (active && _lod_prop(lod, prop))
+        {
+            arr = prop->arr_trans.item_count == lod->item_count ? &prop->arr_trans
+                                                                 : &prop->arr_orig;
+            prop->arr_staging = arr->dtype != DVZ_DTYPE_CUSTOM
+                                    ? dvz_array(n, arr->dtype)
+                                    : dvz_array_struct(n, arr->item_size);
+            for (uint32_t i = 0; i < n; i++)
+                memcpy(
+                    dvz_array_item(&prop->arr_staging, i), dvz_array_item(arr, indices[i]),
+                    arr->item_size);
+        }
+        dvz_container_iter(&iter);
+    }
+    lod->staged = active;
+}
+
+
+
+/*************************************************************************************************/
+/*  Culling                                                                                      */
+/*************************************************************************************************/
+
+typedef struct DvzChunksKernel DvzChunksKernel;
+
+// Compute the bounding boxes of a range of chunks, over all POS props.
+struct DvzChunksKernel
+{
+    uint32_t pos_count;
+    DvzArray* pos[32]; // max number of props of the same type
+    uint32_t item_count;
+    uint32_t chunk_offset; // index of the first chunk to recompute
+    DvzBox* boxes;
+};
+
+static void _chunks_box(uint32_t chunk_first, uint32_t chunk_count, void* user_data)
+{
+    DvzChunksKernel* k = (DvzChunksKernel*)user_data;
+    ASSERT(k != NULL);
+    ASSERT(k->boxes != NULL);
+
+    dvec3 pos = {0};
+    DvzBox* box = NULL;
+    uint32_t first = 0, end = 0;
+    for (uint32_t c = k->chunk_offset + chunk_first;
+         c < k->chunk_offset + chunk_first + chunk_count; c++)
+    {
+        box = &k->boxes[c];
+        *box = DVZ_BOX_INF;
+        first = c * DVZ_CHUNK_SIZE;
+        end = MIN(first + DVZ_CHUNK_SIZE, k->item_count);
+        for (uint32_t p = 0; p < k->pos_count; p++)
+        {
+            for (uint32_t i = first; i < end; i++)
+            {
+                _pos_get(k->pos[p]->dtype, dvz_array_item(k->pos[p], i), pos);
+                for (uint32_t j = 0; j < 3; j++)
+                {
+                    box->p0[j] = MIN(box->p0[j], pos[j]);
+                    box->p1[j] = MAX(box->p1[j], pos[j]);
+                }
+            }
+        }
+    }
+}
+
+
+
+// Mark a range of POS items as modified, the boxes of the chunks containing them will be
+// recomputed.
+static void _chunks_set_dirty(DvzChunks* chunks, uint32_t first, uint32_t count)
+{
+    ASSERT(chunks != NULL);
+    if (count == 0)
+        return;
+    if (chunks->dirty_count == 0)
+    {
+        chunks->dirty_first = first;
+        chunks->dirty_count = count;
+        return;
+    }
+    uint32_t end = MAX(chunks->dirty_first + chunks->dirty_count, first + count);
+    chunks->dirty_first = MIN(chunks->dirty_first, first);
+    chunks->dirty_count = end - chunks->dirty_first;
+}
+
+
+
+// Update the bounding boxes of the chunks after the POS props have been modified. All boxes are
+// recomputed when the number of items has changed, otherwise only the modified chunks are.
+// Return whether any box has been recomputed.
+static bool _chunks_update_boxes(DvzVisual* visual, uint32_t item_count)
+{
+    ASSERT(visual != NULL);
+    DvzChunks* chunks = &visual->chunks;
+
+    uint32_t chunk_first = 0;
+    uint32_t chunk_count = (item_count + DVZ_CHUNK_SIZE - 1) / DVZ_CHUNK_SIZE;
+    if (item_count != chunks->item_count || chunks->boxes.item_count != chunk_count)
+    {
+        if (chunks->boxes.item_size == 0)
+            chunks->boxes = dvz_array_struct(chunk_count, sizeof(DvzBox));
+        else
+            dvz_array_resize(&chunks->boxes, chunk_count);
+        chunks->item_count = item_count;
+        chunks->chunk_count = chunk_count;
+    }
+    else if (chunks->dirty_count > 0)
+    {
+        chunk_first = MIN(chunks->dirty_first, item_count) / DVZ_CHUNK_SIZE;
+        uint32_t end = MIN(chunks->dirty_first + chunks->dirty_count, item_count);
+        chunk_count = end > 0 ? (end - 1) / DVZ_CHUNK_SIZE + 1 - chunk_first : 0;
+    }
+    else
+        return false;
+    chunks->dirty_first = 0;
+    chunks->dirty_count = 0;
+    if (chunk_count == 0)
+        return true;
+
+    DvzChunksKernel k = {
+        .item_count = item_count,
+        .chunk_offset = chunk_first,
+        .boxes = (DvzBox*)chunks->boxes.data};
+    DvzProp* prop = NULL;
+    for (uint32_t i = 0; i < 32; i++)
+    {
+        prop = dvz_prop_get(visual, DVZ_PROP_POS, i);
+        if (prop == NULL)
+            break;
+        if (prop->arr_orig.item_count == item_count)
+            k.pos[k.pos_count++] = &prop->arr_orig;
+    }
+    dvz_parallel(chunk_count, 16, _chunks_box, &k);
+    log_trace("recomputed the boxes of %d chunks from #%d", chunk_count, chunk_first);
+    return true;
+}
+
+
+
+// Number of vertices drawn per POS item if the visual can be drawn chunk by chunk, 0 otherwise.
+// Only visuals with a single non-indexed, non-instanced graphics pipeline with point, line or
+// triangle lists are supported, where the chunks are contiguous ranges of whole primitives.
+static uint32_t _chunks_vertices_per_item(DvzVisual* visual)
+{
+    ASSERT(visual != NULL);
+    if (visual->graphics_count != 1 || visual->octree != NULL)
+        return 0;
+    DvzGraphics* graphics = visual->graphics[0];
+    ASSERT(graphics != NULL);
+    if (graphics->vertices_per_instance > 0)
+        return 0;
+    if (graphics->topology != VK_PRIMITIVE_TOPOLOGY_POINT_LIST &&
+        graphics->topology != VK_PRIMITIVE_TOPOLOGY_LINE_LIST &&
+        graphics->topology != VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+        return 0;
+
+    DvzSource* source = _get_pipeline_source(visual, DVZ_SOURCE_TYPE_INDEX, 0);
+    if (source != NULL && source->arr.item_count > 0)
+        return 0;
+    source = _get_pipeline_source(visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    if (source == NULL || (source->flags & DVZ_SOURCE_FLAG_RING) != 0)
+        return 0;
+
+    DvzProp* prop = dvz_prop_get(visual, DVZ_PROP_POS, 0);
+    uint32_t n = prop != NULL ? prop->arr_orig.item_count : 0;
+    if (n == 0)
+        return 0;
+    uint32_t vertex_count = 0, instance_count = 0;
+    _draw_counts(visual, source, &vertex_count, &instance_count);
+    if (vertex_count == 0 || vertex_count % n != 0)
+        return 0;
+    return vertex_count / n;
+}
+
+
+
+static void _chunks_destroy(DvzChunks* chunks)
+{
+    ASSERT(chunks != NULL);
+    dvz_array_destroy(&chunks->boxes);
+    dvz_array_destroy(&chunks->draws);
+    memset(chunks, 0, sizeof(DvzChunks));
+}
+
+
+
+/*************************************************************************************************/
+/*  Text                                                                                         */
+/*************************************************************************************************/
+
+// Hash of a string or of glyph indices, combined with the layout parameters of the string.
+static uint64_t _text_key(
+    const void* data, size_t size, bool glyphs, float font_size, vec2 anchor, float angle)
+{
+    ASSERT(data != NULL);
+    uint64_t h = dvz_hash(DVZ_HASH_SEED, &glyphs, sizeof(glyphs));
+    h = dvz_hash(h, data, size);
+    float params[4] = {font_size, anchor[0], anchor[1], angle};
+    return dvz_hash(h, params, sizeof(params));
+}
+
+
+
+// Rebuild the hash map of the text layout cache from its glyph runs. The strings that are not
+// displayed anymore are evicted, and only the first of identical strings is kept.
+static void _text_cache_index(DvzTextCache* cache)
+{
+    ASSERT(cache != NULL);
+    uint32_t run_count = cache->runs.item_count;
+    DvzTextRun* runs = (DvzTextRun*)cache->runs.data;
+
+    // Power of two number of slots, with a load factor of at most 1/2.
+    uint32_t slot_count = 16;
+    while (slot_count < 2 * run_count)
+        slot_count *= 2;
+    dvz_array_destroy(&cache->slots);
+    cache->slots = dvz_array(slot_count, DVZ_DTYPE_UINT);
+    uint32_t* slots = (uint32_t*)cache->slots.data;
+
+    uint32_t s = 0;
+    for (uint32_t i = 0; i < run_count; i++)
+    {
+        // Linear probing.
+        s = (uint32_t)(runs[i].key ^ (runs[i].key >> 32)) & (slot_count - 1);
+        while (slots[s] != 0 && runs[slots[s] - 1].key != runs[i].key)
+            s = (s + 1) & (slot_count - 1);
+        if (slots[s] == 0)
+            slots[s] = i + 1;
+    }
+}
+
+
+
+// Find the glyph run of the last bake with a given layout key, the run of the string with the
+// same index first. Returns the index of the run, or UINT32_MAX if there is none.
+static uint32_t _text_cache_find(DvzTextCache* cache, uint64_t key, uint32_t idx)
+{
+    ASSERT(cache != NULL);
+    DvzTextRun* runs = (DvzTextRun*)cache->runs.data;
+    if (idx < cache->runs.item_count && runs[idx].key == key)
+        return idx;
+
+    uint32_t slot_count = cache->slots.item_count;
+    uint32_t* slots = (uint32_t*)cache->slots.data;
+    if (slot_count == 0)
+        return UINT32_MAX;
+    uint32_t s = (uint32_t)(key ^ (key >> 32)) & (slot_count - 1);
+    for (; slots[s] != 0; s = (s + 1) & (slot_count - 1))
+        if (runs[slots[s] - 1].key == key)
+            return slots[s] - 1;
+    return UINT32_MAX;
+}
+
+
+
+// Set the position, color and string index of the glyph vertices of a string without a new
+// layout.
+static void _text_run_patch(DvzArray* arr_vertex, uint32_t reps, DvzTextRun* run, uint32_t idx)
+{
+    ASSERT(arr_vertex != NULL);
+    ASSERT(run != NULL);
+    DvzGraphicsTextVertex* vertex = NULL;
+    for (uint32_t i = reps * run->first; i < reps * (run->first + run->glyph_count); i++)
+    {
+        vertex = dvz_array_item(arr_vertex, i);
+        glm_vec3_copy(run->pos, vertex->pos);
+        memcpy(vertex->color, run->color, sizeof(cvec4));
+        vertex->glyph[3] = (uint16_t)idx; // str idx
+    }
+}
+
+
+
+static void _text_cache_destroy(DvzTextCache* cache)
+{
+    ASSERT(cache != NULL);
+    dvz_array_destroy(&cache->runs);
+    dvz_array_destroy(&cache->slots);
+    memset(cache, 0, sizeof(DvzTextCache));
+}
+
+
+
+static void _axes_labels_destroy(DvzAxesLabels* labels)
+{
+    ASSERT(labels != NULL);
+    dvz_array_destroy(&labels->keys);
+    memset(labels, 0, sizeof(DvzAxesLabels));
+}
+
+
+
+// Bind a font atlas to the FONT_ATLAS and PARAM sources of a visual with a text pipeline: the
+// fixed font atlas when the glyph indices are set directly, the dynamic glyph atlas otherwise.
+// NOTE: the glyphs of the dynamic atlas must have been requested first, they are uploaded here.
+static void _text_font_atlas(DvzVisual* visual, bool fixed)
+{
+    ASSERT(visual != NULL);
+    ASSERT(visual->canvas != NULL);
+    DvzContext* ctx = visual->canvas->gpu->context;
+    ASSERT(ctx != NULL);
+
+    DvzGraphicsTextParams params = {0};
+    DvzTexture* texture = NULL;
+    if (fixed)
+    {
+        DvzFontAtlas* atlas = &ctx->font_atlas;
+        ASSERT(strlen(atlas->font_str) > 0);
+        texture = atlas->texture;
+        params.grid_size[0] = (int32_t)atlas->rows;
+        params.grid_size[1] = (int32_t)atlas->cols;
+        params.tex_size[0] = (int32_t)atlas->width;
+        params.tex_size[1] = (int32_t)atlas->height;
+    }
+    else
+    {
+        DvzGlyphAtlas* atlas = ctx->glyph_atlas;
+        ASSERT(atlas != NULL);
+        dvz_glyph_atlas_upload(atlas);
+        texture = atlas->texture;
+        params.tex_size[0] = (int32_t)atlas->width;
+        params.tex_size[1] = (int32_t)atlas->height;
+        visual->glyph_generation = atlas->generation;
+    }
+    ASSERT(texture != NULL);
+
+    dvz_visual_texture(visual, DVZ_SOURCE_TYPE_FONT_ATLAS, 0, texture);
+    dvz_visual_data_source(visual, DVZ_SOURCE_TYPE_PARAM, 0, 0, 1, 1, &params);
+}
+
+
+
 /*************************************************************************************************/
 /*  Visual default callbacks                                                                     */
 /*************************************************************************************************/
@@ -618,6 +1390,10 @@ static void _default_visual_bake(DvzVisual* visual, DvzVisualDataEvent ev)
 {
     ASSERT(visual != NULL);
 
+    // NOTE: custom baking functions calling this function may modify the props or the sources
+    // in arbitrary ways, so partial source updates are only done with the default baking.
+    bool partial = visual->callback_bake == _default_visual_bake;
+
     // VERTEX source.
     DvzSource* source = NULL;
     for (uint32_t i = 0; i < visual->sources.count; i++)
@@ -625,7 +1401,7 @@ static void _default_visual_bake(DvzVisual* visual, DvzVisualDataEvent ev)
         source = dvz_source_get(visual, DVZ_SOURCE_TYPE_VERTEX, i);
         if (source == NULL)
             break;
-        _bake_source(visual, source);
+        _bake_source(visual, source, partial);
     }
 
     // INDEX source.
@@ -634,7 +1410,7 @@ static void _default_visual_bake(DvzVisual* visual, DvzVisualDataEvent ev)
         source = dvz_source_get(visual, DVZ_SOURCE_TYPE_INDEX, i);
         if (source == NULL)
             break;
-        _bake_source(visual, source);
+        _bake_source(visual, source, partial);
     }
 }
 
@@ -655,6 +1431,8 @@ static void _default_visual_fill(DvzVisual* visual, DvzVisualFillEvent ev)
 
     // Draw all valid graphics pipelines.
     DvzBindings* bindings = NULL;
+    DvzGraphics* graphics = NULL;
+    DvzGraphics* bound = ev.bound_graphics;
     for (uint32_t pipeline_idx = 0; pipeline_idx < visual->graphics_count; pipeline_idx++)
     {
         ASSERT(dvz_obj_is_created(&visual->graphics[pipeline_idx]->obj));
@@ -667,7 +1445,9 @@ static void _default_visual_fill(DvzVisual* visual, DvzVisualFillEvent ev)
         ASSERT(vertex_source != NULL);
         ASSERT(vertex_source->pipeline_idx == pipeline_idx);
 
-        uint32_t vertex_count = vertex_source->arr.item_count;
+        uint32_t vertex_count = 0;
+        uint32_t instance_count = 0;
+        _draw_counts(visual, vertex_source, &vertex_count, &instance_count);
         if (vertex_count == 0)
         {
             log_warn("skip this graphics pipeline as the vertex buffer is empty");
@@ -678,7 +1458,19 @@ static void _default_visual_fill(DvzVisual* visual, DvzVisualFillEvent ev)
         // Bind the vertex buffer.
         DvzBufferRegions* vertex_buf = &vertex_source->u.br;
         ASSERT(vertex_buf != NULL);
-        dvz_cmd_bind_vertex_buffer(cmds, idx, *vertex_buf, 0);
+        dvz_cmd_bind_vertex_buffer(cmds, idx, 0, *vertex_buf, 0);
+
+        // Bind the other vertex buffers of the pipeline, for example the split vertex colors.
+        DvzContainerIterator iter = dvz_container_iterator(&visual->sources);
+        DvzSource* source = NULL;
+        while (iter.item != NULL)
+        {
+            source = iter.item;
+            if (source->source_type == DVZ_SOURCE_TYPE_VERTEX &&
+                source->pipeline_idx == pipeline_idx && source->slot_idx > 0)
+                dvz_cmd_bind_vertex_buffer(cmds, idx, source->slot_idx, source->u.br, 0);
+            dvz_container_iter(&iter);
+        }
 
         // Index buffer?
         DvzSource* index_source =
@@ -696,15 +1488,41 @@ static void _default_visual_fill(DvzVisual* visual, DvzVisualFillEvent ev)
             }
         }
 
-        // Draw command.
-        dvz_cmd_bind_graphics(cmds, idx, visual->graphics[pipeline_idx], bindings, 0);
+        // Bind the graphics pipeline, unless it is already bound (successive visuals sharing
+        // the same graphics pipeline).
+        graphics = visual->graphics[pipeline_idx];
+        if (graphics == bound)
+            dvz_cmd_bind_descriptors(cmds, idx, graphics, bindings, 0);
+        else
+            dvz_cmd_bind_graphics(cmds, idx, graphics, bindings, 0);
+        bound = graphics;
 
-        if (index_count == 0)
+        // One indirect draw command per chunk, emptied when the chunk is out of view.
+        if (visual->chunks.active)
+        {
+            ASSERT(visual->chunks.capacity > 0);
+            dvz_cmd_draw_indirect(cmds, idx, visual->chunks.indirect, visual->chunks.capacity);
+        }
+
+        // Indirect draw commands, the number of vertices/indices is stored in a GPU buffer.
+        else if (visual->indirect.buffer != NULL)
+        {
+            if (index_count == 0)
+                dvz_cmd_draw_indirect(cmds, idx, _indirect_region(visual, pipeline_idx), 1);
+            else
+                dvz_cmd_draw_indexed_indirect(
+                    cmds, idx, _indirect_region(visual, pipeline_idx), 1);
+        }
+        else if (index_count == 0)
         {
             log_debug("draw %d vertices", vertex_count);
             // Make sure the bound vertex buffer is large enough.
-            ASSERT(vertex_buf->size >= vertex_count * vertex_source->arr.item_size);
-            dvz_cmd_draw(cmds, idx, 0, vertex_count);
+            ASSERT(
+                vertex_buf->size >= vertex_source->arr.item_count * vertex_source->arr.item_size);
+            if (graphics->vertices_per_instance > 0)
+                dvz_cmd_draw_instanced(cmds, idx, 0, vertex_count, 0, instance_count);
+            else
+                dvz_cmd_draw(cmds, idx, 0, vertex_count);
         }
         else
         {
@@ -1981,6 +1981,19 @@ void dvz_compute_code(DvzCompute* compute, const char* code)
 
 
 
+void dvz_compute_spirv(DvzCompute* compute, VkDeviceSize size, const uint32_t* buffer)
+{
+    ASSERT(compute != NULL);
+    ASSERT(compute->gpu != NULL);
+    ASSERT(compute->gpu->device != VK_NULL_HANDLE);
+    ASSERT(size % 4 == 0);
+    ASSERT(buffer != NULL);
+
+    compute->shader_module = create_shader_module(compute->gpu->device, size, buffer);
+}
+
+
+
 void dvz_compute_slot(DvzCompute* compute, uint32_t idx, VkDescriptorType type)
 {
     ASSERT(compute != NULL);
@@ -2024,7 +2037,11 @@ void dvz_compute_create(DvzCompute* compute)
 
     log_trace("starting creation of compute...");
 
-    if (compute->shader_code != NULL)
+    if (compute->shader_module != VK_NULL_HANDLE)
+    {
+        // The SPIR-V code has been set with dvz_compute_spirv().
+    }
+    else if (compute->shader_code != NULL)
     {
         compute->shader_module =
             dvz_shader_compile(compute->gpu, compute->shader_code, VK_SHADER_STAGE_COMPUTE_BIT);
@@ -2164,6 +2181,24 @@ void dvz_graphics_vertex_binding(DvzGraphics* graphics, uint32_t binding, VkDevi
     DvzVertexBinding* vb = &graphics->vertex_bindings[graphics->vertex_binding_count++];
     vb->binding = binding;
     vb->stride = stride;
+    vb->input_rate = VK_VERTEX_INPUT_RATE_VERTEX;
+}
+
+
+
+void dvz_graphics_vertex_input_rate(
+    DvzGraphics* graphics, uint32_t binding, VkVertexInputRate input_rate)
+{
+    ASSERT(graphics != NULL);
+    for (uint32_t i = 0; i < graphics->vertex_binding_count; i++)
+    {
+        if (graphics->vertex_bindings[i].binding == binding)
+        {
+            graphics->vertex_bindings[i].input_rate = input_rate;
+            return;
+        }
+    }
+    log_error("vertex binding %d not found", binding);
 }
 
 
@@ -2242,6 +2277,26 @@ void dvz_graphics_slot(DvzGraphics* graphics, uint32_t idx, VkDescriptorType typ
 
 
 
+void dvz_graphics_vertex_pulling(DvzGraphics* graphics, uint32_t idx, uint32_t vertices_per_item)
+{
+    ASSERT(graphics != NULL);
+    ASSERT(vertices_per_item > 0);
+    dvz_slots_binding(&graphics->slots, idx, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    graphics->pull_slot = idx;
+    graphics->vertices_per_item = vertices_per_item;
+}
+
+
+
+void dvz_graphics_instancing(DvzGraphics* graphics, uint32_t vertices_per_instance)
+{
+    ASSERT(graphics != NULL);
+    ASSERT(vertices_per_instance > 0);
+    graphics->vertices_per_instance = vertices_per_instance;
+}
+
+
+
 void dvz_graphics_push(
     DvzGraphics* graphics, VkDeviceSize offset, VkDeviceSize size, VkShaderStageFlags shaders)
 {
@@ -2271,7 +2326,7 @@ void dvz_graphics_create(DvzGraphics* graphics)
     {
         bindings_info[i].binding = graphics->vertex_bindings[i].binding;
         bindings_info[i].stride = graphics->vertex_bindings[i].stride;
-        bindings_info[i].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        bindings_info[i].inputRate = graphics->vertex_bindings[i].input_rate;
     }
     vertex_input_info.vertexBindingDescriptionCount = graphics->vertex_binding_count;
     vertex_input_info.pVertexBindingDescriptions = bindings_info;
@@ -3261,6 +3316,26 @@ void dvz_cmd_compute(DvzCommands* cmds, uint32_t idx, DvzCompute* compute, uvec3
 
 
 
+void dvz_cmd_compute_indirect(
+    DvzCommands* cmds, uint32_t idx, DvzCompute* compute, DvzBufferRegions indirect)
+{
+    ASSERT(compute->bindings != NULL);
+    ASSERT(compute->pipeline != VK_NULL_HANDLE);
+    ASSERT(compute->slots.pipeline_layout != VK_NULL_HANDLE);
+    ASSERT(indirect.buffer != NULL);
+    ASSERT(indirect.size >= sizeof(VkDispatchIndirectCommand));
+
+    CMD_START_CLIP(compute->bindings->dset_count)
+    vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_COMPUTE, compute->pipeline);
+    vkCmdBindDescriptorSets(
+        cb, VK_PIPELINE_BIND_POINT_COMPUTE, compute->slots.pipeline_layout, 0, 1,
+        &compute->bindings->dsets[iclip], 0, 0);
+    vkCmdDispatchIndirect(cb, indirect.buffer->buffer, indirect.offsets[0]);
+    CMD_END
+}
+
+
+
 void dvz_cmd_barrier(DvzCommands* cmds, uint32_t idx, DvzBarrier* barrier)
 {
     ASSERT(barrier != NULL);
@@ -3280,7 +3355,7 @@ void dvz_cmd_barrier(DvzCommands* cmds, uint32_t idx, DvzBarrier* barrier)
         buffer_barrier->sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
         buffer_barrier->buffer = buffer_info->br.buffer->buffer;
         buffer_barrier->size = buffer_info->br.size;
-        buffer_barrier->offset = buffer_info->br.offsets[MIN(i, cmds->count - 1)];
+        buffer_barrier->offset = buffer_info->br.offsets[MIN(i, buffer_info->br.count - 1)];
 
         buffer_barrier->srcAccessMask = buffer_info->src_access;
         buffer_barrier->dstAccessMask = buffer_info->dst_access;
@@ -3486,6 +3561,24 @@ void dvz_cmd_viewport(DvzCommands* cmds, uint32_t idx, VkViewport viewport)
 void dvz_cmd_bind_graphics(
     DvzCommands* cmds, uint32_t idx, DvzGraphics* graphics, //
     DvzBindings* bindings, uint32_t dynamic_idx)
+{
+    ASSERT(graphics != NULL);
+    ASSERT(bindings != NULL);
+
+    if (dvz_obj_is_created(&graphics->obj))
+    {
+        CMD_START
+        vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics->pipeline);
+        CMD_END
+    }
+    dvz_cmd_bind_descriptors(cmds, idx, graphics, bindings, dynamic_idx);
+}
+
+
+
+void dvz_cmd_bind_descriptors(
+    DvzCommands* cmds, uint32_t idx, DvzGraphics* graphics, //
+    DvzBindings* bindings, uint32_t dynamic_idx)
 {
     ASSERT(graphics != NULL);
     DvzSlots* slots = &graphics->slots;
@@ -3506,8 +3599,6 @@ void dvz_cmd_bind_graphics(
     }
 
     CMD_START_CLIP(bindings->dset_count)
-    if (dvz_obj_is_created(&graphics->obj))
-        vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics->pipeline);
     vkCmdBindDescriptorSets(
         cb, VK_PIPELINE_BIND_POINT_GRAPHICS, slots->pipeline_layout, //
         0, 1, &bindings->dsets[iclip], dyn_count, dyn_offsets);
@@ -3517,11 +3608,12 @@ void dvz_cmd_bind_graphics(
 
 
 void dvz_cmd_bind_vertex_buffer(
-    DvzCommands* cmds, uint32_t idx, DvzBufferRegions br, VkDeviceSize offset)
+    DvzCommands* cmds, uint32_t idx, uint32_t binding_idx, DvzBufferRegions br,
+    VkDeviceSize offset)
 {
     CMD_START_CLIP(br.count)
     VkDeviceSize offsets[] = {br.offsets[iclip] + offset};
-    vkCmdBindVertexBuffers(cb, 0, 1, &br.buffer->buffer, offsets);
+    vkCmdBindVertexBuffers(cb, binding_idx, 1, &br.buffer->buffer, offsets);
     CMD_END
 }
 
@@ -3547,6 +3639,19 @@ void dvz_cmd_draw(DvzCommands* cmds, uint32_t idx, uint32_t first_vertex, uint32
 
 
 
+void dvz_cmd_draw_instanced(
+    DvzCommands* cmds, uint32_t idx, uint32_t first_vertex, uint32_t vertex_count,
+    uint32_t first_instance, uint32_t instance_count)
+{
+    ASSERT(vertex_count > 0);
+    ASSERT(instance_count > 0);
+    CMD_START
+    vkCmdDraw(cb, vertex_count, instance_count, first_vertex, first_instance);
+    CMD_END
+}
+
+
+
 void dvz_cmd_draw_indexed(
     DvzCommands* cmds, uint32_t idx, uint32_t first_index, uint32_t vertex_offset,
     uint32_t index_count)
@@ -3559,19 +3664,58 @@ void dvz_cmd_draw_indexed(
 
 
 
-void dvz_cmd_draw_indirect(DvzCommands* cmds, uint32_t idx, DvzBufferRegions indirect)
+// Whether multi-draw indirect commands are enabled on the GPU.
+static bool _multi_draw_indirect(DvzGpu* gpu)
+{
+    ASSERT(gpu != NULL);
+    return gpu->requested_features.multiDrawIndirect;
+}
+
+void dvz_cmd_draw_indirect(
+    DvzCommands* cmds, uint32_t idx, DvzBufferRegions indirect, uint32_t draw_count)
 {
+    ASSERT(draw_count > 0);
+    ASSERT(indirect.size >= draw_count * sizeof(VkDrawIndirectCommand));
+    VkDeviceSize stride = sizeof(VkDrawIndirectCommand);
+
     CMD_START_CLIP(indirect.count)
-    vkCmdDrawIndirect(cb, indirect.buffer->buffer, indirect.offsets[iclip], 1, 0);
+    if (draw_count == 1 || _multi_draw_indirect(cmds->gpu))
+    {
+        vkCmdDrawIndirect(
+            cb, indirect.buffer->buffer, indirect.offsets[iclip], draw_count, (uint32_t)stride);
+    }
+    else
+    {
+        // Fallback when the GPU does not support multi-draw indirect.
+        for (uint32_t k = 0; k < draw_count; k++)
+            vkCmdDrawIndirect(
+                cb, indirect.buffer->buffer, indirect.offsets[iclip] + k * stride, 1, 0);
+    }
     CMD_END
 }
 
 
 
-void dvz_cmd_draw_indexed_indirect(DvzCommands* cmds, uint32_t idx, DvzBufferRegions indirect)
+void dvz_cmd_draw_indexed_indirect(
+    DvzCommands* cmds, uint32_t idx, DvzBufferRegions indirect, uint32_t draw_count)
 {
+    ASSERT(draw_count > 0);
+    ASSERT(indirect.size >= draw_count * sizeof(VkDrawIndexedIndirectCommand));
+    VkDeviceSize stride = sizeof(VkDrawIndexedIndirectCommand);
+
     CMD_START_CLIP(indirect.count)
-    vkCmdDrawIndexedIndirect(cb, indirect.buffer->buffer, indirect.offsets[iclip], 1, 0);
+    if (draw_count == 1 || _multi_draw_indirect(cmds->gpu))
+    {
+        vkCmdDrawIndexedIndirect(
+            cb, indirect.buffer->buffer, indirect.offsets[iclip], draw_count, (uint32_t)stride);
+    }
+    else
+    {
+        // Fallback when the GPU does not support multi-draw indirect.
+        for (uint32_t k = 0; k < draw_count; k++)
+            vkCmdDrawIndexedIndirect(
+                cb, indirect.buffer->buffer, indirect.offsets[iclip] + k * stride, 1, 0);
+    }
     CMD_END
 }
 
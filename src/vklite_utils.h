@@ -975,6 +975,9 @@ static void create_device(DvzGpu* gpu, VkSurfaceKHR surface)
     // If the [VK_KHR_portability_subset] extension is included in pProperties of
     // vkEnumerateDeviceExtensionProperties, ppEnabledExtensions must include
     // "VK_KHR_portability_subset"
+    // The optional VK_KHR_shader_draw_parameters extension is also enabled if it is supported,
+    // the draw batches of the scene need gl_DrawIDARB in the shaders.
+    gpu->draw_parameters = false;
     {
         log_trace("getting device extensions properties");
         uint32_t n = 0;
@@ -991,7 +994,13 @@ static void create_device(DvzGpu* gpu, VkSurfaceKHR surface)
                           "VK_KHR_portability_subset");
                 // extensions[n_extensions++] = "VK_KHR_get_physical_device_properties2";
                 extensions[n_extensions++] = "VK_KHR_portability_subset";
-                break;
+            }
+            else if (
+                strcmp(ext[i].extensionName, VK_KHR_SHADER_DRAW_PARAMETERS_EXTENSION_NAME) == 0)
+            {
+                log_trace("found shader draw parameters, will add the extension");
+                extensions[n_extensions++] = VK_KHR_SHADER_DRAW_PARAMETERS_EXTENSION_NAME;
+                gpu->draw_parameters = true;
             }
         }
         FREE(ext);
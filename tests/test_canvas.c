@@ -815,7 +815,7 @@ static void triangle_refill_compute(DvzCanvas* canvas, DvzEvent ev)
 
     dvz_cmd_begin_renderpass(cmds, idx, &canvas->renderpass, &canvas->framebuffers);
     dvz_cmd_viewport(cmds, idx, canvas->viewport.viewport);
-    dvz_cmd_bind_vertex_buffer(cmds, idx, visual->br, 0);
+    dvz_cmd_bind_vertex_buffer(cmds, idx, 0, visual->br, 0);
     dvz_cmd_bind_graphics(cmds, idx, &visual->graphics, &visual->bindings, 0);
     dvz_cmd_draw(cmds, idx, 0, 3);
     dvz_cmd_end_renderpass(cmds, idx);
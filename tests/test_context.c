@@ -1,4 +1,5 @@
 #include "../include/datoviz/context.h"
+#include "../include/datoviz/glyphs.h"
 #include "proto.h"
 #include "tests.h"
 
@@ -239,3 +240,88 @@ int test_context_colormap_custom(TestContext* tc)
 
     return 0;
 }
+
+
+
+/*************************************************************************************************/
+/*  Glyph atlas                                                                                  */
+/*************************************************************************************************/
+
+int test_context_glyphs(TestContext* tc)
+{
+    DvzContext* ctx = tc->context;
+    ASSERT(ctx != NULL);
+    DvzGpu* gpu = ctx->gpu;
+    ASSERT(gpu != NULL);
+
+    // UTF-8 decoding.
+    const char* str = "a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80";
+    AT(dvz_utf8_count(str) == 4);
+    AT(dvz_utf8_next(&str) == 'a');
+    AT(dvz_utf8_next(&str) == 0xE9);
+    AT(dvz_utf8_next(&str) == 0x20AC);
+    AT(dvz_utf8_next(&str) == 0x1F600);
+    AT(dvz_utf8_next(&str) == 0);
+    str = "\xe2\x82";
+    AT(dvz_utf8_next(&str) == 0xFFFD);
+
+    DvzGlyphAtlas* atlas = ctx->glyph_atlas;
+    ASSERT(atlas != NULL);
+    AT(atlas->font_count == 1);
+
+    // A glyph is rasterized only once.
+    DvzGlyph* glyph = dvz_glyph_atlas_get(atlas, 0, 'A');
+    AT(glyph->rect[2] > 0 && glyph->rect[3] > 0);
+    AT(glyph->advance > 0 && glyph->advance < 1);
+    AT(glyph->offset[1] < 0);
+    uint32_t glyph_count = atlas->glyphs.item_count;
+    AT(dvz_glyph_atlas_get(atlas, 0, 'A') == glyph);
+    AT(atlas->glyphs.item_count == glyph_count);
+
+    // Blank glyphs take no space in the atlas.
+    glyph = dvz_glyph_atlas_get(atlas, 0, ' ');
+    AT(glyph->rect[2] == 0 && glyph->rect[3] == 0);
+    AT(glyph->advance > 0);
+
+    // Fill the atlas so that it grows.
+    uint32_t generation = atlas->generation;
+    for (uint32_t cp = 0x21; cp < 0x250; cp++)
+        dvz_glyph_atlas_get(atlas, 0, cp);
+    AT(atlas->generation > generation);
+    AT(atlas->texture->image->height == atlas->height);
+    glyph = dvz_glyph_atlas_get(atlas, 0, 'A');
+    AT(glyph->codepoint == 'A');
+
+    // Glyphs do not overlap in the atlas.
+    DvzGlyph* other = NULL;
+    for (uint32_t i = 0; i < atlas->glyphs.item_count; i++)
+    {
+        glyph = dvz_array_item(&atlas->glyphs, i);
+        if (glyph->rect[2] == 0)
+            continue;
+        AT(glyph->rect[0] + glyph->rect[2] <= atlas->width);
+        AT(glyph->rect[1] + glyph->rect[3] <= atlas->height);
+        for (uint32_t j = i + 1; j < atlas->glyphs.item_count; j++)
+        {
+            other = dvz_array_item(&atlas->glyphs, j);
+            if (other->rect[2] == 0)
+                continue;
+            AT(glyph->rect[0] + glyph->rect[2] <= other->rect[0] ||
+               other->rect[0] + other->rect[2] <= glyph->rect[0] ||
+               glyph->rect[1] + glyph->rect[3] <= other->rect[1] ||
+               other->rect[1] + other->rect[3] <= glyph->rect[1]);
+        }
+    }
+
+    // Check that the GPU texture matches the atlas.
+    dvz_glyph_atlas_upload(atlas);
+    AT(atlas->dirty_count == 0);
+    VkDeviceSize size = atlas->width * atlas->height * 4;
+    uint8_t* arr = calloc(size, 1);
+    dvz_texture_download(atlas->texture, DVZ_ZERO_OFFSET, DVZ_ZERO_OFFSET, size, arr);
+    dvz_queue_wait(gpu, DVZ_DEFAULT_QUEUE_TRANSFER);
+    AT(memcmp(arr, atlas->pixels, size) == 0);
+    FREE(arr);
+
+    return 0;
+}
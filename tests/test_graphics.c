@@ -1,3 +1,4 @@
+#include "../include/datoviz/glyphs.h"
 #include "../include/datoviz/graphics.h"
 #include "../include/datoviz/interact.h"
 #include "../include/datoviz/mesh.h"
@@ -76,7 +77,7 @@ static void _graphics_refill(DvzCanvas* canvas, DvzEvent ev)
     dvz_cmd_begin(cmds, idx);
     dvz_cmd_begin_renderpass(cmds, idx, &canvas->renderpass, &canvas->framebuffers);
     dvz_cmd_viewport(cmds, idx, canvas->viewport.viewport);
-    dvz_cmd_bind_vertex_buffer(cmds, idx, *br, 0);
+    dvz_cmd_bind_vertex_buffer(cmds, idx, 0, *br, 0);
     if (br_index->buffer != NULL)
         dvz_cmd_bind_index_buffer(cmds, idx, *br_index, 0);
     dvz_cmd_bind_graphics(cmds, idx, graphics, bindings, 0);
@@ -89,8 +90,10 @@ static void _graphics_refill(DvzCanvas* canvas, DvzEvent ev)
         }
         else
         {
-            log_debug("draw non-indexed %d", tg->vertices.item_count);
-            dvz_cmd_draw(cmds, idx, 0, tg->vertices.item_count);
+            // With vertex pulling, each item is expanded into several vertices.
+            uint32_t vertex_count = tg->vertices.item_count * MAX(1, graphics->vertices_per_item);
+            log_debug("draw non-indexed %d", vertex_count);
+            dvz_cmd_draw(cmds, idx, 0, vertex_count);
         }
     }
     dvz_cmd_end_renderpass(cmds, idx);
@@ -123,6 +126,10 @@ static void _graphics_bindings(TestGraphics* tg)
     // Bindings
     dvz_bindings_buffer(&tg->bindings, 0, tg->br_mvp);
     dvz_bindings_buffer(&tg->bindings, 1, tg->br_viewport);
+
+    // Vertex pulling: the vertex buffer is also bound as a storage buffer.
+    if (graphics->vertices_per_item > 0)
+        dvz_bindings_buffer(&tg->bindings, graphics->pull_slot, tg->br_vert);
 }
 
 static void _interact_callback(DvzCanvas* canvas, DvzEvent ev)
@@ -610,7 +617,7 @@ int test_graphics_marker(TestContext* tc)
 
 
 
-int test_graphics_segment(TestContext* tc)
+static int _segment_run(TestContext* tc, DvzGraphicsType type, const char* name)
 {
     DvzCanvas* canvas = tc->canvas;
     DvzContext* context = tc->context;
@@ -619,7 +626,7 @@ int test_graphics_segment(TestContext* tc)
     ASSERT(context != NULL);
 
     // Create the graphics pipeline.
-    DvzGraphics* graphics = dvz_graphics_builtin(canvas, DVZ_GRAPHICS_SEGMENT, 0);
+    DvzGraphics* graphics = dvz_graphics_builtin(canvas, type, 0);
     ASSERT(graphics != NULL);
 
     // Vertex count and params.
@@ -627,7 +634,11 @@ int test_graphics_segment(TestContext* tc)
 
     // Create the graphics struct.
     TestGraphics tg = {.canvas = canvas, .graphics = graphics};
-    _graphics_create(&tg, sizeof(DvzGraphicsSegmentVertex), n, DVZ_INTERACT_PANZOOM);
+    _graphics_create(
+        &tg,
+        type == DVZ_GRAPHICS_SEGMENT_PULL ? sizeof(DvzGraphicsSegmentPullVertex)
+                                          : sizeof(DvzGraphicsSegmentVertex),
+        n, DVZ_INTERACT_PANZOOM);
 
     // Graphics data.
     DvzGraphicsSegmentVertex vertex = {0};
@@ -655,11 +666,22 @@ int test_graphics_segment(TestContext* tc)
     _graphics_run(&tg, N_FRAMES);
 
     // Check screenshot and save it for the documentation.
-    int res = _graphics_screenshot(&tg, "segment");
+    int res = _graphics_screenshot(&tg, name);
 
     return res;
 }
 
+int test_graphics_segment(TestContext* tc)
+{
+    return _segment_run(tc, DVZ_GRAPHICS_SEGMENT, "segment");
+}
+
+int test_graphics_segment_pull(TestContext* tc)
+{
+    // The segments are stored once in the vertex buffer, without indices.
+    return _segment_run(tc, DVZ_GRAPHICS_SEGMENT_PULL, "segment_pull");
+}
+
 
 
 int test_graphics_path(TestContext* tc)
@@ -769,14 +791,9 @@ int test_graphics_text(TestContext* tc)
         glyphs[i] = 33 + i; // HACK: 33 because that's the current index of A in the font atlas
     ASSERT(glyphs != NULL);
 
-    // Font atlas
-    DvzFontAtlas* atlas = &context->font_atlas;
-
-    DvzGraphicsTextParams params = {0};
-    params.grid_size[0] = (int32_t)atlas->rows;
-    params.grid_size[1] = (int32_t)atlas->cols;
-    params.tex_size[0] = (int32_t)atlas->width;
-    params.tex_size[1] = (int32_t)atlas->height;
+    // Glyph atlas, the glyphs of the strings are rasterized when appending the items.
+    // NOTE: the glyph indices refer to the fixed font atlas instead, context->font_atlas.
+    DvzGlyphAtlas* atlas = context->glyph_atlas;
 
     // Create the graphics struct.
     TestGraphics tg = {.canvas = canvas, .graphics = graphics};
@@ -828,6 +845,11 @@ int test_graphics_text(TestContext* tc)
     FREE(item.glyph_colors);
 
     _graphics_upload(&tg);
+    dvz_glyph_atlas_upload(atlas);
+
+    DvzGraphicsTextParams params = {0};
+    params.tex_size[0] = (int32_t)atlas->width;
+    params.tex_size[1] = (int32_t)atlas->height;
 
     // Graphics bindings.
     _graphics_bindings(&tg);
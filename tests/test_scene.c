@@ -1,3 +1,4 @@
+#include "../include/datoviz/octree.h"
 #include "../include/datoviz/scene.h"
 #include "../include/datoviz/visuals.h"
 #include "../src/interact_utils.h"
@@ -197,6 +198,293 @@ int test_scene_multiple(TestContext* tc)
 
 
 
+int test_scene_batch(TestContext* tc)
+{
+    DvzCanvas* canvas = tc->canvas;
+    ASSERT(canvas != NULL);
+
+    DvzScene* scene = dvz_scene(canvas, 1, 1);
+    DvzPanel* panel = dvz_scene_panel(scene, 0, 0, DVZ_CONTROLLER_PANZOOM, 0);
+
+    // Runs of visuals of the same type share the same graphics pipeline, which is only bound once
+    // per run. The visuals are drawn in the order they were added.
+    const uint32_t n_visuals = 6;
+    DvzVisual* visuals[6] = {0};
+    uint32_t n = 20;
+    dvec3* pos = calloc(n, sizeof(dvec3));
+    cvec4* color = calloc(n, sizeof(cvec4));
+    for (uint32_t k = 0; k < n_visuals; k++)
+    {
+        visuals[k] = dvz_scene_visual(
+            panel, (k / 2) % 2 == 0 ? DVZ_VISUAL_POINT : DVZ_VISUAL_MARKER,
+            DVZ_VISUAL_FLAGS_TRANSFORM_NONE);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            pos[i][0] = -.9 + 1.8 * i / (double)(n - 1);
+            pos[i][1] = -.75 + 1.5 * k / (double)(n_visuals - 1);
+            dvz_colormap(DVZ_CMAP_HSV, TO_BYTE(k / (double)n_visuals), color[i]);
+        }
+        dvz_visual_data(visuals[k], DVZ_PROP_POS, 0, n, pos);
+        dvz_visual_data(visuals[k], DVZ_PROP_COLOR, 0, n, color);
+        dvz_visual_data(visuals[k], DVZ_PROP_MARKER_SIZE, 0, 1, (float[]){10});
+    }
+    ASSERT(visuals[0]->graphics[0] == visuals[1]->graphics[0]);
+    ASSERT(visuals[0]->graphics[0] == visuals[4]->graphics[0]);
+    ASSERT(visuals[2]->graphics[0] == visuals[3]->graphics[0]);
+    dvz_app_run(canvas->app, 5);
+
+    // When the GPU supports it, the successive marker visuals are drawn with a single multi-draw
+    // indirect command. Point visuals are always drawn separately.
+    if (canvas->gpu->requested_features.multiDrawIndirect && canvas->gpu->draw_parameters)
+    {
+        AT(visuals[2]->batch != NULL);
+        AT(visuals[2]->batch == visuals[3]->batch);
+        AT(visuals[2]->batch_idx == 0);
+        AT(visuals[3]->batch_idx == 1);
+        AT(visuals[2]->batch->draw_count == 2);
+    }
+    AT(visuals[0]->batch == NULL);
+    AT(visuals[4]->batch == NULL);
+
+    // Change the number of items of a visual: the indirect draw command is updated.
+    dvz_visual_data(visuals[0], DVZ_PROP_POS, 0, n / 2, pos);
+    dvz_visual_data(visuals[0], DVZ_PROP_COLOR, 0, n / 2, color);
+
+    FREE(pos);
+    FREE(color);
+
+    return _scene_run(scene, "batch");
+}
+
+
+
+int test_scene_float(TestContext* tc)
+{
+    DvzCanvas* canvas = tc->canvas;
+    ASSERT(canvas != NULL);
+
+    DvzScene* scene = dvz_scene(canvas, 1, 1);
+    DvzPanel* panel = dvz_scene_panel(scene, 0, 0, DVZ_CONTROLLER_PANZOOM, 0);
+    DvzVisual* visual = dvz_scene_visual(panel, DVZ_VISUAL_MARKER, 0);
+
+    // Single-precision positions, normalized without any double-precision copy.
+    dvz_visual_dtype(visual, DVZ_PROP_POS, 0, DVZ_DTYPE_VEC3);
+
+    const uint32_t n = 10000;
+    vec3* pos = calloc(n, sizeof(vec3));
+    cvec4* color = calloc(n, sizeof(cvec4));
+    for (uint32_t i = 0; i < n; i++)
+    {
+        pos[i][0] = 1000 + 10 * dvz_rand_normal();
+        pos[i][1] = -20 + dvz_rand_normal();
+        dvz_colormap_scale(DVZ_CMAP_VIRIDIS, pos[i][1], -23, -17, color[i]);
+        color[i][3] = 128;
+    }
+    dvz_visual_data(visual, DVZ_PROP_POS, 0, n, pos);
+    dvz_visual_data(visual, DVZ_PROP_COLOR, 0, n, color);
+    dvz_visual_data(visual, DVZ_PROP_MARKER_SIZE, 0, 1, (float[]){10});
+    FREE(pos);
+    FREE(color);
+
+    return _scene_run(scene, "float");
+}
+
+
+
+int test_scene_gpu_transform(TestContext* tc)
+{
+    DvzCanvas* canvas = tc->canvas;
+    ASSERT(canvas != NULL);
+
+    DvzScene* scene = dvz_scene(canvas, 1, 1);
+    DvzPanel* panel = dvz_scene_panel(scene, 0, 0, DVZ_CONTROLLER_AXES_2D, 0);
+    DvzVisual* visual =
+        dvz_scene_visual(panel, DVZ_VISUAL_MARKER, DVZ_VISUAL_FLAGS_TRANSFORM_GPU);
+
+    // Large offset with small variations: the positions are uploaded relative to the visual
+    // origin, and the data normalization is done in the vertex shader.
+    const uint32_t n = 10000;
+    dvec3* pos = calloc(n, sizeof(dvec3));
+    cvec4* color = calloc(n, sizeof(cvec4));
+    for (uint32_t i = 0; i < n; i++)
+    {
+        pos[i][0] = 1e6 + dvz_rand_normal();
+        pos[i][1] = -1e6 + dvz_rand_normal();
+        dvz_colormap_scale(DVZ_CMAP_VIRIDIS, pos[i][1], -1e6 - 3, -1e6 + 3, color[i]);
+        color[i][3] = 128;
+    }
+    dvz_visual_data(visual, DVZ_PROP_POS, 0, n, pos);
+    dvz_visual_data(visual, DVZ_PROP_COLOR, 0, n, color);
+    dvz_visual_data(visual, DVZ_PROP_MARKER_SIZE, 0, 1, (float[]){10});
+    FREE(pos);
+    FREE(color);
+
+    return _scene_run(scene, "gpu_transform");
+}
+
+
+
+int test_scene_point_cloud(TestContext* tc)
+{
+    DvzCanvas* canvas = tc->canvas;
+    ASSERT(canvas != NULL);
+
+    // Build a small octree on disk.
+    const uint32_t n = 200000;
+    dvec3* pos = calloc(n, sizeof(dvec3));
+    cvec4* color = calloc(n, sizeof(cvec4));
+    for (uint32_t i = 0; i < n; i++)
+    {
+        for (uint32_t j = 0; j < 3; j++)
+            pos[i][j] = dvz_rand_normal();
+        dvz_colormap_scale(DVZ_CMAP_VIRIDIS, pos[i][2], -3, +3, color[i]);
+    }
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/test_scene_point_cloud.bin", ARTIFACTS_DIR);
+    AT(dvz_octree_build(path, n, pos, color, 4096) == 0);
+    FREE(pos);
+    FREE(color);
+
+    DvzScene* scene = dvz_scene(canvas, 1, 1);
+    DvzPanel* panel = dvz_scene_panel(scene, 0, 0, DVZ_CONTROLLER_ARCBALL, 0);
+    DvzVisual* visual = dvz_scene_visual(panel, DVZ_VISUAL_POINT_CLOUD, 0);
+
+    // Only a part of the points fit in the budget, the nodes are streamed over several frames.
+    DvzOctree octree = dvz_octree_open(path);
+    AT(dvz_obj_is_created(&octree.obj));
+    dvz_visual_octree(visual, &octree, n / 4);
+
+    int res = _scene_run(scene, "point_cloud");
+    AT(octree.selected_count > 0);
+    dvz_octree_destroy(&octree);
+    return res;
+}
+
+
+
+int test_scene_cull(TestContext* tc)
+{
+    DvzCanvas* canvas = tc->canvas;
+    ASSERT(canvas != NULL);
+
+    DvzScene* scene = dvz_scene(canvas, 1, 1);
+    DvzPanel* panel = dvz_scene_panel(scene, 0, 0, DVZ_CONTROLLER_PANZOOM, 0);
+    DvzVisual* visual = dvz_scene_visual(panel, DVZ_VISUAL_MARKER, DVZ_VISUAL_FLAGS_CULL);
+
+    // Points sorted along x, so that each chunk covers a narrow vertical band.
+    const uint32_t n = 1000000;
+    dvec3* pos = calloc(n, sizeof(dvec3));
+    cvec4* color = calloc(n, sizeof(cvec4));
+    for (uint32_t i = 0; i < n; i++)
+    {
+        pos[i][0] = -1 + 2 * i / (double)(n - 1);
+        pos[i][1] = .25 * dvz_rand_normal();
+        dvz_colormap_scale(DVZ_CMAP_VIRIDIS, pos[i][0], -1, +1, color[i]);
+        color[i][3] = 128;
+    }
+    dvz_visual_data(visual, DVZ_PROP_POS, 0, n, pos);
+    dvz_visual_data(visual, DVZ_PROP_COLOR, 0, n, color);
+    dvz_visual_data(visual, DVZ_PROP_MARKER_SIZE, 0, 1, (float[]){2});
+    FREE(pos);
+    FREE(color);
+
+    // Zoom in the center of the panel: most chunks are out of view.
+    DvzInteract* interact = &panel->controller->interacts[0];
+    interact->u.p.zoom[0] = interact->u.p.zoom[1] = 4;
+    glm_ortho(-.25f, +.25f, -.25f, +.25f, -10.0f, 10.0f, interact->mvp.proj);
+    dvz_app_run(canvas->app, N_FRAMES);
+
+    DvzChunks* chunks = &visual->chunks;
+    AT(chunks->active);
+    AT(chunks->chunk_count == (n + DVZ_CHUNK_SIZE - 1) / DVZ_CHUNK_SIZE);
+    VkDrawIndirectCommand* draws = (VkDrawIndirectCommand*)chunks->draws.data;
+    uint32_t visible = 0;
+    for (uint32_t i = 0; i < chunks->chunk_count; i++)
+        visible += draws[i].vertexCount > 0;
+    AT(visible > 0);
+    AT(visible < chunks->chunk_count / 2);
+
+    return _scene_run(scene, "cull");
+}
+
+
+
+int test_scene_density(TestContext* tc)
+{
+    DvzCanvas* canvas = tc->canvas;
+    ASSERT(canvas != NULL);
+
+    DvzScene* scene = dvz_scene(canvas, 1, 1);
+    DvzPanel* panel = dvz_scene_panel(scene, 0, 0, DVZ_CONTROLLER_PANZOOM, 0);
+    DvzVisual* visual = dvz_scene_visual(panel, DVZ_VISUAL_DENSITY, 0);
+
+    const uint32_t n = 1000000;
+    dvec3* pos = calloc(n, sizeof(dvec3));
+    for (uint32_t i = 0; i < n; i++)
+    {
+        pos[i][0] = .25 * dvz_rand_normal();
+        pos[i][1] = .25 * dvz_rand_normal();
+    }
+    dvz_visual_data(visual, DVZ_PROP_POS, 0, n, pos);
+    dvz_visual_data(visual, DVZ_PROP_COLORMAP, 0, 1, (int32_t[]){DVZ_CMAP_HOT});
+    FREE(pos);
+
+    dvz_app_run(canvas->app, N_FRAMES);
+
+    // The points are binned on the GPU, once per command buffer after the last change.
+    DvzDensity* density = &visual->density;
+    AT(density->ready);
+    AT(density->header.point_count == n);
+    AT(density->header.size[0] == panel->viewport.size_framebuffer[0]);
+    AT(density->header.size[1] == panel->viewport.size_framebuffer[1]);
+    AT(density->frames == 0);
+    AT(density->dispatch_cmds[1].x == 0);
+
+    return _scene_run(scene, "density");
+}
+
+
+
+int test_scene_histogram(TestContext* tc)
+{
+    DvzCanvas* canvas = tc->canvas;
+    ASSERT(canvas != NULL);
+
+    DvzScene* scene = dvz_scene(canvas, 1, 1);
+    DvzPanel* panel = dvz_scene_panel(scene, 0, 0, DVZ_CONTROLLER_PANZOOM, 0);
+    DvzVisual* visual = dvz_scene_visual(panel, DVZ_VISUAL_HISTOGRAM, 0);
+
+    const uint32_t n = 1000000;
+    double* samples = calloc(n, sizeof(double));
+    for (uint32_t i = 0; i < n; i++)
+        samples[i] = dvz_rand_normal();
+    dvz_visual_data(visual, DVZ_PROP_POS, 0, n, samples);
+    dvz_visual_data(visual, DVZ_PROP_RANGE, 0, 1, (vec2){-4, 4});
+    dvz_visual_data(visual, DVZ_PROP_LENGTH, 0, 1, (uint32_t[]){200});
+    FREE(samples);
+
+    dvz_app_run(canvas->app, N_FRAMES);
+
+    // The samples are binned on the GPU, once per command buffer after the last change.
+    DvzHistogram* histogram = &visual->histogram;
+    AT(histogram->ready);
+    AT(histogram->sample_count == n);
+    AT(histogram->params.bin_count == 200);
+    AT(histogram->frames == 0);
+    AT(histogram->dispatch_cmds[1].x == 0);
+
+    // Changing the number of bins only uploads the params.
+    dvz_visual_data(visual, DVZ_PROP_LENGTH, 0, 1, (uint32_t[]){50});
+    dvz_app_run(canvas->app, N_FRAMES);
+    AT(histogram->params.bin_count == 50);
+    AT(histogram->sample_count == n);
+    AT(histogram->frames == 0);
+
+    return _scene_run(scene, "histogram");
+}
+
+
+
 int test_scene_different_size(TestContext* tc)
 {
     DvzCanvas* canvas = tc->canvas;
@@ -1,11 +1,22 @@
 #include "../include/datoviz/array.h"
+#include "../include/datoviz/colormaps.h"
 #include "../include/datoviz/common.h"
 #include "../include/datoviz/fifo.h"
+#include "../include/datoviz/mesh.h"
+#include "../include/datoviz/octree.h"
+#include "../include/datoviz/pslg.h"
 #include "../include/datoviz/transforms.h"
 #include "../src/ticks.h"
 #include "../src/transforms_utils.h"
 #include "tests.h"
 
+#include <sys/stat.h>
+#if OS_WIN32
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
 
 
 /*************************************************************************************************/
@@ -683,6 +694,68 @@ int test_utils_array_cast(TestContext* tc)
 
 
 
+int test_utils_array_quantize(TestContext* tc)
+{
+    // Positions to snorm16.
+    {
+        vec3 pos[] = {{-1, 0, 1}, {.5, -2, .25}};
+        int16_t out[2][4] = {0};
+        DvzArray arr = dvz_array_wrap(2, DVZ_DTYPE_SNORM16_VEC4, out);
+        dvz_array_column(
+            &arr, 0, sizeof(vec3), 0, 2, 2, pos, DVZ_DTYPE_VEC3, DVZ_DTYPE_SNORM16_VEC4,
+            DVZ_ARRAY_COPY_SINGLE, 1);
+        AT(out[0][0] == -32767);
+        AT(out[0][1] == 0);
+        AT(out[0][2] == 32767);
+        AT(out[1][0] == 16384);
+        AT(out[1][1] == -32767); // clipped
+        AT(out[1][2] == 8192);
+    }
+
+    // Half floats.
+    {
+        AT(_half(0) == 0x0000);
+        AT(_half(1) == 0x3c00);
+        AT(_half(-1) == 0xbc00);
+        AT(_half(.5) == 0x3800);
+        AT(_half(65504) == 0x7bff);
+        AT(_half(1e6) == 0x7c00);
+    }
+
+    // Octahedral normals.
+    {
+        vec3 normals[] = {{0, 0, 1}, {0, 0, -1}, {1, 0, 0}, {.6, 0, -.8}};
+        int16_t oct[2] = {0};
+        vec3 n = {0};
+        float x = 0, y = 0, z = 0, l = 0;
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            _oct16(normals[i], oct);
+
+            // Decode, same as oct_decode() in the shaders.
+            x = oct[0] / 32767.0f;
+            y = oct[1] / 32767.0f;
+            z = 1 - fabsf(x) - fabsf(y);
+            if (z < 0)
+            {
+                float x0 = x;
+                x = (1 - fabsf(y)) * (x0 >= 0 ? 1 : -1);
+                y = (1 - fabsf(x0)) * (y >= 0 ? 1 : -1);
+            }
+            l = sqrtf(x * x + y * y + z * z);
+            n[0] = x / l;
+            n[1] = y / l;
+            n[2] = z / l;
+            for (uint32_t j = 0; j < 3; j++)
+                AT(fabs(n[j] - normals[i][j]) < 1e-3);
+        }
+    }
+
+    return 0;
+}
+
+
+
 int test_utils_array_mvp(TestContext* tc)
 {
     DvzArray arr = dvz_array_struct(1, sizeof(_mvp));
@@ -910,6 +983,162 @@ int test_utils_transforms_4(TestContext* tc)
 
 
 
+int test_utils_transforms_float(TestContext* tc)
+{
+    const uint32_t n = 1000;
+    const double eps = 1e-6;
+
+    // Same positions in double and single precision.
+    DvzArray pos_d = dvz_array(n, DVZ_DTYPE_DVEC3);
+    DvzArray pos_f = dvz_array(n, DVZ_DTYPE_VEC3);
+    dvec3* pd = (dvec3*)pos_d.data;
+    vec3* pf = (vec3*)pos_f.data;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            pf[i][j] = -5 + 10 * dvz_rand_float();
+            pd[i][j] = pf[i][j];
+        }
+    }
+
+    // The bounding box is computed in double precision whatever the dtype.
+    DvzBox box_d = _box_bounding(&pos_d);
+    DvzBox box_f = _box_bounding(&pos_f);
+    for (uint32_t j = 0; j < 3; j++)
+    {
+        AT(box_d.p0[j] == box_f.p0[j]);
+        AT(box_d.p1[j] == box_f.p1[j]);
+    }
+
+    DvzDataCoords coords = {0};
+    coords.box = box_d;
+    coords.transform = DVZ_TRANSFORM_CARTESIAN;
+
+    // Double precision, single precision, and mixed precision (double in, single out).
+    DvzArray out_d = dvz_array(n, DVZ_DTYPE_DVEC3);
+    DvzArray out_f = dvz_array(n, DVZ_DTYPE_VEC3);
+    DvzArray out_m = dvz_array(n, DVZ_DTYPE_VEC3);
+    dvz_transform_pos(coords, &pos_d, &out_d, false);
+    dvz_transform_pos(coords, &pos_f, &out_f, false);
+    dvz_transform_pos(coords, &pos_d, &out_m, false);
+
+    dvec3* od = (dvec3*)out_d.data;
+    vec3* of = (vec3*)out_f.data;
+    vec3* om = (vec3*)out_m.data;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            AT(-1 - eps <= od[i][j] && od[i][j] <= +1 + eps);
+            AT(fabs(of[i][j] - od[i][j]) < eps);
+            AT(fabs(om[i][j] - od[i][j]) < eps);
+        }
+    }
+
+    // 2D positions.
+    DvzArray pos_2 = dvz_array(n, DVZ_DTYPE_VEC2);
+    DvzArray out_2 = dvz_array(n, DVZ_DTYPE_VEC2);
+    for (uint32_t i = 0; i < n; i++)
+        memcpy(dvz_array_item(&pos_2, i), pf[i], sizeof(vec2));
+    dvz_transform_pos(coords, &pos_2, &out_2, false);
+    vec2* o2 = (vec2*)out_2.data;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        AT(fabs(o2[i][0] - od[i][0]) < eps);
+        AT(fabs(o2[i][1] - od[i][1]) < eps);
+    }
+
+    dvz_array_destroy(&pos_d);
+    dvz_array_destroy(&pos_f);
+    dvz_array_destroy(&out_d);
+    dvz_array_destroy(&out_f);
+    dvz_array_destroy(&out_m);
+    dvz_array_destroy(&pos_2);
+    dvz_array_destroy(&out_2);
+
+    return 0;
+}
+
+
+
+int test_utils_transforms_box(TestContext* tc)
+{
+    const uint32_t n = 1000;
+    DvzArray pos = dvz_array(n, DVZ_DTYPE_DVEC3);
+    dvec3* pd = (dvec3*)pos.data;
+    for (uint32_t i = 0; i < n; i++)
+        for (uint32_t j = 0; j < 3; j++)
+            pd[i][j] = dvz_rand_normal();
+
+    // Incremental bounding box, as when appending data to a POS prop.
+    DvzBox box = DVZ_BOX_INF;
+    _box_extend(&box, &pos, 0, 10);
+    _box_extend(&box, &pos, 10, 490);
+    _box_extend(&box, &pos, 500, 500);
+
+    DvzBox expected = _box_bounding(&pos);
+    for (uint32_t j = 0; j < 3; j++)
+    {
+        AT(box.p0[j] == expected.p0[j]);
+        AT(box.p1[j] == expected.p1[j]);
+    }
+
+    dvz_array_destroy(&pos);
+    return 0;
+}
+
+
+
+int test_utils_transforms_parallel(TestContext* tc)
+{
+    // More positions than the minimum chunk size, so that the kernels run in several threads on
+    // multi-core machines.
+    const uint32_t n = 4 * DVZ_TRANSFORM_CHUNK_SIZE + 17;
+    const double eps = 1e-6;
+
+    DvzArray pos = dvz_array(n, DVZ_DTYPE_DVEC3);
+    dvec3* pd = (dvec3*)pos.data;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        pd[i][0] = -180 + 360 * dvz_rand_float();
+        pd[i][1] = -80 + 160 * dvz_rand_float();
+        pd[i][2] = dvz_rand_normal();
+    }
+
+    DvzTransform tr = _transform_interp(_box_bounding(&pos), DVZ_BOX_NDC);
+    DvzTransform tr_merc = _transform(DVZ_TRANSFORM_EARTH_MERCATOR_WEB);
+
+    // Write the transformed positions directly in single precision.
+    DvzArray out = dvz_array(n, DVZ_DTYPE_VEC3);
+    DvzArray out_merc = dvz_array(n, DVZ_DTYPE_DVEC2);
+    _transform_array(&tr, &pos, &out);
+    _transform_array(&tr_merc, &pos, &out_merc);
+
+    // Compare with the position-wise transform.
+    vec3* of = (vec3*)out.data;
+    dvec2* om = (dvec2*)out_merc.data;
+    dvec3 expected = {0};
+    for (uint32_t i = 0; i < n; i++)
+    {
+        _transform_apply(&tr, pd[i], expected);
+        for (uint32_t j = 0; j < 3; j++)
+            AT(fabs(of[i][j] - expected[j]) < eps);
+
+        _transform_apply(&tr_merc, pd[i], expected);
+        AT(om[i][0] == expected[0]);
+        AT(om[i][1] == expected[1]);
+    }
+
+    dvz_array_destroy(&pos);
+    dvz_array_destroy(&out);
+    dvz_array_destroy(&out_merc);
+
+    return 0;
+}
+
+
+
 // int test_utils_transforms_5(TestContext* tc)
 // {
 //     DvzApp* app = dvz_app(DVZ_BACKEND_GLFW);
@@ -1271,3 +1500,609 @@ int test_utils_ticks_extend(TestContext* context)
 
     return 0;
 }
+
+
+
+int test_utils_ticks_worker(TestContext* context)
+{
+    DvzAxesContext ctx = {0};
+    ctx.coord = DVZ_AXES_COORD_X;
+    ctx.size_viewport = 1000;
+    ctx.size_glyph = 10;
+    ctx.extensions = 1;
+
+    DvzTicksWorker* worker = dvz_ticks_worker();
+
+    // The range is quantized to a tenth of its order of magnitude.
+    DvzTicksMemo key = _ticks_key((dvec2){-2.123, 2.456}, &ctx);
+    AC(key.range[0], -2.2, 1e-9);
+    AC(key.range[1], +2.5, 1e-9);
+    AT(dvz_ticks_memo_get(worker, &key) == NULL);
+
+    // Compute the ticks in the background.
+    dvz_ticks_submit(worker, &key, ctx);
+    AT(dvz_ticks_pending(worker, DVZ_AXES_COORD_X));
+    DvzTicksRequest* req = NULL;
+    for (uint32_t i = 0; i < 100 && req == NULL; i++)
+    {
+        dvz_sleep(10);
+        req = dvz_ticks_poll(worker);
+    }
+    AT(req != NULL);
+    AT(!dvz_ticks_pending(worker, DVZ_AXES_COORD_X));
+
+    // Same ticks as the synchronous computation.
+    DvzAxesTicks ticks = dvz_ticks(key.range[0], key.range[1], ctx);
+    AT(_ticks_equal(&req->memo.ticks, &ticks));
+    dvz_ticks_destroy(&ticks);
+
+    // The result has been memoized, and is reused for a close range.
+    DvzTicksMemo key_close = _ticks_key((dvec2){-2.15, 2.41}, &ctx);
+    DvzAxesTicks* memo = dvz_ticks_memo_get(worker, &key_close);
+    AT(memo != NULL);
+    AT(_ticks_equal(memo, &req->memo.ticks));
+    dvz_ticks_destroy(&req->memo.ticks);
+    FREE(req);
+
+    // Different viewport size.
+    ctx.size_viewport = 500;
+    key = _ticks_key((dvec2){-2.123, 2.456}, &ctx);
+    AT(dvz_ticks_memo_get(worker, &key) == NULL);
+
+    // Cancelled computation.
+    dvz_ticks_submit(worker, &key, ctx);
+    dvz_ticks_cancel(worker, DVZ_AXES_COORD_X);
+    AT(!dvz_ticks_pending(worker, DVZ_AXES_COORD_X));
+    dvz_sleep(50);
+    AT(dvz_ticks_poll(worker) == NULL);
+    AT(dvz_ticks_memo_get(worker, &key) == NULL);
+
+    dvz_ticks_worker_destroy(worker);
+    return 0;
+}
+
+
+
+/*************************************************************************************************/
+/* Octree tests                                                                                  */
+/*************************************************************************************************/
+
+int test_utils_octree(TestContext* tc)
+{
+    const uint32_t n = 100000;
+    const uint32_t capacity = 1000;
+
+    dvec3* pos = calloc(n, sizeof(dvec3));
+    for (uint32_t i = 0; i < n; i++)
+        for (uint32_t j = 0; j < 3; j++)
+            pos[i][j] = 10 + 5 * dvz_rand_float();
+
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/test_octree.bin", ARTIFACTS_DIR);
+    AT(dvz_octree_build(path, n, pos, NULL, capacity) == 0);
+    FREE(pos);
+
+    DvzOctree octree = dvz_octree_open(path);
+    AT(dvz_obj_is_created(&octree.obj));
+    AT(octree.header.point_count == n);
+    AT(octree.header.node_capacity == capacity);
+
+    // Every point is stored once, inside the cube of its node.
+    DvzVertex* vertices = calloc(capacity, sizeof(DvzVertex));
+    DvzOctreeNode* node = NULL;
+    uint64_t count = 0;
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < octree.header.node_count; i++)
+    {
+        node = &octree.nodes[i];
+        k = dvz_octree_load(&octree, i, vertices);
+        AT(k == node->point_count);
+        AT(k <= capacity);
+        for (uint32_t l = 0; l < k; l++)
+            for (uint32_t j = 0; j < 3; j++)
+                AT(fabs(vertices[l].pos[j] - node->center[j]) <= node->half_size + 1e-5);
+        count += k;
+    }
+    AT(count == n);
+    FREE(vertices);
+
+    // Budget of 10 nodes.
+    uint32_t slot_count = dvz_octree_budget(&octree, 10 * capacity);
+    AT(slot_count == 10);
+
+    // Identity MVP: the whole cube is visible, the root is selected first.
+    DvzMVP mvp = {0};
+    glm_mat4_identity(mvp.model);
+    glm_mat4_identity(mvp.view);
+    glm_mat4_identity(mvp.proj);
+    mvp.proj[2][2] = .5;
+    mvp.proj[3][2] = .5;
+    vec2 size = {800, 600};
+    AT(dvz_octree_select(&octree, &mvp, size) == slot_count);
+    AT(octree.selected[0] == 0);
+
+    // The nodes are loaded in several frames.
+    AT(dvz_octree_update(&octree) == DVZ_OCTREE_MAX_LOADS);
+    AT(octree.draws_changed);
+    AT(dvz_octree_update(&octree) == slot_count - DVZ_OCTREE_MAX_LOADS);
+    AT(dvz_octree_update(&octree) == 0);
+    AT(!octree.draws_changed);
+    VkDrawIndirectCommand* draws = dvz_octree_draws(&octree);
+    count = 0;
+    for (uint32_t i = 0; i < slot_count; i++)
+        count += draws[i].vertexCount;
+    AT(count == slot_count * capacity);
+
+    // Zoom out: only the root is selected, it is already resident.
+    mvp.view[0][0] = mvp.view[1][1] = mvp.view[2][2] = .01;
+    AT(dvz_octree_select(&octree, &mvp, size) == 1);
+    AT(dvz_octree_update(&octree) == 0);
+    AT(octree.draws_changed);
+    draws = dvz_octree_draws(&octree);
+    count = 0;
+    for (uint32_t i = 0; i < slot_count; i++)
+        count += draws[i].vertexCount;
+    AT(count == capacity);
+
+    // Move the cube out of the view.
+    mvp.view[3][0] = 10;
+    AT(dvz_octree_select(&octree, &mvp, size) == 0);
+
+    dvz_octree_destroy(&octree);
+    return 0;
+}
+
+
+
+/*************************************************************************************************/
+/* PSLG tests                                                                                    */
+/*************************************************************************************************/
+
+// Smallest angle of a triangle, in degrees.
+static double _triangle_min_angle(dvec2 a, dvec2 b, dvec2 c)
+{
+    double* p[3] = {a, b, c};
+    double angle = 180, u0 = 0, u1 = 0, v0 = 0, v1 = 0;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        u0 = p[(i + 1) % 3][0] - p[i][0];
+        u1 = p[(i + 1) % 3][1] - p[i][1];
+        v0 = p[(i + 2) % 3][0] - p[i][0];
+        v1 = p[(i + 2) % 3][1] - p[i][1];
+        angle = MIN(
+            angle, acos((u0 * v0 + u1 * v1) / sqrt((u0 * u0 + u1 * u1) * (v0 * v0 + v1 * v1))));
+    }
+    return angle * 180 / M_PI;
+}
+
+int test_utils_pslg(TestContext* tc)
+{
+    // A square with a square hole, a square without segments, and an invalid PSLG.
+    dvec2 points[] = {
+        {0, 0}, {1, 0}, {1, 1}, {0, 1}, {.4, .4}, {.6, .4}, {.6, .6}, {.4, .6}, //
+        {2, 0}, {3, 0}, {3, 1}, {2, 1},                                         //
+        {4, 0}, {5, 0}, {5, 1}};
+    uvec2 segments[] = {
+        {0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4}, //
+        {0, 3}};
+    dvec2 holes[] = {{.5, .5}};
+    uint32_t point_counts[] = {8, 4, 3};
+    uint32_t segment_counts[] = {8, 0, 1};
+
+    DvzPslgInput input = {0};
+    input.pslg_count = 3;
+    input.point_counts = point_counts;
+    input.segment_counts = segment_counts;
+    input.points = (const dvec2*)points;
+    input.segments = (const uvec2*)segments;
+    input.hole_count = 1;
+    input.holes = (const dvec2*)holes;
+    input.min_angle = 25;
+
+    char path[1024];
+    snprintf(
+        path, sizeof(path), "%s/dvz_pslg_%016" PRIx64 ".bin", ARTIFACTS_DIR, dvz_pslg_key(&input));
+    remove(path);
+
+    DvzPslgMesh mesh = dvz_pslg_triangulate(&input, ARTIFACTS_DIR);
+    AT(mesh.key == dvz_pslg_key(&input));
+    AT(mesh.pslg_count == 3);
+    AT(mesh.vertex_counts[0] >= 8);
+    AT(mesh.vertex_counts[1] >= 4);
+    AT(mesh.vertex_counts[2] == 0);
+    AT(mesh.index_count % 3 == 0);
+
+    // The points of each PSLG come first, then the Steiner points.
+    for (uint32_t i = 0; i < 8; i++)
+        AT(memcmp(mesh.vertices[i], points[i], sizeof(dvec2)) == 0);
+    for (uint32_t i = 0; i < 4; i++)
+        AT(memcmp(mesh.vertices[mesh.vertex_counts[0] + i], points[8 + i], sizeof(dvec2)) == 0);
+
+    // The triangles cover the squares except the hole, with the minimum angle.
+    double area = 0;
+    double *a = NULL, *b = NULL, *c = NULL;
+    for (uint32_t i = 0; i < mesh.index_count; i += 3)
+    {
+        AT(mesh.indices[i + 2] < mesh.vertex_count);
+        a = mesh.vertices[mesh.indices[i + 0]];
+        b = mesh.vertices[mesh.indices[i + 1]];
+        c = mesh.vertices[mesh.indices[i + 2]];
+        area += .5 * fabs((b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1]));
+        AT(_triangle_min_angle(a, b, c) >= 25 - 1e-3);
+    }
+    AT(fabs(area - (1 - .04 + 1)) < 1e-9);
+
+    // The triangulation is loaded from the disk cache.
+    FILE* f = fopen(path, "rb");
+    AT(f != NULL);
+    fclose(f);
+    DvzPslgMesh cached = dvz_pslg_triangulate(&input, ARTIFACTS_DIR);
+    AT(cached.vertex_count == mesh.vertex_count);
+    AT(cached.index_count == mesh.index_count);
+    AT(memcmp(cached.vertices, mesh.vertices, mesh.vertex_count * sizeof(dvec2)) == 0);
+    AT(memcmp(cached.indices, mesh.indices, mesh.index_count * sizeof(DvzIndex)) == 0);
+
+    dvz_pslg_destroy(&mesh);
+    dvz_pslg_destroy(&cached);
+    remove(path);
+    return 0;
+}
+
+
+
+int test_utils_pslg_degenerate(TestContext* tc)
+{
+    // A valid triangle, then degenerate PSLGs that would make Triangle exit the process:
+    // identical points, collinear points, and a zero-length segment between distinct points.
+    dvec2 points[] = {
+        {0, 0}, {1, 0}, {0, 1},         //
+        {2, 2}, {2, 2}, {2, 2},         //
+        {0, 0}, {1, 1}, {2, 2}, {3, 3}, //
+        {0, 0}, {1, 0}, {1, 1}, {1, 0}};
+    uvec2 segments[] = {
+        {0, 1}, {1, 2}, {2, 0}, //
+        {0, 1}, {1, 2}, {2, 3}, {1, 3}};
+    uint32_t point_counts[] = {3, 3, 4, 4};
+    uint32_t segment_counts[] = {3, 0, 0, 4};
+
+    DvzPslgInput input = {0};
+    input.pslg_count = 4;
+    input.point_counts = point_counts;
+    input.segment_counts = segment_counts;
+    input.points = (const dvec2*)points;
+    input.segments = (const uvec2*)segments;
+
+    char path[1024];
+    snprintf(
+        path, sizeof(path), "%s/dvz_pslg_%016" PRIx64 ".bin", ARTIFACTS_DIR, dvz_pslg_key(&input));
+    remove(path);
+
+    DvzPslgMesh mesh = dvz_pslg_triangulate(&input, ARTIFACTS_DIR);
+    AT(mesh.pslg_count == 4);
+    AT(mesh.vertex_counts[0] == 3);
+    AT(mesh.vertex_counts[1] == 0);
+    AT(mesh.vertex_counts[2] == 0);
+    AT(mesh.vertex_counts[3] == 0);
+    AT(mesh.vertex_count == 3);
+    AT(mesh.index_count == 3);
+
+    dvz_pslg_destroy(&mesh);
+    remove(path);
+    return 0;
+}
+
+
+
+/*************************************************************************************************/
+/* Mesh tests                                                                                    */
+/*************************************************************************************************/
+
+int test_utils_mesh_normals(TestContext* tc)
+{
+    // Enough faces for the parallel version on multi-core machines.
+    const uint32_t n = 300;
+    DvzMesh mesh = dvz_mesh_sphere(n, n);
+    uint32_t vertex_count = mesh.vertices.item_count;
+    uint32_t face_count = mesh.indices.item_count / 3;
+    DvzGraphicsMeshVertex* vertices = (DvzGraphicsMeshVertex*)mesh.vertices.data;
+    DvzIndex* indices = (DvzIndex*)mesh.indices.data;
+    AT(vertex_count == n * n);
+
+    // Reference: sum of the unit face normals, computed serially.
+    vec3* expected = calloc(vertex_count, sizeof(vec3));
+    vec3 u = {0}, v = {0}, normal = {0};
+    for (uint32_t i = 0; i < face_count; i++)
+    {
+        DvzIndex* face = &indices[3 * i];
+        glm_vec3_sub(vertices[face[1]].pos, vertices[face[0]].pos, u);
+        glm_vec3_sub(vertices[face[2]].pos, vertices[face[0]].pos, v);
+        glm_vec3_crossn(u, v, normal);
+        for (uint32_t j = 0; j < 3; j++)
+            glm_vec3_add(expected[face[j]], normal, expected[face[j]]);
+    }
+    for (uint32_t i = 0; i < vertex_count; i++)
+        glm_vec3_normalize(expected[i]);
+
+    for (uint32_t i = 0; i < vertex_count; i++)
+        glm_vec3_zero(vertices[i].normal);
+    dvz_mesh_normals(&mesh);
+    for (uint32_t i = 0; i < vertex_count; i++)
+        for (uint32_t j = 0; j < 3; j++)
+            AT(fabs(vertices[i].normal[j] - expected[i][j]) < 1e-5);
+
+    // Away from the poles and the seam, all weights give the radial direction.
+    for (DvzMeshNormalsWeight weight = DVZ_MESH_NORMALS_UNIFORM; weight <= DVZ_MESH_NORMALS_ANGLE;
+         weight++)
+    {
+        dvz_mesh_normals_weighted(&mesh, weight);
+        for (uint32_t i = 1; i < n - 1; i++)
+        {
+            for (uint32_t j = 1; j < n - 1; j++)
+            {
+                DvzGraphicsMeshVertex* vertex = &vertices[n * i + j];
+                AT(fabs(glm_vec3_norm(vertex->normal) - 1) < 1e-5);
+                glm_vec3_normalize_to(vertex->pos, normal);
+                AT(fabs(glm_vec3_dot(vertex->normal, normal)) > .999);
+            }
+        }
+    }
+
+    FREE(expected);
+    dvz_mesh_destroy(&mesh);
+    return 0;
+}
+
+
+
+int test_utils_mesh_obj(TestContext* tc)
+{
+    // Grid of quads, larger than an OBJ parsing block, with the different face formats.
+    const uint32_t n = 300;
+    char obj_path[1024] = {0};
+    snprintf(obj_path, sizeof(obj_path), "%s/test_mesh.obj", ARTIFACTS_DIR);
+    FILE* f = fopen(obj_path, "w");
+    AT(f != NULL);
+    fprintf(f, "# grid\r\ng grid\n");
+    for (uint32_t i = 0; i < n; i++)
+        for (uint32_t j = 0; j < n; j++)
+            fprintf(f, "v %.6f %.6f %.6e\n", (float)i / n, (float)j / n, -1e-3 * (i + j));
+    for (uint32_t i = 0; i < n * n; i++)
+        fprintf(f, "vt %f %f\n", .25, .5);
+    uint32_t a = 0, b = 0, c = 0, d = 0;
+    for (uint32_t i = 0; i < n - 1; i++)
+    {
+        for (uint32_t j = 0; j < n - 1; j++)
+        {
+            a = n * i + j + 1, b = a + 1, c = a + n + 1, d = a + n;
+            if ((i + j) % 3 == 0)
+                fprintf(f, "f %u/%u %u/%u %u/%u %u/%u\n", a, a, b, b, c, c, d, d);
+            else if ((i + j) % 3 == 1)
+                fprintf(f, "f %u//%u %u//%u %u//%u\t%u//%u\n", a, a, b, b, c, c, d, d);
+            else
+                fprintf(f, "f %u %u %u %u\n", a, b, c, d);
+        }
+    }
+    // Negative indices are relative to the last vertex.
+    fprintf(f, "v 1 2 3\nv 4 5 6\nv 7 8 9\nf -3 -2 -1\n# end");
+    fclose(f);
+
+    // Parsing, with fan triangulation of the quads.
+    DvzMesh mesh = dvz_mesh_obj_parse(obj_path);
+    uint32_t face_count = 2 * (n - 1) * (n - 1) + 1;
+    AT(mesh.vertices.item_count == n * n + 3);
+    AT(mesh.indices.item_count == 3 * face_count);
+    DvzGraphicsMeshVertex* vertices = (DvzGraphicsMeshVertex*)mesh.vertices.data;
+    DvzIndex* indices = (DvzIndex*)mesh.indices.data;
+    DvzIndex* face = NULL;
+    for (uint32_t i = 0; i < n - 1; i++)
+    {
+        for (uint32_t j = 0; j < n - 1; j++)
+        {
+            a = n * i + j, b = a + 1, c = a + n + 1, d = a + n;
+            face = &indices[6 * ((n - 1) * i + j)];
+            AT(face[0] == a && face[1] == b && face[2] == c);
+            AT(face[3] == a && face[4] == c && face[5] == d);
+            AT(vertices[a].uv[0] == .25 && vertices[a].uv[1] == .5);
+            AT(vertices[a].alpha == 255);
+        }
+    }
+    face = &indices[3 * (face_count - 1)];
+    AT(face[0] == n * n && face[1] == n * n + 1 && face[2] == n * n + 2);
+
+    // First import: the mesh file is written to the cache, then mapped.
+    DvzMeshFile file = dvz_mesh_obj_file(obj_path, ARTIFACTS_DIR, 0);
+    AT(file.header != NULL);
+    AT(file.header->magic == DVZ_MESH_FILE_MAGIC);
+    AT(file.header->vertex_count == mesh.vertices.item_count);
+    AT(file.header->index_count == mesh.indices.item_count);
+    AT(file.header->chunk_count == (face_count + DVZ_MESH_FILE_CHUNK - 1) / DVZ_MESH_FILE_CHUNK);
+    AT(file.header->vertex_offset % DVZ_MESH_FILE_ALIGNMENT == 0);
+    AT(file.header->index_offset % DVZ_MESH_FILE_ALIGNMENT == 0);
+    AT(memcmp(file.vertices, vertices, mesh.vertices.buffer_size) == 0);
+    AT(memcmp(file.indices, indices, mesh.indices.buffer_size) == 0);
+
+    // The chunk bounds contain the vertices of their faces.
+    const DvzMeshChunk* chunk = NULL;
+    float x = 0;
+    for (uint32_t i = 0; i < mesh.indices.item_count; i++)
+    {
+        chunk = &file.chunks[i / 3 / file.header->chunk_size];
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            x = vertices[indices[i]].pos[j];
+            AT(chunk->box_min[j] <= x && x <= chunk->box_max[j]);
+        }
+    }
+
+    // Subsequent imports: the mesh file is mapped without parsing the OBJ file.
+    DvzMeshFile cached = dvz_mesh_obj_file(obj_path, ARTIFACTS_DIR, 0);
+    AT(cached.header != NULL);
+    AT(cached.header->key == file.header->key);
+    DvzMesh copy = dvz_mesh_file_mesh(&cached);
+    AT(copy.vertices.item_count == mesh.vertices.item_count);
+    AT(memcmp(copy.vertices.data, vertices, mesh.vertices.buffer_size) == 0);
+    AT(memcmp(copy.indices.data, indices, mesh.indices.buffer_size) == 0);
+
+    // Quantized mesh file.
+    DvzMeshFile quantized =
+        dvz_mesh_obj_file(obj_path, ARTIFACTS_DIR, DVZ_MESH_FILE_FLAGS_QUANTIZED);
+    AT(quantized.header != NULL);
+    AT(quantized.header->key != file.header->key);
+    AT(quantized.header->vertex_size == sizeof(DvzGraphicsMeshQuantizedVertex));
+    AT(memcmp(quantized.indices, indices, mesh.indices.buffer_size) == 0);
+
+    // A modified OBJ file with the same size, but a newer modification time, is parsed again:
+    // the mesh file of the previous version is not used anymore.
+    struct stat st = {0};
+    AT(stat(obj_path, &st) == 0);
+    f = fopen(obj_path, "r+b");
+    AT(f != NULL);
+    const char* tail = "v 1 2 3\nv 4 5 6\nv 7 8 9\nf -3 -2 -1\n# end";
+    fseek(f, -(long)strlen(tail) + 2, SEEK_END);
+    fputc('9', f); // v 1 2 3 => v 9 2 3
+    fclose(f);
+    struct utimbuf times = {st.st_atime, st.st_mtime + 10};
+    AT(utime(obj_path, &times) == 0);
+    DvzMeshFile updated = dvz_mesh_obj_file(obj_path, ARTIFACTS_DIR, 0);
+    AT(updated.header != NULL);
+    AT(updated.header->key != file.header->key);
+    AT(updated.header->vertex_count == file.header->vertex_count);
+    AT(memcmp(updated.indices, indices, mesh.indices.buffer_size) == 0);
+    AT(memcmp(updated.vertices, vertices, mesh.vertices.buffer_size) != 0);
+
+    char path[1024] = {0};
+    char quantized_path[1024] = {0};
+    char updated_path[1024] = {0};
+    dvz_cache_path(ARTIFACTS_DIR, "mesh", file.header->key, path, sizeof(path));
+    dvz_cache_path(
+        ARTIFACTS_DIR, "mesh", quantized.header->key, quantized_path, sizeof(quantized_path));
+    dvz_cache_path(
+        ARTIFACTS_DIR, "mesh", updated.header->key, updated_path, sizeof(updated_path));
+    DvzMeshFileHeader header = *file.header;
+    dvz_mesh_file_close(&file);
+    dvz_mesh_file_close(&cached);
+    dvz_mesh_file_close(&quantized);
+    dvz_mesh_file_close(&updated);
+    AT(file.header == NULL);
+
+    // A truncated mesh file is rejected.
+    f = fopen(path, "wb");
+    AT(f != NULL);
+    fwrite(&header, sizeof(header), 1, f);
+    fclose(f);
+    file = dvz_mesh_file(path);
+    AT(file.header == NULL);
+
+    dvz_mesh_destroy(&mesh);
+    dvz_mesh_destroy(&copy);
+    remove(path);
+    remove(quantized_path);
+    remove(updated_path);
+    remove(obj_path);
+    return 0;
+}
+
+
+
+int test_utils_mesh_obj_parity(TestContext* tc)
+{
+    // Cube, the corners are in the order of the bits of their index (x, y, z), the normalization
+    // of the mesh leaves them unchanged.
+    vec3 corners[8] = {0};
+    for (uint32_t i = 0; i < 8; i++)
+        for (uint32_t j = 0; j < 3; j++)
+            corners[i][j] = (i >> j) & 1 ? 1 : -1;
+
+    // OBJ file with the features of the former tinyobjloader-based loader: comments and blank
+    // lines, normals and tex coords, the v, v/vt, v//vn and v/vt/vn face formats, negative
+    // indices, and polygons, triangulated as fans.
+    char obj_path[1024] = {0};
+    snprintf(obj_path, sizeof(obj_path), "%s/test_mesh_parity.obj", ARTIFACTS_DIR);
+    FILE* f = fopen(obj_path, "wb");
+    AT(f != NULL);
+    fprintf(f, "# cube\n\n   # indented comment\r\nmtllib cube.mtl\no cube\n");
+    for (uint32_t i = 0; i < 8; i++)
+        fprintf(f, "v %g %g %g\n", corners[i][0], corners[i][1], corners[i][2]);
+    fprintf(f, "\n");
+    for (uint32_t i = 0; i < 8; i++)
+        fprintf(f, "vn %g %g %g\n", .25 * i, -.5, 1.);
+    for (uint32_t i = 0; i < 8; i++)
+        fprintf(f, "vt %g %g\n", .125 * i, 1 - .125 * i);
+    fprintf(f, "s off\nusemtl red\n");
+    fprintf(f, "f 1/1/1 2/2/2 3/3/3 # triangle\n");
+    fprintf(f, "f 5//5 6//6 7//7 8//8\n");
+    fprintf(f, "f 1/1 2/2 6/6 7/7 3/3\n\n");
+    fprintf(f, "f -8/-8/-8 -7//-7 -4\n");
+    fprintf(f, "\tf\t4 3 7\r\n");
+    fclose(f);
+
+    DvzMesh mesh = dvz_mesh_obj_parse(obj_path);
+    DvzIndex expected[] = {
+        0, 1, 2,                         // triangle
+        4, 5, 6, 4, 6, 7,                // quad
+        0, 1, 5, 0, 5, 6, 0, 6, 2,       // pentagon
+        0, 1, 4,                         // negative indices
+        3, 2, 6,                         // tabs
+    };
+    AT(mesh.vertices.item_count == 8);
+    AT(mesh.indices.item_count == sizeof(expected) / sizeof(DvzIndex));
+    AT(memcmp(mesh.indices.data, expected, sizeof(expected)) == 0);
+    DvzGraphicsMeshVertex* vertices = (DvzGraphicsMeshVertex*)mesh.vertices.data;
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        AT(memcmp(vertices[i].pos, corners[i], sizeof(vec3)) == 0);
+        AT(vertices[i].normal[0] == .25f * i);
+        AT(vertices[i].normal[1] == -.5f);
+        AT(vertices[i].normal[2] == 1);
+        AT(vertices[i].uv[0] == .125f * i);
+        AT(vertices[i].uv[1] == 1 - .125f * i);
+        AT(vertices[i].alpha == 255);
+    }
+    dvz_mesh_destroy(&mesh);
+
+    // Vertex colors, without tex coords, and without normals: the normals are computed.
+    f = fopen(obj_path, "wb");
+    AT(f != NULL);
+    for (uint32_t i = 0; i < 8; i++)
+        fprintf(
+            f, "v %g %g %g %d %d %d\n", corners[i][0], corners[i][1], corners[i][2], i & 1,
+            (i >> 1) & 1, (i >> 2) & 1);
+    fprintf(f, "f 1 3 4 2\nf 5 6 8 7\nf 1 2 6 5\nf 3 7 8 4\nf 1 5 7 3\nf 2 4 8 6\n");
+    fclose(f);
+
+    mesh = dvz_mesh_obj_parse(obj_path);
+    AT(mesh.vertices.item_count == 8);
+    AT(mesh.indices.item_count == 36);
+    vertices = (DvzGraphicsMeshVertex*)mesh.vertices.data;
+    cvec3 color = {0};
+    vec2 uv = {0};
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        for (uint32_t j = 0; j < 3; j++)
+            color[j] = (i >> j) & 1 ? 255 : 0;
+        dvz_colormap_packuv(color, uv);
+        AT(memcmp(vertices[i].uv, uv, sizeof(vec2)) == 0);
+
+        // The normals point outwards.
+        AT(fabs(glm_vec3_norm(vertices[i].normal) - 1) < 1e-5);
+        AT(glm_vec3_dot(vertices[i].normal, vertices[i].pos) > 0);
+    }
+    dvz_mesh_destroy(&mesh);
+
+    // A position with missing coordinates does not get the coordinates of the previous one.
+    f = fopen(obj_path, "wb");
+    AT(f != NULL);
+    fprintf(f, "v -1 -1 -1\nv 1 1\nv 1 -1 1\nv -1 1 0\nf 1 2 3\nf 1 3 4\n");
+    fclose(f);
+
+    mesh = dvz_mesh_obj_parse(obj_path);
+    AT(mesh.vertices.item_count == 4);
+    vertices = (DvzGraphicsMeshVertex*)mesh.vertices.data;
+    AT(vertices[1].pos[0] == 1);
+    AT(vertices[1].pos[1] == 1);
+    AT(vertices[1].pos[2] == 0);
+    dvz_mesh_destroy(&mesh);
+
+    remove(obj_path);
+    return 0;
+}
@@ -129,6 +129,20 @@ int test_vislib_point(TestContext* tc)
     return _visual_run(&visual, "point");
 }
 
+int test_vislib_point_quantized(TestContext* tc)
+{
+    DvzCanvas* canvas = tc->canvas;
+    ASSERT(canvas != NULL);
+
+    // Make visual.
+    DvzVisual visual = dvz_visual(canvas);
+    dvz_visual_builtin(&visual, DVZ_VISUAL_POINT, DVZ_POINT_FLAGS_QUANTIZED);
+    _visual_common(&visual);
+    _point_data(&visual, 50);
+
+    return _visual_run(&visual, "point_quantized");
+}
+
 
 
 int test_vislib_line_list(TestContext* tc)
@@ -438,14 +452,13 @@ int test_vislib_rectangle(TestContext* tc)
 /*  2D visuals tests                                                                             */
 /*************************************************************************************************/
 
-int test_vislib_marker(TestContext* tc)
+static int _marker_run(DvzCanvas* canvas, int flags, const char* name)
 {
-    DvzCanvas* canvas = tc->canvas;
     ASSERT(canvas != NULL);
 
     // Make visual.
     DvzVisual visual = dvz_visual(canvas);
-    dvz_visual_builtin(&visual, DVZ_VISUAL_MARKER, 0);
+    dvz_visual_builtin(&visual, DVZ_VISUAL_MARKER, flags);
     _visual_common(&visual);
 
     // Create visual data.
@@ -501,7 +514,204 @@ int test_vislib_marker(TestContext* tc)
     dvz_visual_data(&visual, DVZ_PROP_LINE_WIDTH, 0, 1, (float[]){2});
     dvz_visual_data(&visual, DVZ_PROP_COLOR, 1, 1, (vec4){1, 1, 1, 1});
 
-    return _visual_run(&visual, "marker");
+    return _visual_run(&visual, name);
+}
+
+int test_vislib_marker(TestContext* tc)
+{
+    return _marker_run(tc->canvas, 0, "marker");
+}
+
+int test_vislib_marker_instanced(TestContext* tc)
+{
+    return _marker_run(tc->canvas, DVZ_MARKER_FLAGS_INSTANCED, "marker_instanced");
+}
+
+int test_vislib_marker_split_color(TestContext* tc)
+{
+    DvzCanvas* canvas = tc->canvas;
+    ASSERT(canvas != NULL);
+
+    DvzVisual visual = dvz_visual(canvas);
+    dvz_visual_builtin(&visual, DVZ_VISUAL_MARKER, DVZ_GRAPHICS_FLAGS_SPLIT_COLOR);
+    _visual_common(&visual);
+
+    const uint32_t n_side = 20, n = n_side * n_side;
+    dvec3* pos = calloc(n, sizeof(dvec3));
+    cvec4* color = calloc(n, sizeof(cvec4));
+    for (uint32_t i = 0; i < n; i++)
+    {
+        pos[i][0] = .9 * (-1 + 2 * (i % n_side) / (double)(n_side - 1));
+        pos[i][1] = .9 * (-1 + 2 * (i / n_side) / (double)(n_side - 1));
+        dvz_colormap_scale(DVZ_CMAP_HSV, i, 0, n, color[i]);
+    }
+    dvz_visual_data(&visual, DVZ_PROP_POS, 0, n, pos);
+    dvz_visual_data(&visual, DVZ_PROP_COLOR, 0, n, color);
+    dvz_visual_data(&visual, DVZ_PROP_MARKER_SIZE, 0, 1, (float[]){15});
+    dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+
+    // The colors are stored in their own vertex buffer, with one color per marker.
+    DvzArray* arr_vertex = &dvz_source_get(&visual, DVZ_SOURCE_TYPE_VERTEX, 0)->arr;
+    DvzArray* arr_color = &dvz_source_get(&visual, DVZ_SOURCE_TYPE_VERTEX, 1)->arr;
+    AT(arr_vertex->item_count == n);
+    AT(arr_color->item_count == n);
+    AT(arr_color->item_size == sizeof(cvec4));
+    AT(memcmp(arr_color->data, color, n * sizeof(cvec4)) == 0);
+
+    // Changing the colors does not touch the main vertex buffer.
+    DvzGraphicsMarkerVertex* vertices = (DvzGraphicsMarkerVertex*)arr_vertex->data;
+    vertices[0].size = -1;
+    for (uint32_t i = 0; i < n; i++)
+        dvz_colormap_scale(DVZ_CMAP_VIRIDIS, i, 0, n, color[i]);
+    dvz_visual_data(&visual, DVZ_PROP_COLOR, 0, n, color);
+    dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+    AT(((DvzGraphicsMarkerVertex*)arr_vertex->data)[0].size == -1);
+    AT(memcmp(arr_color->data, color, n * sizeof(cvec4)) == 0);
+
+    // Restore the marker size before rendering.
+    dvz_visual_data(&visual, DVZ_PROP_MARKER_SIZE, 0, 1, (float[]){15});
+
+    FREE(pos);
+    FREE(color);
+    return _visual_run(&visual, "marker_split_color");
+}
+
+int test_vislib_marker_scalar_color(TestContext* tc)
+{
+    DvzCanvas* canvas = tc->canvas;
+    ASSERT(canvas != NULL);
+
+    DvzVisual visual = dvz_visual(canvas);
+    dvz_visual_builtin(&visual, DVZ_VISUAL_MARKER, DVZ_GRAPHICS_FLAGS_SCALAR_COLOR);
+    _visual_common(&visual);
+
+    const uint32_t n_side = 20, n = n_side * n_side;
+    dvec3* pos = calloc(n, sizeof(dvec3));
+    float* values = calloc(n, sizeof(float));
+    for (uint32_t i = 0; i < n; i++)
+    {
+        pos[i][0] = .9 * (-1 + 2 * (i % n_side) / (double)(n_side - 1));
+        pos[i][1] = .9 * (-1 + 2 * (i / n_side) / (double)(n_side - 1));
+        values[i] = i;
+    }
+    dvz_visual_data(&visual, DVZ_PROP_POS, 0, n, pos);
+    dvz_visual_data(&visual, DVZ_PROP_COLOR, 0, n, values);
+    dvz_visual_data(&visual, DVZ_PROP_MARKER_SIZE, 0, 1, (float[]){15});
+    dvz_visual_data(&visual, DVZ_PROP_RANGE, 0, 1, (vec2){0, n});
+    dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+
+    // The scalar values are stored in their own vertex buffer, with one float per marker.
+    DvzArray* arr_vertex = &dvz_source_get(&visual, DVZ_SOURCE_TYPE_VERTEX, 0)->arr;
+    DvzArray* arr_value = &dvz_source_get(&visual, DVZ_SOURCE_TYPE_VERTEX, 1)->arr;
+    DvzArray* arr_params = &dvz_source_get(&visual, DVZ_SOURCE_TYPE_PARAM, 1)->arr;
+    AT(arr_value->item_count == n);
+    AT(arr_value->item_size == sizeof(float));
+    AT(memcmp(arr_value->data, values, n * sizeof(float)) == 0);
+
+    DvzGraphicsColormapParams* params = (DvzGraphicsColormapParams*)arr_params->data;
+    AT(params->vrange[1] == n);
+    AT(params->cmap == DVZ_CMAP_VIRIDIS);
+
+    // Changing the colormap only updates the colormap params.
+    DvzGraphicsMarkerVertex* vertices = (DvzGraphicsMarkerVertex*)arr_vertex->data;
+    vertices[0].size = -1;
+    ((float*)arr_value->data)[0] = -1;
+    dvz_visual_data(&visual, DVZ_PROP_COLORMAP, 0, 1, (int32_t[]){DVZ_CMAP_HSV});
+    dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+    params = (DvzGraphicsColormapParams*)arr_params->data;
+    AT(params->cmap == DVZ_CMAP_HSV);
+    AT(((DvzGraphicsMarkerVertex*)arr_vertex->data)[0].size == -1);
+    AT(((float*)arr_value->data)[0] == -1);
+
+    // Restore the data before rendering.
+    dvz_visual_data(&visual, DVZ_PROP_MARKER_SIZE, 0, 1, (float[]){15});
+    dvz_visual_data(&visual, DVZ_PROP_COLOR, 0, n, values);
+
+    FREE(pos);
+    FREE(values);
+    return _visual_run(&visual, "marker_scalar_color");
+}
+
+
+
+static int _segment_run(DvzCanvas* canvas, int flags, const char* name)
+{
+    ASSERT(canvas != NULL);
+
+    DvzVisual visual = dvz_visual(canvas);
+    dvz_visual_builtin(&visual, DVZ_VISUAL_SEGMENT, flags);
+    _visual_common(&visual);
+
+    const uint32_t n = 16;
+    dvec3* p0 = calloc(n, sizeof(dvec3));
+    dvec3* p1 = calloc(n, sizeof(dvec3));
+    cvec4* color = calloc(n, sizeof(cvec4));
+    float* linewidth = calloc(n, sizeof(float));
+    int32_t* cap = calloc(n, sizeof(int32_t));
+    double t = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        t = i / (double)(n - 1);
+        p0[i][0] = p1[i][0] = .9 * (-1 + 2 * t);
+        p0[i][1] = .9;
+        p1[i][1] = -.9;
+        dvz_colormap_scale(DVZ_CMAP_HSV, t, 0, 1, color[i]);
+        linewidth[i] = 5 + 30 * t;
+        cap[i] = (int32_t)(i % DVZ_CAP_COUNT);
+    }
+    dvz_visual_data(&visual, DVZ_PROP_POS, 0, n, p0);
+    dvz_visual_data(&visual, DVZ_PROP_POS, 1, n, p1);
+    dvz_visual_data(&visual, DVZ_PROP_COLOR, 0, n, color);
+    dvz_visual_data(&visual, DVZ_PROP_LINE_WIDTH, 0, n, linewidth);
+    dvz_visual_data(&visual, DVZ_PROP_CAP_TYPE, 0, n, cap);
+    dvz_visual_data(&visual, DVZ_PROP_CAP_TYPE, 1, n, cap);
+    dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+
+    // With vertex pulling, the segments are stored once in the vertex buffer, without indices.
+    // Otherwise, each segment is repeated for its 4 vertices, with 6 indices.
+    DvzArray* arr_vertex = &dvz_source_get(&visual, DVZ_SOURCE_TYPE_VERTEX, 0)->arr;
+    DvzSource* src_index = dvz_source_get(&visual, DVZ_SOURCE_TYPE_INDEX, 0);
+    if ((flags & DVZ_SEGMENT_FLAGS_VERTEX_PULLING) != 0)
+    {
+        AT(src_index == NULL);
+        AT(arr_vertex->item_count == n);
+        AT(arr_vertex->item_size == sizeof(DvzGraphicsSegmentPullVertex));
+        DvzGraphicsSegmentPullVertex* vertex = dvz_array_item(arr_vertex, 3);
+        AT(vertex->P0[0] == (float)p0[3][0]);
+        AT(vertex->P1[1] == (float)p1[3][1]);
+        AT(memcmp(vertex->color, color[3], sizeof(cvec4)) == 0);
+        AT(vertex->cap0 == cap[3]);
+        AT(vertex->cap1 == cap[3]);
+    }
+    else
+    {
+        AT(src_index != NULL);
+        AT(arr_vertex->item_count == 4 * n);
+        AT(src_index->arr.item_count == 6 * n);
+        DvzGraphicsSegmentVertex* vertex = dvz_array_item(arr_vertex, 4 * 3 + 2);
+        AT(vertex->P0[0] == (float)p0[3][0]);
+        AT(vertex->P1[1] == (float)p1[3][1]);
+        AT(memcmp(vertex->color, color[3], sizeof(cvec4)) == 0);
+        AT(vertex->cap0 == (DvzCapType)cap[3]);
+        AT(vertex->cap1 == (DvzCapType)cap[3]);
+    }
+
+    FREE(p0);
+    FREE(p1);
+    FREE(color);
+    FREE(linewidth);
+    FREE(cap);
+    return _visual_run(&visual, name);
+}
+
+int test_vislib_segment(TestContext* tc)
+{
+    return _segment_run(tc->canvas, 0, "segment");
+}
+
+int test_vislib_segment_pull(TestContext* tc)
+{
+    return _segment_run(tc->canvas, DVZ_SEGMENT_FLAGS_VERTEX_PULLING, "segment_pull");
 }
 
 
@@ -556,16 +766,142 @@ int test_vislib_polygon(TestContext* tc)
     return _visual_run(&visual, "polygon");
 }
 
+int test_vislib_polygon_cache(TestContext* tc)
+{
+    DvzCanvas* canvas = tc->canvas;
+    ASSERT(canvas != NULL);
 
+    DvzVisual visual = dvz_visual(canvas);
+    dvz_visual_builtin(&visual, DVZ_VISUAL_POLYGON, 0);
+    _visual_common(&visual);
 
-int test_vislib_path(TestContext* tc)
+    // Many small polygons, triangulated in parallel.
+    const uint32_t n = 8, n_side = 64, n_polys = 64 * 64;
+    dvec3* points = calloc(n * n_polys, sizeof(dvec3));
+    uint32_t* poly_lengths = calloc(n_polys, sizeof(uint32_t));
+    cvec4* color = calloc(n_polys, sizeof(cvec4));
+    for (uint32_t i = 0; i < n_polys; i++)
+    {
+        _add_polygon(
+            points + n * i, n, 0,
+            (dvec3){-1 + (2 * (i % n_side) + 1.) / n_side, -1 + (2 * (i / n_side) + 1.) / n_side},
+            1);
+        poly_lengths[i] = n;
+        dvz_colormap(DVZ_CPAL256_GLASBEY, i % 256, color[i]);
+    }
+    dvz_visual_data(&visual, DVZ_PROP_POS, 0, n * n_polys, points);
+    dvz_visual_data(&visual, DVZ_PROP_LENGTH, 0, n_polys, poly_lengths);
+    dvz_visual_data(&visual, DVZ_PROP_COLOR, 0, n_polys, color);
+    dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+
+    // The triangulations are concatenated in the order of the polygons.
+    DvzArray* arr_index = &dvz_source_get(&visual, DVZ_SOURCE_TYPE_INDEX, 0)->arr;
+    uint32_t index_count = arr_index->item_count;
+    DvzIndex* indices = (DvzIndex*)arr_index->data;
+    AT(index_count > 0);
+    AT(index_count % 3 == 0);
+    uint32_t poly = 0;
+    for (uint32_t i = 0; i < index_count; i += 3)
+    {
+        AT(indices[i] / n >= poly);
+        poly = indices[i] / n;
+        AT(indices[i + 1] / n == poly);
+        AT(indices[i + 2] / n == poly);
+    }
+    AT(poly == n_polys - 1);
+
+    // Changing the colors only does not triangulate the polygons again.
+    uint64_t key = visual.polygon_key;
+    DvzIndex first = indices[0];
+    indices[0] = UINT32_MAX;
+    dvz_colormap(DVZ_CPAL256_GLASBEY, 42, color[0]);
+    dvz_visual_data(&visual, DVZ_PROP_COLOR, 0, n_polys, color);
+    dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+    AT(visual.polygon_key == key);
+    AT(((DvzIndex*)arr_index->data)[0] == UINT32_MAX);
+
+    // Changing the positions does.
+    points[0][0] += .01;
+    dvz_visual_data(&visual, DVZ_PROP_POS, 0, n * n_polys, points);
+    dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+    AT(visual.polygon_key != key);
+    AT(((DvzIndex*)arr_index->data)[0] == first);
+
+    FREE(points);
+    FREE(poly_lengths);
+    FREE(color);
+    dvz_visual_destroy(&visual);
+    return 0;
+}
+
+int test_vislib_pslg(TestContext* tc)
 {
     DvzCanvas* canvas = tc->canvas;
     ASSERT(canvas != NULL);
 
     // Make visual.
     DvzVisual visual = dvz_visual(canvas);
-    dvz_visual_builtin(&visual, DVZ_VISUAL_PATH, 0);
+    dvz_visual_builtin(&visual, DVZ_VISUAL_PSLG, 0);
+    _visual_common(&visual);
+
+    // A ring on the left, a star on the right.
+    const uint32_t n0 = 64, n1 = 32, n2 = 10;
+    double aspect = dvz_canvas_aspect(canvas);
+    dvec3 points[64 + 32 + 10] = {0};
+    uvec2 segments[64 + 32 + 10] = {0};
+    double r = 0, a = 0;
+    for (uint32_t i = 0; i < n0 + n1 + n2; i++)
+    {
+        if (i < n0 + n1)
+        {
+            // Outer and inner circles of the ring.
+            r = i < n0 ? .5 : .2;
+            a = M_2PI * (i < n0 ? i : i - n0) / (i < n0 ? n0 : n1);
+            points[i][0] = -.5 + r * cos(a);
+            points[i][1] = aspect * r * sin(a);
+            segments[i][0] = i;
+            segments[i][1] = i < n0 ? (i + 1) % n0 : n0 + (i - n0 + 1) % n1;
+        }
+        else
+        {
+            r = (i - n0 - n1) % 2 == 0 ? .4 : .15;
+            a = M_PI / 2 + M_2PI * (i - n0 - n1) / n2;
+            points[i][0] = +.5 + r * cos(a);
+            points[i][1] = aspect * r * sin(a);
+            segments[i][0] = i - n0 - n1;
+            segments[i][1] = (i - n0 - n1 + 1) % n2;
+        }
+    }
+    dvec3 hole = {-.5, 0, 0};
+
+    uint32_t point_counts[2] = {n0 + n1, n2};
+    uint32_t segment_counts[2] = {n0 + n1, n2};
+
+    cvec4 color[2] = {0};
+    dvz_colormap(DVZ_CPAL256_GLASBEY, 0, color[0]);
+    dvz_colormap(DVZ_CPAL256_GLASBEY, 1, color[1]);
+
+    // Set visual data.
+    dvz_visual_data(&visual, DVZ_PROP_POS, 0, n0 + n1 + n2, points);
+    dvz_visual_data(&visual, DVZ_PROP_POS, 1, 1, hole);
+    dvz_visual_data(&visual, DVZ_PROP_INDEX, 0, n0 + n1 + n2, segments);
+    dvz_visual_data(&visual, DVZ_PROP_LENGTH, 0, 2, point_counts);
+    dvz_visual_data(&visual, DVZ_PROP_LENGTH, 1, 2, segment_counts);
+    dvz_visual_data(&visual, DVZ_PROP_COLOR, 0, 2, color);
+
+    return _visual_run(&visual, "pslg");
+}
+
+
+
+
+static int _path_run(DvzCanvas* canvas, int flags, const char* name)
+{
+    ASSERT(canvas != NULL);
+
+    // Make visual.
+    DvzVisual visual = dvz_visual(canvas);
+    dvz_visual_builtin(&visual, DVZ_VISUAL_PATH, flags);
     _visual_common(&visual);
 
     // Set paths.
@@ -625,19 +961,69 @@ int test_vislib_path(TestContext* tc)
     dvz_visual_data(&visual, DVZ_PROP_MITER_LIMIT, 0, 1, (float[]){4});
     dvz_visual_data(&visual, DVZ_PROP_JOIN_TYPE, 0, 1, (int32_t[]){DVZ_JOIN_ROUND});
 
-    return _visual_run(&visual, "path");
+    return _visual_run(&visual, name);
+}
+
+int test_vislib_path(TestContext* tc)
+{
+    return _path_run(tc->canvas, 0, "path");
+}
+
+int test_vislib_path_pull(TestContext* tc)
+{
+    return _path_run(tc->canvas, DVZ_PATH_FLAGS_VERTEX_PULLING, "path_pull");
 }
 
 
 
-int test_vislib_text(TestContext* tc)
+int test_vislib_stream(TestContext* tc)
 {
     DvzCanvas* canvas = tc->canvas;
     ASSERT(canvas != NULL);
 
     // Make visual.
     DvzVisual visual = dvz_visual(canvas);
-    dvz_visual_builtin(&visual, DVZ_VISUAL_TEXT, 0);
+    dvz_visual_builtin(&visual, DVZ_VISUAL_STREAM, 0);
+    _visual_common(&visual);
+
+    // Ring buffer with 1000 samples per channel.
+    const uint32_t n_channels = 8;
+    const uint32_t n_samples = 1000;
+    const uint32_t chunk = 100;
+    dvz_visual_ring(&visual, DVZ_SOURCE_TYPE_VERTEX, 0, n_channels * n_samples);
+    DvzSource* source = dvz_source_get(&visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+
+    dvz_visual_data(&visual, DVZ_PROP_LENGTH, 0, 1, (uint32_t[]){n_channels});
+    dvz_visual_data(&visual, DVZ_PROP_SCALE, 0, 1, (float[]){.1});
+
+    // Append 15 chunks of samples, the ring buffer wraps around.
+    float* samples = calloc(n_channels * chunk, sizeof(float));
+    uint32_t k = 0;
+    for (uint32_t c = 0; c < 15; c++)
+    {
+        for (uint32_t i = 0; i < chunk; i++, k++)
+            for (uint32_t j = 0; j < n_channels; j++)
+                samples[n_channels * i + j] = sin(M_2PI * k * (j + 1) / (double)n_samples);
+        dvz_visual_data_ring(&visual, DVZ_SOURCE_TYPE_VERTEX, 0, n_channels * chunk, samples);
+    }
+    FREE(samples);
+
+    AT(source->arr.item_count == n_channels * n_samples);
+    AT(source->ring_count == n_channels * n_samples);
+    AT(source->ring_head == n_channels * 500);
+
+    return _visual_run(&visual, "stream");
+}
+
+
+
+static int _text_run(DvzCanvas* canvas, int flags, const char* name)
+{
+    ASSERT(canvas != NULL);
+
+    // Make visual.
+    DvzVisual visual = dvz_visual(canvas);
+    dvz_visual_builtin(&visual, DVZ_VISUAL_TEXT, flags);
     _visual_common(&visual);
 
     // Vertex count and params.
@@ -718,7 +1104,117 @@ int test_vislib_text(TestContext* tc)
     FREE(glyph);
     FREE(length);
 
-    return _visual_run(&visual, "text");
+    return _visual_run(&visual, name);
+}
+
+int test_vislib_text(TestContext* tc)
+{
+    return _text_run(tc->canvas, 0, "text");
+}
+
+int test_vislib_text_instanced(TestContext* tc)
+{
+    return _text_run(tc->canvas, DVZ_TEXT_FLAGS_INSTANCED, "text_instanced");
+}
+
+int test_vislib_text_cache(TestContext* tc)
+{
+    DvzCanvas* canvas = tc->canvas;
+    ASSERT(canvas != NULL);
+
+    DvzVisual visual = dvz_visual(canvas);
+    dvz_visual_builtin(&visual, DVZ_VISUAL_TEXT, 0);
+    _visual_common(&visual);
+
+    char* text[3] = {"abc", "de", "fgh"};
+    dvz_visual_data(&visual, DVZ_PROP_POS, 0, 3, (dvec3[]){{-.5, 0, 0}, {0, 0, 0}, {.5, 0, 0}});
+    dvz_visual_data(&visual, DVZ_PROP_TEXT, 0, 3, text);
+    dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+
+    DvzSource* source = dvz_source_get(&visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    DvzArray* arr = &source->arr;
+    const uint32_t reps = 4;
+    AT(visual.text_cache.runs.item_count == 3);
+    AT(visual.text_cache.glyph_count == 8);
+    AT(arr->item_count == reps * 8);
+    DvzGraphicsTextVertex* vertices = calloc(arr->item_count, sizeof(DvzGraphicsTextVertex));
+    memcpy(vertices, arr->data, arr->item_count * sizeof(DvzGraphicsTextVertex));
+
+    // Same number of glyphs: only the modified string is laid out and uploaded.
+    text[1] = "xy";
+    dvz_visual_data(&visual, DVZ_PROP_TEXT, 0, 3, text);
+    visual.callback_bake(&visual, (DvzVisualDataEvent){0});
+    AT(source->dirty_first == reps * 3);
+    AT(source->dirty_count == reps * 2);
+    AT(memcmp(arr->data, vertices, reps * 3 * sizeof(DvzGraphicsTextVertex)) == 0);
+    AT(memcmp(
+           dvz_array_item(arr, reps * 3), &vertices[reps * 3],
+           reps * 2 * sizeof(DvzGraphicsTextVertex)) != 0);
+    dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+
+    // Moving a string does not require a new layout.
+    memcpy(vertices, arr->data, arr->item_count * sizeof(DvzGraphicsTextVertex));
+    dvz_visual_data_partial(&visual, DVZ_PROP_POS, 0, 2, 1, 1, (dvec3[]){{.5, .5, 0}});
+    visual.callback_bake(&visual, (DvzVisualDataEvent){0});
+    AT(source->dirty_first == reps * 5);
+    AT(source->dirty_count == reps * 3);
+    DvzGraphicsTextVertex* vertex = dvz_array_item(arr, reps * 5);
+    AT(memcmp(vertex->glyph_rect, vertices[reps * 5].glyph_rect, sizeof(usvec4)) == 0);
+    AT(memcmp(vertex->pos, vertices[reps * 5].pos, sizeof(vec3)) != 0);
+    dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+
+    // Different number of glyphs: the unchanged glyph runs are moved.
+    memcpy(vertices, arr->data, arr->item_count * sizeof(DvzGraphicsTextVertex));
+    text[1] = "xyz";
+    dvz_visual_data(&visual, DVZ_PROP_TEXT, 0, 3, text);
+    visual.callback_bake(&visual, (DvzVisualDataEvent){0});
+    AT(visual.text_cache.glyph_count == 9);
+    AT(arr->item_count == reps * 9);
+    AT(source->dirty_count == 0);
+    AT(memcmp(arr->data, vertices, reps * 3 * sizeof(DvzGraphicsTextVertex)) == 0);
+    AT(memcmp(
+           dvz_array_item(arr, reps * 6), &vertices[reps * 5],
+           reps * 3 * sizeof(DvzGraphicsTextVertex)) == 0);
+    dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+
+    // Inserting a string: the other strings are found in the cache at their previous index. The
+    // glyph rectangles are marked to check that their glyphs are not laid out again.
+    DvzGraphicsTextVertex* vertex_item = NULL;
+    for (uint32_t i = 0; i < arr->item_count; i++)
+        ((DvzGraphicsTextVertex*)dvz_array_item(arr, i))->glyph_rect[3] = 12345;
+    char* text_inserted[4] = {"ij", "abc", "xyz", "fgh"};
+    dvz_visual_data(
+        &visual, DVZ_PROP_POS, 0, 4,
+        (dvec3[]){{0, -.5, 0}, {-.5, 0, 0}, {0, 0, 0}, {.5, 0, 0}});
+    dvz_visual_data(&visual, DVZ_PROP_TEXT, 0, 4, text_inserted);
+    visual.callback_bake(&visual, (DvzVisualDataEvent){0});
+    AT(visual.text_cache.glyph_count == 11);
+    AT(arr->item_count == reps * 11);
+    AT(((DvzGraphicsTextVertex*)dvz_array_item(arr, 0))->glyph_rect[3] != 12345);
+    for (uint32_t i = reps * 2; i < arr->item_count; i++)
+    {
+        vertex_item = dvz_array_item(arr, i);
+        AT(vertex_item->glyph_rect[3] == 12345);
+        AT(vertex_item->glyph[3] == 1 + (i / reps - 2) / 3);
+    }
+
+    // Removing strings: the other strings are evicted from the cache.
+    uint32_t* slots = NULL;
+    uint32_t slot_count = 0;
+    dvz_visual_data(&visual, DVZ_PROP_POS, 0, 1, (dvec3[]){{0, 0, 0}});
+    dvz_visual_data(&visual, DVZ_PROP_TEXT, 0, 1, (char*[]){"fgh"});
+    visual.callback_bake(&visual, (DvzVisualDataEvent){0});
+    AT(visual.text_cache.runs.item_count == 1);
+    AT(arr->item_count == reps * 3);
+    AT(((DvzGraphicsTextVertex*)dvz_array_item(arr, 0))->glyph_rect[3] == 12345);
+    AT(((DvzGraphicsTextVertex*)dvz_array_item(arr, 0))->glyph[3] == 0);
+    slots = (uint32_t*)visual.text_cache.slots.data;
+    for (uint32_t i = 0; i < visual.text_cache.slots.item_count; i++)
+        slot_count += slots[i] != 0 ? 1 : 0;
+    AT(slot_count == 1);
+
+    FREE(vertices);
+    return _visual_run(&visual, "text_cache");
 }
 
 
@@ -799,7 +1295,7 @@ int test_vislib_image_cmap(TestContext* tc)
 /*  Axes visuals tests                                                                           */
 /*************************************************************************************************/
 
-static int _vislib_axes(TestContext* tc, DvzAxisCoord coord, const char* name)
+static int _vislib_axes(TestContext* tc, DvzAxisCoord coord, int flags, const char* name)
 {
     DvzCanvas* canvas = tc->canvas;
     ASSERT(canvas != NULL);
@@ -811,19 +1307,13 @@ static int _vislib_axes(TestContext* tc, DvzAxisCoord coord, const char* name)
 
     // Make visual.
     DvzVisual visual = dvz_visual(canvas);
-    dvz_visual_builtin(&visual, DVZ_VISUAL_AXES_2D, (int)coord);
+    dvz_visual_builtin(&visual, DVZ_VISUAL_AXES_2D, (int)coord | flags);
     _visual_common(&visual);
     dvz_visual_data(&visual, DVZ_PROP_VIEWPORT, 1, 1, &canvas->viewport);
 
 
-    // Font atlas.
-    DvzFontAtlas* atlas = &canvas->gpu->context->font_atlas;
-    ASSERT(atlas != NULL);
-    ASSERT(atlas->font_str != NULL);
-    ASSERT(strlen(atlas->font_str) > 0);
-    ASSERT(atlas->texture != NULL);
-
-    dvz_visual_texture(&visual, DVZ_SOURCE_TYPE_FONT_ATLAS, 0, atlas->texture);
+    // NOTE: the glyph atlas is bound to the visual when the labels are baked.
+    ASSERT(canvas->gpu->context->glyph_atlas != NULL);
 
 
     // Prepare the data.
@@ -855,15 +1345,19 @@ static int _vislib_axes(TestContext* tc, DvzAxisCoord coord, const char* name)
     dvz_visual_data(&visual, DVZ_PROP_POS, DVZ_AXES_LEVEL_GRID, N, xticks);
     dvz_visual_data(&visual, DVZ_PROP_TEXT, 0, N, strings);
 
-    // Text params.
-    DvzGraphicsTextParams params = {0};
-    params.grid_size[0] = (int32_t)atlas->rows;
-    params.grid_size[1] = (int32_t)atlas->cols;
-    params.tex_size[0] = (int32_t)atlas->width;
-    params.tex_size[1] = (int32_t)atlas->height;
-    dvz_visual_data_source(&visual, DVZ_SOURCE_TYPE_PARAM, 0, 0, 1, 1, &params);
-
-
+    // GPU axes: the labels are laid out once, and not again when the same ticks are set.
+    if ((flags & (DVZ_AXES_FLAGS_GPU >> 8)) != 0)
+    {
+        dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+        uint32_t run_count = visual.axes_labels.keys.item_count;
+        AT(run_count == N + 1); // the first glyph run is the empty label
+
+        dvz_visual_data(&visual, DVZ_PROP_POS, DVZ_AXES_LEVEL_MAJOR, N, xticks);
+        dvz_visual_data(&visual, DVZ_PROP_TEXT, 0, N, strings);
+        dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+        AT(visual.axes_labels.keys.item_count == run_count);
+        AT(dvz_source_get(&visual, DVZ_SOURCE_TYPE_VERTEX, 0)->arr.item_count == N);
+    }
 
     int res = _visual_run(&visual, name);
 
@@ -880,14 +1374,21 @@ static int _vislib_axes(TestContext* tc, DvzAxisCoord coord, const char* name)
 
 int test_vislib_axes_2D_x(TestContext* tc)
 {
-    return _vislib_axes(tc, DVZ_AXES_COORD_X, "axes_2D_x");
+    return _vislib_axes(tc, DVZ_AXES_COORD_X, 0, "axes_2D_x");
 }
 
 
 
 int test_vislib_axes_2D_y(TestContext* tc)
 {
-    return _vislib_axes(tc, DVZ_AXES_COORD_Y, "axes_2D_y");
+    return _vislib_axes(tc, DVZ_AXES_COORD_Y, 0, "axes_2D_y");
+}
+
+
+
+int test_vislib_axes_2D_gpu(TestContext* tc)
+{
+    return _vislib_axes(tc, DVZ_AXES_COORD_X, DVZ_AXES_FLAGS_GPU >> 8, "axes_2D_gpu");
 }
 
 
@@ -941,6 +1442,67 @@ int test_vislib_mesh(TestContext* tc)
     return _visual_run(&visual, "mesh");
 }
 
+int test_vislib_mesh_quantized(TestContext* tc)
+{
+    DvzCanvas* canvas = tc->canvas;
+    ASSERT(canvas != NULL);
+
+    // Make visual.
+    DvzVisual visual = dvz_visual(canvas);
+    dvz_visual_builtin(&visual, DVZ_VISUAL_MESH, DVZ_MESH_FLAGS_QUANTIZED);
+    _visual_common(&visual);
+
+    DvzMesh mesh = dvz_mesh_cube();
+
+    // Go through the props, the vertices are quantized when they are copied to the vertex buffer.
+    uint32_t n = mesh.vertices.item_count;
+    dvec3* pos = calloc(n, sizeof(dvec3));
+    vec3* normal = calloc(n, sizeof(vec3));
+    vec2* uv = calloc(n, sizeof(vec2));
+    DvzGraphicsMeshVertex* vertex = NULL;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        vertex = (DvzGraphicsMeshVertex*)dvz_array_item(&mesh.vertices, i);
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            pos[i][j] = vertex->pos[j];
+            normal[i][j] = vertex->normal[j];
+        }
+        uv[i][0] = vertex->uv[0];
+        uv[i][1] = vertex->uv[1];
+    }
+    dvz_visual_data(&visual, DVZ_PROP_POS, 0, n, pos);
+    dvz_visual_data(&visual, DVZ_PROP_NORMAL, 0, n, normal);
+    dvz_visual_data(&visual, DVZ_PROP_TEXCOORDS, 0, n, uv);
+    dvz_visual_data(&visual, DVZ_PROP_INDEX, 0, mesh.indices.item_count, mesh.indices.data);
+    FREE(pos);
+    FREE(normal);
+    FREE(uv);
+
+    // Params.
+    DvzGraphicsMeshParams params = default_graphics_mesh_params((vec3){0, 0, 3});
+    dvz_visual_data_source(&visual, DVZ_SOURCE_TYPE_PARAM, 0, 0, 1, 1, &params);
+
+    // Texture.
+    DvzTexture* texture = _mock_texture(canvas->gpu->context);
+    dvz_visual_texture(&visual, DVZ_SOURCE_TYPE_IMAGE, 0, texture);
+
+    // Arcball interact and rotation.
+    DvzInteract interact = dvz_interact_builtin(canvas, DVZ_INTERACT_ARCBALL);
+    DvzArcball* arcball = &interact.u.a;
+    vec3 angles = {M_PI / 8, -M_PI / 8, 0};
+    _arcball_from_angles(arcball, angles);
+    glm_quat_mat4(arcball->rotation, arcball->mat);
+    _arcball_update_mvp(canvas->viewport, arcball, &interact.mvp);
+    dvz_visual_data(&visual, DVZ_PROP_MODEL, 0, 1, interact.mvp.model);
+    dvz_visual_data(&visual, DVZ_PROP_VIEW, 0, 1, interact.mvp.view);
+    dvz_visual_data(&visual, DVZ_PROP_PROJ, 0, 1, interact.mvp.proj);
+
+    dvz_mesh_destroy(&mesh);
+
+    return _visual_run(&visual, "mesh_quantized");
+}
+
 
 
 int test_vislib_volume(TestContext* tc) { return 0; }
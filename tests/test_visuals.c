@@ -1,6 +1,7 @@
 #include "../include/datoviz/colormaps.h"
 #include "../include/datoviz/interact.h"
 #include "../include/datoviz/visuals.h"
+#include "../src/visuals_utils.h"
 #include "proto.h"
 #include "tests.h"
 
@@ -465,6 +466,133 @@ int test_visuals_partial(TestContext* tc)
 
 
 
+int test_visuals_dirty(TestContext* tc)
+{
+    DvzCanvas* canvas = tc->canvas;
+    DvzContext* context = tc->context;
+
+    ASSERT(canvas != NULL);
+    ASSERT(context != NULL);
+
+    // Create the visual.
+    DvzVisual visual = dvz_visual(canvas);
+    _visual_create(&visual);
+    _visual_bindings(&visual);
+
+    // Vertex data.
+    const uint32_t N = 12;
+    _visual_data(&visual, N);
+    dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+
+    DvzProp* prop = dvz_prop_get(&visual, DVZ_PROP_POS, 0);
+    DvzSource* source = dvz_source_get(&visual, DVZ_SOURCE_TYPE_VERTEX, 0);
+    AT(prop->dirty_count == 0);
+    AT(source->dirty_count == 0);
+
+    // Partial data update: only the modified items should be marked as dirty.
+    dvec3 pos[2] = {{0, .5, 0}, {0, -.5, 0}};
+    dvz_visual_data_partial(&visual, DVZ_PROP_POS, 0, 3, 2, 2, pos);
+    AT(prop->dirty_first == 3);
+    AT(prop->dirty_count == 2);
+
+    // Another partial update extends the dirty range.
+    dvz_visual_data_partial(&visual, DVZ_PROP_POS, 0, 7, 1, 1, pos);
+    AT(prop->dirty_first == 3);
+    AT(prop->dirty_count == 5);
+
+    // The bake only copies the dirty range into the vertex source.
+    dvz_visual_update(&visual, canvas->viewport, (DvzDataCoords){0}, NULL);
+    AT(prop->dirty_count == 0);
+    AT(source->dirty_count == 0);
+    DvzVertex* vertex = dvz_array_item(&source->arr, 4);
+    AC(vertex->pos[1], -.5, 1e-6);
+    vertex = dvz_array_item(&source->arr, 7);
+    AC(vertex->pos[1], .5, 1e-6);
+
+    // Resizing the prop marks the whole array as dirty.
+    _visual_data(&visual, N + 1);
+    AT(prop->dirty_first == 0);
+    AT(prop->dirty_count == N + 1);
+
+    _visual_destroy(&visual);
+    return 0;
+}
+
+
+
+int test_visuals_lod(TestContext* tc)
+{
+    DvzCanvas* canvas = tc->canvas;
+    ASSERT(canvas != NULL);
+
+    // Create the visual.
+    DvzVisual visual = dvz_visual(canvas);
+    _visual_create(&visual);
+
+    // Vertex data: a sine wave, the minimum is at i = 750 and the maximum at i = 250.
+    const uint32_t N = 1000;
+    dvec3* pos = calloc(N, sizeof(dvec3));
+    for (uint32_t i = 0; i < N; i++)
+    {
+        pos[i][0] = -1 + 2 * i / (double)(N - 1);
+        pos[i][1] = sin(M_2PI * i / (double)N);
+    }
+    dvz_visual_data(&visual, DVZ_PROP_POS, 0, N, pos);
+    FREE(pos);
+
+    DvzProp* prop = dvz_prop_get(&visual, DVZ_PROP_POS, 0);
+    DvzLod* lod = &visual.lod;
+    _lod_build(lod, &prop->arr_orig);
+    AT(lod->valid);
+    AT(lod->item_count == N);
+
+    // Level L has 2 samples per bin of 2^L samples.
+    AT(lod->level_count == 10);
+    AT(lod->levels[2].item_count == N / 2);
+    AT(lod->levels[8].item_count == 8);
+
+    // The samples of each bin are the min and max, in order.
+    uint32_t* indices = (uint32_t*)lod->levels[8].data;
+    AT(indices[0] == 0);
+    AT(indices[1] == 250);
+    AT(indices[4] == 512);
+    AT(indices[5] == 750);
+    for (uint32_t l = 2; l < lod->level_count; l++)
+    {
+        indices = (uint32_t*)lod->levels[l].data;
+        for (uint32_t i = 0; i < lod->levels[l].item_count / 2; i++)
+            AT(indices[2 * i] <= indices[2 * i + 1]);
+    }
+
+    // Level selection: each bin spans at most one pixel.
+    AT(_lod_level(lod, 1000) == 0);
+    AT(_lod_level(lod, 250) == 2);
+    AT(_lod_level(lod, 100) == 3);
+    AT(_lod_level(lod, 1) == 9);
+
+    // Decimated props in the staging arrays.
+    lod->level = 3;
+    _lod_stage(&visual);
+    AT(lod->staged);
+    AT(prop->arr_staging.item_count == lod->levels[3].item_count);
+    AT(_prop_array(prop, DVZ_PROP_ARRAY_DEFAULT) == &prop->arr_staging);
+
+    // Back to the full resolution.
+    lod->level = 0;
+    _lod_stage(&visual);
+    AT(!lod->staged);
+    AT(prop->arr_staging.item_count == 0);
+
+    // Changing the positions invalidates the pyramid.
+    dvz_visual_data(&visual, DVZ_PROP_POS, 0, 1, (dvec3[]){{0, 0, 0}});
+    AT(!lod->valid);
+
+    _visual_destroy(&visual);
+    return 0;
+}
+
+
+
 static void _visual_append(DvzCanvas* canvas, DvzEvent ev)
 {
     ASSERT(canvas != NULL);
@@ -30,6 +30,7 @@ int test_utils_array_5(TestContext*);
 int test_utils_array_6(TestContext*);
 int test_utils_array_7(TestContext*);
 int test_utils_array_cast(TestContext*);
+int test_utils_array_quantize(TestContext*);
 int test_utils_array_mvp(TestContext*);
 int test_utils_array_3D(TestContext*);
 
@@ -37,6 +38,9 @@ int test_utils_transforms_1(TestContext*);
 int test_utils_transforms_2(TestContext*);
 int test_utils_transforms_3(TestContext*);
 int test_utils_transforms_4(TestContext*);
+int test_utils_transforms_float(TestContext*);
+int test_utils_transforms_box(TestContext*);
+int test_utils_transforms_parallel(TestContext*);
 // int test_utils_transforms_5(TestContext*);
 
 int test_utils_colormap_idx(TestContext*);
@@ -51,6 +55,14 @@ int test_utils_ticks_1(TestContext*);
 int test_utils_ticks_2(TestContext*);
 int test_utils_ticks_duplicate(TestContext*);
 int test_utils_ticks_extend(TestContext*);
+int test_utils_ticks_worker(TestContext*);
+
+int test_utils_octree(TestContext*);
+int test_utils_pslg(TestContext*);
+int test_utils_pslg_degenerate(TestContext*);
+int test_utils_mesh_normals(TestContext*);
+int test_utils_mesh_obj(TestContext*);
+int test_utils_mesh_obj_parity(TestContext*);
 
 // Test vklite.
 int test_vklite_app(TestContext*);
@@ -80,6 +92,7 @@ int test_context_compute(TestContext*);
 int test_context_transfer_buffer(TestContext*);
 int test_context_transfer_texture(TestContext*);
 int test_context_colormap_custom(TestContext*);
+int test_context_glyphs(TestContext*);
 
 // Test canvas.
 int test_canvas_blank(TestContext*);
@@ -113,6 +126,7 @@ int test_graphics_triangle_strip(TestContext*);
 int test_graphics_triangle_fan(TestContext*);
 int test_graphics_marker(TestContext*);
 int test_graphics_segment(TestContext*);
+int test_graphics_segment_pull(TestContext*);
 int test_graphics_path(TestContext*);
 int test_graphics_text(TestContext*);
 int test_graphics_image_1(TestContext*);
@@ -127,11 +141,14 @@ int test_visuals_props(TestContext*);
 int test_visuals_update_color(TestContext*);
 int test_visuals_update_pos(TestContext*);
 int test_visuals_partial(TestContext*);
+int test_visuals_dirty(TestContext*);
+int test_visuals_lod(TestContext*);
 int test_visuals_append(TestContext*);
 int test_visuals_shared(TestContext*);
 
 // Test builtin visuals.
 int test_vislib_point(TestContext*);
+int test_vislib_point_quantized(TestContext*);
 int test_vislib_line_list(TestContext*);
 int test_vislib_line_strip(TestContext*);
 int test_vislib_triangle_list(TestContext*);
@@ -139,14 +156,27 @@ int test_vislib_triangle_strip(TestContext*);
 int test_vislib_triangle_fan(TestContext*);
 int test_vislib_rectangle(TestContext*);
 int test_vislib_marker(TestContext*);
+int test_vislib_marker_instanced(TestContext*);
+int test_vislib_marker_split_color(TestContext*);
+int test_vislib_marker_scalar_color(TestContext*);
+int test_vislib_segment(TestContext*);
+int test_vislib_segment_pull(TestContext*);
 int test_vislib_polygon(TestContext*);
+int test_vislib_polygon_cache(TestContext*);
+int test_vislib_pslg(TestContext*);
 int test_vislib_path(TestContext*);
+int test_vislib_path_pull(TestContext*);
+int test_vislib_stream(TestContext*);
 int test_vislib_text(TestContext*);
+int test_vislib_text_instanced(TestContext*);
+int test_vislib_text_cache(TestContext*);
 int test_vislib_image_1(TestContext*);
 int test_vislib_image_cmap(TestContext*);
 int test_vislib_axes_2D_x(TestContext*);
 int test_vislib_axes_2D_y(TestContext*);
+int test_vislib_axes_2D_gpu(TestContext*);
 int test_vislib_mesh(TestContext*);
+int test_vislib_mesh_quantized(TestContext*);
 int test_vislib_volume(TestContext*);
 int test_vislib_volume_slice(TestContext*);
 
@@ -156,10 +186,17 @@ int test_scene_empty_visuals(TestContext*);
 int test_scene_single(TestContext*);
 int test_scene_double(TestContext*);
 int test_scene_multiple(TestContext*);
+int test_scene_batch(TestContext*);
+int test_scene_float(TestContext*);
+int test_scene_gpu_transform(TestContext*);
 int test_scene_link(TestContext*);
 int test_scene_different_size(TestContext*);
 int test_scene_different_controllers(TestContext*);
 int test_scene_dynamic_axes(TestContext*);
+int test_scene_point_cloud(TestContext*);
+int test_scene_cull(TestContext*);
+int test_scene_density(TestContext*);
+int test_scene_histogram(TestContext*);
 
 
 
@@ -174,40 +211,51 @@ int test_scene_dynamic_axes(TestContext*);
 
 static TestCase TEST_CASES[] = {
     // Utils.
-    CASE_FIXTURE(NONE, test_utils_container),        //
-    CASE_FIXTURE(NONE, test_utils_thread),           //
-    CASE_FIXTURE(NONE, test_utils_fifo_1),           //
-    CASE_FIXTURE(NONE, test_utils_fifo_2),           //
-    CASE_FIXTURE(NONE, test_utils_fifo_resize),      //
-    CASE_FIXTURE(NONE, test_utils_fifo_discard),     //
-    CASE_FIXTURE(NONE, test_utils_fifo_first),       //
-    CASE_FIXTURE(NONE, test_utils_deq_1),            //
-    CASE_FIXTURE(NONE, test_utils_deq_2),            //
-    CASE_FIXTURE(NONE, test_utils_array_1),          //
-    CASE_FIXTURE(NONE, test_utils_array_2),          //
-    CASE_FIXTURE(NONE, test_utils_array_3),          //
-    CASE_FIXTURE(NONE, test_utils_array_4),          //
-    CASE_FIXTURE(NONE, test_utils_array_5),          //
-    CASE_FIXTURE(NONE, test_utils_array_6),          //
-    CASE_FIXTURE(NONE, test_utils_array_7),          //
-    CASE_FIXTURE(NONE, test_utils_array_cast),       //
-    CASE_FIXTURE(NONE, test_utils_array_mvp),        //
-    CASE_FIXTURE(NONE, test_utils_array_3D),         //
-    CASE_FIXTURE(NONE, test_utils_transforms_1),     //
-    CASE_FIXTURE(NONE, test_utils_transforms_2),     //
-    CASE_FIXTURE(NONE, test_utils_transforms_3),     //
-    CASE_FIXTURE(NONE, test_utils_transforms_4),     //
-    CASE_FIXTURE(NONE, test_utils_colormap_idx),     //
-    CASE_FIXTURE(NONE, test_utils_colormap_uv),      //
-    CASE_FIXTURE(NONE, test_utils_colormap_extent),  //
-    CASE_FIXTURE(NONE, test_utils_colormap_default), //
-    CASE_FIXTURE(NONE, test_utils_colormap_scale),   //
-    CASE_FIXTURE(NONE, test_utils_colormap_packuv),  //
-    CASE_FIXTURE(NONE, test_utils_colormap_array),   //
-    CASE_FIXTURE(NONE, test_utils_ticks_1),          //
-    CASE_FIXTURE(NONE, test_utils_ticks_2),          //
-    CASE_FIXTURE(NONE, test_utils_ticks_duplicate),  //
-    CASE_FIXTURE(NONE, test_utils_ticks_extend),     //
+    CASE_FIXTURE(NONE, test_utils_container),           //
+    CASE_FIXTURE(NONE, test_utils_thread),              //
+    CASE_FIXTURE(NONE, test_utils_fifo_1),              //
+    CASE_FIXTURE(NONE, test_utils_fifo_2),              //
+    CASE_FIXTURE(NONE, test_utils_fifo_resize),         //
+    CASE_FIXTURE(NONE, test_utils_fifo_discard),        //
+    CASE_FIXTURE(NONE, test_utils_fifo_first),          //
+    CASE_FIXTURE(NONE, test_utils_deq_1),               //
+    CASE_FIXTURE(NONE, test_utils_deq_2),               //
+    CASE_FIXTURE(NONE, test_utils_array_1),             //
+    CASE_FIXTURE(NONE, test_utils_array_2),             //
+    CASE_FIXTURE(NONE, test_utils_array_3),             //
+    CASE_FIXTURE(NONE, test_utils_array_4),             //
+    CASE_FIXTURE(NONE, test_utils_array_5),             //
+    CASE_FIXTURE(NONE, test_utils_array_6),             //
+    CASE_FIXTURE(NONE, test_utils_array_7),             //
+    CASE_FIXTURE(NONE, test_utils_array_cast),          //
+    CASE_FIXTURE(NONE, test_utils_array_quantize),      //
+    CASE_FIXTURE(NONE, test_utils_array_mvp),           //
+    CASE_FIXTURE(NONE, test_utils_array_3D),            //
+    CASE_FIXTURE(NONE, test_utils_transforms_1),        //
+    CASE_FIXTURE(NONE, test_utils_transforms_2),        //
+    CASE_FIXTURE(NONE, test_utils_transforms_3),        //
+    CASE_FIXTURE(NONE, test_utils_transforms_4),        //
+    CASE_FIXTURE(NONE, test_utils_transforms_float),    //
+    CASE_FIXTURE(NONE, test_utils_transforms_box),      //
+    CASE_FIXTURE(NONE, test_utils_transforms_parallel), //
+    CASE_FIXTURE(NONE, test_utils_colormap_idx),        //
+    CASE_FIXTURE(NONE, test_utils_colormap_uv),         //
+    CASE_FIXTURE(NONE, test_utils_colormap_extent),     //
+    CASE_FIXTURE(NONE, test_utils_colormap_default),    //
+    CASE_FIXTURE(NONE, test_utils_colormap_scale),      //
+    CASE_FIXTURE(NONE, test_utils_colormap_packuv),     //
+    CASE_FIXTURE(NONE, test_utils_colormap_array),      //
+    CASE_FIXTURE(NONE, test_utils_ticks_1),             //
+    CASE_FIXTURE(NONE, test_utils_ticks_2),             //
+    CASE_FIXTURE(NONE, test_utils_ticks_duplicate),     //
+    CASE_FIXTURE(NONE, test_utils_ticks_extend),        //
+    CASE_FIXTURE(NONE, test_utils_ticks_worker),        //
+    CASE_FIXTURE(NONE, test_utils_octree),              //
+    CASE_FIXTURE(NONE, test_utils_pslg),                //
+    CASE_FIXTURE(NONE, test_utils_pslg_degenerate),     //
+    CASE_FIXTURE(NONE, test_utils_mesh_normals),        //
+    CASE_FIXTURE(NONE, test_utils_mesh_obj),            //
+    CASE_FIXTURE(NONE, test_utils_mesh_obj_parity),     //
 
     // vklite.
     CASE_FIXTURE(NONE, test_vklite_app),             //
@@ -237,6 +285,7 @@ static TestCase TEST_CASES[] = {
     CASE_FIXTURE(CONTEXT, test_context_transfer_buffer),  //
     CASE_FIXTURE(CONTEXT, test_context_transfer_texture), //
     CASE_FIXTURE(CONTEXT, test_context_colormap_custom),  //
+    CASE_FIXTURE(CONTEXT, test_context_glyphs),           //
 
     // Canvas.
     CASE_FIXTURE(APP, test_canvas_blank),              //
@@ -269,6 +318,7 @@ static TestCase TEST_CASES[] = {
     CASE_FIXTURE(CANVAS, test_graphics_triangle_fan),   //
     CASE_FIXTURE(CANVAS, test_graphics_marker),         //
     CASE_FIXTURE(CANVAS, test_graphics_segment),        //
+    CASE_FIXTURE(CANVAS, test_graphics_segment_pull),   //
     CASE_FIXTURE(CANVAS, test_graphics_path),           //
     CASE_FIXTURE(CANVAS, test_graphics_text),           //
     CASE_FIXTURE(CANVAS, test_graphics_image_1),        //
@@ -283,28 +333,44 @@ static TestCase TEST_CASES[] = {
     CASE_FIXTURE(CANVAS, test_visuals_update_color), //
     CASE_FIXTURE(CANVAS, test_visuals_update_pos),   //
     CASE_FIXTURE(CANVAS, test_visuals_partial),      //
+    CASE_FIXTURE(CANVAS, test_visuals_dirty),        //
+    CASE_FIXTURE(CANVAS, test_visuals_lod),          //
     CASE_FIXTURE(CANVAS, test_visuals_append),       //
     CASE_FIXTURE(CANVAS, test_visuals_shared),       //
 
     // Builtin visuals.
-    CASE_FIXTURE(CANVAS, test_vislib_point),          //
-    CASE_FIXTURE(CANVAS, test_vislib_line_list),      //
-    CASE_FIXTURE(CANVAS, test_vislib_line_strip),     //
-    CASE_FIXTURE(CANVAS, test_vislib_triangle_list),  //
-    CASE_FIXTURE(CANVAS, test_vislib_triangle_strip), //
-    CASE_FIXTURE(CANVAS, test_vislib_triangle_fan),   //
-    CASE_FIXTURE(CANVAS, test_vislib_rectangle),      //
-    CASE_FIXTURE(CANVAS, test_vislib_marker),         //
-    CASE_FIXTURE(CANVAS, test_vislib_polygon),        //
-    CASE_FIXTURE(CANVAS, test_vislib_path),           //
-    CASE_FIXTURE(CANVAS, test_vislib_text),           //
-    CASE_FIXTURE(CANVAS, test_vislib_image_1),        //
-    CASE_FIXTURE(CANVAS, test_vislib_image_cmap),     //
-    CASE_FIXTURE(CANVAS, test_vislib_axes_2D_x),      //
-    CASE_FIXTURE(CANVAS, test_vislib_axes_2D_y),      //
-    CASE_FIXTURE(CANVAS, test_vislib_mesh),           //
-    CASE_FIXTURE(CANVAS, test_vislib_volume),         //
-    CASE_FIXTURE(CANVAS, test_vislib_volume_slice),   //
+    CASE_FIXTURE(CANVAS, test_vislib_point),               //
+    CASE_FIXTURE(CANVAS, test_vislib_point_quantized),     //
+    CASE_FIXTURE(CANVAS, test_vislib_line_list),           //
+    CASE_FIXTURE(CANVAS, test_vislib_line_strip),          //
+    CASE_FIXTURE(CANVAS, test_vislib_triangle_list),       //
+    CASE_FIXTURE(CANVAS, test_vislib_triangle_strip),      //
+    CASE_FIXTURE(CANVAS, test_vislib_triangle_fan),        //
+    CASE_FIXTURE(CANVAS, test_vislib_rectangle),           //
+    CASE_FIXTURE(CANVAS, test_vislib_marker),              //
+    CASE_FIXTURE(CANVAS, test_vislib_marker_instanced),    //
+    CASE_FIXTURE(CANVAS, test_vislib_marker_split_color),  //
+    CASE_FIXTURE(CANVAS, test_vislib_marker_scalar_color), //
+    CASE_FIXTURE(CANVAS, test_vislib_segment),             //
+    CASE_FIXTURE(CANVAS, test_vislib_segment_pull),        //
+    CASE_FIXTURE(CANVAS, test_vislib_polygon),             //
+    CASE_FIXTURE(CANVAS, test_vislib_polygon_cache),       //
+    CASE_FIXTURE(CANVAS, test_vislib_pslg),                //
+    CASE_FIXTURE(CANVAS, test_vislib_path),                //
+    CASE_FIXTURE(CANVAS, test_vislib_path_pull),           //
+    CASE_FIXTURE(CANVAS, test_vislib_stream),              //
+    CASE_FIXTURE(CANVAS, test_vislib_text),                //
+    CASE_FIXTURE(CANVAS, test_vislib_text_instanced),      //
+    CASE_FIXTURE(CANVAS, test_vislib_text_cache),          //
+    CASE_FIXTURE(CANVAS, test_vislib_image_1),             //
+    CASE_FIXTURE(CANVAS, test_vislib_image_cmap),          //
+    CASE_FIXTURE(CANVAS, test_vislib_axes_2D_x),           //
+    CASE_FIXTURE(CANVAS, test_vislib_axes_2D_y),           //
+    CASE_FIXTURE(CANVAS, test_vislib_axes_2D_gpu),         //
+    CASE_FIXTURE(CANVAS, test_vislib_mesh),                //
+    CASE_FIXTURE(CANVAS, test_vislib_mesh_quantized),      //
+    CASE_FIXTURE(CANVAS, test_vislib_volume),              //
+    CASE_FIXTURE(CANVAS, test_vislib_volume_slice),        //
 
     // Scene.
     CASE_FIXTURE(CANVAS, test_scene_empty),                 //
@@ -312,10 +378,17 @@ static TestCase TEST_CASES[] = {
     CASE_FIXTURE(CANVAS, test_scene_single),                //
     CASE_FIXTURE(CANVAS, test_scene_double),                //
     CASE_FIXTURE(CANVAS, test_scene_multiple),              //
+    CASE_FIXTURE(CANVAS, test_scene_batch),                 //
+    CASE_FIXTURE(CANVAS, test_scene_float),                 //
+    CASE_FIXTURE(CANVAS, test_scene_gpu_transform),         //
     CASE_FIXTURE(CANVAS, test_scene_link),                  //
     CASE_FIXTURE(CANVAS, test_scene_different_size),        //
     CASE_FIXTURE(CANVAS, test_scene_different_controllers), //
     CASE_FIXTURE(CANVAS, test_scene_dynamic_axes),          //
+    CASE_FIXTURE(CANVAS, test_scene_point_cloud),           //
+    CASE_FIXTURE(CANVAS, test_scene_cull),                  //
+    CASE_FIXTURE(CANVAS, test_scene_density),               //
+    CASE_FIXTURE(CANVAS, test_scene_histogram),             //
 
 };
 